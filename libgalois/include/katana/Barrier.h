@@ -58,6 +58,8 @@ public:
  * be in the barrier while the main thread reinitializes this
  * barrier to the new number of active threads. If that may
  * happen, use {@link CreateSimpleBarrier()} instead.
+ *
+ * Inside of a SubPool, this returns the barrier of the sub-pool.
  */
 KATANA_EXPORT Barrier& GetBarrier(unsigned active_threads);
 
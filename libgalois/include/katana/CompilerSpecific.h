@@ -50,6 +50,19 @@ constexpr int KATANA_CACHE_LINE_SIZE = 128;
 #define KATANA_ATTRIBUTE_NOINLINE
 #endif
 
+// Compile a function once for each listed target and pick the best version
+// for the running CPU when the library is loaded. The dispatch uses ifunc, so
+// other platforms only get the default version.
+#if defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define KATANA_ATTRIBUTE_TARGET_CLONES(...)                                    \
+  __attribute__((target_clones(__VA_ARGS__)))
+#endif
+#endif
+#ifndef KATANA_ATTRIBUTE_TARGET_CLONES
+#define KATANA_ATTRIBUTE_TARGET_CLONES(...)
+#endif
+
 }  // namespace katana
 
 #endif
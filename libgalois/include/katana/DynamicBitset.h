@@ -115,13 +115,12 @@ public:
   auto& get_vec() { return bitvec_; }
 
   iterator begin() const {
-    iterator bit0{this, 0, 0};
-    if (test(0)) {
-      // If bit 0 is set then we have the right iterator
-      return bit0;
+    size_t first = FindNextSet(0);
+    if (first == size()) {
+      return end();
     }
-    // Otherwise, increment to find the first set bit.
-    return ++bit0;
+    return {this, first / kNumBitsInUint64,
+            static_cast<uint8_t>(first % kNumBitsInUint64)};
   }
 
   iterator end() const { return {this, bitvec_.size(), 0}; }
@@ -351,6 +350,38 @@ public:
    */
   void bitwise_xor(const DynamicBitset& other1, const DynamicBitset& other2);
 
+  /**
+   * Does an IN-PLACE bitwise and of this bitset and the complement of another
+   * bitset, i.e., unsets every bit that is set in other
+   *
+   * @param other Bitset whose set bits to unset in this one
+   */
+  void bitwise_andnot(const DynamicBitset& other);
+
+  /**
+   * Finds the first set bit at or after index. Using this is recommended only
+   * if set() and reset() are not being used in that parallel section/phase.
+   *
+   * @param index Bit to start the search from
+   * @returns the index of the set bit or size() if there is none
+   */
+  size_t FindNextSet(size_t index) const {
+    if (index >= num_bits_) {
+      return num_bits_;
+    }
+    size_t word_index = index / kNumBitsInUint64;
+    uint64_t word = bitvec_[word_index].load(std::memory_order_relaxed) &
+                    (~uint64_t{0} << (index % kNumBitsInUint64));
+    while (word == 0) {
+      if (++word_index == bitvec_.size()) {
+        return num_bits_;
+      }
+      word = bitvec_[word_index].load(std::memory_order_relaxed);
+    }
+    // The unused bits of the last word are 0, so the result is < num_bits_
+    return word_index * kNumBitsInUint64 + __builtin_ctzll(word);
+  }
+
   /**
    * Count how many bits are set in the bitset. Do not call in a parallel
    * region as it uses a parallel loop.
@@ -401,17 +432,13 @@ public:
 
   bool operator!=(const DynamicBitset& other) const { return !Equals(other); }
 
-  bool Equals(const DynamicBitset& other) const {
-    if (size() != other.size()) {
-      return false;
-    }
-    for (size_t i = 0; i < size(); i++) {
-      if (test(i) != other.test(i)) {
-        return false;
-      }
-    }
-    return true;
-  }
+  /**
+   * Compares this bitset with another word by word. Assumes neither bitset
+   * is updated in parallel.
+   *
+   * @returns true if both bitsets have the same size and the same bits set
+   */
+  bool Equals(const DynamicBitset& other) const;
 
   //TODO(emcginnis): DynamicBitset is not actually memory copyable, remove this
   //! this is defined to
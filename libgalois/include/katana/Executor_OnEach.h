@@ -49,6 +49,7 @@ on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
 
   PerThreadTimer<MORE_STATS> execTime(loopname, "Execute");
 
+  ThreadPool::StartGuard start_guard;
   const auto numT = getActiveThreads();
 
   OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))> fn_ref = fn;
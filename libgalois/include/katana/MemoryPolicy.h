@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
 #include "katana/Manager.h"
@@ -33,6 +34,11 @@ public:
   static uint64_t OOMScore();
   /// Utility function to find out available memory in the machine
   static uint64_t AvailableMemoryBytes();
+  /// Utility functions to find out the memory limit of our cgroup (v2
+  /// memory.max or v1 memory.limit_in_bytes) and how much of it is charged.
+  /// nullopt if we are not in a cgroup with a memory limit.
+  static std::optional<uint64_t> CgroupMemoryLimitBytes();
+  static std::optional<uint64_t> CgroupMemoryUsageBytes();
 
   struct MemInfo;
   struct Thresholds {
@@ -44,7 +50,11 @@ public:
 
 protected:
   MemoryPolicy(Thresholds thresholds);
+  /// Policy for a process that may use at most \p physical bytes
+  MemoryPolicy(Thresholds thresholds, count_t physical);
   void UpdateMemInfo(MemInfo* mem_info, count_t standby) const;
+  /// Bytes we could still allocate without pressure
+  virtual count_t AvailableBytes() const;
 
   count_t physical() const { return physical_; }
   double high_used_ratio_threshold() const {
@@ -93,6 +103,22 @@ public:
   bool KillSelfForLackOfMemory(count_t standby) const override;
 };
 
+/// Memory policy for processes in a container. Thresholds are relative to the
+/// memory limit of the cgroup (if there is one, otherwise the machine), and
+/// available memory is what the cgroup may still be charged for, since the
+/// kernel reclaims or OOM kills within the cgroup long before the machine runs
+/// out of memory.
+class KATANA_EXPORT MemoryPolicyCgroup : public MemoryPolicy {
+public:
+  MemoryPolicyCgroup();
+  count_t ReclaimForMemoryPressure(count_t standby) const override;
+  bool IsMemoryPressureHigh(count_t standby) const override;
+  bool KillSelfForLackOfMemory(count_t standby) const override;
+
+protected:
+  count_t AvailableBytes() const override;
+};
+
 /// Do nothing to ever shed memory.  This will OOM if we occupy too much memory.
 class KATANA_EXPORT MemoryPolicyNull : public MemoryPolicy {
 public:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "katana/Cache.h"
@@ -11,7 +12,8 @@
 #include "katana/config.h"
 
 namespace katana {
-/// The memory supervisor singleton (MS).  Not thread safe.
+/// The memory supervisor singleton (MS).  Thread safe: managers may call it
+/// from several threads at once, e.g., when properties load concurrently.
 ///
 /// The MS controls policy and does bookkeeping.  All memory allocation
 /// is done by the system, mostly the C++ standard library.
@@ -58,15 +60,25 @@ public:
   /// Managers are always allowed to transition from standby to active
   void StandbyToActive(const std::string& name, count_t bytes);
 
+  /// How much standby memory manager \p name may hold: what it holds now plus
+  /// the memory still available or, under memory pressure, minus what the
+  /// policy wants reclaimed. Managers use it to decide what is worth keeping.
+  count_t StandbyBudget(const std::string& name);
+
   /// Give the memory supervisor a chance to release memory.  This is useful to call
   /// If you will be calling a series of allocations for active memory, you can use
   /// this to make sure we aren't holding on to too much standby memory.
   void CheckPressure();
 
   /// The MemoryPolicy controls decisions about memory allocation, like how
-  /// aggressively to deallocate.
+  /// aggressively to deallocate. The initial policy is chosen by
+  /// KATANA_MEMORY_POLICY (minimal, performance, meek, cgroup or null) and is
+  /// MemoryPolicyMinimal if it is not set.
   void SetPolicy(std::unique_ptr<MemoryPolicy> policy);
 
+  /// Sum of all standby memory across all managers
+  count_t standby() const;
+
   /// Provide access to a property manager, which manages the property cache
   PropertyManager* GetPropertyManager();
   CacheStats GetPropertyCacheStats() const;
@@ -74,21 +86,34 @@ public:
 
   /// Calls sysconf
   static uint64_t GetTotalSystemMemory();
+  /// The memory we may use: the memory of the machine or, if it is lower,
+  /// the memory limit of our cgroup
+  static uint64_t GetMemoryLimit();
 
 private:
   MemorySupervisor();
-  /// Make sure our state is sane, log if not
+  /// Make sure our state is sane, log if not. Called with mutex_ held.
   void SanityCheck();
 
-  /// Get managers to free \p goal bytes of standby memory
+  /// Get managers to free \p goal bytes of standby memory. Called with
+  /// reclaim_mutex_ held and mutex_ not held, because managers call back
+  /// into PutStandby.
   void ReclaimMemory(count_t goal);
 
   struct ManagerInfo {
     std::unique_ptr<Manager> manager_;
     count_t standby{};
   };
+  /// Fixed after construction
   std::unordered_map<std::string, ManagerInfo> managers_;
 
+  /// Guards policy_, the standby counts and bytes_reclaimed_. Never held
+  /// while calling into a manager.
+  mutable std::mutex mutex_;
+  /// Serializes reclaiming so that concurrent callers do not each free the
+  /// same excess. Taken before mutex_.
+  std::mutex reclaim_mutex_;
+
   count_t Available() {
     auto rss = static_cast<katana::count_t>(
         katana::ProgressTracer::ParseProcSelfRssBytes());
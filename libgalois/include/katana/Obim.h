@@ -20,8 +20,11 @@
 #ifndef KATANA_LIBGALOIS_KATANA_OBIM_H_
 #define KATANA_LIBGALOIS_KATANA_OBIM_H_
 
+#include <array>
+#include <atomic>
 #include <deque>
 #include <limits>
+#include <optional>
 #include <type_traits>
 
 #include "katana/Barrier.h"
@@ -29,6 +32,7 @@
 #include "katana/FlatMap.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/TerminationDetection.h"
+#include "katana/Threads.h"
 #include "katana/WorkListHelpers.h"
 
 namespace katana {
@@ -53,7 +57,7 @@ protected:
 
   Barrier& barrier;
 
-  OrderedByIntegerMetricData() : barrier(GetBarrier(activeThreads)) {}
+  OrderedByIntegerMetricData() : barrier(GetBarrier(getActiveThreads())) {}
 
   bool hasStored(ThreadData& p, Index idx) {
     for (auto& e : p.stored) {
@@ -108,6 +112,87 @@ struct OrderedByIntegerMetricComparator<Index, true> {
         earliest(std::numeric_limits<Index>::max()) {}
 };
 
+/// Append-only log of (index, bucket) pairs that grows without a lock.
+/// Writers reserve a slot with a fetch_add and publish it by storing the bucket
+/// pointer. Slots live in segments of doubling size, so a published slot never
+/// moves and readers can walk the log while it grows.
+template <typename Index, typename Bucket>
+class ObimDirectory {
+  static constexpr unsigned kFirstSegmentBits = 6;
+  static constexpr unsigned kNumSegments = 32;
+
+  struct Slot {
+    Index index;
+    std::atomic<Bucket*> bucket{nullptr};
+  };
+
+  std::array<std::atomic<Slot*>, kNumSegments> segments_{};
+  std::atomic<size_t> size_{0};
+
+  static size_t SegmentSize(unsigned seg) {
+    return size_t{1} << (seg + kFirstSegmentBits);
+  }
+
+  static std::pair<unsigned, size_t> Locate(size_t pos) {
+    size_t biased = pos + SegmentSize(0);
+    unsigned seg = 63 - __builtin_clzll(biased) - kFirstSegmentBits;
+    return std::make_pair(seg, biased - SegmentSize(seg));
+  }
+
+  Slot* GetOrCreateSegment(unsigned seg) {
+    Slot* s = segments_[seg].load(std::memory_order_acquire);
+    if (s) {
+      return s;
+    }
+    Slot* fresh = new Slot[SegmentSize(seg)];
+    if (segments_[seg].compare_exchange_strong(
+            s, fresh, std::memory_order_acq_rel)) {
+      return fresh;
+    }
+    delete[] fresh;
+    return s;
+  }
+
+public:
+  ObimDirectory() = default;
+  ObimDirectory(const ObimDirectory&) = delete;
+  ObimDirectory& operator=(const ObimDirectory&) = delete;
+
+  ~ObimDirectory() {
+    for (auto& seg : segments_) {
+      delete[] seg.load(std::memory_order_relaxed);
+    }
+  }
+
+  /// Number of reserved slots; slots below this may not be published yet
+  size_t size() const { return size_.load(std::memory_order_acquire); }
+
+  /// Add an entry and return its position in the log
+  size_t Append(Index index, Bucket* bucket) {
+    size_t pos = size_.fetch_add(1, std::memory_order_acq_rel);
+    auto [seg, offset] = Locate(pos);
+    KATANA_LOG_ASSERT(seg < kNumSegments);
+    Slot& slot = GetOrCreateSegment(seg)[offset];
+    slot.index = index;
+    slot.bucket.store(bucket, std::memory_order_release);
+    return pos;
+  }
+
+  /// Return the bucket at pos, or nullptr if its writer has not published it
+  Bucket* Get(size_t pos, Index* index) const {
+    auto [seg, offset] = Locate(pos);
+    Slot* s = segments_[seg].load(std::memory_order_acquire);
+    if (!s) {
+      return nullptr;
+    }
+    Bucket* bucket = s[offset].bucket.load(std::memory_order_acquire);
+    if (bucket) {
+      *index = s[offset].index;
+    }
+    return bucket;
+  }
+};
+
 }  // namespace internal
 
 /**
@@ -283,7 +368,7 @@ private:
     if (BSP && !UseMonotonic) {
       msS = p.scanStart;
       if (localLeader) {
-        for (unsigned i = 0; i < activeThreads; ++i) {
+        for (unsigned i = 0, num = getActiveThreads(); i < num; ++i) {
           Index o = data.getRemote(i)->scanStart;
           if (this->compare(o, msS))
             msS = o;
@@ -443,7 +528,7 @@ public:
     Index curIndex = (hasWork) ? p.curIndex : this->identity;
     CTy* C = (hasWork) ? p.current : nullptr;
 
-    for (unsigned i = 0; i < activeThreads; ++i) {
+    for (unsigned i = 0, num = getActiveThreads(); i < num; ++i) {
       ThreadData& o = *data.getRemote(i);
       if (o.hasWork && this->compare(o.curIndex, curIndex)) {
         curIndex = o.curIndex;
@@ -471,6 +556,346 @@ public:
 };
 KATANA_WLCOMPILECHECK(OrderedByIntegerMetric)
 
+/**
+ * Approximate priority scheduling for many threads and sockets. Works like
+ * {@link OrderedByIntegerMetric} but
+ *
+ * - the directory of priority levels is an append-only log that threads add
+ *   to without taking a lock,
+ * - each priority level has one Container per socket; threads push to the
+ *   queue of their own socket, and
+ * - when the queue of its socket runs dry, a thread compares the earliest
+ *   level of its socket with that of a random other socket and pops from the
+ *   earlier one (as in a MultiQueue). If both are empty, it tries every
+ *   socket before giving up.
+ *
+ * Priorities are therefore only followed approximately across sockets, in
+ * exchange for no shared lock and mostly socket-local memory traffic. Use
+ * {@link OrderedByIntegerMetric} if a barrier between levels is needed.
+ *
+ * @tparam Indexer        Indexer class
+ * @tparam Container      Scheduler for each bucket of each socket
+ * @tparam BlockPeriod    Check for higher priority work every 2^BlockPeriod
+ *                        iterations
+ * @tparam UseDescending  Use descending order instead
+ */
+template <
+    class Indexer = DummyIndexer<int>, typename Container = ChunkFIFO<>,
+    unsigned BlockPeriod = 0, typename T = int, typename Index = int,
+    bool UseDescending = false, bool Concurrent = true>
+struct PerSocketOrderedByIntegerMetric
+    : private boost::noncopyable,
+      public internal::OrderedByIntegerMetricComparator<Index, UseDescending> {
+  template <typename _T>
+  using retype = PerSocketOrderedByIntegerMetric<
+      Indexer, typename Container::template retype<_T>, BlockPeriod, _T,
+      typename std::result_of<Indexer(_T)>::type, UseDescending, Concurrent>;
+
+  template <bool _b>
+  using rethread = PerSocketOrderedByIntegerMetric<
+      Indexer, Container, BlockPeriod, T, Index, UseDescending, _b>;
+
+  template <unsigned _period>
+  struct with_block_period {
+    typedef PerSocketOrderedByIntegerMetric<
+        Indexer, Container, _period, T, Index, UseDescending, Concurrent>
+        type;
+  };
+
+  template <typename _container>
+  struct with_container {
+    typedef PerSocketOrderedByIntegerMetric<
+        Indexer, _container, BlockPeriod, T, Index, UseDescending, Concurrent>
+        type;
+  };
+
+  template <typename _indexer>
+  struct with_indexer {
+    typedef PerSocketOrderedByIntegerMetric<
+        _indexer, Container, BlockPeriod, T, Index, UseDescending, Concurrent>
+        type;
+  };
+
+  template <bool _use_descending>
+  struct with_descending {
+    typedef PerSocketOrderedByIntegerMetric<
+        Indexer, Container, BlockPeriod, T, Index, _use_descending, Concurrent>
+        type;
+  };
+
+  typedef T value_type;
+  typedef Index index_type;
+
+private:
+  typedef typename Container::template rethread<Concurrent> CTy;
+  typedef internal::OrderedByIntegerMetricComparator<Index, UseDescending>
+      Comparator;
+  // A bucket is an array with one CTy per socket
+  typedef typename Comparator::template with_local_map<CTy*>::type LMapTy;
+  typedef internal::ObimDirectory<Index, CTy> Directory;
+
+  struct ThreadData {
+    LMapTy local;
+    Index curIndex;
+    Index scanStart;
+    // Containers of other sockets may hold items in a private chunk of this
+    // thread at this level or later
+    Index remoteStart;
+    CTy* current;
+    // Whether current belongs to the socket of this thread
+    bool currentIsLocal;
+    size_t lastMasterVersion;
+    unsigned int numPops;
+    uint64_t rand;
+
+    ThreadData(Index initial, Index none)
+        : curIndex(initial),
+          scanStart(initial),
+          remoteStart(none),
+          current(nullptr),
+          currentIsLocal(false),
+          lastMasterVersion(0),
+          numPops(0),
+          rand(reinterpret_cast<uintptr_t>(this) | 1) {}
+
+    unsigned nextRandom() {
+      // xorshift64
+      rand ^= rand << 13;
+      rand ^= rand >> 7;
+      rand ^= rand << 17;
+      return rand;
+    }
+  };
+
+  struct SocketData {
+    // No thread of the socket has work before this level; lowered by pushes
+    // and recomputed by the socket leader
+    std::atomic<Index> earliest;
+
+    SocketData(Index initial) : earliest(initial) {}
+  };
+
+  PerThreadStorage<ThreadData> data;
+  PerSocketStorage<SocketData> sockets;
+  unsigned numSockets;
+  Directory masterLog;
+  Indexer indexer;
+
+  /// Read new directory entries. When an index appears more than once
+  /// because two threads created it at the same time, the first entry wins
+  /// everywhere.
+  bool updateLocal(ThreadData& p) {
+    size_t end = masterLog.size();
+    if (p.lastMasterVersion == end) {
+      return false;
+    }
+    for (; p.lastMasterVersion < end; ++p.lastMasterVersion) {
+      Index index;
+      CTy* bucket = masterLog.Get(p.lastMasterVersion, &index);
+      if (!bucket) {
+        // Being published; pick it up next time
+        break;
+      }
+      p.local.emplace(index, bucket);
+    }
+    return true;
+  }
+
+  void lowerEarliest(SocketData& s, Index index) {
+    Index cur = s.earliest.load(std::memory_order_relaxed);
+    while (this->compare(index, cur) &&
+           !s.earliest.compare_exchange_weak(
+               cur, index, std::memory_order_relaxed)) {
+    }
+  }
+
+  void refreshEarliest(SocketData& s) {
+    auto& tp = GetThreadPool();
+    unsigned socket = ThreadPool::getSocket();
+    Index msS = this->identity;
+    for (unsigned i = 0, num = getActiveThreads(); i < num; ++i) {
+      if (tp.getSocket(i) != socket) {
+        continue;
+      }
+      Index o = data.getRemote(i)->scanStart;
+      if (this->compare(o, msS)) {
+        msS = o;
+      }
+    }
+    s.earliest.store(msS, std::memory_order_relaxed);
+  }
+
+  /// Where to start looking for work in the containers of another socket
+  Index remoteStart(ThreadData& p, unsigned socket) {
+    Index start = sockets.getRemoteByPkg(socket)->earliest.load(
+        std::memory_order_relaxed);
+    return this->compare(p.remoteStart, start) ? p.remoteStart : start;
+  }
+
+  std::optional<T> popFrom(ThreadData& p, unsigned socket, Index start) {
+    bool isLocal = socket == ThreadPool::getSocket();
+    for (auto ii = p.local.lower_bound(start), ei = p.local.end(); ii != ei;
+         ++ii) {
+      std::optional<T> item;
+      if ((item = ii->second[socket].pop())) {
+        p.current = &ii->second[socket];
+        p.currentIsLocal = isLocal;
+        p.curIndex = ii->first;
+        if (isLocal) {
+          p.scanStart = ii->first;
+        } else if (this->compare(ii->first, p.remoteStart)) {
+          p.remoteStart = ii->first;
+        }
+        return item;
+      }
+    }
+    return std::nullopt;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  std::optional<T> slowPop(ThreadData& p) {
+    updateLocal(p);
+
+    unsigned mine = ThreadPool::getSocket();
+    SocketData& local = *sockets.getLocal();
+    if (ThreadPool::isLeader()) {
+      refreshEarliest(local);
+    }
+
+    // Own items may still be in a private chunk, so always scan from our
+    // own scanStart on our socket
+    Index localStart = local.earliest.load(std::memory_order_relaxed);
+    if (this->compare(p.scanStart, localStart)) {
+      localStart = p.scanStart;
+    }
+
+    std::optional<T> item;
+    if (numSockets == 1) {
+      return popFrom(p, mine, localStart);
+    }
+
+    unsigned victim = p.nextRandom() % (numSockets - 1);
+    if (victim >= mine) {
+      ++victim;
+    }
+    Index victimStart = remoteStart(p, victim);
+
+    if (this->compare(victimStart, localStart)) {
+      if ((item = popFrom(p, victim, victimStart))) {
+        return item;
+      }
+    }
+    if ((item = popFrom(p, mine, localStart))) {
+      return item;
+    }
+
+    for (unsigned i = 1; i < numSockets; ++i) {
+      unsigned s = (mine + i) % numSockets;
+      if ((item = popFrom(p, s, remoteStart(p, s)))) {
+        return item;
+      }
+    }
+    // Nothing left anywhere, including in chunks this thread took from
+    // other sockets
+    p.remoteStart = this->identity;
+    return std::nullopt;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  CTy* slowUpdateLocalOrCreate(ThreadData& p, Index i) {
+    updateLocal(p);
+    auto it = p.local.find(i);
+    if (it != p.local.end()) {
+      return it->second;
+    }
+
+    CTy* bucket = new CTy[numSockets];
+    size_t pos = masterLog.Append(i, bucket);
+    // Another thread may have added i concurrently; whichever entry comes
+    // first in the log is the one everybody uses. Entries before ours are
+    // reserved, so their writers are about to publish them.
+    while (p.lastMasterVersion <= pos) {
+      updateLocal(p);
+    }
+    return p.local.find(i)->second;
+  }
+
+  inline CTy* updateLocalOrCreate(ThreadData& p, Index i) {
+    auto it = p.local.find(i);
+    if (it != p.local.end())
+      return it->second;
+    return slowUpdateLocalOrCreate(p, i);
+  }
+
+public:
+  PerSocketOrderedByIntegerMetric(const Indexer& x = Indexer())
+      : data(this->earliest, this->identity),
+        sockets(this->earliest),
+        numSockets(
+            GetThreadPool().getCumulativeMaxSocket(getActiveThreads() - 1) + 1),
+        indexer(x) {}
+
+  ~PerSocketOrderedByIntegerMetric() {
+    // Deallocate in LIFO order to give opportunity for simple garbage
+    // collection
+    for (size_t pos = masterLog.size(); pos > 0; --pos) {
+      Index index;
+      delete[] masterLog.Get(pos - 1, &index);
+    }
+  }
+
+  void push(const value_type& val) {
+    Index index = indexer(val);
+    ThreadData& p = *data.getLocal();
+
+    // Fast path
+    if (index == p.curIndex && p.current && p.currentIsLocal) {
+      p.current->push(val);
+      return;
+    }
+
+    // Slow path
+    CTy* C = &updateLocalOrCreate(p, index)[ThreadPool::getSocket()];
+    if (this->compare(index, p.scanStart)) {
+      p.scanStart = index;
+      lowerEarliest(*sockets.getLocal(), index);
+    }
+    // Opportunistically move to higher priority work
+    if (this->compare(index, p.curIndex)) {
+      p.curIndex = index;
+      p.current = C;
+      p.currentIsLocal = true;
+    }
+    C->push(val);
+  }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    while (b != e)
+      push(*b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  std::optional<value_type> pop() {
+    ThreadData& p = *data.getLocal();
+    CTy* C = p.current;
+
+    if (BlockPeriod && ((p.numPops++ & ((1 << BlockPeriod) - 1)) == 0))
+      return slowPop(p);
+
+    std::optional<value_type> item;
+    if (C && (item = C->pop()))
+      return item;
+
+    return slowPop(p);
+  }
+};
+KATANA_WLCOMPILECHECK(PerSocketOrderedByIntegerMetric)
+
 }  // end namespace katana
 
 #endif
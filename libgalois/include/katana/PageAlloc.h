@@ -26,11 +26,55 @@
 
 namespace katana {
 
+// Pages that can back an allocation from allocPages, from smallest to largest.
+//
+// allocPages tries 1GB pages (kGigantic) for allocations of at least
+// KATANA_GIGANTIC_PAGES_MIN_GB gigabytes, if that variable is set, then
+// reserved 2MB pages (kHuge), then transparent huge pages (kTransparentHuge)
+// and finally regular pages (kSmall). Set KATANA_HUGE_PAGES to "thp" to skip
+// the reserved 2MB pages or to "none" to only use regular pages.
+enum class PageKind { kSmall, kTransparentHuge, kHuge, kGigantic };
+
+// size of a page of the given kind; for kTransparentHuge, the size of the
+// huge pages the kernel may use, the region may still be partly on regular
+// pages
+KATANA_EXPORT size_t pageKindSize(PageKind kind);
+
+KATANA_EXPORT const char* pageKindName(PageKind kind);
+
+// How allocPages picks pages. The default is read from KATANA_HUGE_PAGES and
+// KATANA_GIGANTIC_PAGES_MIN_GB.
+struct PageAllocConfig {
+  // use reserved 2MB pages when available
+  bool huge_tlb{true};
+  // madvise regions that do not get reserved pages for transparent huge pages
+  bool transparent{true};
+  // allocations of at least this many bytes try 1GB pages; 0 disables them
+  size_t gigantic_min_bytes{0};
+};
+
+KATANA_EXPORT PageAllocConfig getPageAllocConfig();
+
+// replace the page configuration, e.g., to test each kind of pages; must not
+// be called while pages are being allocated or freed
+KATANA_EXPORT void setPageAllocConfig(const PageAllocConfig& config);
+
 // size of pages
 KATANA_EXPORT size_t allocSize();
 
-// allocate contiguous pages, optionally faulting them in
-KATANA_EXPORT void* allocPages(unsigned num, bool preFault);
+// multiple of allocSize() to round an allocation of bytes up to so that it
+// can use the largest pages enabled for its size
+KATANA_EXPORT size_t allocSizeFor(size_t bytes);
+
+// allocate contiguous pages, optionally faulting them in; if kind is not null,
+// it is set to the kind of pages backing the allocation
+KATANA_EXPORT void* allocPages(
+    unsigned num, bool preFault, PageKind* kind = nullptr);
+
+// allocate contiguous 1GB pages like allocPages, but return null instead of
+// falling back to smaller pages if 1GB pages are not enabled for the size or
+// the kernel has too few of them
+KATANA_EXPORT void* allocGiganticPages(unsigned num, bool preFault);
 
 // free page range
 KATANA_EXPORT void freePages(void* ptr, unsigned num);
@@ -27,6 +27,7 @@
 #include "katana/NoDerefIterator.h"
 #include "katana/Range.h"
 #include "katana/Reduction.h"
+#include "katana/ThreadPool.h"
 #include "katana/Threads.h"
 #include "katana/Traits.h"
 #include "katana/UserContext.h"
@@ -334,6 +335,7 @@ partial_sum(InputIt first, InputIt last, OutputIt d_first) {
 
   // only bother with parallel execution if vector is larger than some size
   if (sizeOfVector >= 1024) {
+    ThreadPool::StartGuard start_guard;
     const size_t numBlocks = katana::getActiveThreads();
     const size_t blockSize = (sizeOfVector + numBlocks - 1) / numBlocks;
     KATANA_LOG_DEBUG_ASSERT(numBlocks * blockSize >= sizeOfVector);
@@ -496,6 +498,7 @@ copy_if(InputIt first, InputIt last, OutputIt d_first, UnaryPredicate pred) {
   using diff_type = typename std::iterator_traits<InputIt>::difference_type;
 
   // first on_each, set ranges
+  ThreadPool::StartGuard start_guard;
   uint32_t num_threads = getActiveThreads();
   std::vector<diff_type> prefix_sum(num_threads);
   on_each([&](unsigned tid, unsigned total) {
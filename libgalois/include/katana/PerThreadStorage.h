@@ -71,11 +71,16 @@ public:
 
   unsigned allocOffset(unsigned size);
   void deallocOffset(unsigned offset, unsigned size);
+  //! thread is relative to the calling thread's sub-pool, if any
   void* getRemote(unsigned thread, unsigned offset);
+  //! Like getRemote but thread is an id in the whole pool
+  void* getRemoteByPoolID(unsigned pool_id, unsigned offset);
   void* getLocal(unsigned offset, char* base) { return &base[offset]; }
   // faster when (1) you already know the id and (2) shared access to heads is
   // not to expensive; otherwise use getLocal(unsigned,char*)
-  void* getLocal(unsigned offset, unsigned id) { return &heads[id][offset]; }
+  void* getLocal(unsigned offset, unsigned id) {
+    return &heads[ThreadPool::getRegionBase() + id][offset];
+  }
 };
 
 extern thread_local char* ptsBase;
@@ -96,8 +101,8 @@ class PerThreadStorage {
       return;
     }
 
-    for (unsigned n = 0; n < GetThreadPool().getMaxThreads(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(n, offset))->~T();
+    for (unsigned n = 0; n < GetThreadPool().getPoolThreads(); ++n) {
+      reinterpret_cast<T*>(b->getRemoteByPoolID(n, offset))->~T();
     }
     b->deallocOffset(offset, sizeof(T));
     offset = ~0U;
@@ -145,8 +150,8 @@ public:
     auto& tp = GetThreadPool();
 
     offset = b->allocOffset(sizeof(T));
-    for (unsigned n = 0; n < tp.getMaxThreads(); ++n) {
-      new (b->getRemote(n, offset)) T(std::forward<Args>(args)...);
+    for (unsigned n = 0; n < tp.getPoolThreads(); ++n) {
+      new (b->getRemoteByPoolID(n, offset)) T(std::forward<Args>(args)...);
     }
   }
 
@@ -216,9 +221,10 @@ class PerSocketStorage {
 
   void destruct() {
     auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(tp.getLeaderForSocket(n), offset))
-          ->~T();
+    for (unsigned n = 0; n < tp.getPoolThreads(); ++n) {
+      if (tp.isPoolLeader(n)) {
+        reinterpret_cast<T*>(b->getRemoteByPoolID(n, offset))->~T();
+      }
     }
     b->deallocOffset(offset, sizeof(T));
   }
@@ -234,9 +240,10 @@ public:
 
     offset = b->allocOffset(sizeof(T));
     auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      new (b->getRemote(tp.getLeaderForSocket(n), offset))
-          T(std::forward<Args>(args)...);
+    for (unsigned n = 0; n < tp.getPoolThreads(); ++n) {
+      if (tp.isPoolLeader(n)) {
+        new (b->getRemoteByPoolID(n, offset)) T(std::forward<Args>(args)...);
+      }
     }
   }
 
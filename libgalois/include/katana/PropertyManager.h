@@ -1,11 +1,16 @@
 #pragma once
 
 #include <cstdint>
+#include <list>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "katana/Cache.h"
 #include "katana/Manager.h"
+#include "katana/Result.h"
 #include "katana/Time.h"
+#include "katana/URI.h"
 
 namespace katana {
 
@@ -21,18 +26,37 @@ public:
   count_t FreeStandbyMemory(count_t goal) override;
 
   /// Client wants a property, see if we have it in the cache and if so return it and
-  /// make the memory active.
-  /// Returns nullptr if manager does not have it in the cache
+  /// make the memory active. Otherwise, if the property was spilled, map it back
+  /// from the spill file.
+  /// Returns nullptr if manager does not have it in the cache or spilled
   std::shared_ptr<arrow::Table> GetProperty(const katana::URI& property_path);
 
-  /// The property data has come into memory from storage.
-  void PropertyLoadedActive(const std::shared_ptr<arrow::Table>& property);
+  /// The property data for \p property_path has come into memory from
+  /// storage.
+  void PropertyLoadedActive(
+      const katana::URI& property_path,
+      const std::shared_ptr<arrow::Table>& property);
 
-  /// We are done with the property.  Put it in the cache if we have room.
+  /// We are done with the property.  Put it in the cache if the cache admits
+  /// it within the standby budget of the MemorySupervisor, otherwise spill or
+  /// drop it.
   void PutProperty(
       const katana::URI& property_path,
       const std::shared_ptr<arrow::Table>& property);
 
+  /// Rather than dropping properties reclaimed from the cache, write them to
+  /// \p dir in Arrow IPC format, keeping at most \p max_bytes there (the
+  /// oldest files are deleted first). Spilled properties are memory mapped
+  /// when they are next needed, so their pages can be dropped and read back
+  /// by the kernel instead of the process running out of memory.
+  ///
+  /// Spilling is enabled at startup if KATANA_PROPERTY_SPILL_DIR is set.
+  katana::Result<void> EnableSpilling(
+      const std::string& dir, count_t max_bytes = kDefaultMaxSpillBytes);
+  /// Stop spilling and delete the spill files. Mapped properties stay valid.
+  void DisableSpilling();
+  bool IsSpilling() const;
+
   CacheStats GetPropertyCacheStats() const { return cache_->GetStats(); }
   void LogMemoryStats(const std::string& message);
   struct Stats {
@@ -42,16 +66,50 @@ public:
           {
               {"bytes_loaded", bytes_loaded},
               {"gb_loaded", katana::ToGB(bytes_loaded)},
+              {"bytes_spilled", bytes_spilled},
+              {"spill_count", spill_count},
+              {"bytes_unspilled", bytes_unspilled},
+              {"unspill_count", unspill_count},
           });
     }
     count_t bytes_loaded{0LL};
+    count_t bytes_spilled{0LL};
+    count_t spill_count{0LL};
+    count_t bytes_unspilled{0LL};
+    count_t unspill_count{0LL};
   };
-  Stats GetStats() const { return stats; }
+  Stats GetStats() const;
+
+  static constexpr count_t kDefaultMaxSpillBytes = 64LL << 30;  // 64 GB
 
 private:
+  struct SpillFile {
+    std::string path;
+    count_t bytes{0};
+    // The file is being written outside of mutex_ and may not be mapped yet
+    bool writing{false};
+  };
+
   void MakePropertyCache();
+  void SpillProperty(
+      const katana::URI& property_path,
+      const std::shared_ptr<arrow::Table>& property);
+  std::shared_ptr<arrow::Table> UnspillProperty(
+      const katana::URI& property_path);
+  void RemoveSpillFile(const katana::URI& property_path);
+
   std::unique_ptr<PropertyCache> cache_;
   Stats stats;
+
+  // Guards stats and the spill state below. Spill files are written and
+  // mapped without holding it.
+  mutable std::mutex mutex_;
+  std::string spill_dir_;
+  count_t max_spill_bytes_{0};
+  count_t spill_bytes_{0};
+  std::unordered_map<katana::URI, SpillFile, katana::URI::Hash> spilled_;
+  // oldest first
+  std::list<katana::URI> spill_order_;
 };
 
 }  // namespace katana
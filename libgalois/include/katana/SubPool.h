@@ -0,0 +1,83 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SUBPOOL_H_
+#define KATANA_LIBGALOIS_KATANA_SUBPOOL_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "katana/Barrier.h"
+#include "katana/Result.h"
+#include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A SubPool leases a contiguous range of threads from the thread pool so
+/// that a client can run parallel loops on them while other clients run
+/// loops on other sub-pools or on the rest of the pool.
+///
+/// Code passed to Run sees the sub-pool as if it were the whole pool: thread
+/// ids, sockets, getActiveThreads() and setActiveThreads() are relative to
+/// the sub-pool, and loops use a barrier and termination detection of their
+/// own. A sub-pool starts with all of its threads active.
+///
+///   auto sub_pool = KATANA_CHECKED(katana::SubPool::Make(4));
+///   sub_pool->Run([&]() {
+///     katana::do_all(katana::iterate(nodes), ...);
+///   });
+///
+/// Sub-pools take the highest free threads of the pool, so the threads left
+/// to loops outside of sub-pools are 0 to the lowest leased thread. While
+/// threads are leased, getActiveThreads() outside of sub-pools returns at
+/// most the number of threads left, and it returns the number set by
+/// setActiveThreads() again once they are released.
+///
+/// Make and the destructor wait until no thread outside of sub-pools holds
+/// a ThreadPool::StartGuard. Loops hold one from before they read
+/// getActiveThreads() until they finish, so the threads of a loop do not
+/// change while it runs. Code that sizes per-thread data with
+/// getActiveThreads() before running a loop should hold one across both.
+/// Sub-pools must not be made or destroyed while the calling thread holds
+/// one, e.g. from inside a loop outside of sub-pools.
+class KATANA_EXPORT SubPool {
+public:
+  /// Lease num_threads threads. Fails if the pool does not have that many
+  /// contiguous free threads, not counting thread 0.
+  static Result<std::unique_ptr<SubPool>> Make(unsigned num_threads);
+
+  ~SubPool();
+
+  SubPool(const SubPool&) = delete;
+  SubPool& operator=(const SubPool&) = delete;
+  SubPool(SubPool&&) = delete;
+  SubPool& operator=(SubPool&&) = delete;
+
+  /// Run fn on the first thread of the sub-pool and wait for it to finish.
+  /// Exceptions thrown by fn are rethrown here. Only one thread may call
+  /// Run on a sub-pool at a time.
+  void Run(const std::function<void()>& fn);
+
+  /// Number of threads in the sub-pool
+  unsigned size() const;
+
+private:
+  friend unsigned int setActiveThreads(unsigned int) noexcept;
+  friend unsigned int getActiveThreads() noexcept;
+  friend Barrier& GetBarrier(unsigned);
+  friend TerminationDetection& GetTerminationDetection(unsigned);
+
+  SubPool() = default;
+
+  std::unique_ptr<ThreadPool::Region> region_;
+  unsigned active_threads_{1};
+  std::unique_ptr<Barrier> barrier_;
+  unsigned barrier_threads_{0};
+  std::unique_ptr<TerminationDetection> term_;
+  std::atomic<bool> running_{false};
+};
+
+}  // namespace katana
+
+#endif
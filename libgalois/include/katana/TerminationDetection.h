@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_TERMINATIONDETECTION_H_
 
 #include <atomic>
+#include <memory>
 
 #include "katana/CacheLineStorage.h"
 #include "katana/PerThreadStorage.h"
@@ -32,7 +33,8 @@ class TerminationDetection;
 
 /*
  * Returns the termination detection instance. The instance will be reused, but
- * reinitialized to activeThreads.
+ * reinitialized to activeThreads. Inside of a SubPool, this returns the
+ * instance of the sub-pool.
  */
 KATANA_EXPORT TerminationDetection& GetTerminationDetection(
     unsigned active_threads);
@@ -110,6 +112,10 @@ public:
 
 namespace internal {
 void SetTerminationDetection(TerminationDetection* term);
+
+/// Create an instance of the termination detection used by the runtime, for
+/// a SubPool
+std::unique_ptr<TerminationDetection> CreateTerminationDetection();
 }  // end namespace internal
 
 }  // end namespace katana
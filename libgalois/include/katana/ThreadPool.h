@@ -23,8 +23,12 @@
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <vector>
 
@@ -51,9 +55,12 @@ struct ExecuteTupleImpl<tpl, s, 0> {
 
 namespace katana {
 
+class SubPool;
+
 class KATANA_EXPORT ThreadPool {
 private:
   friend class GaloisRuntime;
+  friend class SubPool;
 
   struct shutdown_ty {};  //! type for shutting down thread
   struct fastmode_ty {
@@ -63,39 +70,85 @@ private:
     std::function<void(void)> fn;
   };  //! type to switch to dedicated mode
 
+  //! A reference to the callable of the current run. Unlike std::function,
+  //! it never allocates and costs one indirect call.
+  struct WorkRef {
+    void (*fn)(void*) = nullptr;
+    void* ctx = nullptr;
+
+    void operator()() const { fn(ctx); }
+    explicit operator bool() const { return fn; }
+
+    template <typename F>
+    static WorkRef of(F& f) {
+      return WorkRef{[](void* c) { (*static_cast<F*>(c))(); }, &f};
+    }
+  };
+
+  //! A contiguous range of pool threads that runs parallel sections
+  //! independently of the rest of the pool. Threads, sockets and numa nodes
+  //! are numbered from 0 within a region, so code running in a region sees
+  //! a pool of mi.maxThreads threads. The whole pool is itself a region.
+  struct Region {
+    //! Pool id of the first thread
+    unsigned base{0};
+    MachineTopoInfo mi{};
+    //! Indexed by thread id within the region
+    std::vector<ThreadTopoInfo> topo;
+    //! Null for the whole pool
+    SubPool* owner{nullptr};
+
+    //! State of the current run
+    bool running{false};
+    unsigned fastmode{0};
+    WorkRef work;
+    //! Start of the current run, for wakeup latencies
+    std::atomic<uint64_t> runStartNs{0};
+    uint64_t runs{0};
+    uint64_t joinNs{0};
+  };
+
   //! Per-thread mailboxes for notification
   struct per_signal {
+#if !defined(__linux__)
     std::condition_variable cv;
     std::mutex m;
+#endif
     unsigned wbegin, wend;
     std::atomic<int> done;
     std::atomic<int> fastRelease;
+    //! Bumped by each wakeup; a parked thread sleeps until it changes
+    std::atomic<uint32_t> wakeSeq{0};
+    std::atomic<int> parked{0};
+    //! Last value of wakeSeq seen by the owner
+    uint32_t seenSeq{0};
+    //! Iterations to spin before parking, adapted to observed wait times
+    unsigned spinLimit{0};
+    //! Written by the owner only; read while the pool is idle
+    uint64_t wakeups{0};
+    uint64_t parkedWakeups{0};
+    uint64_t wakeNs{0};
+    uint64_t maxWakeNs{0};
+    //! Identity within the current region
     ThreadTopoInfo topo;
-
-    void wakeup(bool fastmode) {
-      if (fastmode) {
-        done = 0;
-        fastRelease = 1;
-      } else {
-        std::lock_guard<std::mutex> lg(m);
-        done = 0;
-        cv.notify_one();
-        // start.release();
-      }
-    }
-
-    void wait(bool fastmode) {
-      if (fastmode) {
-        while (!fastRelease.load(std::memory_order_relaxed)) {
-          asmPause();
-        }
-        fastRelease = 0;
-      } else {
-        std::unique_lock<std::mutex> lg(m);
-        cv.wait(lg, [=] { return !done; });
-        // start.acquire();
-      }
-    }
+    //! Id within the whole pool
+    unsigned poolID{0};
+    //! Region of the current run and the pool id of its first thread
+    Region* region{nullptr};
+    unsigned regionBase{0};
+    //! Number of StartGuards held by this thread
+    unsigned startDepth{0};
+    //! Set when this thread is woken to be the master of its region: the
+    //! work to run and the mailbox to wake once it is done
+    WorkRef job;
+    per_signal* caller{nullptr};
+
+    void wakeup(bool fastmode);
+    void wait(bool fastmode);
+    //! Set done after a job and wake the thread in waitJob
+    void finishJob();
+    //! Wait for the job of this thread to finish
+    void waitJob();
   };
 
   thread_local static per_signal my_box;
@@ -104,9 +157,17 @@ private:
   std::vector<per_signal*> signals;
   std::vector<std::thread> threads;
   unsigned reserved;
-  unsigned masterFastmode;
-  bool running;
-  std::function<void(void)> work;
+  //! The whole pool; my_box.region of threads outside of any sub-pool
+  Region whole;
+
+  //! Serializes leasing and releasing sub-pool regions
+  std::mutex regionLock;
+  //! Pool threads owned by sub-pool regions
+  std::vector<bool> leased;
+  //! Runs of the whole pool may use threads [0, wholeLimit)
+  std::atomic<unsigned> wholeLimit;
+  //! Held shared by StartGuards and exclusively while wholeLimit changes
+  std::shared_mutex wholeStartLock;
 
   //! destroy all threads
   void destroyCommon();
@@ -124,11 +185,49 @@ private:
   void decascade();
 
   //! execute work on num threads
-  void runInternal(unsigned num);
+  void runInternal(unsigned num, WorkRef work);
+
+  //! Region of the calling thread
+  Region& region() { return my_box.region ? *my_box.region : whole; }
+  const Region& region() const {
+    return my_box.region ? *my_box.region : whole;
+  }
+
+  //! Take num free threads out of the whole pool into a new region owned
+  //! by owner. Returns null if there are not num contiguous free threads.
+  std::unique_ptr<Region> leaseRegion(unsigned num, SubPool* owner);
+
+  //! Return the threads of a region to the whole pool
+  void releaseRegion(std::unique_ptr<Region> r);
+
+  //! Run job on the first thread of r, which becomes the master of r's
+  //! parallel sections. Returns once job has finished.
+  void runRegionMaster(Region& r, WorkRef job);
 
   ThreadPool();
 
 public:
+  //! Keeps sub-pools from taking threads of the whole pool while it is
+  //! held, so that code outside of sub-pools can read getActiveThreads(),
+  //! size per-thread data with it and run loops on that many threads. Loops
+  //! hold one from before they read the thread count until they finish.
+  //! Does nothing in sub-pools and in the threads of a running loop.
+  class KATANA_EXPORT StartGuard {
+  public:
+    StartGuard();
+    ~StartGuard();
+
+    StartGuard(const StartGuard&) = delete;
+    StartGuard& operator=(const StartGuard&) = delete;
+
+  private:
+    friend class ThreadPool;
+    explicit StartGuard(ThreadPool& pool);
+
+    //! Null in sub-pools and in the threads of a running loop
+    ThreadPool* pool_{nullptr};
+  };
+
   ~ThreadPool();
 
   ThreadPool(const ThreadPool&) = delete;
@@ -152,32 +251,52 @@ public:
       }
       ExecuteTuple(Args&&... args) : cmds(std::forward<Args>(args)...) {}
     };
-    // paying for an indirection in work allows small-object optimization in
-    // std::function to kick in and avoid a heap allocation
     ExecuteTuple lwork(std::forward<Args>(args)...);
-    work = std::ref(lwork);
-    // work =
-    // std::function<void(void)>(ExecuteTuple(std::forward<Args>(args)...));
     KATANA_LOG_DEBUG_ASSERT(num <= getMaxThreads());
-    runInternal(num);
+    runInternal(num, WorkRef::of(lwork));
   }
 
   //! run function in a dedicated thread until the threadpool exits
   void runDedicated(std::function<void(void)>& f);
 
+  //! Wakeup and join latencies of parallel runs
+  struct LatencyStats {
+    //! Number of runs
+    uint64_t runs;
+    //! Number of times a worker was woken up for a run
+    uint64_t wakeups;
+    //! Wakeups that found the worker parked in the kernel rather than
+    //! spinning
+    uint64_t parkedWakeups;
+    //! Total and largest time from the start of a run until a worker begins
+    //! its share
+    uint64_t wakeNs;
+    uint64_t maxWakeNs;
+    //! Total time the calling thread waited for workers at the end of runs
+    uint64_t joinNs;
+  };
+
+  //! Stats of the calling thread's region. Must not be called during a run.
+  LatencyStats getLatencyStats() const;
+  void resetLatencyStats();
+
   // experimental: busy wait for work
   void burnPower(unsigned num);
   // experimental: leave busy wait
   void beKind();
 
-  //! return the number of non-reserved threads in the pool
-  unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
+  // Thread counts, ids and topology below are those of the calling thread's
+  // sub-pool when it runs in one
+
+  //! return the number of non-reserved threads in the pool, not counting
+  //! threads leased to sub-pools
+  unsigned getMaxUsableThreads() const;
   //! return the number of threads supported by the thread pool on the current
   //! machine
-  unsigned getMaxThreads() const { return mi.maxThreads; }
-  unsigned getMaxCores() const { return mi.maxCores; }
-  unsigned getMaxSockets() const { return mi.maxSockets; }
-  unsigned getMaxNumaNodes() const { return mi.maxNumaNodes; }
+  unsigned getMaxThreads() const { return region().mi.maxThreads; }
+  unsigned getMaxCores() const { return region().mi.maxCores; }
+  unsigned getMaxSockets() const { return region().mi.maxSockets; }
+  unsigned getMaxNumaNodes() const { return region().mi.maxNumaNodes; }
 
   unsigned getLeaderForSocket(unsigned pid) const {
     for (unsigned i = 0; i < getMaxThreads(); ++i)
@@ -187,17 +306,24 @@ public:
   }
 
   bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
+    return region().topo[tid].socketLeader == tid;
   }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
+  unsigned getSocket(unsigned tid) const { return region().topo[tid].socket; }
   unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+    return region().topo[tid].socketLeader;
   }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
+    return region().topo[tid].cumulativeMaxSocket;
   }
   unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+    return region().topo[tid].numaNode;
+  }
+
+  //! Threads and socket leaders of the whole pool regardless of the calling
+  //! thread's sub-pool, for storage that every pool thread may use
+  unsigned getPoolThreads() const { return mi.maxThreads; }
+  bool isPoolLeader(unsigned pool_id) const {
+    return whole.topo[pool_id].socketLeader == pool_id;
   }
 
   static unsigned getTID() { return my_box.topo.tid; }
@@ -208,6 +334,14 @@ public:
     return my_box.topo.cumulativeMaxSocket;
   }
   static unsigned getNumaNode() { return my_box.topo.numaNode; }
+
+  //! Pool id of thread 0 of the calling thread's sub-pool; 0 outside of
+  //! sub-pools. The pool id of thread tid is getRegionBase() + tid.
+  static unsigned getRegionBase() { return my_box.regionBase; }
+  //! The sub-pool the calling thread runs in, or null outside of sub-pools
+  static SubPool* getSubPool() {
+    return my_box.region ? my_box.region->owner : nullptr;
+  }
 };
 
 /**
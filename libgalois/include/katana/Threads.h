@@ -29,11 +29,16 @@ namespace katana {
  * the actual value of threads used, which could be less than the requested
  * value. System behavior is undefined if this function is called during
  * parallel execution or after the first parallel execution.
+ *
+ * Inside of a SubPool, this sets the number of threads of that sub-pool
+ * only.
  */
 KATANA_EXPORT unsigned int setActiveThreads(unsigned int num) noexcept;
 
 /**
- * Returns the number of threads in use.
+ * Returns the number of threads in use, by the calling thread's SubPool if
+ * it runs in one. Outside of sub-pools, this is at most the number of
+ * threads that are not leased to a SubPool.
  */
 KATANA_EXPORT unsigned int getActiveThreads() noexcept;
 
@@ -31,15 +31,19 @@
 #include "katana/PerThreadChunk.h"
 #include "katana/Simple.h"
 #include "katana/StableIterator.h"
+#include "katana/WorkStealing.h"
 #include "katana/config.h"
 
 namespace katana {
 /**
  * Scheduling policies for Galois iterators. Unless you have very specific
  * scheduling requirement, \ref PerSocketChunkLIFO or \ref PerSocketChunkFIFO is
- * a reasonable scheduling policy. If you need approximate priority scheduling,
- * use \ref OrderedByIntegerMetric. For debugging, you may be interested in
- * \ref FIFO or \ref LIFO, which try to follow serial order exactly.
+ * a reasonable scheduling policy. For irregular work, \ref StealingChunkDeque
+ * balances load by stealing and sizes its chunks by task cost. If you need
+ * approximate priority scheduling, use \ref OrderedByIntegerMetric, or
+ * \ref PerSocketOrderedByIntegerMetric on machines with many threads. For
+ * debugging, you may be interested in \ref FIFO or \ref LIFO, which try to
+ * follow serial order exactly.
  *
  * The way to use a worklist is to pass it as a template parameter to
  * \ref for_each(). For example,
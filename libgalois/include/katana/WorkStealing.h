@@ -0,0 +1,363 @@
+#ifndef KATANA_LIBGALOIS_KATANA_WORKSTEALING_H_
+#define KATANA_LIBGALOIS_KATANA_WORKSTEALING_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "katana/FixedSizeRing.h"
+#include "katana/Mem.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
+#include "katana/WLCompileCheck.h"
+#include "katana/config.h"
+
+namespace katana {
+
+namespace internal {
+
+/// The dynamic circular work-stealing deque of Chase and Lev, with the memory
+/// orderings of Le et al., "Correct and Efficient Work-Stealing for Weak
+/// Memory Models" (PPoPP 2013). The owning thread pushes and takes at the
+/// bottom; any thread may steal from the top.
+template <typename E>
+class ChaseLevDeque {
+  struct Array {
+    int64_t capacity;
+    std::atomic<E>* slots;
+
+    explicit Array(int64_t c) : capacity(c), slots(new std::atomic<E>[c]) {}
+    ~Array() { delete[] slots; }
+
+    E get(int64_t i) const {
+      return slots[i & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+    void put(int64_t i, E e) {
+      slots[i & (capacity - 1)].store(e, std::memory_order_relaxed);
+    }
+  };
+
+  static constexpr int64_t kInitialCapacity = 64;
+
+  // Thieves write top_ and the owner writes bottom_; keep them apart
+  std::atomic<int64_t> top_{0};
+  char pad_[KATANA_CACHE_LINE_SIZE];
+  std::atomic<int64_t> bottom_{0};
+  std::atomic<Array*> array_;
+  // Arrays replaced by a bigger one may still be read by thieves, so they are
+  // only freed with the deque
+  std::vector<Array*> retired_;
+
+  Array* Grow(Array* a, int64_t b, int64_t t) {
+    Array* bigger = new Array(a->capacity * 2);
+    for (int64_t i = t; i < b; ++i) {
+      bigger->put(i, a->get(i));
+    }
+    retired_.push_back(a);
+    array_.store(bigger, std::memory_order_release);
+    return bigger;
+  }
+
+public:
+  ChaseLevDeque() : array_(new Array(kInitialCapacity)) {}
+  ChaseLevDeque(const ChaseLevDeque&) = delete;
+  ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+  ~ChaseLevDeque() {
+    delete array_.load(std::memory_order_relaxed);
+    for (Array* a : retired_) {
+      delete a;
+    }
+  }
+
+  /// Approximate number of elements; exact for the owner when there are no
+  /// concurrent thieves
+  int64_t size() const {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    return std::max<int64_t>(b - t, 0);
+  }
+
+  /// Owner only
+  void push(E e) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Array* a = array_.load(std::memory_order_relaxed);
+    if (b - t > a->capacity - 1) {
+      a = Grow(a, b, t);
+    }
+    a->put(b, e);
+    bottom_.store(b + 1, std::memory_order_release);
+  }
+
+  /// Owner only
+  std::optional<E> take() {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Array* a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_seq_cst);
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    E e = a->get(b);
+    if (t == b) {
+      // Last element; race against thieves for it
+      bool won = top_.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      if (!won) {
+        return std::nullopt;
+      }
+    }
+    return e;
+  }
+
+  /// Any thread. Fails if the deque is empty or another thread took the
+  /// element first.
+  std::optional<E> steal() {
+    int64_t t = top_.load(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_seq_cst);
+    if (t >= b) {
+      return std::nullopt;
+    }
+    Array* a = array_.load(std::memory_order_acquire);
+    E e = a->get(t);
+    if (!top_.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return std::nullopt;
+    }
+    return e;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Work-stealing worklist. Each thread fills chunks of work privately and
+ * publishes full chunks on its own Chase-Lev deque. A thread that runs out of
+ * work steals half of the chunks of another thread, starting with the oldest.
+ *
+ * Rather than a fixed chunk size, each thread times how long its chunks take
+ * to process and sizes the chunks it fills so that each holds about
+ * kTargetChunkNs of work, between 1 and MaxChunkSize items. Cheap tasks get
+ * large chunks, which keeps scheduling overhead low, and expensive tasks get
+ * small ones, which leaves enough chunks to steal.
+ *
+ * @tparam MaxChunkSize  largest number of items in a chunk
+ */
+template <int MaxChunkSize = 128, typename T = int, bool Concurrent = true>
+struct StealingChunkDeque {
+  template <typename _T>
+  using retype = StealingChunkDeque<MaxChunkSize, _T, Concurrent>;
+
+  template <int _chunk_size>
+  using with_chunk_size = StealingChunkDeque<_chunk_size, T, Concurrent>;
+
+  template <bool _Concurrent>
+  using rethread = StealingChunkDeque<MaxChunkSize, T, _Concurrent>;
+
+  /// Amount of work to aim for in each chunk
+  static constexpr uint64_t kTargetChunkNs = 10000;
+
+  typedef T value_type;
+
+private:
+  class Chunk : public FixedSizeRing<T, MaxChunkSize> {};
+
+  using Clock = std::chrono::steady_clock;
+
+  struct ThreadData {
+    internal::ChaseLevDeque<Chunk*> deque;
+    // Chunk being popped from
+    Chunk* cur{nullptr};
+    // Chunk being filled; private until it reaches limit items
+    Chunk* next{nullptr};
+    unsigned limit{std::max(MaxChunkSize / 4, 1)};
+    // Moving average of the time to process one item
+    double itemNs{0};
+    Clock::time_point curStart;
+    unsigned curPopped{0};
+    uint64_t rand;
+
+    ThreadData() : rand(reinterpret_cast<uintptr_t>(this) | 1) {}
+
+    unsigned nextRandom() {
+      // xorshift64
+      rand ^= rand << 13;
+      rand ^= rand >> 7;
+      rand ^= rand << 17;
+      return rand;
+    }
+  };
+
+  FixedSizeAllocator<Chunk> alloc;
+  PerThreadStorage<ThreadData> data;
+
+  Chunk* mkChunk() {
+    Chunk* ptr = alloc.allocate(1);
+    alloc.construct(ptr);
+    return ptr;
+  }
+
+  void delChunk(Chunk* ptr) {
+    alloc.destroy(ptr);
+    alloc.deallocate(ptr, 1);
+  }
+
+  /// Fold the time taken by the chunk that was just finished into the
+  /// estimate of the per item cost and resize future chunks
+  void adapt(ThreadData& p, Clock::time_point now) {
+    if (p.curPopped == 0) {
+      return;
+    }
+    double ns =
+        std::chrono::duration<double, std::nano>(now - p.curStart).count() /
+        p.curPopped;
+    p.itemNs = p.itemNs == 0 ? ns : 0.75 * p.itemNs + 0.25 * ns;
+    double items = kTargetChunkNs / std::max(p.itemNs, 1.0);
+    p.limit = std::clamp<double>(items, 1, MaxChunkSize);
+  }
+
+  void setCur(ThreadData& p, Chunk* c) {
+    auto now = Clock::now();
+    adapt(p, now);
+    if (p.cur) {
+      delChunk(p.cur);
+    }
+    p.cur = c;
+    p.curStart = now;
+    p.curPopped = 0;
+  }
+
+  void publish(ThreadData& p) {
+    if (p.next) {
+      p.deque.push(p.next);
+      p.next = nullptr;
+    }
+  }
+
+  template <typename... Args>
+  void emplacei(ThreadData& p, Args&&... args) {
+    if (p.next && p.next->size() >= p.limit) {
+      publish(p);
+    }
+    if (!p.next) {
+      p.next = mkChunk();
+    }
+    p.next->emplace_back(std::forward<Args>(args)...);
+  }
+
+  /// Take half of the chunks of some other thread, keep the first and put
+  /// the rest on our deque so that others can steal them in turn
+  Chunk* stealHalf(ThreadData& p) {
+    unsigned num = getActiveThreads();
+    if (num <= 1) {
+      return nullptr;
+    }
+    unsigned me = ThreadPool::getTID();
+    unsigned start = p.nextRandom() % num;
+    for (unsigned i = 0; i < num; ++i) {
+      unsigned victim = (start + i) % num;
+      if (victim == me) {
+        continue;
+      }
+      auto& deque = data.getRemote(victim)->deque;
+      int64_t want = (deque.size() + 1) / 2;
+      Chunk* first = nullptr;
+      for (int64_t n = 0; n < want; ++n) {
+        std::optional<Chunk*> c = deque.steal();
+        if (!c) {
+          break;
+        }
+        if (!first) {
+          first = *c;
+        } else {
+          p.deque.push(*c);
+        }
+      }
+      if (first) {
+        return first;
+      }
+    }
+    return nullptr;
+  }
+
+  KATANA_ATTRIBUTE_NOINLINE
+  std::optional<value_type> slowPop(ThreadData& p) {
+    for (;;) {
+      Chunk* c = nullptr;
+      if (auto taken = p.deque.take()) {
+        c = *taken;
+      } else if (p.next) {
+        c = p.next;
+        p.next = nullptr;
+      } else {
+        c = stealHalf(p);
+      }
+      if (!c) {
+        return std::nullopt;
+      }
+      setCur(p, c);
+      if (std::optional<value_type> item = c->extract_front()) {
+        ++p.curPopped;
+        return item;
+      }
+    }
+  }
+
+public:
+  StealingChunkDeque() = default;
+  StealingChunkDeque(const StealingChunkDeque&) = delete;
+  StealingChunkDeque& operator=(const StealingChunkDeque&) = delete;
+
+  ~StealingChunkDeque() {
+    for (unsigned i = 0; i < data.size(); ++i) {
+      ThreadData& p = *data.getRemote(i);
+      while (auto c = p.deque.take()) {
+        delChunk(*c);
+      }
+      if (p.cur) {
+        delChunk(p.cur);
+      }
+      if (p.next) {
+        delChunk(p.next);
+      }
+    }
+  }
+
+  void push(const value_type& val) { emplacei(*data.getLocal(), val); }
+
+  template <typename Iter>
+  void push(Iter b, Iter e) {
+    ThreadData& p = *data.getLocal();
+    while (b != e)
+      emplacei(p, *b++);
+  }
+
+  template <typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    push(range.local_begin(), range.local_end());
+    // Let other threads steal initial work right away
+    publish(*data.getLocal());
+  }
+
+  std::optional<value_type> pop() {
+    ThreadData& p = *data.getLocal();
+    std::optional<value_type> item;
+    if (p.cur && (item = p.cur->extract_front())) {
+      ++p.curPopped;
+      return item;
+    }
+    return slowPop(p);
+  }
+};
+KATANA_WLCOMPILECHECK(StealingChunkDeque)
+
+}  // end namespace katana
+
+#endif
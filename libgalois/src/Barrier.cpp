@@ -20,6 +20,7 @@
 #include "katana/Barrier.h"
 
 #include "katana/Logging.h"
+#include "katana/SubPool.h"
 #include "katana/ThreadPool.h"
 
 // anchor vtable
@@ -43,15 +44,21 @@ katana::internal::SetBarrier(katana::Barrier* barrier) {
 
 katana::Barrier&
 katana::GetBarrier(unsigned active_threads) {
-  KATANA_LOG_VASSERT(kBarrier, "Barrier not initialized");
+  Barrier* barrier = kBarrier;
+  unsigned* barrier_threads = &kBarrierThreads;
+  if (SubPool* sub_pool = ThreadPool::getSubPool()) {
+    barrier = sub_pool->barrier_.get();
+    barrier_threads = &sub_pool->barrier_threads_;
+  }
+  KATANA_LOG_VASSERT(barrier, "Barrier not initialized");
   active_threads =
       std::min(active_threads, GetThreadPool().getMaxUsableThreads());
   active_threads = std::max(active_threads, 1U);
 
-  if (active_threads != kBarrierThreads) {
-    kBarrierThreads = active_threads;
-    kBarrier->Reinit(kBarrierThreads);
+  if (active_threads != *barrier_threads) {
+    *barrier_threads = active_threads;
+    barrier->Reinit(active_threads);
   }
 
-  return *kBarrier;
+  return *barrier;
 }
@@ -23,24 +23,138 @@
 
 #include "katana/DynamicBitset.h"
 
+#include <algorithm>
+
+#include "katana/CompilerSpecific.h"
 #include "katana/Galois.h"
 
 KATANA_EXPORT katana::DynamicBitset katana::EmptyBitset;
 
+namespace {
+
+// The bulk operations below read and write the words of a bitset as plain
+// uint64_t so that the compiler can vectorize them. Like the operations that
+// use them, they assume that the bitsets are not updated in parallel.
+static_assert(sizeof(katana::DynamicBitset::TItem) == sizeof(uint64_t));
+
+uint64_t*
+Words(katana::DynamicBitset* bitset) {
+  return reinterpret_cast<uint64_t*>(bitset->get_vec().data());
+}
+
+const uint64_t*
+Words(const katana::DynamicBitset& bitset) {
+  return reinterpret_cast<const uint64_t*>(bitset.get_vec().data());
+}
+
+// Each kernel is compiled for AVX-512, AVX2 and plain x86-64, and the best
+// version for the running CPU is picked at load time.
+#define KATANA_BITSET_KERNEL                                                   \
+  KATANA_ATTRIBUTE_TARGET_CLONES("avx512f", "avx2", "default")
+
+// Icelake and later have a vector popcount (AVX512_VPOPCNTDQ)
+#define KATANA_BITSET_POPCOUNT_KERNEL                                          \
+  KATANA_ATTRIBUTE_TARGET_CLONES("arch=icelake-server", "popcnt", "default")
+
+KATANA_BITSET_KERNEL void
+OrWords(uint64_t* dst, const uint64_t* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] |= src[i];
+  }
+}
+
+KATANA_BITSET_KERNEL void
+NotWords(uint64_t* dst, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = ~dst[i];
+  }
+}
+
+KATANA_BITSET_KERNEL void
+AndWords(uint64_t* dst, const uint64_t* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] &= src[i];
+  }
+}
+
+KATANA_BITSET_KERNEL void
+AndWords(uint64_t* dst, const uint64_t* src1, const uint64_t* src2, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = src1[i] & src2[i];
+  }
+}
+
+KATANA_BITSET_KERNEL void
+AndNotWords(uint64_t* dst, const uint64_t* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] &= ~src[i];
+  }
+}
+
+KATANA_BITSET_KERNEL void
+XorWords(uint64_t* dst, const uint64_t* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] ^= src[i];
+  }
+}
+
+KATANA_BITSET_KERNEL void
+XorWords(uint64_t* dst, const uint64_t* src1, const uint64_t* src2, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = src1[i] ^ src2[i];
+  }
+}
+
+KATANA_BITSET_POPCOUNT_KERNEL size_t
+CountWords(const uint64_t* words, size_t n) {
+  size_t ret = 0;
+  for (size_t i = 0; i < n; ++i) {
+    ret += __builtin_popcountll(words[i]);
+  }
+  return ret;
+}
+
+/// Words per unit of parallel work: big enough for the vector loops to
+/// dominate the scheduling cost and small enough to balance the load
+constexpr size_t kWordsPerBlock = 4096;
+
+/// Calls fn(begin, end) on blocks of words in parallel. Bitsets of one block
+/// are handled on the calling thread.
+template <typename F>
+void
+ForEachBlock(size_t num_words, const F& fn) {
+  if (num_words <= kWordsPerBlock) {
+    fn(size_t{0}, num_words);
+    return;
+  }
+  size_t num_blocks = (num_words + kWordsPerBlock - 1) / kWordsPerBlock;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_blocks),
+      [&](size_t block) {
+        size_t begin = block * kWordsPerBlock;
+        fn(begin, std::min(begin + kWordsPerBlock, num_words));
+      },
+      katana::no_stats());
+}
+
+}  // namespace
+
 void
 katana::DynamicBitset::bitwise_or(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] |= other_bitvec[i]; }, katana::no_stats());
+  uint64_t* dst = Words(this);
+  const uint64_t* src = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    OrWords(dst + begin, src + begin, end - begin);
+  });
 }
 
 void
 katana::DynamicBitset::bitwise_not() {
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = ~bitvec_[i]; }, katana::no_stats());
+  uint64_t* dst = Words(this);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    NotWords(dst + begin, end - begin);
+  });
 
   RestoreTrailingBitsInvariant();
 }
@@ -48,10 +162,11 @@ katana::DynamicBitset::bitwise_not() {
 void
 katana::DynamicBitset::bitwise_and(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] &= other_bitvec[i]; }, katana::no_stats());
+  uint64_t* dst = Words(this);
+  const uint64_t* src = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    AndWords(dst + begin, src + begin, end - begin);
+  });
 }
 
 void
@@ -59,22 +174,32 @@ katana::DynamicBitset::bitwise_and(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
   KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
+  uint64_t* dst = Words(this);
+  const uint64_t* src1 = Words(other1);
+  const uint64_t* src2 = Words(other2);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    AndWords(dst + begin, src1 + begin, src2 + begin, end - begin);
+  });
+}
 
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] & other_bitvec2[i]; },
-      katana::no_stats());
+void
+katana::DynamicBitset::bitwise_andnot(const DynamicBitset& other) {
+  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
+  uint64_t* dst = Words(this);
+  const uint64_t* src = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    AndNotWords(dst + begin, src + begin, end - begin);
+  });
 }
 
 void
 katana::DynamicBitset::bitwise_xor(const DynamicBitset& other) {
   KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] ^= other_bitvec[i]; }, katana::no_stats());
+  uint64_t* dst = Words(this);
+  const uint64_t* src = Words(other);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    XorWords(dst + begin, src + begin, end - begin);
+  });
 }
 
 void
@@ -82,47 +207,37 @@ katana::DynamicBitset::bitwise_xor(
     const DynamicBitset& other1, const DynamicBitset& other2) {
   KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
   KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
+  uint64_t* dst = Words(this);
+  const uint64_t* src1 = Words(other1);
+  const uint64_t* src2 = Words(other2);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    XorWords(dst + begin, src1 + begin, src2 + begin, end - begin);
+  });
+}
 
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] ^ other_bitvec2[i]; },
-      katana::no_stats());
+bool
+katana::DynamicBitset::Equals(const DynamicBitset& other) const {
+  if (size() != other.size()) {
+    return false;
+  }
+  // The unused bits of the last word are 0 in both bitsets
+  const uint64_t* words = Words(*this);
+  return std::equal(words, words + bitvec_.size(), Words(other));
 }
 
 size_t
 katana::DynamicBitset::count() const {
   katana::GAccumulator<size_t> ret;
-  katana::do_all(
-      katana::iterate(bitvec_.begin(), bitvec_.end()),
-      [&](uint64_t n) {
-#ifdef __GNUC__
-        ret += __builtin_popcountll(n);
-#else
-        n = n - ((n >> 1) & 0x5555555555555555UL);
-        n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-        ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-               56;
-#endif
-      },
-      katana::no_stats());
+  const uint64_t* words = Words(*this);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    ret += CountWords(words + begin, end - begin);
+  });
   return ret.reduce();
 }
 
 size_t
 katana::DynamicBitset::SerialCount() const {
-  size_t ret = 0;
-  for (uint64_t n : bitvec_) {
-#ifdef __GNUC__
-    ret += __builtin_popcountll(n);
-#else
-    n = n - ((n >> 1) & 0x5555555555555555UL);
-    n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-    ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
-#endif
-  }
-  return ret;
+  return CountWords(Words(*this), bitvec_.size());
 }
 
 namespace {
@@ -133,20 +248,15 @@ ComputeOffsets(
   // TODO uint32_t is somewhat dangerous; change in the future
   uint32_t activeThreads = katana::getActiveThreads();
   std::vector<Integer> tPrefixBitCounts(activeThreads);
+  const uint64_t* words = Words(bitset);
+  size_t num_words = bitset.get_vec().size();
 
-  // count how many bits are set on each thread
+  // count how many bits are set on each thread; threads split the bitset at
+  // word boundaries so that they can count and extract whole words
   katana::on_each([&](unsigned tid, unsigned nthreads) {
     auto [start, end] =
-        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
-
-    Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
-    }
-
-    tPrefixBitCounts[tid] = count;
+        katana::block_range(size_t{0}, num_words, tid, nthreads);
+    tPrefixBitCounts[tid] = CountWords(words + start, end - start);
   });
 
   // calculate prefix sum of bits per thread
@@ -162,18 +272,20 @@ ComputeOffsets(
   if (bitsetCount > 0) {
     size_t cur_size = offsets->size();
     offsets->resize(cur_size + bitsetCount);
+    Integer* out = offsets->data() + cur_size;
     katana::on_each([&](unsigned tid, unsigned nthreads) {
       auto [start, end] =
-          katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
-      Integer index = cur_size;
+          katana::block_range(size_t{0}, num_words, tid, nthreads);
+      Integer index = 0;
       if (tid != 0) {
-        index += tPrefixBitCounts[tid - 1];
+        index = tPrefixBitCounts[tid - 1];
       }
 
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets->at(index) = i;
-          ++index;
+      for (size_t w = start; w < end; ++w) {
+        // visit only the set bits of each word, lowest first
+        for (uint64_t word = words[w]; word != 0; word &= word - 1) {
+          out[index++] = w * katana::DynamicBitset::kNumBitsInUint64 +
+                         __builtin_ctzll(word);
         }
       }
     });
@@ -205,6 +205,11 @@ public:
 
 }  // namespace
 
+std::unique_ptr<katana::TerminationDetection>
+katana::internal::CreateTerminationDetection() {
+  return std::make_unique<LocalTerminationDetection>();
+}
+
 struct katana::GaloisRuntime::Impl {
   struct Dependents {
     LocalTerminationDetection term;
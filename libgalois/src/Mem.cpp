@@ -28,7 +28,7 @@
 void
 katana::Prealloc(size_t pagesPerThread, size_t bytes) {
   size_t size =
-      (pagesPerThread * katana::activeThreads) + (bytes / allocSize());
+      (pagesPerThread * katana::getActiveThreads()) + (bytes / allocSize());
   // If the user requested a non-zero allocation, at the very least
   // allocate a page.
   if (size == 0 && bytes > 0) {
@@ -40,9 +40,10 @@ katana::Prealloc(size_t pagesPerThread, size_t bytes) {
 
 void
 katana::Prealloc(size_t pages) {
-  unsigned pagesPerThread =
-      (pages + katana::activeThreads - 1) / katana::activeThreads;
-  katana::GetThreadPool().run(katana::activeThreads, [=]() {
+  ThreadPool::StartGuard start_guard;
+  unsigned num_threads = katana::getActiveThreads();
+  unsigned pagesPerThread = (pages + num_threads - 1) / num_threads;
+  katana::GetThreadPool().run(num_threads, [=]() {
     katana::pagePoolPreAlloc(pagesPerThread);
   });
 }
@@ -50,7 +51,7 @@ katana::Prealloc(size_t pages) {
 void
 katana::EnsurePreallocated(size_t pagesPerThread, size_t bytes) {
   size_t size =
-      (pagesPerThread * katana::activeThreads) + (bytes / allocSize());
+      (pagesPerThread * katana::getActiveThreads()) + (bytes / allocSize());
   // If the user requested a non-zero allocation, at the very least
   // allocate a page.
   if (size == 0 && bytes > 0) {
@@ -62,9 +63,10 @@ katana::EnsurePreallocated(size_t pagesPerThread, size_t bytes) {
 
 void
 katana::EnsurePreallocated(size_t pages) {
-  unsigned pagesPerThread =
-      (pages + katana::activeThreads - 1) / katana::activeThreads;
-  katana::GetThreadPool().run(katana::activeThreads, [=]() {
+  ThreadPool::StartGuard start_guard;
+  unsigned num_threads = katana::getActiveThreads();
+  unsigned pagesPerThread = (pages + num_threads - 1) / num_threads;
+  katana::GetThreadPool().run(num_threads, [=]() {
     katana::pagePoolEnsurePreallocated(pagesPerThread);
   });
 }
@@ -1,7 +1,10 @@
 #include "katana/MemoryPolicy.h"
 
+#include <algorithm>
 #include <fstream>
+#include <optional>
 #include <regex>
+#include <string>
 
 #include "katana/MemoryPolicy.h"
 #include "katana/MemorySupervisor.h"
@@ -49,7 +52,7 @@ void
 katana::MemoryPolicy::UpdateMemInfo(MemInfo* mem_info, count_t standby) const {
   mem_info->standby = standby;
   mem_info->rss_bytes = katana::ProgressTracer::ParseProcSelfRssBytes();
-  mem_info->available_bytes = AvailableMemoryBytes();
+  mem_info->available_bytes = AvailableBytes();
   mem_info->used_ratio = (double)mem_info->rss_bytes / physical();
   mem_info->oom_score = OOMScore();
 }
@@ -215,6 +218,73 @@ katana::MemoryPolicyMeek::MemoryPolicyMeek()
           .high_pressure_oom_threshold = 1100,
       }) {}
 
+//////////////////////////////////////////////////////////////////////
+// MemoryPolicyCgroup
+bool
+katana::MemoryPolicyCgroup::IsMemoryPressureHigh(count_t standby) const {
+  MemInfo mem_info;
+  UpdateMemInfo(&mem_info, standby);
+  if (mem_info.used_ratio > high_used_ratio_threshold() ||
+      mem_info.available_bytes < 0.1 * physical()) {
+    LogIt("memory pressure high", &mem_info);
+    return true;
+  }
+
+  return false;
+}
+
+count_t
+katana::MemoryPolicyCgroup::ReclaimForMemoryPressure(count_t standby) const {
+  MemInfo mem_info;
+  UpdateMemInfo(&mem_info, standby);
+
+  // Reclaim enough to get back under the threshold, all of it if the limit is
+  // near
+  if (mem_info.available_bytes < 0.05 * physical()) {
+    return standby;
+  }
+  if (mem_info.used_ratio > high_used_ratio_threshold()) {
+    auto over = static_cast<count_t>(
+        (mem_info.used_ratio - high_used_ratio_threshold()) * physical());
+    return std::min(standby, over);
+  }
+  return 0;
+}
+
+bool
+katana::MemoryPolicyCgroup::KillSelfForLackOfMemory(count_t standby) const {
+  MemInfo mem_info;
+  UpdateMemInfo(&mem_info, standby);
+
+  if (mem_info.used_ratio > kill_used_ratio_threshold() &&
+      mem_info.available_bytes < 0.02 * physical()) {
+    LogIt("KILL SELF", &mem_info);
+    return true;
+  }
+  return false;
+}
+
+count_t
+katana::MemoryPolicyCgroup::AvailableBytes() const {
+  count_t available = MemoryPolicy::AvailableBytes();
+  if (auto usage = CgroupMemoryUsageBytes(); usage) {
+    count_t usage_bytes = static_cast<count_t>(*usage);
+    available = std::min(
+        available, usage_bytes >= physical() ? 0 : physical() - usage_bytes);
+  }
+  return available;
+}
+
+katana::MemoryPolicyCgroup::MemoryPolicyCgroup()
+    : MemoryPolicy(
+          {
+              .high_used_ratio_threshold = 0.85,
+              .kill_used_ratio_threshold = 0.98,
+              .kill_self_oom_threshold = 1280,
+              .high_pressure_oom_threshold = 1100,
+          },
+          katana::MemorySupervisor::GetMemoryLimit()) {}
+
 //////////////////////////////////////////////////////////////////////
 // MemoryPolicyNull
 bool
@@ -247,8 +317,13 @@ katana::MemoryPolicyNull::MemoryPolicyNull()
 // MemoryPolicy
 
 katana::MemoryPolicy::MemoryPolicy(
-    katana::MemoryPolicy::Thresholds thresholds) {
-  physical_ = katana::MemorySupervisor::GetTotalSystemMemory();
+    katana::MemoryPolicy::Thresholds thresholds)
+    : MemoryPolicy(
+          thresholds, katana::MemorySupervisor::GetTotalSystemMemory()) {}
+
+katana::MemoryPolicy::MemoryPolicy(
+    katana::MemoryPolicy::Thresholds thresholds, count_t physical) {
+  physical_ = physical;
   // We divide by physical_
   if (physical_ == 0) {
     physical_ = 1;
@@ -256,6 +331,11 @@ katana::MemoryPolicy::MemoryPolicy(
   thresholds_ = thresholds;
 }
 
+count_t
+katana::MemoryPolicy::AvailableBytes() const {
+  return static_cast<count_t>(AvailableMemoryBytes());
+}
+
 #if __linux__
 
 // TODO(witchel), check /proc/self/oom_adj and /proc/self/oom_score_adj
@@ -303,6 +383,126 @@ katana::MemoryPolicy::AvailableMemoryBytes() {
   return value * 1024;
 }
 
+namespace {
+
+/// The directory of our cgroup in the hierarchy for \p controller ("" for
+/// cgroup v2), relative to the mount point
+std::string
+CgroupPath(const std::string& controller) {
+  std::ifstream proc_self("/proc/self/cgroup");
+  std::string line;
+  while (std::getline(proc_self, line)) {
+    // hierarchy-ID:controller-list:cgroup-path
+    auto first = line.find(':');
+    auto second = line.find(':', first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+      continue;
+    }
+    std::string controllers = line.substr(first + 1, second - first - 1);
+    bool match = controller.empty()
+                     ? controllers.empty()
+                     : ("," + controllers + ",").find("," + controller + ",") !=
+                           std::string::npos;
+    if (match) {
+      return line.substr(second + 1);
+    }
+  }
+  return "/";
+}
+
+/// Read a single number from a cgroup file, trying our own cgroup first and
+/// then the root of the mount (which is our cgroup inside most containers).
+/// nullopt if no file could be read or it says "max".
+std::optional<uint64_t>
+ReadCgroupValue(
+    const std::string& mount, const std::string& cgroup,
+    const std::string& file) {
+  for (const auto& dir : {mount + cgroup, mount}) {
+    std::ifstream in(dir + "/" + file);
+    std::string value;
+    if (!(in >> value)) {
+      continue;
+    }
+    if (value == "max") {
+      return std::nullopt;
+    }
+    try {
+      return static_cast<uint64_t>(std::stoull(value));
+    } catch (std::exception& e) {
+      KATANA_LOG_WARN("problem parsing {}/{}: {}", dir, file, e.what());
+      return std::nullopt;
+    }
+  }
+  return std::nullopt;
+}
+
+/// Read the value of \p key from a cgroup file of "key value" lines
+std::optional<uint64_t>
+ReadCgroupStat(
+    const std::string& mount, const std::string& cgroup,
+    const std::string& file, const std::string& key) {
+  for (const auto& dir : {mount + cgroup, mount}) {
+    std::ifstream in(dir + "/" + file);
+    if (!in) {
+      continue;
+    }
+    std::string name;
+    uint64_t value{};
+    while (in >> name >> value) {
+      if (name == key) {
+        return value;
+      }
+    }
+    return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+std::optional<uint64_t>
+katana::MemoryPolicy::CgroupMemoryLimitBytes() {
+  std::optional<uint64_t> limit =
+      ReadCgroupValue("/sys/fs/cgroup", CgroupPath(""), "memory.max");
+  if (!limit) {
+    limit = ReadCgroupValue(
+        "/sys/fs/cgroup/memory", CgroupPath("memory"),
+        "memory.limit_in_bytes");
+  }
+  // cgroup v1 reports "no limit" as a very large number
+  if (limit && *limit >= katana::MemorySupervisor::GetTotalSystemMemory()) {
+    return std::nullopt;
+  }
+  return limit;
+}
+
+std::optional<uint64_t>
+katana::MemoryPolicy::CgroupMemoryUsageBytes() {
+  if (!CgroupMemoryLimitBytes()) {
+    return std::nullopt;
+  }
+  std::optional<uint64_t> usage =
+      ReadCgroupValue("/sys/fs/cgroup", CgroupPath(""), "memory.current");
+  std::optional<uint64_t> inactive_file;
+  if (usage) {
+    inactive_file = ReadCgroupStat(
+        "/sys/fs/cgroup", CgroupPath(""), "memory.stat", "inactive_file");
+  } else {
+    usage = ReadCgroupValue(
+        "/sys/fs/cgroup/memory", CgroupPath("memory"),
+        "memory.usage_in_bytes");
+    inactive_file = ReadCgroupStat(
+        "/sys/fs/cgroup/memory", CgroupPath("memory"), "memory.stat",
+        "total_inactive_file");
+  }
+  // The usage includes page cache that the kernel can drop instead of
+  // reclaiming our memory
+  if (usage && inactive_file) {
+    *usage -= std::min(*usage, *inactive_file);
+  }
+  return usage;
+}
+
 #else
 
 uint64_t
@@ -311,4 +511,14 @@ katana::MemoryPolicy::OOMScore() {
   return 0;
 }
 
+std::optional<uint64_t>
+katana::MemoryPolicy::CgroupMemoryLimitBytes() {
+  return std::nullopt;
+}
+
+std::optional<uint64_t>
+katana::MemoryPolicy::CgroupMemoryUsageBytes() {
+  return std::nullopt;
+}
+
 #endif
@@ -3,6 +3,8 @@
 #include <fstream>
 
 #include "katana/Cache.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
 #include "katana/MemoryPolicy.h"
 #include "katana/PropertyManager.h"
 #include "katana/Time.h"
@@ -24,6 +26,32 @@ LogState(const std::string& str, count_t standby, count_t bytes_reclaimed) {
            });
 }
 
+/// The policy named by KATANA_MEMORY_POLICY, MemoryPolicyMinimal by default
+std::unique_ptr<katana::MemoryPolicy>
+PolicyFromEnv() {
+  std::string name;
+  if (!katana::GetEnv("KATANA_MEMORY_POLICY", &name) || name == "minimal") {
+    return std::make_unique<katana::MemoryPolicyMinimal>();
+  }
+  if (name == "performance") {
+    return std::make_unique<katana::MemoryPolicyPerformance>();
+  }
+  if (name == "meek") {
+    return std::make_unique<katana::MemoryPolicyMeek>();
+  }
+  if (name == "cgroup") {
+    return std::make_unique<katana::MemoryPolicyCgroup>();
+  }
+  if (name == "null") {
+    return std::make_unique<katana::MemoryPolicyNull>();
+  }
+  KATANA_LOG_WARN(
+      "ignoring KATANA_MEMORY_POLICY={}, expected minimal, performance, meek, "
+      "cgroup or null",
+      name);
+  return std::make_unique<katana::MemoryPolicyMinimal>();
+}
+
 void
 KillCheck(
     katana::MemoryPolicy* policy, count_t standby, count_t bytes_reclaimed) {
@@ -58,8 +86,8 @@ katana::MemorySupervisor::SanityCheck() {
 }
 
 katana::MemorySupervisor::MemorySupervisor() {
-  physical_ = GetTotalSystemMemory();
-  policy_ = std::make_unique<katana::MemoryPolicyMinimal>();
+  physical_ = GetMemoryLimit();
+  policy_ = PolicyFromEnv();
   // Memory supervisor creates managers
   auto pr = std::make_unique<PropertyManager>();
   const auto& name = pr->Name();
@@ -100,6 +128,7 @@ katana::MemorySupervisor::ReclaimMemory(count_t goal) {
       break;
     }
   }
+  std::lock_guard<std::mutex> lock(mutex_);
   bytes_reclaimed_ += reclaimed;
 }
 
@@ -113,6 +142,7 @@ katana::MemorySupervisor::GetStandby(const std::string& name, count_t goal) {
   auto& info = it->second;
 
   CheckPressure();
+  std::lock_guard<std::mutex> lock(mutex_);
   if (policy_->IsMemoryPressureHigh(standby_)) {
     return 0;
   }
@@ -133,6 +163,7 @@ katana::MemorySupervisor::PutStandby(const std::string& name, count_t bytes) {
   }
   auto& info = it->second;
 
+  std::lock_guard<std::mutex> lock(mutex_);
   StandbyMinus(info, bytes);
 
   SanityCheck();
@@ -151,9 +182,13 @@ katana::MemorySupervisor::ActiveToStandby(
   }
   auto& info = it->second;
 
-  StandbyPlus(info, bytes);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StandbyPlus(info, bytes);
+  }
 
   CheckPressure();
+  std::lock_guard<std::mutex> lock(mutex_);
   SanityCheck();
   KillCheck(policy_.get(), standby_, bytes_reclaimed_);
 }
@@ -168,26 +203,63 @@ katana::MemorySupervisor::StandbyToActive(
   }
   auto& info = it->second;
 
-  StandbyMinus(info, bytes);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StandbyMinus(info, bytes);
+  }
 
   CheckPressure();
+  std::lock_guard<std::mutex> lock(mutex_);
   SanityCheck();
   KillCheck(policy_.get(), standby_, bytes_reclaimed_);
 }
 
+count_t
+katana::MemorySupervisor::StandbyBudget(const std::string& name) {
+  auto it = managers_.find(name);
+  if (it == managers_.end()) {
+    KATANA_LOG_WARN("no manager with name {}\n", name);
+    return 0;
+  }
+  const auto& info = it->second;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  count_t reclaim = policy_->ReclaimForMemoryPressure(standby_);
+  if (reclaim > 0) {
+    return std::max<count_t>(info.standby - reclaim, 0);
+  }
+  return info.standby + Available();
+}
+
 void
 katana::MemorySupervisor::CheckPressure() {
-  count_t try_reclaim = policy_->ReclaimForMemoryPressure(standby_);
+  std::lock_guard<std::mutex> reclaim_lock(reclaim_mutex_);
+  // Decided after waiting for other reclaims, which may have freed enough
+  count_t try_reclaim{};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    try_reclaim = policy_->ReclaimForMemoryPressure(standby_);
+  }
   ReclaimMemory(try_reclaim);
 }
 
 void
 katana::MemorySupervisor::SetPolicy(std::unique_ptr<MemoryPolicy> policy) {
-  policy_.swap(policy);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_.swap(policy);
+  }
   CheckPressure();
+  std::lock_guard<std::mutex> lock(mutex_);
   SanityCheck();
 }
 
+count_t
+katana::MemorySupervisor::standby() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return standby_;
+}
+
 katana::CacheStats
 katana::MemorySupervisor::GetPropertyCacheStats() const {
   auto name = PropertyManager::name_;
@@ -203,7 +275,11 @@ katana::MemorySupervisor::GetPropertyCacheStats() const {
 
 void
 katana::MemorySupervisor::LogMemoryStats(const std::string& message) {
-  policy_->LogMemoryStats(message, standby_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_->LogMemoryStats(message, standby_);
+  }
+  GetPropertyCacheStats().Log();
 }
 
 katana::PropertyManager*
@@ -225,3 +301,12 @@ katana::MemorySupervisor::GetTotalSystemMemory() {
   uint64_t page_size = sysconf(_SC_PAGE_SIZE);
   return pages * page_size;
 }
+
+uint64_t
+katana::MemorySupervisor::GetMemoryLimit() {
+  uint64_t physical = GetTotalSystemMemory();
+  if (auto limit = MemoryPolicy::CgroupMemoryLimitBytes(); limit) {
+    return std::min(physical, *limit);
+  }
+  return physical;
+}
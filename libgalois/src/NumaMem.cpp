@@ -19,9 +19,11 @@
 
 #include "katana/NumaMem.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "katana/PageAlloc.h"
+#include "katana/Statistics.h"
 #include "katana/ThreadPool.h"
 #include "katana/gIO.h"
 
@@ -39,8 +41,12 @@ pageIn(
     for (size_t x = 0; x < len; x += pageSize / 2)
       ptr[x] = 0;
   } else {
+    // Only a hint where pages go: if sub-pools took threads since
+    // numThreads was read, the pages of the missing threads fault in later
+    ThreadPool::StartGuard start_guard;
     GetThreadPool().run(
-        numThreads, [ptr, len, pageSize, numThreads, finegrained]() {
+        std::min(numThreads, GetThreadPool().getMaxUsableThreads()),
+        [ptr, len, pageSize, numThreads, finegrained]() {
           auto myID = ThreadPool::getTID();
 
           if (finegrained) {
@@ -87,8 +93,11 @@ pageInSpecified(
   char* ptr = static_cast<char*>(_ptr);
 
   if (numThreads > 1) {
+    // As in pageIn, missing threads just leave their pages to fault in later
+    ThreadPool::StartGuard start_guard;
     GetThreadPool().run(
-        numThreads, [ptr, pageSize, threadRanges, elementSize]() {
+        std::min(numThreads, GetThreadPool().getMaxUsableThreads()),
+        [ptr, pageSize, threadRanges, elementSize]() {
           auto myID = ThreadPool::getTID();
 
           uint64_t beginLocation = threadRanges[myID];
@@ -113,8 +122,8 @@ pageInSpecified(
             // memset(ptr + beginByte, 0, (endByte - beginByte +
             // 1));
 
-            uint32_t beginPage = beginByte / pageSize;
-            uint32_t endPage = endByte / pageSize;
+            size_t beginPage = beginByte / pageSize;
+            size_t endPage = endByte / pageSize;
 
             KATANA_LOG_DEBUG_ASSERT(beginPage <= endPage);
 
@@ -123,7 +132,7 @@ pageInSpecified(
             //        beginPage, endPage);
 
             // write a byte to every page this thread occupies
-            for (uint32_t i = beginPage; i <= endPage; i++) {
+            for (size_t i = beginPage; i <= endPage; i++) {
               ptr[i * pageSize] = 0;
             }
           }
@@ -155,11 +164,38 @@ roundup(size_t data, size_t mult) {
   return data + (mult - rem);
 }
 
+// Round bytes up to a multiple of the pages it gets and map it; kind is set
+// to the pages backing the allocation, whose size is the granularity at which
+// threads can page in their parts
+static void*
+allocLarge(size_t* bytes, bool preFault, PageKind* kind) {
+  void* data = nullptr;
+  size_t gigantic_bytes = roundup(*bytes, allocSizeFor(*bytes));
+  if (gigantic_bytes % pageKindSize(PageKind::kGigantic) == 0) {
+    data = allocGiganticPages(gigantic_bytes / allocSize(), preFault);
+  }
+  if (data) {
+    *bytes = gigantic_bytes;
+    *kind = PageKind::kGigantic;
+  } else {
+    // Smaller pages only need the size rounded to allocSize()
+    *bytes = roundup(*bytes, allocSize());
+    data = allocPages(*bytes / allocSize(), preFault, kind);
+  }
+  if (data) {
+    KATANA_LOG_DEBUG(
+        "large alloc of {} bytes on {} pages", *bytes, pageKindName(*kind));
+    if (internal::sysStatManager()) {
+      ReportStatSum(
+          "PageAlloc", std::string("LargeAllocBytes") + pageKindName(*kind),
+          *bytes);
+    }
+  }
+  return data;
+}
+
 LAptr
 katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
-
 #ifdef KATANA_USE_NUMA
   // We don't use numa_alloc_interleaved_subset because we really want huge
   // pages
@@ -167,43 +203,41 @@ katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
   // the alloc would go
 #endif
   // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  PageKind kind;
+  void* data = allocLarge(&bytes, false, &kind);
 
   // Then page in based on thread number
   if (data)
     // true = round robin paging
-    pageIn(data, bytes, allocSize(), numThreads, true);
+    ::pageIn(data, bytes, pageKindSize(kind), numThreads, true);
 
   return LAptr{data, internal::largeFreer{bytes}};
 }
 
 LAptr
 katana::largeMallocLocal(size_t bytes) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
   // Get a prefaulted allocation
-  return LAptr{
-      allocPages(bytes / allocSize(), true), internal::largeFreer{bytes}};
+  PageKind kind;
+  void* data = allocLarge(&bytes, true, &kind);
+  return LAptr{data, internal::largeFreer{bytes}};
 }
 
 LAptr
 katana::largeMallocFloating(size_t bytes) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
-  return LAptr{
-      allocPages(bytes / allocSize(), false), internal::largeFreer{bytes}};
+  PageKind kind;
+  void* data = allocLarge(&bytes, false, &kind);
+  return LAptr{data, internal::largeFreer{bytes}};
 }
 
 LAptr
 katana::largeMallocBlocked(size_t bytes, unsigned numThreads) {
-  // round up to hugePageSize
-  bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  PageKind kind;
+  void* data = allocLarge(&bytes, false, &kind);
   if (data)
     // false = blocked paging
-    pageIn(data, bytes, allocSize(), numThreads, false);
+    ::pageIn(data, bytes, pageKindSize(kind), numThreads, false);
   return LAptr{data, internal::largeFreer{bytes}};
 }
 
@@ -225,15 +259,14 @@ KATANA_EXPORT LAptr
 katana::largeMallocSpecified(
     size_t bytes, uint32_t numThreads, RangeArrayTy& threadRanges,
     size_t elementSize) {
-  // ceiling to nearest page
-  bytes = roundup(bytes, allocSize());
-
-  void* data = allocPages(bytes / allocSize(), false);
+  PageKind kind;
+  void* data = allocLarge(&bytes, false, &kind);
 
   // NUMA aware page in based on element distribution specified in threadRanges
   if (data)
     pageInSpecified(
-        data, bytes, allocSize(), numThreads, threadRanges, elementSize);
+        data, bytes, pageKindSize(kind), numThreads, threadRanges,
+        elementSize);
 
   return LAptr{data, internal::largeFreer{bytes}};
 }
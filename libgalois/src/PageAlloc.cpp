@@ -19,59 +19,187 @@
 
 #include "katana/PageAlloc.h"
 
-#include <mutex>
+#include <unistd.h>
 
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "katana/Env.h"
 #include "katana/Logging.h"
-#include "katana/SimpleLock.h"
 
 #ifdef __linux__
 #include <linux/mman.h>
 #endif
 #include <sys/mman.h>
 
-// figure this out dynamically
+namespace {
+
 const size_t hugePageSize = 2 * 1024 * 1024;
-// protect mmap, munmap since linux has issues
-static katana::SimpleLock allocLock;
+const size_t giganticPageSize = 1024 * 1024 * 1024;
 
 // mmap flags
 #if defined(MAP_ANONYMOUS)
-static const int _MAP_ANON = MAP_ANONYMOUS;
+const int _MAP_ANON = MAP_ANONYMOUS;
 #elif defined(MAP_ANON)
-static const int _MAP_ANON = MAP_ANON;
+const int _MAP_ANON = MAP_ANON;
 #else
 static_assert(false, "No Anonymous mapping");
 #endif
 
-static const int _MAP = _MAP_ANON | MAP_PRIVATE;
+const int _MAP = _MAP_ANON | MAP_PRIVATE;
 #ifdef MAP_POPULATE
-static const int _MAP_POP = MAP_POPULATE | _MAP;
-static const bool doHandMap = false;
+const int _MAP_POP = MAP_POPULATE | _MAP;
+const bool doHandMap = false;
 #else
-static const int _MAP_POP = _MAP;
-static const bool doHandMap = true;
+const int _MAP_POP = _MAP;
+const bool doHandMap = true;
 #endif
 #ifdef MAP_HUGETLB
-static const int _MAP_HUGE_POP = MAP_HUGETLB | _MAP_POP;
-static const int _MAP_HUGE = MAP_HUGETLB | _MAP;
+const int _MAP_HUGE_POP = MAP_HUGETLB | _MAP_POP;
+const int _MAP_HUGE = MAP_HUGETLB | _MAP;
+#else
+const int _MAP_HUGE_POP = _MAP_POP;
+const int _MAP_HUGE = _MAP;
+#endif
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_1GB)
+const bool haveGiganticPages = true;
+const int _MAP_GIGANTIC_POP = MAP_HUGE_1GB | _MAP_HUGE_POP;
+const int _MAP_GIGANTIC = MAP_HUGE_1GB | _MAP_HUGE;
 #else
-static const int _MAP_HUGE_POP = _MAP_POP;
-static const int _MAP_HUGE = _MAP;
+const bool haveGiganticPages = false;
+const int _MAP_GIGANTIC_POP = _MAP_HUGE_POP;
+const int _MAP_GIGANTIC = _MAP_HUGE;
 #endif
 
+// Whether transparent huge pages are enabled at all; they are unless the
+// kernel lacks them or the administrator set them to "never"
+bool
+TransparentHugePagesEnabled() {
+  std::ifstream enabled("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string line;
+  if (!std::getline(enabled, line)) {
+    return false;
+  }
+  return line.find("[never]") == std::string::npos;
+}
+
+katana::PageAllocConfig&
+GetPageConfig() {
+  static katana::PageAllocConfig config = []() {
+    katana::PageAllocConfig ret;
+    std::string mode;
+    if (katana::GetEnv("KATANA_HUGE_PAGES", &mode)) {
+      if (mode == "thp") {
+        ret.huge_tlb = false;
+      } else if (mode == "none") {
+        ret.huge_tlb = false;
+        ret.transparent = false;
+      } else if (mode != "hugetlb") {
+        KATANA_LOG_WARN(
+            "ignoring KATANA_HUGE_PAGES={}, expected hugetlb, thp or none",
+            mode);
+      }
+    }
+    ret.transparent = ret.transparent && TransparentHugePagesEnabled();
+
+    int min_gb = 0;
+    if (haveGiganticPages &&
+        katana::GetEnv("KATANA_GIGANTIC_PAGES_MIN_GB", &min_gb) && min_gb > 0 &&
+        ret.huge_tlb) {
+      ret.gigantic_min_bytes = static_cast<size_t>(min_gb) * giganticPageSize;
+    }
+    return ret;
+  }();
+  return config;
+}
+
+size_t
+SmallPageSize() {
+  static size_t size = sysconf(_SC_PAGESIZE);
+  return size;
+}
+
+bool
+UseGiganticPages(size_t bytes) {
+  size_t min_bytes = GetPageConfig().gigantic_min_bytes;
+  return min_bytes != 0 && bytes >= min_bytes;
+}
+
+}  // namespace
+
+katana::PageAllocConfig
+katana::getPageAllocConfig() {
+  return GetPageConfig();
+}
+
+void
+katana::setPageAllocConfig(const PageAllocConfig& config) {
+  PageAllocConfig& current = GetPageConfig();
+  current = config;
+  if (!haveGiganticPages) {
+    current.gigantic_min_bytes = 0;
+  }
+}
+
+size_t
+katana::pageKindSize(PageKind kind) {
+  switch (kind) {
+  case PageKind::kSmall:
+    return SmallPageSize();
+  case PageKind::kTransparentHuge:
+  case PageKind::kHuge:
+    return hugePageSize;
+  case PageKind::kGigantic:
+    return giganticPageSize;
+  }
+  KATANA_LOG_FATAL("unknown page kind: {}", static_cast<int>(kind));
+}
+
+const char*
+katana::pageKindName(PageKind kind) {
+  switch (kind) {
+  case PageKind::kSmall:
+    return "Small";
+  case PageKind::kTransparentHuge:
+    return "TransparentHuge";
+  case PageKind::kHuge:
+    return "Huge";
+  case PageKind::kGigantic:
+    return "Gigantic";
+  }
+  KATANA_LOG_FATAL("unknown page kind: {}", static_cast<int>(kind));
+}
+
 size_t
 katana::allocSize() {
   return hugePageSize;
 }
 
+size_t
+katana::allocSizeFor(size_t bytes) {
+  return UseGiganticPages(bytes) ? giganticPageSize : hugePageSize;
+}
+
 #ifdef KATANA_USE_JEMALLOC
 
 void*
-katana::allocPages(unsigned num, [[maybe_unused]] bool preFault) {
+katana::allocGiganticPages(
+    [[maybe_unused]] unsigned num, [[maybe_unused]] bool preFault) {
+  return nullptr;
+}
+
+void*
+katana::allocPages(
+    unsigned num, [[maybe_unused]] bool preFault, PageKind* kind) {
   if (num == 0) {
     return nullptr;
   }
   KATANA_DEBUG_WARN_ONCE("not using huge pages due to jemalloc");
+  if (kind) {
+    *kind = PageKind::kSmall;
+  }
   return malloc(num * hugePageSize);
 }
 
@@ -82,9 +210,12 @@ katana::freePages(void* ptr, [[maybe_unused]] unsigned num) {
 
 #else
 
-static void*
-trymmap(size_t size, int flag) {
-  std::lock_guard<katana::SimpleLock> lg(allocLock);
+namespace {
+
+// mmap and munmap are thread safe, so mapping needs no lock of our own
+
+void*
+TryMmap(size_t size, int flag) {
   const int _PROT = PROT_READ | PROT_WRITE;
   void* ptr = mmap(0, size, _PROT, flag, -1, 0);
   if (ptr == MAP_FAILED) {
@@ -93,37 +224,119 @@ trymmap(size_t size, int flag) {
   return ptr;
 }
 
+void
+Unmap(void* ptr, size_t size) {
+  if (munmap(ptr, size) != 0) {
+    KATANA_LOG_FATAL("munmap failed: {}", errno);
+  }
+}
+
+// Maps size bytes of regular pages at a hugePageSize aligned address and asks
+// the kernel to back the region with transparent huge pages, which it only
+// does for aligned 2MB ranges
 void*
-katana::allocPages(unsigned num, bool preFault) {
-  if (num == 0) {
+MapTransparentHuge(size_t size) {
+  size_t padded = size + hugePageSize;
+  char* raw = static_cast<char*>(TryMmap(padded, _MAP));
+  if (!raw) {
     return nullptr;
   }
 
-  void* ptr = trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+  uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+  char* aligned = raw + ((hugePageSize - addr % hugePageSize) % hugePageSize);
+  size_t head = aligned - raw;
+  size_t tail = padded - head - size;
+  if (head) {
+    Unmap(raw, head);
+  }
+  if (tail) {
+    Unmap(aligned + size, tail);
+  }
+
+  if (madvise(aligned, size, MADV_HUGEPAGE) != 0) {
+    KATANA_DEBUG_WARN_ONCE("madvise(MADV_HUGEPAGE) failed: {}", errno);
+  }
+  return aligned;
+}
+
+void
+PreFault(void* ptr, size_t size) {
+  size_t page_size = SmallPageSize();
+  for (size_t x = 0; x < size; x += page_size) {
+    static_cast<char*>(ptr)[x] = 0;
+  }
+}
+
+}  // namespace
+
+void*
+katana::allocGiganticPages(unsigned num, bool preFault) {
+  size_t size = num * hugePageSize;
+  // munmap of 1GB pages needs a multiple of 1GB, see allocSizeFor
+  if (num == 0 || !UseGiganticPages(size) || size % giganticPageSize != 0) {
+    return nullptr;
+  }
+  void* ptr = TryMmap(size, preFault ? _MAP_GIGANTIC_POP : _MAP_GIGANTIC);
   if (!ptr) {
     KATANA_DEBUG_WARN_ONCE(
-        "huge page alloc failed, falling back to regular pages");
-    ptr = trymmap(num * hugePageSize, preFault ? _MAP_POP : _MAP);
+        "1GB page alloc failed, falling back to smaller pages");
+  }
+  return ptr;
+}
+
+void*
+katana::allocPages(unsigned num, bool preFault, PageKind* kind) {
+  if (num == 0) {
+    return nullptr;
+  }
+
+  const PageAllocConfig& config = GetPageConfig();
+  size_t size = num * hugePageSize;
+  void* ptr = nullptr;
+  PageKind got = PageKind::kSmall;
+
+  ptr = allocGiganticPages(num, preFault);
+  got = PageKind::kGigantic;
+
+  if (!ptr && config.huge_tlb) {
+    ptr = TryMmap(size, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+    got = PageKind::kHuge;
+    if (!ptr) {
+      KATANA_DEBUG_WARN_ONCE(
+          "huge page alloc failed, falling back to transparent huge pages");
+    }
+  }
+
+  if (!ptr && config.transparent) {
+    ptr = MapTransparentHuge(size);
+    got = PageKind::kTransparentHuge;
+    // MAP_POPULATE would also fault in the padding, so fault in by hand
+    if (ptr && preFault) {
+      PreFault(ptr, size);
+    }
+  }
+
+  if (!ptr) {
+    ptr = TryMmap(size, preFault ? _MAP_POP : _MAP);
+    got = PageKind::kSmall;
   }
 
   if (!ptr) {
     KATANA_LOG_FATAL("failed to allocate: {}", errno);
   }
 
-  if (preFault && doHandMap) {
-    for (size_t x = 0; x < num * hugePageSize; x += 4096) {
-      static_cast<char*>(ptr)[x] = 0;
-    }
+  if (preFault && doHandMap && got != PageKind::kTransparentHuge) {
+    PreFault(ptr, size);
   }
 
+  if (kind) {
+    *kind = got;
+  }
   return ptr;
 }
 
 void
 katana::freePages(void* ptr, unsigned num) {
-  std::lock_guard<SimpleLock> lg(allocLock);
-  if (munmap(ptr, num * hugePageSize) != 0) {
-    KATANA_LOG_FATAL("munmap failed: {}", errno);
-  }
+  Unmap(ptr, num * hugePageSize);
 }
 #endif
@@ -1,12 +1,56 @@
 #include "katana/PropertyManager.h"
 
+#include <filesystem>
+#include <system_error>
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+
 #include "katana/ArrowInterchange.h"
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/MemorySupervisor.h"
 #include "katana/ProgressTracer.h"
+#include "katana/Random.h"
 
 const std::string katana::PropertyManager::name_ = "property";
 
+namespace {
+
+// Enough that concurrent lookups from several graphs rarely contend
+constexpr size_t kPropertyCacheShards = 16;
+
+katana::Result<void>
+WriteIpcFile(const std::string& path, const arrow::Table& table) {
+  auto out = KATANA_CHECKED(arrow::io::FileOutputStream::Open(path));
+  auto writer =
+      KATANA_CHECKED(arrow::ipc::MakeFileWriter(out, table.schema()));
+  KATANA_CHECKED(writer->WriteTable(table));
+  KATANA_CHECKED(writer->Close());
+  KATANA_CHECKED(out->Close());
+  return katana::ResultSuccess();
+}
+
+/// Read a table from an IPC file without copying: its buffers point into a
+/// read only mapping of the file
+katana::Result<std::shared_ptr<arrow::Table>>
+MapIpcFile(const std::string& path) {
+  auto file = KATANA_CHECKED(
+      arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ));
+  auto reader =
+      KATANA_CHECKED(arrow::ipc::RecordBatchFileReader::Open(file));
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0, n = reader->num_record_batches(); i < n; ++i) {
+    batches.emplace_back(KATANA_CHECKED(reader->ReadRecordBatch(i)));
+  }
+  return KATANA_CHECKED(
+      arrow::Table::FromRecordBatches(reader->schema(), batches));
+}
+
+}  // namespace
+
 // Anchor manager vtable
 katana::Manager::~Manager() = default;
 
@@ -18,11 +62,185 @@ katana::PropertyManager::MakePropertyCache() {
   cache_ = std::make_unique<katana::PropertyCache>(
       [](const std::shared_ptr<arrow::Table>& table) {
         return ApproxTableMemUse(table);
+      },
+      katana::CacheOptions{
+          .num_shards = kPropertyCacheShards,
+          .admission = katana::CacheAdmission::kFrequency,
+      });
+}
+
+katana::PropertyManager::PropertyManager() {
+  MakePropertyCache();
+
+  std::string spill_dir;
+  if (katana::GetEnv("KATANA_PROPERTY_SPILL_DIR", &spill_dir) &&
+      !spill_dir.empty()) {
+    if (auto res = EnableSpilling(spill_dir); !res) {
+      KATANA_LOG_WARN(
+          "cannot spill properties to {}: {}", spill_dir, res.error());
+    }
+  }
+}
+katana::PropertyManager::~PropertyManager() {
+  DisableSpilling();
+  cache_.reset();
+}
+
+katana::Result<void>
+katana::PropertyManager::EnableSpilling(
+    const std::string& dir, count_t max_bytes) {
+  if (std::error_code err;
+      !std::filesystem::create_directories(dir, err) && err) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "creating {}: {}", dir,
+        err.message());
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  spill_dir_ = dir;
+  max_spill_bytes_ = max_bytes;
+  return katana::ResultSuccess();
+}
+
+void
+katana::PropertyManager::DisableSpilling() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& [path, file] : spilled_) {
+    std::error_code err;
+    std::filesystem::remove(file.path, err);
+  }
+  spilled_.clear();
+  spill_order_.clear();
+  spill_bytes_ = 0;
+  spill_dir_.clear();
+}
+
+bool
+katana::PropertyManager::IsSpilling() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !spill_dir_.empty();
+}
+
+katana::PropertyManager::Stats
+katana::PropertyManager::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats;
+}
+
+// Called with mutex_ held
+void
+katana::PropertyManager::RemoveSpillFile(const katana::URI& property_path) {
+  auto it = spilled_.find(property_path);
+  if (it == spilled_.end()) {
+    return;
+  }
+  std::error_code err;
+  std::filesystem::remove(it->second.path, err);
+  if (!it->second.writing) {
+    spill_bytes_ -= it->second.bytes;
+    spill_order_.remove(property_path);
+  }
+  spilled_.erase(it);
+}
+
+void
+katana::PropertyManager::SpillProperty(
+    const katana::URI& property_path,
+    const std::shared_ptr<arrow::Table>& property) {
+  auto bytes = static_cast<count_t>(katana::ApproxTableMemUse(property));
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Properties are immutable once stored, so an existing spill file is
+    // still good
+    if (spill_dir_.empty() || spilled_.count(property_path) > 0 ||
+        bytes > max_spill_bytes_) {
+      return;
+    }
+    path = fmt::format(
+        "{}/{}.arrow", spill_dir_, katana::RandomAlphanumericString(16));
+    // Claim the property so that nobody else spills it or maps the file
+    // before it is written
+    spilled_[property_path] =
+        SpillFile{.path = path, .bytes = bytes, .writing = true};
+  }
+
+  // Write without holding the lock so that lookups of other properties and
+  // stats do not wait for the disk
+  auto res = WriteIpcFile(path, *property);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = spilled_.find(property_path);
+  // DisableSpilling may have dropped the claim while we were writing
+  bool claimed = it != spilled_.end() && it->second.path == path;
+  if (!res || !claimed) {
+    if (!res) {
+      KATANA_LOG_WARN("spilling {}: {}", property_path, res.error());
+    }
+    std::error_code err;
+    std::filesystem::remove(path, err);
+    if (claimed) {
+      spilled_.erase(it);
+    }
+    return;
+  }
+  it->second.writing = false;
+  spill_order_.emplace_back(property_path);
+  spill_bytes_ += bytes;
+  stats.bytes_spilled += bytes;
+  stats.spill_count++;
+
+  while (spill_bytes_ > max_spill_bytes_) {
+    RemoveSpillFile(spill_order_.front());
+  }
+
+  katana::GetTracer().GetActiveSpan().Log(
+      "property spill",
+      {
+          {"storage_name", property_path.BaseName()},
+          {"approx_size_gb", ToGB(bytes)},
+          {"spill_gb", ToGB(spill_bytes_)},
       });
 }
 
-katana::PropertyManager::PropertyManager() { MakePropertyCache(); }
-katana::PropertyManager::~PropertyManager() { cache_.reset(); }
+std::shared_ptr<arrow::Table>
+katana::PropertyManager::UnspillProperty(const katana::URI& property_path) {
+  SpillFile file;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = spilled_.find(property_path);
+    // A file still being written is not complete; the caller loads the
+    // property from storage instead
+    if (it == spilled_.end() || it->second.writing) {
+      return nullptr;
+    }
+    file = it->second;
+  }
+
+  // Map without holding the lock, like SpillProperty writes
+  auto table_res = MapIpcFile(file.path);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!table_res) {
+    // The file may have been deleted to make room for others meanwhile,
+    // which is not worth a warning
+    auto it = spilled_.find(property_path);
+    if (it != spilled_.end() && it->second.path == file.path) {
+      KATANA_LOG_WARN(
+          "mapping spilled {}: {}", property_path, table_res.error());
+      RemoveSpillFile(property_path);
+    }
+    return nullptr;
+  }
+  stats.bytes_unspilled += file.bytes;
+  stats.unspill_count++;
+  katana::GetTracer().GetActiveSpan().Log(
+      "property unspill",
+      {
+          {"storage_name", property_path.BaseName()},
+          {"approx_size_gb", ToGB(file.bytes)},
+      });
+  return std::move(table_res.value());
+}
 
 std::shared_ptr<arrow::Table>
 katana::PropertyManager::GetProperty(const katana::URI& property_path) {
@@ -41,6 +259,9 @@ katana::PropertyManager::GetProperty(const katana::URI& property_path) {
     return property.value();
   }
   MemorySupervisor::Get().CheckPressure();
+  if (auto spilled = UnspillProperty(property_path); spilled) {
+    return spilled;
+  }
   katana::GetTracer().GetActiveSpan().Log(
       "property cache get not found",
       {
@@ -52,10 +273,15 @@ katana::PropertyManager::GetProperty(const katana::URI& property_path) {
 
 void
 katana::PropertyManager::PropertyLoadedActive(
+    const katana::URI& property_path,
     const std::shared_ptr<arrow::Table>& property) {
   KATANA_LOG_DEBUG_ASSERT(property);
   auto sz = katana::ApproxTableMemUse(property);
-  stats.bytes_loaded += sz;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.bytes_loaded += sz;
+  }
+  cache_->AddMissBytes(property_path, sz);
   katana::GetTracer().GetActiveSpan().Log(
       "property cache loaded active", {
                                           {"name", property->field(0)->name()},
@@ -68,7 +294,17 @@ katana::PropertyManager::PutProperty(
     const katana::URI& property_path,
     const std::shared_ptr<arrow::Table>& property) {
   auto bytes = static_cast<count_t>(katana::ApproxTableMemUse(property));
-  cache_->Insert(property_path, property);
+  cache_->set_capacity(MemorySupervisor::Get().StandbyBudget(Name()));
+  if (!cache_->Insert(property_path, property)) {
+    katana::GetTracer().GetActiveSpan().Log(
+        "property cache insert rejected",
+        {
+            {"storage_name", property_path.BaseName()},
+            {"approx_size_gb", ToGB(bytes)},
+        });
+    SpillProperty(property_path, property);
+    return;
+  }
   katana::GetTracer().GetActiveSpan().Log(
       "property cache insert",
       {
@@ -87,7 +323,12 @@ katana::PropertyManager::FreeStandbyMemory(count_t goal) {
                     {"cache_gb", ToGB(cache_->size())},
                 });
 
-  auto reclaim = static_cast<count_t>(cache_->Reclaim(goal));
+  auto reclaim = static_cast<count_t>(cache_->Reclaim(
+      goal, [this](
+                const katana::URI& property_path,
+                std::shared_ptr<arrow::Table>&& property) {
+        SpillProperty(property_path, property);
+      }));
   MemorySupervisor::Get().PutStandby(Name(), reclaim);
 
   scope.span().Log(
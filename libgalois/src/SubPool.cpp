@@ -0,0 +1,57 @@
+#include "katana/SubPool.h"
+
+#include <exception>
+
+#include "katana/Logging.h"
+
+katana::Result<std::unique_ptr<katana::SubPool>>
+katana::SubPool::Make(unsigned num_threads) {
+  auto& tp = GetThreadPool();
+  std::unique_ptr<SubPool> sub_pool(new SubPool());
+  sub_pool->region_ = tp.leaseRegion(num_threads, sub_pool.get());
+  if (!sub_pool->region_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "cannot lease {} contiguous free threads from a pool of {}",
+        num_threads, tp.getPoolThreads());
+  }
+  sub_pool->active_threads_ = num_threads;
+  // Initialized for the sub-pool by the first GetBarrier in it
+  sub_pool->barrier_ = CreateTopoBarrier(num_threads);
+  sub_pool->term_ = internal::CreateTerminationDetection();
+  return std::unique_ptr<SubPool>(std::move(sub_pool));
+}
+
+katana::SubPool::~SubPool() {
+  if (!region_) {
+    return;
+  }
+  // Threads that busy wait for the sub-pool would not notice wakeups from
+  // the whole pool
+  Run([]() { GetThreadPool().beKind(); });
+  GetThreadPool().releaseRegion(std::move(region_));
+}
+
+void
+katana::SubPool::Run(const std::function<void()>& fn) {
+  KATANA_LOG_VASSERT(
+      !running_.exchange(true), "Concurrent runs of the same SubPool");
+  std::exception_ptr error;
+  auto job = [&fn, &error]() {
+    try {
+      fn();
+    } catch (...) {
+      error = std::current_exception();
+    }
+  };
+  GetThreadPool().runRegionMaster(*region_, ThreadPool::WorkRef::of(job));
+  running_ = false;
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+unsigned
+katana::SubPool::size() const {
+  return region_->mi.maxThreads;
+}
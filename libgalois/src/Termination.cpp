@@ -18,6 +18,7 @@
  */
 
 #include "katana/Logging.h"
+#include "katana/SubPool.h"
 #include "katana/TerminationDetection.h"
 
 // vtable anchoring
@@ -35,6 +36,10 @@ katana::internal::SetTerminationDetection(katana::TerminationDetection* t) {
 
 katana::TerminationDetection&
 katana::GetTerminationDetection(unsigned active_threads) {
-  kTerminationDetection->Init(active_threads);
-  return *kTerminationDetection;
+  TerminationDetection* term = kTerminationDetection;
+  if (SubPool* sub_pool = ThreadPool::getSubPool()) {
+    term = sub_pool->term_.get();
+  }
+  term->Init(active_threads);
+  return *term;
 }
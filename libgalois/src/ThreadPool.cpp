@@ -20,7 +20,15 @@
 #include "katana/ThreadPool.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "katana/Env.h"
 #include "katana/HWTopo.h"
@@ -38,11 +46,160 @@ using katana::ThreadPool;
 
 thread_local ThreadPool::per_signal ThreadPool::my_box;
 
+namespace {
+
+// Bounds on how long a worker spins (in asmPause iterations) waiting for
+// work before it parks in the kernel. Each wait that ends while spinning
+// doubles the spin for the next wait, each wait that has to park halves it,
+// so threads spin through the short gaps between back to back loops and
+// sleep through long ones.
+constexpr unsigned kMinSpin = 1 << 6;
+constexpr unsigned kInitialSpin = 1 << 10;
+constexpr unsigned kDefaultMaxSpin = 1 << 14;
+
+unsigned
+MaxSpin() {
+  static unsigned max_spin = []() {
+    int spin = 0;
+    if (katana::GetEnv("KATANA_THREAD_SPIN", &spin) && spin >= 0) {
+      return static_cast<unsigned>(spin);
+    }
+    return kDefaultMaxSpin;
+  }();
+  return max_spin;
+}
+
+uint64_t
+NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+#if defined(__linux__)
+template <typename T>
+void
+FutexWait(std::atomic<T>* addr, T expected) {
+  static_assert(sizeof(T) == sizeof(uint32_t));
+  syscall(
+      SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT_PRIVATE,
+      expected, nullptr, nullptr, 0);
+}
+
+template <typename T>
+void
+FutexWake(std::atomic<T>* addr) {
+  static_assert(sizeof(T) == sizeof(uint32_t));
+  syscall(
+      SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE_PRIVATE, 1,
+      nullptr, nullptr, 0);
+}
+#endif
+
+}  // namespace
+
+void
+ThreadPool::per_signal::wakeup(bool fastmode) {
+  if (fastmode) {
+    done = 0;
+    fastRelease = 1;
+    return;
+  }
+  done = 0;
+#if defined(__linux__)
+  wakeSeq.fetch_add(1, std::memory_order_seq_cst);
+  // Pairs with the store to parked in wait: either the waiter sees the new
+  // wakeSeq or we see that it parked
+  if (parked.load(std::memory_order_seq_cst)) {
+    FutexWake(&wakeSeq);
+  }
+#else
+  std::lock_guard<std::mutex> lg(m);
+  wakeSeq.fetch_add(1, std::memory_order_seq_cst);
+  if (parked.load(std::memory_order_relaxed)) {
+    cv.notify_one();
+  }
+#endif
+}
+
+void
+ThreadPool::per_signal::wait(bool fastmode) {
+  if (fastmode) {
+    while (!fastRelease.load(std::memory_order_relaxed)) {
+      asmPause();
+    }
+    fastRelease = 0;
+    return;
+  }
+
+  if (!spinLimit) {
+    spinLimit = std::min(kInitialSpin, MaxSpin());
+  }
+
+  for (unsigned i = 0; i < spinLimit; ++i) {
+    if (wakeSeq.load(std::memory_order_acquire) != seenSeq) {
+      seenSeq = wakeSeq.load(std::memory_order_relaxed);
+      spinLimit = std::min(spinLimit * 2, MaxSpin());
+      return;
+    }
+    asmPause();
+  }
+
+  parked.store(1, std::memory_order_seq_cst);
+#if defined(__linux__)
+  while (wakeSeq.load(std::memory_order_seq_cst) == seenSeq) {
+    FutexWait(&wakeSeq, seenSeq);
+  }
+#else
+  {
+    std::unique_lock<std::mutex> lg(m);
+    cv.wait(lg, [this] {
+      return wakeSeq.load(std::memory_order_relaxed) != seenSeq;
+    });
+  }
+#endif
+  parked.store(0, std::memory_order_relaxed);
+  seenSeq = wakeSeq.load(std::memory_order_relaxed);
+  spinLimit = std::max(spinLimit / 2, std::min(kMinSpin, MaxSpin()));
+  ++parkedWakeups;
+}
+
+void
+ThreadPool::per_signal::finishJob() {
+#if defined(__linux__)
+  done.store(1, std::memory_order_seq_cst);
+  FutexWake(&done);
+#else
+  std::lock_guard<std::mutex> lg(m);
+  done = 1;
+  // The owner may be waiting on cv for its next wakeup as well
+  cv.notify_all();
+#endif
+}
+
+void
+ThreadPool::per_signal::waitJob() {
+  for (unsigned i = 0; i < MaxSpin(); ++i) {
+    if (done.load(std::memory_order_acquire)) {
+      return;
+    }
+    asmPause();
+  }
+#if defined(__linux__)
+  while (!done.load(std::memory_order_seq_cst)) {
+    FutexWait(&done, 0);
+  }
+#else
+  std::unique_lock<std::mutex> lg(m);
+  cv.wait(lg, [this] { return done.load(); });
+#endif
+}
+
 ThreadPool::ThreadPool()
-    : mi(getHWTopo().machineTopoInfo),
-      reserved(0),
-      masterFastmode(0),
-      running(false) {
+    : mi(getHWTopo().machineTopoInfo), reserved(0), wholeLimit(mi.maxThreads) {
+  whole.mi = mi;
+  whole.topo = getHWTopo().threadTopoInfo;
+  leased.resize(mi.maxThreads);
   signals.resize(mi.maxThreads);
   initThread(0);
 
@@ -60,10 +217,14 @@ ThreadPool::ThreadPool()
 }
 
 ThreadPool::~ThreadPool() {
+  KATANA_LOG_VASSERT(
+      std::none_of(leased.begin(), leased.end(), [](bool b) { return b; }),
+      "SubPools must be destroyed before the thread pool");
   destroyCommon();
   for (auto& t : threads) {
     t.join();
   }
+  my_box.region = nullptr;
 }
 
 void
@@ -74,26 +235,39 @@ ThreadPool::destroyCommon() {
 
 void
 ThreadPool::burnPower(unsigned num) {
+  StartGuard start_guard(*this);
   num = std::min(num, getMaxUsableThreads());
+  Region& r = region();
 
   // changing number of threads?  just do a reset
-  if (masterFastmode && masterFastmode != num) {
+  if (r.fastmode && r.fastmode != num) {
     beKind();
   }
-  if (!masterFastmode) {
+  if (!r.fastmode) {
     run(num, []() { throw fastmode_ty{true}; });
-    masterFastmode = num;
+    r.fastmode = num;
   }
 }
 
 void
 ThreadPool::beKind() {
-  if (masterFastmode) {
-    run(masterFastmode, []() { throw fastmode_ty{false}; });
-    masterFastmode = 0;
+  Region& r = region();
+  if (r.fastmode) {
+    run(r.fastmode, []() { throw fastmode_ty{false}; });
+    r.fastmode = 0;
   }
 }
 
+unsigned
+ThreadPool::getMaxUsableThreads() const {
+  const Region& r = region();
+  if (&r != &whole) {
+    return r.mi.maxThreads;
+  }
+  return std::min(
+      mi.maxThreads - reserved, wholeLimit.load(std::memory_order_relaxed));
+}
+
 // inefficient append
 template <typename T>
 static void
@@ -129,7 +303,10 @@ getNth(std::atomic<T*>& headptr, unsigned off) {
 void
 ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
-  my_box.topo = getHWTopo().threadTopoInfo[tid];
+  my_box.topo = whole.topo[tid];
+  my_box.poolID = tid;
+  my_box.region = &whole;
+  my_box.regionBase = 0;
   // Initialize
   initPTS(mi.maxThreads);
 
@@ -159,7 +336,26 @@ ThreadPool::threadLoop(unsigned tid) {
   auto& me = my_box;
   do {
     me.wait(fastmode);
+    Region& r = *me.region;
+    me.topo = r.topo[me.poolID - r.base];
+    me.regionBase = r.base;
+    uint64_t wake_ns = NowNs() - r.runStartNs.load(std::memory_order_relaxed);
+    ++me.wakeups;
+    me.wakeNs += wake_ns;
+    me.maxWakeNs = std::max(me.maxWakeNs, wake_ns);
+    if (me.job) {
+      // Master of a sub-pool; its own runs wake and join the other threads
+      try {
+        me.job();
+      } catch (...) {
+        abort();
+      }
+      me.job = WorkRef{};
+      me.finishJob();
+      continue;
+    }
     cascade(fastmode);
+    WorkRef work = r.work;
     try {
       work();
     } catch (const shutdown_ty&) {
@@ -187,12 +383,12 @@ ThreadPool::decascade() {
   // nothing to wake up
   if (me.wbegin != me.wend) {
     auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
-    auto& c1done = signals[me.wbegin]->done;
+    auto& c1done = signals[me.regionBase + me.wbegin]->done;
     while (!c1done) {
       asmPause();
     }
     if (midpoint < me.wend) {
-      auto& c2done = signals[midpoint]->done;
+      auto& c2done = signals[me.regionBase + midpoint]->done;
       while (!c2done) {
         asmPause();
       }
@@ -212,37 +408,55 @@ ThreadPool::cascade(bool fastmode) {
   }
 
   auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
+  Region* r = &region();
 
-  auto* child1 = signals[me.wbegin];
+  auto* child1 = signals[me.regionBase + me.wbegin];
   child1->wbegin = me.wbegin + 1;
   child1->wend = midpoint;
+  child1->region = r;
   child1->wakeup(fastmode);
 
   if (midpoint < me.wend) {
-    auto* child2 = signals[midpoint];
+    auto* child2 = signals[me.regionBase + midpoint];
     child2->wbegin = midpoint + 1;
     child2->wend = me.wend;
+    child2->region = r;
     child2->wakeup(fastmode);
   }
 }
 
 void
-ThreadPool::runInternal(unsigned num) {
+ThreadPool::runInternal(unsigned num, WorkRef work) {
   // sanitize num
   // seq write to starting should make work safe
-  KATANA_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
-  running = true;
+  Region& r = region();
+  KATANA_LOG_VASSERT(
+      !r.running, "Recursive thread pool execution not supported");
+  r.running = true;
+  // Sub-pools can't be leased until the run finishes
+  StartGuard guard(*this);
+  if (&r == &whole) {
+    unsigned limit = wholeLimit.load(std::memory_order_relaxed);
+    KATANA_LOG_VASSERT(
+        num <= limit,
+        "run on {} threads, but sub-pools leased all but {}; read the number "
+        "of threads under a ThreadPool::StartGuard",
+        num, limit);
+  }
   num = std::min(std::max(1U, num), getMaxUsableThreads());
+  r.work = work;
   // my_box is tid 0
   auto& me = my_box;
   me.wbegin = 1;
   me.wend = num;
 
   KATANA_LOG_VASSERT(
-      !masterFastmode || masterFastmode == num,
-      "fastmode threads {} != num threads {}", masterFastmode, num);
+      !r.fastmode || r.fastmode == num, "fastmode threads {} != num threads {}",
+      r.fastmode, num);
   // launch threads
-  cascade(masterFastmode);
+  r.runStartNs.store(NowNs(), std::memory_order_relaxed);
+  ++r.runs;
+  cascade(r.fastmode);
   // Do master thread work
   try {
     work();
@@ -251,10 +465,154 @@ ThreadPool::runInternal(unsigned num) {
   } catch (const fastmode_ty& fm) {
   }
   // wait for children
+  uint64_t join_start = NowNs();
   decascade();
+  r.joinNs += NowNs() - join_start;
   // Clean up
-  work = nullptr;
-  running = false;
+  r.work = WorkRef{};
+  r.running = false;
+}
+
+std::unique_ptr<ThreadPool::Region>
+ThreadPool::leaseRegion(unsigned num, SubPool* owner) {
+  KATANA_LOG_VASSERT(
+      &region() == &whole, "Sub-pools can only be made outside of sub-pools");
+  // Wait for loops of the whole pool that may use our threads to finish
+  std::unique_lock<std::shared_mutex> start(wholeStartLock);
+  std::lock_guard<std::mutex> lg(regionLock);
+
+  // Take the highest free threads so that the whole pool keeps a prefix of
+  // its threads, starting with the master thread 0
+  unsigned end = mi.maxThreads - reserved;
+  unsigned base = 0;
+  for (unsigned hi = end; num && hi >= num + 1; --hi) {
+    if (std::none_of(
+            leased.begin() + hi - num, leased.begin() + hi,
+            [](bool b) { return b; })) {
+      base = hi - num;
+      break;
+    }
+  }
+  if (!base) {
+    return nullptr;
+  }
+  std::fill(leased.begin() + base, leased.begin() + base + num, true);
+
+  unsigned limit = std::find(leased.begin() + 1, leased.end(), true) -
+                   leased.begin();
+  wholeLimit.store(limit, std::memory_order_relaxed);
+
+  auto r = std::make_unique<Region>();
+  r->base = base;
+  r->owner = owner;
+  r->topo.resize(num);
+  // Renumber sockets and numa nodes in order of appearance
+  std::vector<unsigned> sockets;
+  std::vector<unsigned> leaders;
+  std::vector<unsigned> numa_nodes;
+  auto dense = [](std::vector<unsigned>& ids, unsigned id) -> unsigned {
+    auto it = std::find(ids.begin(), ids.end(), id);
+    if (it == ids.end()) {
+      ids.push_back(id);
+      return ids.size() - 1;
+    }
+    return it - ids.begin();
+  };
+  unsigned max_socket = 0;
+  for (unsigned i = 0; i < num; ++i) {
+    ThreadTopoInfo t = whole.topo[base + i];
+    t.tid = i;
+    t.socket = dense(sockets, t.socket);
+    if (t.socket == leaders.size()) {
+      leaders.push_back(i);
+    }
+    t.socketLeader = leaders[t.socket];
+    t.numaNode = dense(numa_nodes, t.numaNode);
+    max_socket = std::max(max_socket, t.socket);
+    t.cumulativeMaxSocket = max_socket;
+    r->topo[i] = t;
+  }
+  r->mi.maxThreads = num;
+  r->mi.maxCores = std::max(1U, num * mi.maxCores / mi.maxThreads);
+  r->mi.maxSockets = sockets.size();
+  r->mi.maxNumaNodes = numa_nodes.size();
+  return r;
+}
+
+void
+ThreadPool::releaseRegion(std::unique_ptr<Region> r) {
+  // Running loops must not see the number of threads grow either
+  std::unique_lock<std::shared_mutex> start(wholeStartLock);
+  std::lock_guard<std::mutex> lg(regionLock);
+  KATANA_LOG_VASSERT(!r->running, "Can't release a sub-pool during a run");
+  std::fill(
+      leased.begin() + r->base, leased.begin() + r->base + r->mi.maxThreads,
+      false);
+  unsigned limit = std::find(leased.begin() + 1, leased.end(), true) -
+                   leased.begin();
+  wholeLimit.store(limit, std::memory_order_relaxed);
+}
+
+ThreadPool::StartGuard::StartGuard() : StartGuard(GetThreadPool()) {}
+
+ThreadPool::StartGuard::StartGuard(ThreadPool& pool) {
+  // Threads other than thread 0 only run loops inside of other loops or
+  // sub-pools
+  if (&pool.region() != &pool.whole || my_box.poolID != 0) {
+    return;
+  }
+  if (my_box.startDepth++ == 0) {
+    pool.wholeStartLock.lock_shared();
+  }
+  pool_ = &pool;
+}
+
+ThreadPool::StartGuard::~StartGuard() {
+  if (pool_ && --my_box.startDepth == 0) {
+    pool_->wholeStartLock.unlock_shared();
+  }
+}
+
+void
+ThreadPool::runRegionMaster(Region& r, WorkRef job) {
+  per_signal* master = signals[r.base];
+  master->region = &r;
+  master->job = job;
+  r.runStartNs.store(NowNs(), std::memory_order_relaxed);
+  // The master's done is only written by the master and us while it is
+  // leased, and it lives as long as the pool, so it is safe to wait on
+  master->wakeup(false);
+  master->waitJob();
+}
+
+ThreadPool::LatencyStats
+ThreadPool::getLatencyStats() const {
+  const Region& r = region();
+  LatencyStats stats{};
+  stats.runs = r.runs;
+  stats.joinNs = r.joinNs;
+  for (unsigned i = 0; i < r.mi.maxThreads; ++i) {
+    const per_signal* sig = signals[r.base + i];
+    stats.wakeups += sig->wakeups;
+    stats.parkedWakeups += sig->parkedWakeups;
+    stats.wakeNs += sig->wakeNs;
+    stats.maxWakeNs = std::max(stats.maxWakeNs, sig->maxWakeNs);
+  }
+  return stats;
+}
+
+void
+ThreadPool::resetLatencyStats() {
+  Region& r = region();
+  r.runs = 0;
+  r.joinNs = 0;
+  for (unsigned i = 0; i < r.mi.maxThreads; ++i) {
+    per_signal* sig = signals[r.base + i];
+    sig->wakeups = 0;
+    sig->parkedWakeups = 0;
+    sig->wakeNs = 0;
+    sig->maxWakeNs = 0;
+  }
 }
 
 void
@@ -263,20 +621,27 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   // thread but we don't want to depend on katana symbols and too many
   // clients access katana::activeThreads directly.
   KATANA_LOG_VASSERT(
-      !running, "Can't start dedicated thread during parallel section");
+      !whole.running, "Can't start dedicated thread during parallel section");
+  std::lock_guard<std::mutex> lg(regionLock);
   ++reserved;
 
   KATANA_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
-  work = [&f]() { throw dedicated_ty{f}; };
+  KATANA_LOG_VASSERT(
+      !leased[mi.maxThreads - reserved],
+      "Can't start dedicated thread on a thread of a sub-pool");
+  auto throw_dedicated = [&f]() { throw dedicated_ty{f}; };
+  whole.work = WorkRef::of(throw_dedicated);
+  whole.runStartNs.store(NowNs(), std::memory_order_relaxed);
   auto* child = signals[mi.maxThreads - reserved];
   child->wbegin = 0;
   child->wend = 0;
   child->done = 0;
-  child->wakeup(masterFastmode);
+  child->region = &whole;
+  child->wakeup(whole.fastmode);
   while (!child->done) {
     asmPause();
   }
-  work = nullptr;
+  whole.work = WorkRef{};
 }
 
 static katana::ThreadPool* TPOOL = nullptr;
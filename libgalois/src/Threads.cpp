@@ -21,6 +21,7 @@
 
 #include <algorithm>
 
+#include "katana/SubPool.h"
 #include "katana/ThreadPool.h"
 namespace katana {
 KATANA_EXPORT unsigned int activeThreads = 1;
@@ -34,11 +35,21 @@ katana::setActiveThreads(unsigned int num) noexcept {
   katana::GetThreadPool().beKind();
   num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
   num = std::max(num, 1U);
-  katana::activeThreads = num;
+  if (SubPool* sub_pool = ThreadPool::getSubPool()) {
+    sub_pool->active_threads_ = num;
+  } else {
+    katana::activeThreads = num;
+  }
   return num;
 }
 
 unsigned int
 katana::getActiveThreads() noexcept {
-  return katana::activeThreads;
+  if (SubPool* sub_pool = ThreadPool::getSubPool()) {
+    return sub_pool->active_threads_;
+  }
+  // Sub-pools leased after the last setActiveThreads() may have taken some
+  // of the threads of the whole pool
+  return std::min(
+      katana::activeThreads, katana::GetThreadPool().getMaxUsableThreads());
 }
@@ -0,0 +1,179 @@
+#include <climits>
+#include <limits>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Threads.h"
+
+namespace {
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long size : {64 * 1024, 1024 * 1024, 16 * 1024 * 1024}) {
+    // dense and sparse bitsets
+    for (long stride : {3, 1000}) {
+      b->Args({size, stride});
+    }
+  }
+}
+
+katana::DynamicBitset
+MakeBitset(long size, long stride, long first = 0) {
+  katana::DynamicBitset ret;
+  ret.resize(size);
+  ret.reset();
+  for (long i = first; i < size; i += stride) {
+    ret.set(i);
+  }
+  return ret;
+}
+
+void
+SetBytesProcessed(benchmark::State& state, long num_bitsets) {
+  state.SetBytesProcessed(
+      state.iterations() * num_bitsets * state.range(0) / CHAR_BIT);
+}
+
+void
+BitwiseOr(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1));
+  auto b = MakeBitset(state.range(0), state.range(1), 1);
+
+  for (auto _ : state) {
+    a.bitwise_or(b);
+  }
+
+  SetBytesProcessed(state, 2);
+}
+
+void
+BitwiseAndNot(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1));
+  auto b = MakeBitset(state.range(0), state.range(1), 1);
+
+  for (auto _ : state) {
+    a.bitwise_andnot(b);
+  }
+
+  SetBytesProcessed(state, 2);
+}
+
+void
+Count(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1));
+  size_t expected = a.SerialCount();
+
+  for (auto _ : state) {
+    KATANA_LOG_ASSERT(a.count() == expected);
+  }
+
+  SetBytesProcessed(state, 1);
+}
+
+void
+SerialCount(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.SerialCount());
+  }
+
+  SetBytesProcessed(state, 1);
+}
+
+void
+Equals(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1));
+  auto b = MakeBitset(state.range(0), state.range(1));
+
+  for (auto _ : state) {
+    KATANA_LOG_ASSERT(a == b);
+  }
+
+  SetBytesProcessed(state, 2);
+}
+
+/// Baseline for Equals: compare bit by bit
+void
+EqualsByBit(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1));
+  auto b = MakeBitset(state.range(0), state.range(1));
+
+  for (auto _ : state) {
+    bool equal = true;
+    for (size_t i = 0, size = a.size(); i < size && equal; ++i) {
+      equal = a.test(i) == b.test(i);
+    }
+    KATANA_LOG_ASSERT(equal);
+  }
+
+  SetBytesProcessed(state, 2);
+}
+
+void
+GetOffsets(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1));
+  size_t expected = a.SerialCount();
+
+  for (auto _ : state) {
+    KATANA_LOG_ASSERT(a.GetOffsets<uint32_t>().size() == expected);
+  }
+
+  SetBytesProcessed(state, 1);
+}
+
+void
+FindNextSet(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1));
+  size_t expected = a.SerialCount();
+
+  for (auto _ : state) {
+    size_t found = 0;
+    for (size_t i = a.FindNextSet(0); i < a.size(); i = a.FindNextSet(i + 1)) {
+      ++found;
+    }
+    KATANA_LOG_ASSERT(found == expected);
+  }
+
+  SetBytesProcessed(state, 1);
+}
+
+/// Baseline for FindNextSet: test every bit
+void
+TestEveryBit(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1));
+  size_t expected = a.SerialCount();
+
+  for (auto _ : state) {
+    size_t found = 0;
+    for (size_t i = 0, size = a.size(); i < size; ++i) {
+      found += a.test(i);
+    }
+    KATANA_LOG_ASSERT(found == expected);
+  }
+
+  SetBytesProcessed(state, 1);
+}
+
+BENCHMARK(BitwiseOr)->Apply(MakeArguments);
+BENCHMARK(BitwiseAndNot)->Apply(MakeArguments);
+BENCHMARK(Count)->Apply(MakeArguments);
+BENCHMARK(SerialCount)->Apply(MakeArguments);
+BENCHMARK(Equals)->Apply(MakeArguments);
+BENCHMARK(EqualsByBit)->Apply(MakeArguments);
+BENCHMARK(GetOffsets)->Apply(MakeArguments);
+BENCHMARK(FindNextSet)->Apply(MakeArguments);
+BENCHMARK(TestEveryBit)->Apply(MakeArguments);
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::GaloisRuntime G;
+  // Use every core for the parallel operations
+  katana::setActiveThreads(std::numeric_limits<unsigned>::max());
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -74,9 +74,37 @@ const TestCaseGenerator TestBitsetFive = []() {
   return test;
 };
 
+// several blocks of words for the parallel bulk operations, with runs of
+// empty words
+const TestCaseGenerator TestBitsetSix = []() {
+  katana::DynamicBitset test;
+  test.resize(1000003);
+  test.reset();
+
+  for (size_t i = 0; i < test.size(); i += (i / 1000) % 2 == 0 ? 7 : 1000) {
+    test.set(i);
+  }
+
+  return test;
+};
+
 const std::vector<TestCaseGenerator> test_case_generators = {
-    TestBitsetEmpty, TestBitsetOne,  TestBitsetTwo,
-    TestBitsetThree, TestBitsetFour, TestBitsetFive};
+    TestBitsetEmpty, TestBitsetOne,  TestBitsetTwo, TestBitsetThree,
+    TestBitsetFour,  TestBitsetFive, TestBitsetSix};
+
+/// Copies a bitset bit by bit
+katana::DynamicBitset
+Copy(const katana::DynamicBitset& bitset) {
+  katana::DynamicBitset copy;
+  copy.resize(bitset.size());
+  copy.reset();
+  for (size_t i = 0, size = bitset.size(); i < size; ++i) {
+    if (bitset.test(i)) {
+      copy.set(i);
+    }
+  }
+  return copy;
+}
 
 const Invariant NotAndCount =
     [](katana::DynamicBitset* test) -> katana::Result<void> {
@@ -133,7 +161,107 @@ const Invariant NotValues =
   return katana::ResultSuccess();
 };
 
-const std::vector<Invariant> invariants = {NotAndCount, NotValues};
+const Invariant IndicesMatchTest =
+    [](katana::DynamicBitset* test) -> katana::Result<void> {
+  std::vector<uint64_t> expected;
+  for (size_t i = 0, size = test->size(); i < size; ++i) {
+    if (test->test(i)) {
+      expected.push_back(i);
+    }
+  }
+
+  std::vector<uint64_t> offsets = test->GetOffsets<uint64_t>();
+  if (offsets != expected) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "GetOffsets returned {} offsets but {} bits are set", offsets.size(),
+        expected.size());
+  }
+
+  std::vector<uint64_t> iterated(test->begin(), test->end());
+  if (iterated != expected) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "iterating found {} set bits but {} bits are set", iterated.size(),
+        expected.size());
+  }
+
+  size_t found = 0;
+  for (size_t i = test->FindNextSet(0); i < test->size();
+       i = test->FindNextSet(i + 1)) {
+    if (found == expected.size() || i != expected[found]) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "FindNextSet found bit {} which is not the next set bit", i);
+    }
+    ++found;
+  }
+  if (found != expected.size() || test->count() != expected.size() ||
+      test->SerialCount() != expected.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "set bits: {}, found: {}, count: {}, serial count: {}",
+        expected.size(), found, test->count(), test->SerialCount());
+  }
+
+  return katana::ResultSuccess();
+};
+
+const Invariant BinaryOps =
+    [](katana::DynamicBitset* test) -> katana::Result<void> {
+  // every fifth bit, so that it overlaps test in some bits but not all
+  katana::DynamicBitset other;
+  other.resize(test->size());
+  other.reset();
+  for (size_t i = 0; i < other.size(); i += 5) {
+    other.set(i);
+  }
+
+  katana::DynamicBitset ored = Copy(*test);
+  ored.bitwise_or(other);
+  katana::DynamicBitset anded;
+  anded.resize(test->size());
+  anded.bitwise_and(*test, other);
+  katana::DynamicBitset xored = Copy(*test);
+  xored.bitwise_xor(other);
+  katana::DynamicBitset andnoted = Copy(*test);
+  andnoted.bitwise_andnot(other);
+
+  for (size_t i = 0, size = test->size(); i < size; ++i) {
+    bool a = test->test(i);
+    bool b = other.test(i);
+    if (ored.test(i) != (a || b) || anded.test(i) != (a && b) ||
+        xored.test(i) != (a != b) || andnoted.test(i) != (a && !b)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "binary operation computed the wrong value for bit {}", i);
+    }
+  }
+
+  katana::DynamicBitset copy = Copy(*test);
+  if (copy != *test) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed, "copy does not equal original");
+  }
+  if (test->size() > 0) {
+    size_t last = test->size() - 1;
+    if (copy.test(last)) {
+      copy.reset(last);
+    } else {
+      copy.set(last);
+    }
+    if (copy == *test) {
+      return KATANA_ERROR(
+          katana::ErrorCode::AssertionFailed,
+          "bitsets that differ in bit {} are equal", last);
+    }
+  }
+
+  return katana::ResultSuccess();
+};
+
+const std::vector<Invariant> invariants = {
+    NotAndCount, NotValues, IndicesMatchTest, BinaryOps};
 
 katana::Result<void>
 TestAll() {
@@ -97,6 +97,20 @@ t_doall(
   return t.get();
 }
 
+//! Average wakeup (or join) latency in ns of the loops of t_doall
+unsigned
+t_latency(bool join, std::vector<unsigned>& V, unsigned num, unsigned th) {
+  katana::setActiveThreads(th);
+  auto& pool = katana::GetThreadPool();
+  pool.resetLatencyStats();
+  for (unsigned x = 0; x < iter; ++x)
+    katana::do_all(katana::iterate(V.begin(), V.begin() + num), emp());
+  auto stats = pool.getLatencyStats();
+  if (join)
+    return stats.runs ? stats.joinNs / stats.runs : 0;
+  return stats.wakeups ? stats.wakeNs / stats.wakeups : 0;
+}
+
 unsigned
 t_foreach(bool burn, std::vector<unsigned>& V, unsigned num, unsigned th) {
   katana::setActiveThreads(th);
@@ -136,6 +150,7 @@ test(
 int
 main(int argc, char** argv) {
   using namespace std::placeholders;
+  katana::GaloisRuntime Katana_runtime;
 #pragma omp parallel for
   for (int x = 0; x < 100; ++x) {
   }
@@ -169,6 +184,12 @@ main(int argc, char** argv) {
       "doall N S", M, 16, maxVector,
       std::bind(t_doall, false, true, _1, _2, _3));
   test("foreach N", M, 16, maxVector, std::bind(t_foreach, false, _1, _2, _3));
+  test(
+      "doall wake ns", M, 16, maxVector,
+      std::bind(t_latency, false, _1, _2, _3));
+  test(
+      "doall join ns", M, 16, maxVector,
+      std::bind(t_latency, true, _1, _2, _3));
   test(
       "doall B W", M, 16, maxVector,
       std::bind(t_doall, true, false, _1, _2, _3));
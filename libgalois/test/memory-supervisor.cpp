@@ -0,0 +1,153 @@
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/MemoryPolicy.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/PropertyManager.h"
+#include "katana/URI.h"
+
+namespace {
+
+std::shared_ptr<arrow::Table>
+MakeProperty(const std::string& name, int64_t num_rows) {
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(i * i).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::int64())}), {array});
+}
+
+katana::URI
+MakeKey(const std::string& name) {
+  auto uri_res = katana::URI::Make("file:///property/" + name);
+  KATANA_LOG_ASSERT(uri_res);
+  return uri_res.value();
+}
+
+void
+TestSpill(const std::string& dir) {
+  auto& supervisor = katana::MemorySupervisor::Get();
+  // Only reclaim when we ask for it
+  supervisor.SetPolicy(std::make_unique<katana::MemoryPolicyNull>());
+  katana::PropertyManager* pm = supervisor.GetPropertyManager();
+  KATANA_LOG_ASSERT(pm);
+  KATANA_LOG_ASSERT(pm->EnableSpilling(dir));
+  KATANA_LOG_ASSERT(pm->IsSpilling());
+
+  auto property = MakeProperty("spilled", 1 << 16);
+  katana::URI key = MakeKey("spilled");
+  pm->PutProperty(key, property);
+  pm->FreeStandbyMemory(std::numeric_limits<katana::count_t>::max());
+  KATANA_LOG_ASSERT(pm->GetStats().spill_count == 1);
+  KATANA_LOG_ASSERT(!std::filesystem::is_empty(dir));
+
+  auto unspilled = pm->GetProperty(key);
+  KATANA_LOG_ASSERT(unspilled);
+  KATANA_LOG_ASSERT(unspilled->Equals(*property));
+  KATANA_LOG_ASSERT(pm->GetStats().unspill_count == 1);
+
+  // Spill files are reused when the property is reclaimed again
+  pm->PutProperty(key, unspilled);
+  pm->FreeStandbyMemory(std::numeric_limits<katana::count_t>::max());
+  KATANA_LOG_ASSERT(pm->GetStats().spill_count == 1);
+
+  KATANA_LOG_ASSERT(!pm->GetProperty(MakeKey("never-stored")));
+
+  pm->DisableSpilling();
+  KATANA_LOG_ASSERT(std::filesystem::is_empty(dir));
+  KATANA_LOG_ASSERT(!pm->GetProperty(key));
+}
+
+/// Threads that load, put and reclaim properties at the same time keep the
+/// standby accounting of the supervisor consistent
+void
+TestConcurrentLoads(const std::string& dir) {
+  constexpr int kThreads = 8;
+  constexpr int kRounds = 200;
+  constexpr int kKeysPerThread = 4;
+
+  auto& supervisor = katana::MemorySupervisor::Get();
+  supervisor.SetPolicy(std::make_unique<katana::MemoryPolicyNull>());
+  katana::PropertyManager* pm = supervisor.GetPropertyManager();
+  KATANA_LOG_ASSERT(pm->EnableSpilling(dir));
+  pm->FreeStandbyMemory(std::numeric_limits<katana::count_t>::max());
+  KATANA_LOG_ASSERT(supervisor.standby() == 0);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t, pm]() {
+      std::vector<std::shared_ptr<arrow::Table>> properties;
+      std::vector<katana::URI> keys;
+      for (int k = 0; k < kKeysPerThread; ++k) {
+        std::string name = fmt::format("concurrent-{}-{}", t, k);
+        properties.emplace_back(MakeProperty(name, 1000 * (k + 1)));
+        keys.emplace_back(MakeKey(name));
+      }
+      for (int r = 0; r < kRounds; ++r) {
+        int k = r % kKeysPerThread;
+        auto property = pm->GetProperty(keys[k]);
+        if (property) {
+          KATANA_LOG_ASSERT(property->Equals(*properties[k]));
+        } else {
+          // Loaded from storage
+          property = properties[k];
+          pm->PropertyLoadedActive(keys[k], property);
+        }
+        pm->PutProperty(keys[k], property);
+        if (r % 7 == t % 7) {
+          pm->FreeStandbyMemory(1 << 14);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  pm->FreeStandbyMemory(std::numeric_limits<katana::count_t>::max());
+  KATANA_LOG_ASSERT(supervisor.standby() == 0);
+  pm->DisableSpilling();
+}
+
+void
+TestCgroupPolicy() {
+  uint64_t limit = katana::MemorySupervisor::GetMemoryLimit();
+  KATANA_LOG_ASSERT(limit > 0);
+  KATANA_LOG_ASSERT(limit <= katana::MemorySupervisor::GetTotalSystemMemory());
+  if (auto cgroup_limit = katana::MemoryPolicy::CgroupMemoryLimitBytes();
+      cgroup_limit) {
+    KATANA_LOG_ASSERT(limit == cgroup_limit.value());
+  }
+
+  katana::MemoryPolicyCgroup policy;
+  // nothing is on standby, so there is nothing to reclaim
+  KATANA_LOG_ASSERT(policy.ReclaimForMemoryPressure(0) == 0);
+  katana::MemorySupervisor::Get().SetPolicy(
+      std::make_unique<katana::MemoryPolicyCgroup>());
+}
+
+}  // namespace
+
+int
+main() {
+  char dir_template[] = "/tmp/memory-supervisor-XXXXXX";
+  KATANA_LOG_ASSERT(mkdtemp(dir_template) != nullptr);
+  std::string dir(dir_template);
+
+  TestSpill(dir);
+  TestConcurrentLoads(dir);
+  TestCgroupPolicy();
+
+  std::filesystem::remove_all(dir);
+  return 0;
+}
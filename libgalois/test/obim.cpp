@@ -0,0 +1,160 @@
+#include <atomic>
+#include <limits>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max();
+
+struct Graph {
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> dests;
+  std::vector<uint32_t> weights;
+
+  uint32_t size() const { return offsets.size() - 1; }
+};
+
+Graph
+MakeRandomGraph(uint32_t num_nodes, uint32_t degree) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  std::uniform_int_distribution<uint32_t> weight(1, 100);
+
+  Graph g;
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    g.offsets.push_back(g.dests.size());
+    for (uint32_t i = 0; i < degree; ++i) {
+      g.dests.push_back(node(gen));
+      g.weights.push_back(weight(gen));
+    }
+  }
+  g.offsets.push_back(g.dests.size());
+  return g;
+}
+
+std::vector<uint32_t>
+SerialDistances(const Graph& g, uint32_t source) {
+  using Item = std::pair<uint32_t, uint32_t>;
+  std::vector<uint32_t> dist(g.size(), kInfinity);
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+  dist[source] = 0;
+  pq.emplace(0, source);
+  while (!pq.empty()) {
+    auto [d, n] = pq.top();
+    pq.pop();
+    if (d > dist[n]) {
+      continue;
+    }
+    for (uint32_t e = g.offsets[n]; e < g.offsets[n + 1]; ++e) {
+      uint32_t nd = d + g.weights[e];
+      if (nd < dist[g.dests[e]]) {
+        dist[g.dests[e]] = nd;
+        pq.emplace(nd, g.dests[e]);
+      }
+    }
+  }
+  return dist;
+}
+
+struct Request {
+  uint32_t node;
+  uint32_t dist;
+};
+
+struct RequestIndexer {
+  unsigned shift;
+  uint32_t operator()(const Request& r) const { return r.dist >> shift; }
+};
+
+/// Label correcting shortest paths give the same answer for any order, so
+/// compare against Dijkstra; a small shift creates thousands of levels
+template <typename WL>
+void
+TestDistances(const Graph& g, unsigned shift) {
+  std::vector<std::atomic<uint32_t>> dist(g.size());
+  for (auto& d : dist) {
+    d = kInfinity;
+  }
+  dist[0] = 0;
+
+  std::vector<Request> init{{0, 0}};
+  katana::for_each(
+      katana::iterate(init),
+      [&](const Request& r, auto& ctx) {
+        if (dist[r.node] < r.dist) {
+          return;
+        }
+        for (uint32_t e = g.offsets[r.node]; e < g.offsets[r.node + 1]; ++e) {
+          uint32_t nd = r.dist + g.weights[e];
+          uint32_t old = katana::atomicMin(dist[g.dests[e]], nd);
+          if (nd < old) {
+            ctx.push(Request{g.dests[e], nd});
+          }
+        }
+      },
+      katana::wl<WL>(RequestIndexer{shift}),
+      katana::disable_conflict_detection(), katana::loopname("ObimSSSP"));
+
+  std::vector<uint32_t> expected = SerialDistances(g, 0);
+  for (uint32_t n = 0; n < g.size(); ++n) {
+    KATANA_LOG_ASSERT(dist[n] == expected[n]);
+  }
+}
+
+/// Every pushed item is popped exactly once
+template <typename WL>
+void
+TestAllPopped(uint32_t num_items, uint32_t num_levels) {
+  std::vector<std::atomic<uint32_t>> seen(num_items);
+  for (auto& s : seen) {
+    s = 0;
+  }
+  katana::for_each(
+      katana::iterate(uint32_t{0}, num_items),
+      [&](uint32_t i, auto&) { seen[i] += 1; },
+      katana::wl<WL>(
+          [num_levels](uint32_t i) -> uint32_t { return i % num_levels; }),
+      katana::disable_conflict_detection(), katana::loopname("ObimAllPopped"));
+
+  for (uint32_t i = 0; i < num_items; ++i) {
+    KATANA_LOG_ASSERT(seen[i] == 1);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(8);
+
+  using Chunk = katana::ChunkFIFO<16>;
+  using PerSocketObim =
+      katana::PerSocketOrderedByIntegerMetric<RequestIndexer, Chunk>;
+  using BlockingPerSocketObim =
+      typename PerSocketObim::template with_block_period<4>::type;
+
+  Graph g = MakeRandomGraph(20000, 8);
+  TestDistances<PerSocketObim>(g, 0);
+  TestDistances<PerSocketObim>(g, 6);
+  TestDistances<BlockingPerSocketObim>(g, 2);
+
+  using AnyIndexer = std::function<uint32_t(uint32_t)>;
+  using AllObim = katana::PerSocketOrderedByIntegerMetric<
+      AnyIndexer, katana::ChunkFIFO<16>>;
+  TestAllPopped<AllObim>(100000, 1);
+  TestAllPopped<AllObim>(100000, 5000);
+  TestAllPopped<typename AllObim::template with_descending<true>::type>(
+      100000, 5000);
+
+  katana::setActiveThreads(1);
+  TestDistances<PerSocketObim>(g, 3);
+
+  return 0;
+}
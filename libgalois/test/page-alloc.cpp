@@ -0,0 +1,148 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NumaMem.h"
+#include "katana/PageAlloc.h"
+
+namespace {
+
+void
+CheckPages(void* ptr, unsigned num, katana::PageKind kind) {
+  KATANA_LOG_ASSERT(ptr);
+  size_t alignment = kind == katana::PageKind::kSmall
+                         ? katana::pageKindSize(kind)
+                         : katana::allocSize();
+  KATANA_LOG_VASSERT(
+      reinterpret_cast<uintptr_t>(ptr) % alignment == 0, "{} pages at {}",
+      katana::pageKindName(kind), ptr);
+  // Every byte is usable
+  std::memset(ptr, 1, num * katana::allocSize());
+}
+
+/// Maps and unmaps pages from every thread at once
+void
+TestConcurrentAlloc() {
+  katana::on_each([](unsigned tid, unsigned) {
+    for (unsigned i = 0; i < 16; ++i) {
+      unsigned num = 1 + (tid + i) % 3;
+      katana::PageKind kind;
+      void* ptr = katana::allocPages(num, i % 2 == 0, &kind);
+      CheckPages(ptr, num, kind);
+      katana::freePages(ptr, num);
+    }
+  });
+}
+
+void
+TestLargeMalloc() {
+  unsigned num_threads = katana::getActiveThreads();
+  size_t bytes = 3 * katana::allocSize() + 5;
+  KATANA_LOG_ASSERT(katana::allocSizeFor(bytes) % katana::allocSize() == 0);
+
+  std::vector<uint64_t> ranges;
+  for (unsigned i = 0; i <= num_threads; ++i) {
+    ranges.push_back(bytes * i / num_threads);
+  }
+
+  std::vector<katana::LAptr> ptrs;
+  ptrs.emplace_back(katana::largeMallocLocal(bytes));
+  ptrs.emplace_back(katana::largeMallocFloating(bytes));
+  ptrs.emplace_back(katana::largeMallocInterleaved(bytes, num_threads));
+  ptrs.emplace_back(katana::largeMallocBlocked(bytes, num_threads));
+  ptrs.emplace_back(
+      katana::largeMallocSpecified(bytes, num_threads, ranges, 1));
+  for (const katana::LAptr& ptr : ptrs) {
+    KATANA_LOG_ASSERT(ptr);
+    KATANA_LOG_ASSERT(ptr.get_deleter().bytes >= bytes);
+    std::memset(ptr.get(), 1, bytes);
+  }
+}
+
+/// Each configuration gets the pages it asks for, or falls back to smaller
+/// ones
+void
+TestPageConfigs() {
+  katana::PageAllocConfig saved = katana::getPageAllocConfig();
+  constexpr unsigned kNum = 3;
+
+  katana::PageAllocConfig none;
+  none.huge_tlb = false;
+  none.transparent = false;
+  katana::setPageAllocConfig(none);
+  for (bool pre_fault : {false, true}) {
+    katana::PageKind kind;
+    void* ptr = katana::allocPages(kNum, pre_fault, &kind);
+    KATANA_LOG_ASSERT(kind == katana::PageKind::kSmall);
+    CheckPages(ptr, kNum, kind);
+    katana::freePages(ptr, kNum);
+  }
+
+  katana::PageAllocConfig thp;
+  thp.huge_tlb = false;
+  katana::setPageAllocConfig(thp);
+  for (bool pre_fault : {false, true}) {
+    katana::PageKind kind;
+    void* ptr = katana::allocPages(kNum, pre_fault, &kind);
+    KATANA_LOG_ASSERT(kind == katana::PageKind::kTransparentHuge);
+    CheckPages(ptr, kNum, kind);
+    katana::freePages(ptr, kNum);
+  }
+
+  size_t gb = katana::pageKindSize(katana::PageKind::kGigantic);
+  katana::PageAllocConfig gigantic;
+  gigantic.gigantic_min_bytes = gb;
+  katana::setPageAllocConfig(gigantic);
+  // Without kernel support, 1GB pages stay disabled
+  if (katana::getPageAllocConfig().gigantic_min_bytes != 0) {
+    KATANA_LOG_ASSERT(katana::allocSizeFor(gb) == gb);
+    KATANA_LOG_ASSERT(katana::allocSizeFor(gb - 1) == katana::allocSize());
+
+    // Without enough reserved 1GB pages, the fallback is only rounded up to
+    // the smaller pages it gets. Not faulted in, so this costs no memory.
+    size_t bytes = gb + 5;
+    katana::LAptr ptr = katana::largeMallocFloating(bytes);
+    KATANA_LOG_ASSERT(ptr);
+    size_t got = ptr.get_deleter().bytes;
+    KATANA_LOG_VASSERT(
+        got == 2 * gb || got == gb + katana::allocSize(),
+        "{} bytes for {}", got, bytes);
+
+    unsigned num = gb / katana::allocSize();
+    void* pages = katana::allocGiganticPages(num, false);
+    if (pages) {
+      CheckPages(pages, 1, katana::PageKind::kGigantic);
+      katana::freePages(pages, num);
+    }
+    KATANA_LOG_ASSERT(katana::allocGiganticPages(num - 1, false) == nullptr);
+  }
+
+  katana::setPageAllocConfig(saved);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  KATANA_LOG_ASSERT(katana::allocPages(0, false) == nullptr);
+  for (katana::PageKind kind :
+       {katana::PageKind::kSmall, katana::PageKind::kTransparentHuge,
+        katana::PageKind::kHuge, katana::PageKind::kGigantic}) {
+    KATANA_LOG_ASSERT(katana::pageKindSize(kind) > 0);
+    KATANA_LOG_ASSERT(katana::pageKindName(kind)[0] != '\0');
+  }
+
+  TestPageConfigs();
+
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    TestConcurrentAlloc();
+    TestLargeMalloc();
+  }
+
+  return 0;
+}
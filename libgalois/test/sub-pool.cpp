@@ -0,0 +1,207 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SubPool.h"
+
+namespace {
+
+/// Pool ids of the threads that ran a loop
+struct PoolIDs {
+  std::vector<std::atomic<int>> used;
+
+  PoolIDs() : used(katana::GetThreadPool().getPoolThreads()) {}
+
+  void Mark() {
+    used[katana::ThreadPool::getRegionBase() + katana::ThreadPool::getTID()] =
+        1;
+  }
+
+  bool Overlaps(const PoolIDs& other) const {
+    for (size_t i = 0; i < used.size(); ++i) {
+      if (used[i] && other.used[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/// Loops that use the barrier, termination detection and per-thread storage
+/// of the calling thread's pool
+void
+RunLoops(unsigned num_threads, int rounds, PoolIDs* ids) {
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == num_threads);
+
+  for (int r = 0; r < rounds; ++r) {
+    constexpr uint32_t kNumItems = 10000;
+    katana::GAccumulator<uint64_t> sum;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, kNumItems),
+        [&](uint32_t i) {
+          KATANA_LOG_ASSERT(katana::ThreadPool::getTID() < num_threads);
+          ids->Mark();
+          sum += i;
+        },
+        katana::steal());
+    KATANA_LOG_ASSERT(
+        sum.reduce() == uint64_t{kNumItems} * (kNumItems - 1) / 2);
+
+    std::vector<uint32_t> init{1};
+    katana::GAccumulator<uint32_t> count;
+    katana::for_each(
+        katana::iterate(init),
+        [&](uint32_t n, auto& ctx) {
+          count += 1;
+          if (n < kNumItems / 2) {
+            ctx.push(2 * n);
+            ctx.push(2 * n + 1);
+          }
+        },
+        katana::disable_conflict_detection());
+    KATANA_LOG_ASSERT(count.reduce() == kNumItems - 1);
+
+    std::atomic<unsigned> seen{0};
+    katana::on_each([&](unsigned tid, unsigned total) {
+      KATANA_LOG_ASSERT(total == num_threads);
+      KATANA_LOG_ASSERT(tid < total);
+      seen += 1;
+    });
+    KATANA_LOG_ASSERT(seen == num_threads);
+  }
+}
+
+void
+TestConcurrentSubPools(unsigned pool_threads) {
+  // Set before leasing, so loops outside of sub-pools must not use the
+  // leased threads without being told
+  KATANA_LOG_ASSERT(katana::setActiveThreads(pool_threads) == pool_threads);
+
+  unsigned num_threads = (pool_threads - 1) / 3;
+  auto a_res = katana::SubPool::Make(num_threads);
+  KATANA_LOG_ASSERT(a_res);
+  auto b_res = katana::SubPool::Make(num_threads);
+  KATANA_LOG_ASSERT(b_res);
+  std::unique_ptr<katana::SubPool> a = std::move(a_res.value());
+  std::unique_ptr<katana::SubPool> b = std::move(b_res.value());
+  KATANA_LOG_ASSERT(a->size() == num_threads);
+
+  // The rest of the pool keeps the threads that were not leased
+  unsigned rest = pool_threads - 2 * num_threads;
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == rest);
+
+  PoolIDs a_ids;
+  PoolIDs b_ids;
+  PoolIDs rest_ids;
+  std::thread ta([&]() {
+    a->Run([&]() {
+      KATANA_LOG_ASSERT(katana::GetThreadPool().getMaxThreads() == num_threads);
+      RunLoops(num_threads, 50, &a_ids);
+      // Active threads are scoped to the sub-pool
+      KATANA_LOG_ASSERT(katana::setActiveThreads(1) == 1);
+      RunLoops(1, 5, &a_ids);
+    });
+  });
+  std::thread tb([&]() {
+    b->Run([&]() { RunLoops(num_threads, 50, &b_ids); });
+  });
+  RunLoops(rest, 50, &rest_ids);
+  ta.join();
+  tb.join();
+
+  KATANA_LOG_ASSERT(!a_ids.Overlaps(b_ids));
+  KATANA_LOG_ASSERT(!a_ids.Overlaps(rest_ids));
+  KATANA_LOG_ASSERT(!b_ids.Overlaps(rest_ids));
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == rest);
+
+  // Scoping survives between runs
+  a->Run([&]() { KATANA_LOG_ASSERT(katana::getActiveThreads() == 1); });
+  b->Run([&]() {
+    KATANA_LOG_ASSERT(katana::getActiveThreads() == num_threads);
+  });
+
+  bool caught = false;
+  try {
+    a->Run([]() { throw std::runtime_error("from sub-pool"); });
+  } catch (const std::runtime_error&) {
+    caught = true;
+  }
+  KATANA_LOG_ASSERT(caught);
+
+  a.reset();
+  b.reset();
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == pool_threads);
+  PoolIDs all_ids;
+  RunLoops(pool_threads, 5, &all_ids);
+}
+
+/// Loops outside of sub-pools keep the threads they started with while
+/// another thread leases sub-pools
+void
+TestMakeDuringLoops(unsigned pool_threads) {
+  KATANA_LOG_ASSERT(katana::setActiveThreads(pool_threads) == pool_threads);
+
+  std::atomic<bool> done{false};
+  std::thread leaser([&]() {
+    while (!done) {
+      auto res = katana::SubPool::Make(pool_threads / 2);
+      KATANA_LOG_ASSERT(res);
+    }
+  });
+
+  for (int r = 0; r < 200; ++r) {
+    constexpr uint32_t kNumItems = 10000;
+    katana::GAccumulator<uint64_t> sum;
+    katana::do_all(
+        katana::iterate(uint32_t{0}, kNumItems), [&](uint32_t i) { sum += i; },
+        katana::steal());
+    KATANA_LOG_ASSERT(
+        sum.reduce() == uint64_t{kNumItems} * (kNumItems - 1) / 2);
+
+    katana::ThreadPool::StartGuard start_guard;
+    unsigned num_threads = katana::getActiveThreads();
+    std::vector<std::atomic<int>> ran(num_threads);
+    katana::on_each([&](unsigned tid, unsigned total) {
+      KATANA_LOG_ASSERT(total == num_threads);
+      ran[tid] = 1;
+    });
+    for (const auto& tid_ran : ran) {
+      KATANA_LOG_ASSERT(tid_ran);
+    }
+  }
+
+  done = true;
+  leaser.join();
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == pool_threads);
+}
+
+void
+TestTooLarge(unsigned pool_threads) {
+  // Thread 0 is never leased
+  KATANA_LOG_ASSERT(!katana::SubPool::Make(pool_threads));
+  KATANA_LOG_ASSERT(!katana::SubPool::Make(0));
+  if (pool_threads > 1) {
+    auto res = katana::SubPool::Make(pool_threads - 1);
+    KATANA_LOG_ASSERT(res);
+    KATANA_LOG_ASSERT(!katana::SubPool::Make(1));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  unsigned pool_threads = katana::GetThreadPool().getMaxUsableThreads();
+
+  TestTooLarge(pool_threads);
+  if (pool_threads >= 4) {
+    TestConcurrentSubPools(pool_threads);
+    TestMakeDuringLoops(pool_threads);
+  }
+
+  return 0;
+}
@@ -17,6 +17,7 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <iostream>
@@ -81,13 +82,41 @@ runExplicitThread(int num) {
   });
 }
 
+//! Many loops with one iteration per thread, where wakeup and join are
+//! nearly all the work
+void
+runTinyDoAll(int) {
+  int num = katana::getActiveThreads();
+  for (int r = 0; r < rounds; ++r) {
+    katana::do_all(katana::iterate(0, num), [&](int) {
+      asm volatile("" ::: "memory");
+    });
+  }
+}
+
+void
+reportLatency(const std::string& name) {
+  auto stats = katana::GetThreadPool().getLatencyStats();
+  if (!stats.runs) {
+    return;
+  }
+  double wakeups = std::max<uint64_t>(stats.wakeups, 1);
+  std::cout << name << " runs: " << stats.runs
+            << " wake avg ns: " << stats.wakeNs / wakeups
+            << " wake max ns: " << stats.maxWakeNs
+            << " parked: " << 100.0 * stats.parkedWakeups / wakeups << "%"
+            << " join avg ns: " << stats.joinNs / stats.runs << "\n";
+}
+
 void
 run(std::function<void(int)> fn, std::string name) {
+  katana::GetThreadPool().resetLatencyStats();
   katana::Timer t;
   t.start();
   fn(size);
   t.stop();
   std::cout << name << " time: " << t.get() << "\n";
+  reportLatency(name);
 }
 
 std::atomic<int> EXIT;
@@ -110,6 +139,7 @@ main(int argc, char* argv[]) {
 
   for (int t = 0; t < trials; ++t) {
     run(runDoAll, "DoAll");
+    run(runTinyDoAll, "TinyDoAll");
     run(runDoAllBurn, "DoAllBurn");
     run(runExplicitThread, "ExplicitThread");
   }
@@ -0,0 +1,124 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/WorkStealing.h"
+
+namespace {
+
+/// The owner pushes and takes while other threads steal; every element must
+/// come out exactly once
+void
+TestDeque() {
+  constexpr int kNumItems = 200000;
+  constexpr int kNumThieves = 3;
+
+  katana::internal::ChaseLevDeque<int> deque;
+  std::vector<std::atomic<int>> seen(kNumItems);
+  for (auto& s : seen) {
+    s = 0;
+  }
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < kNumThieves; ++i) {
+    thieves.emplace_back([&]() {
+      while (!done.load()) {
+        if (std::optional<int> v = deque.steal()) {
+          seen[*v] += 1;
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < kNumItems; ++i) {
+    deque.push(i);
+    // Take some back so that the owner and thieves race for the last items
+    if (i % 3 == 0) {
+      if (std::optional<int> v = deque.take()) {
+        seen[*v] += 1;
+      }
+    }
+  }
+  while (std::optional<int> v = deque.take()) {
+    seen[*v] += 1;
+  }
+  done = true;
+  for (auto& t : thieves) {
+    t.join();
+  }
+
+  for (int i = 0; i < kNumItems; ++i) {
+    KATANA_LOG_VASSERT(seen[i] == 1, "item {} seen {} times", i, seen[i]);
+  }
+}
+
+/// Expand a binary tree from its root so that nearly all work is created
+/// during the loop
+void
+TestTree(uint32_t num_nodes, uint32_t spin_ns) {
+  std::vector<std::atomic<uint32_t>> seen(num_nodes);
+  for (auto& s : seen) {
+    s = 0;
+  }
+
+  std::vector<uint32_t> init{0};
+  katana::for_each(
+      katana::iterate(init),
+      [&](uint32_t n, auto& ctx) {
+        seen[n] += 1;
+        if (spin_ns) {
+          auto until = std::chrono::steady_clock::now() +
+                       std::chrono::nanoseconds(spin_ns);
+          while (std::chrono::steady_clock::now() < until) {
+          }
+        }
+        for (uint32_t c = 2 * n + 1; c <= 2 * n + 2 && c < num_nodes; ++c) {
+          ctx.push(c);
+        }
+      },
+      katana::wl<katana::StealingChunkDeque<>>(),
+      katana::disable_conflict_detection(), katana::loopname("StealingTree"));
+
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_ASSERT(seen[n] == 1);
+  }
+}
+
+void
+TestRange(uint32_t num_items) {
+  std::vector<std::atomic<uint32_t>> seen(num_items);
+  for (auto& s : seen) {
+    s = 0;
+  }
+  katana::for_each(
+      katana::iterate(uint32_t{0}, num_items),
+      [&](uint32_t i, auto&) { seen[i] += 1; },
+      katana::wl<katana::StealingChunkDeque<16>>(),
+      katana::disable_conflict_detection(), katana::loopname("StealingRange"));
+
+  for (uint32_t i = 0; i < num_items; ++i) {
+    KATANA_LOG_ASSERT(seen[i] == 1);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  TestDeque();
+
+  for (unsigned threads : {1U, 8U}) {
+    katana::setActiveThreads(threads);
+    TestTree(1 << 20, 0);
+    TestTree(1 << 12, 20000);
+    TestRange(100000);
+  }
+
+  return 0;
+}
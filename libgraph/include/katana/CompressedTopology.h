@@ -0,0 +1,185 @@
+#ifndef KATANA_LIBGRAPH_KATANA_COMPRESSEDTOPOLOGY_H_
+#define KATANA_LIBGRAPH_KATANA_COMPRESSEDTOPOLOGY_H_
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/Range.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A read-only topology that stores the out-neighbors of each node compressed
+/// and decodes them while iterating. It is meant for memory bound traversals
+/// that only need the neighbors of a node, not edge ids or edge properties,
+/// e.g., BFS, connected components or PageRank.
+///
+/// It is built in memory next to the CSR topology of the PropertyGraph, which
+/// stays loaded, so it adds to the memory of the graph: there is no persisted
+/// compressed topology kind to load instead of the CSR. MakeTransposed() and
+/// MakeUndirected() compress in-neighbors without building and caching a
+/// transposed topology in the PropertyGraph.
+///
+/// The neighbors of a node are sorted and stored as the varint encoded
+/// difference of each neighbor to the previous one (the first one to the node
+/// itself), after the varint encoded degree. Sorted neighbor lists of real
+/// graphs mostly have small gaps, so most neighbors take 1 or 2 bytes instead
+/// of 4, in addition to 8 bytes per node for the start of its list.
+///
+/// Since the neighbors are sorted, their order can differ from the order of
+/// the edges of the topology the CompressedTopology was made from.
+class KATANA_EXPORT CompressedTopology : public GraphTopologyTypes {
+public:
+  /// Decodes the neighbors of a node one at a time
+  class NeighborIterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Node*;
+    using reference = const Node&;
+
+    NeighborIterator() = default;
+
+    const Node& operator*() const noexcept { return current_; }
+
+    NeighborIterator& operator++() noexcept {
+      if (--remaining_ != 0) {
+        current_ += ReadVarint(&pos_);
+      }
+      return *this;
+    }
+
+    NeighborIterator operator++(int) noexcept {
+      NeighborIterator ret = *this;
+      ++*this;
+      return ret;
+    }
+
+    bool operator==(const NeighborIterator& that) const noexcept {
+      return remaining_ == that.remaining_;
+    }
+    bool operator!=(const NeighborIterator& that) const noexcept {
+      return !(*this == that);
+    }
+
+  private:
+    friend class CompressedTopology;
+
+    NeighborIterator(Node node, const uint8_t* pos) noexcept : pos_(pos) {
+      remaining_ = ReadVarint(&pos_);
+      if (remaining_ != 0) {
+        current_ = node + UnZigZag(ReadVarint(&pos_));
+      }
+    }
+
+    const uint8_t* pos_{nullptr};
+    uint64_t remaining_{0};
+    Node current_{0};
+  };
+
+  using neighbors_range = StandardRange<NeighborIterator>;
+
+  /// Appends the out-neighbors of a node to a vector
+  using GetNeighborsFn = std::function<void(Node, std::vector<Node>*)>;
+
+  CompressedTopology() = default;
+  CompressedTopology(CompressedTopology&&) = default;
+  CompressedTopology& operator=(CompressedTopology&&) = default;
+
+  CompressedTopology(const CompressedTopology&) = delete;
+  CompressedTopology& operator=(const CompressedTopology&) = delete;
+
+  /// Compress the neighbors given by Edges() and EdgeDst() for \p topology,
+  /// which may be a GraphTopology or any view, e.g., the out-neighbors of a
+  /// transposed view or the neighbors of an undirected view
+  template <typename Topology>
+  static CompressedTopology Make(const Topology& topology) {
+    return Make(
+        topology.NumNodes(), [&topology](Node n, std::vector<Node>* v) {
+          for (auto e : Edges(topology, n)) {
+            v->push_back(EdgeDst(topology, e));
+          }
+        });
+  }
+
+  /// Compress the in-neighbors of each node of \p topology, i.e., the
+  /// out-neighbors of its transpose. The in-edges are grouped in temporary
+  /// arrays of 4 bytes per edge that are freed before this returns.
+  static CompressedTopology MakeTransposed(const GraphTopology& topology);
+
+  /// Compress the out- and in-neighbors of each node of \p topology, i.e.,
+  /// the neighbors of the undirected view of it, like MakeTransposed()
+  static CompressedTopology MakeUndirected(const GraphTopology& topology);
+
+  /// Compress the graph with \p num_nodes nodes whose out-neighbors are given
+  /// by \p get_neighbors. get_neighbors is called twice for every node and
+  /// from several threads at once.
+  static CompressedTopology Make(
+      uint64_t num_nodes, const GetNeighborsFn& get_neighbors);
+
+  uint64_t NumNodes() const noexcept {
+    return offsets_.empty() ? 0 : offsets_.size() - 1;
+  }
+
+  uint64_t NumEdges() const noexcept { return num_edges_; }
+
+  size_t size() const noexcept { return NumNodes(); }
+
+  node_iterator begin() const noexcept { return node_iterator(0); }
+
+  node_iterator end() const noexcept { return node_iterator(NumNodes()); }
+
+  nodes_range Nodes() const noexcept {
+    return MakeStandardRange<node_iterator>(Node{0}, Node(NumNodes()));
+  }
+
+  uint64_t OutDegree(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < NumNodes());
+    const uint8_t* pos = &data_[offsets_[node]];
+    return ReadVarint(&pos);
+  }
+
+  /// The out-neighbors of \p node in ascending order
+  neighbors_range OutNeighbors(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < NumNodes());
+    return MakeStandardRange(
+        NeighborIterator(node, &data_[offsets_[node]]), NeighborIterator());
+  }
+
+  /// Bytes taken by the compressed topology
+  size_t SizeInBytes() const noexcept {
+    return offsets_.size() * sizeof(uint64_t) + data_.size();
+  }
+
+private:
+  static uint64_t ReadVarint(const uint8_t** pos) noexcept {
+    const uint8_t* p = *pos;
+    uint8_t byte = *p++;
+    uint64_t value = byte & 0x7fU;
+    for (unsigned shift = 7; byte & 0x80U; shift += 7) {
+      byte = *p++;
+      value |= uint64_t{byte & 0x7fU} << shift;
+    }
+    *pos = p;
+    return value;
+  }
+
+  static uint64_t UnZigZag(uint64_t value) noexcept {
+    return (value >> 1) ^ -(value & 1);
+  }
+
+  /// Byte offset of the neighbors of each node in data_, plus the size of
+  /// data_
+  NUMAArray<uint64_t> offsets_;
+  NUMAArray<uint8_t> data_;
+  uint64_t num_edges_{0};
+};
+
+}  // namespace katana
+
+#endif
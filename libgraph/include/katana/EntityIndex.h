@@ -1,46 +1,52 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ENTITYINDEX_H_
 #define KATANA_LIBGRAPH_KATANA_ENTITYINDEX_H_
 
-#include <set>
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <string>
-#include <variant>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/array.h>
 #include <arrow/type_traits.h>
-#include <boost/iterator/iterator_categories.hpp>
-#include <boost/iterator/iterator_facade.hpp>
+#include <boost/iterator/iterator_adaptor.hpp>
 
+#include "katana/DynamicBitset.h"
+#include "katana/EntityIndexPrimitive.h"
+#include "katana/NUMAArray.h"
 #include "katana/Result.h"
 #include "katana/config.h"
 
 namespace katana {
 
+// The lookup structure used by an EntityIndex.
+enum EntityIndexKind {
+  // Sorted by property value; supports equality, range and prefix queries.
+  kOrderedIndex,
+  // Hashed by property value; supports equality queries only. Only available
+  // for string properties.
+  kHashIndex,
+};
+
 // EntityIndex provides an interface similar to an ordered container
 // over a single property.
+//
+// Indexes are stored as packed, sorted arrays of node or edge ids (plus, for
+// fixed-width types, a parallel array of the corresponding property values) so
+// that lookups are binary searches over contiguous memory.
 template <typename node_or_edge>
 class KATANA_EXPORT EntityIndex {
 public:
-  // Type-safe container for node and edge ids to avoid overlap with the
-  // primitive types we are indexing.
-  struct IndexID {
-    node_or_edge id;
-  };
-
-  // The set key type is either a node/edge id (all the keys in the actual set)
-  // or a value representing the search key.
-  using set_key_type = typename std::variant<
-      IndexID, bool, uint8_t, int64_t, uint64_t, double_t, std::string_view*>;
-
   // EntityIndex::iterator returns a sequence of node or edge ids.
-  using base_iterator = typename std::multiset<set_key_type>::iterator;
-  class iterator : public base_iterator {
+  class iterator
+      : public boost::iterator_adaptor<iterator, const node_or_edge*> {
   public:
-    explicit iterator(const base_iterator& base) : base_iterator(base) {}
-    iterator() : base_iterator(0) {}
-    const node_or_edge& operator*() const {
-      return std::get<IndexID>(base_iterator::operator*()).id;
-    }
+    iterator() : iterator::iterator_adaptor_(nullptr) {}
+    explicit iterator(const node_or_edge* base)
+        : iterator::iterator_adaptor_(base) {}
   };
 
   EntityIndex(std::string property_name)
@@ -54,13 +60,27 @@ public:
   virtual ~EntityIndex() = default;
 
   // The name of the indexed property.
-  std::string property_name() { return property_name_; }
+  std::string property_name() const { return property_name_; }
 
   virtual iterator begin() = 0;
   virtual iterator end() = 0;
 
   virtual Result<void> BuildFromProperty() = 0;
-  // virtual Result<void> BuildFromFile() = 0;
+
+  // Adopt an index previously stored with ToPrimitive(). The stored arrays
+  // are mapped rather than copied.
+  virtual Result<void> BuildFromPrimitive(EntityIndexPrimitive&& primitive) = 0;
+
+  // Describe this index for storage. The result refers to this index's arrays
+  // and must not outlive it.
+  virtual EntityIndexPrimitive ToPrimitive() const = 0;
+
+  // Whether this index adopted a stored copy rather than being built from the
+  // property.
+  bool loaded_from_storage() const { return loaded_from_storage_; }
+
+protected:
+  bool loaded_from_storage_{false};
 
 private:
   std::string property_name_;
@@ -71,74 +91,68 @@ template <typename node_or_edge, typename c_type>
 class KATANA_EXPORT PrimitiveEntityIndex : public EntityIndex<node_or_edge> {
 public:
   using ArrowArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
-  using IndexID = typename EntityIndex<node_or_edge>::IndexID;
   using iterator = typename EntityIndex<node_or_edge>::iterator;
-  using set_key_type = typename EntityIndex<node_or_edge>::set_key_type;
 
   PrimitiveEntityIndex(
       const std::string& column, size_t num_entities,
       std::shared_ptr<arrow::Array> property)
       : EntityIndex<node_or_edge>(column),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<ArrowArrayType>(property)),
-        set_(PropertyCompare(property_)) {}
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
 
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
+  iterator begin() override { return iterator(ids_.begin()); }
+  iterator end() override { return iterator(ids_.end()); }
 
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not seem to specify that
-  // multiset::find returns the first value, though it appears so in practice.
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
   iterator Find(c_type key) {
-    auto it = set_.lower_bound(key);
-    if (it == set_.end() ||
-        property_->Value(std::get<IndexID>(*it).id) != key) {
+    size_t pos = LowerBoundPos(key);
+    if (pos == keys_.size() || keys_[pos] != key) {
       return end();
     }
-    return iterator(it);
+    return iterator(ids_.begin() + pos);
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(c_type key) { return iterator(set_.lower_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater than
+  // or equal to `key`.
+  iterator LowerBound(c_type key) {
+    return iterator(ids_.begin() + LowerBoundPos(key));
+  }
 
-  // Returns an iterator to the first element in the set that is greater than
+  // Returns an iterator to the first element in the index that is greater than
   // `key`.
-  iterator UpperBound(c_type key) { return iterator(set_.upper_bound(key)); }
+  iterator UpperBound(c_type key) {
+    return iterator(ids_.begin() + UpperBoundPos(key));
+  }
 
-private:
-  class PropertyCompare {
-  public:
-    PropertyCompare(std::shared_ptr<ArrowArrayType> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a literal key_type or a node/edge.
-      c_type val_a = GetValue(a);
-      c_type val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<c_type>{}(val_a, val_b);
-    }
+  // Returns a bitset over all entities with a bit set for every entity whose
+  // property value is equal to one of `keys`. The keys are probed in parallel.
+  DynamicBitset FindBatch(const std::vector<c_type>& keys) const;
 
-  private:
-    c_type GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        node_or_edge id = std::get<IndexID>(a).id;
-        c_type val = property_->Value(id);
-        return val;
-      }
-      return std::get<c_type>(a);
-    }
+  // Returns a bitset over all entities with a bit set for every entity whose
+  // property value is in the closed range [lo, hi].
+  DynamicBitset RangeScan(c_type lo, c_type hi) const;
 
-    std::shared_ptr<ArrowArrayType> property_;
-  };
+private:
+  size_t LowerBoundPos(c_type key) const {
+    return std::lower_bound(keys_.begin(), keys_.end(), key) - keys_.begin();
+  }
+
+  size_t UpperBoundPos(c_type key) const {
+    return std::upper_bound(keys_.begin(), keys_.end(), key) - keys_.begin();
+  }
 
   Result<void> BuildFromProperty() override;
-  // Result<void> BuildFromFile(...) override;
+  Result<void> BuildFromPrimitive(EntityIndexPrimitive&& primitive) override;
+  EntityIndexPrimitive ToPrimitive() const override;
 
   size_t num_entities_;
   std::shared_ptr<ArrowArrayType> property_;
-  std::multiset<set_key_type, PropertyCompare> set_;
+  // keys_[i] is the property value of ids_[i]; both are sorted by (key, id).
+  NUMAArray<c_type> keys_;
+  NUMAArray<node_or_edge> ids_;
+  // Owns the mapped arrays when the index was loaded from storage.
+  EntityIndexPrimitive storage_;
 };
 
 // StringEntityIndex provides a EntityIndex for strings.
@@ -147,89 +161,208 @@ class KATANA_EXPORT StringEntityIndex : public EntityIndex<node_or_edge> {
 public:
   using ArrowArrayType =
       typename arrow::TypeTraits<arrow::LargeStringType>::ArrayType;
-  using IndexID = typename EntityIndex<node_or_edge>::IndexID;
   using iterator = typename EntityIndex<node_or_edge>::iterator;
-  using set_key_type = typename EntityIndex<node_or_edge>::set_key_type;
 
   StringEntityIndex(
       const std::string& property_name, size_t num_entities,
       const std::shared_ptr<arrow::Array>& property)
       : EntityIndex<node_or_edge>(property_name),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)),
-        set_(StringCompare(property_)) {}
+        property_(
+            std::static_pointer_cast<arrow::LargeStringArray>(property)) {}
 
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
+  iterator begin() override { return iterator(ids_.begin()); }
+  iterator end() override { return iterator(ids_.end()); }
 
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not appear to specify that
-  // multiset::find returns the first value, though it appears so in practice.
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
   iterator Find(std::string_view key) {
-    auto it = set_.lower_bound(&key);
-    if (it != set_.end()) {
-      arrow::util::string_view arrow_view =
-          property_->GetView(std::get<IndexID>(*it).id);
-      if (std::string_view(arrow_view.data(), arrow_view.length()) != key) {
-        return end();
-      }
+    iterator it = LowerBound(key);
+    if (it == end() || GetValue(*it) != key) {
+      return end();
     }
-    return iterator(it);
+    return it;
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
+  // Returns an iterator to the first element in the index that is greater than
+  // or equal to `key`.
   iterator LowerBound(std::string_view key) {
-    return iterator(set_.lower_bound(&key));
+    return iterator(ids_.begin() + LowerBoundPos(key));
   }
 
-  // Returns an iterator to the first element in the set that is greater than
+  // Returns an iterator to the first element in the index that is greater than
   // `key`.
   iterator UpperBound(std::string_view key) {
-    return iterator(set_.upper_bound(&key));
+    return iterator(ids_.begin() + UpperBoundPos(key));
+  }
+
+  // Returns a bitset over all entities with a bit set for every entity whose
+  // property value is equal to one of `keys`. The keys are probed in parallel.
+  DynamicBitset FindBatch(const std::vector<std::string>& keys) const;
+
+  // Returns a bitset over all entities with a bit set for every entity whose
+  // property value is in the closed range [lo, hi].
+  DynamicBitset RangeScan(std::string_view lo, std::string_view hi) const;
+
+  // Returns the range of elements in the index whose property value starts
+  // with `prefix`.
+  std::pair<iterator, iterator> PrefixRange(std::string_view prefix) {
+    auto [begin, end] = PrefixPos(prefix);
+    return std::make_pair(
+        iterator(ids_.begin() + begin), iterator(ids_.begin() + end));
   }
 
+  // Returns a bitset over all entities with a bit set for every entity whose
+  // property value starts with `prefix`.
+  DynamicBitset PrefixScan(std::string_view prefix) const;
+
 private:
-  class StringCompare {
-  public:
-    StringCompare(std::shared_ptr<arrow::LargeStringArray> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a pointer to a string_view or a node/edge.
-      std::string_view val_a = GetValue(a);
-      std::string_view val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<std::string_view>{}(val_a, val_b);
-    }
+  // Values with a common prefix are contiguous in the index and start at the
+  // lower bound of the prefix itself.
+  std::pair<size_t, size_t> PrefixPos(std::string_view prefix) const {
+    auto first = ids_.begin() + LowerBoundPos(prefix);
+    auto last = std::partition_point(first, ids_.end(), [&](node_or_edge id) {
+      return GetValue(id).substr(0, prefix.size()) == prefix;
+    });
+    return std::make_pair(first - ids_.begin(), last - ids_.begin());
+  }
+
+  size_t LowerBoundPos(std::string_view key) const {
+    return std::lower_bound(
+               ids_.begin(), ids_.end(), key,
+               [this](node_or_edge id, std::string_view k) {
+                 return GetValue(id) < k;
+               }) -
+           ids_.begin();
+  }
+
+  size_t UpperBoundPos(std::string_view key) const {
+    return std::upper_bound(
+               ids_.begin(), ids_.end(), key,
+               [this](std::string_view k, node_or_edge id) {
+                 return k < GetValue(id);
+               }) -
+           ids_.begin();
+  }
+
+  std::string_view GetValue(node_or_edge id) const {
+    arrow::util::string_view arrow_view = property_->GetView(id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
+
+  Result<void> BuildFromProperty() override;
+  Result<void> BuildFromPrimitive(EntityIndexPrimitive&& primitive) override;
+  EntityIndexPrimitive ToPrimitive() const override;
+
+  size_t num_entities_;
+  std::shared_ptr<arrow::LargeStringArray> property_;
+  // Ids of entities with a valid property value, sorted by (value, id).
+  NUMAArray<node_or_edge> ids_;
+  // Owns the mapped arrays when the index was loaded from storage.
+  EntityIndexPrimitive storage_;
+};
 
-  private:
-    std::string_view GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        arrow::util::string_view arrow_view =
-            property_->GetView(std::get<IndexID>(a).id);
-        return std::string_view(arrow_view.data(), arrow_view.length());
-      }
-      return *std::get<std::string_view*>(a);
+// HashStringEntityIndex provides a EntityIndex for strings that only answers
+// equality queries.
+//
+// Every distinct value is assigned a dense dictionary code. Ids are grouped by
+// code and codes are found through an open addressing table keyed by the hash
+// of their value, so a lookup only compares strings on a full hash match.
+// Iteration visits ids grouped by value but in no particular value order.
+template <typename node_or_edge>
+class KATANA_EXPORT HashStringEntityIndex : public EntityIndex<node_or_edge> {
+public:
+  using ArrowArrayType =
+      typename arrow::TypeTraits<arrow::LargeStringType>::ArrayType;
+  using iterator = typename EntityIndex<node_or_edge>::iterator;
+
+  // The code returned by FindCode() for values not in the index.
+  static constexpr uint64_t kNoCode = std::numeric_limits<uint64_t>::max();
+
+  HashStringEntityIndex(
+      const std::string& property_name, size_t num_entities,
+      const std::shared_ptr<arrow::Array>& property)
+      : EntityIndex<node_or_edge>(property_name),
+        num_entities_(num_entities),
+        property_(
+            std::static_pointer_cast<arrow::LargeStringArray>(property)) {}
+
+  iterator begin() override { return iterator(ids_.begin()); }
+  iterator end() override { return iterator(ids_.end()); }
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(std::string_view key) { return EqualRange(key).first; }
+
+  // Returns the range of elements in the index with their property value equal
+  // to `key`. Both iterators are end() if there are none.
+  std::pair<iterator, iterator> EqualRange(std::string_view key) {
+    uint64_t code = FindCode(key);
+    if (code == kNoCode) {
+      return std::make_pair(end(), end());
     }
+    return CodeRange(code);
+  }
 
-    std::shared_ptr<arrow::LargeStringArray> property_;
-  };
+  // Returns the dictionary code of `key`, or kNoCode if no entity has the
+  // value `key`.
+  uint64_t FindCode(std::string_view key) const;
+
+  // Returns the range of elements in the index whose value has dictionary
+  // code `code`.
+  std::pair<iterator, iterator> CodeRange(uint64_t code) {
+    return std::make_pair(
+        iterator(ids_.begin() + offsets_[code]),
+        iterator(ids_.begin() + offsets_[code + 1]));
+  }
+
+  // The number of distinct values in the index.
+  uint64_t num_codes() const { return hashes_.size(); }
+
+  // Returns a bitset over all entities with a bit set for every entity whose
+  // property value is equal to one of `keys`. The keys are probed in parallel.
+  DynamicBitset FindBatch(const std::vector<std::string>& keys) const;
+
+private:
+  static uint64_t Hash(std::string_view value) {
+    return std::hash<std::string_view>{}(value);
+  }
+
+  std::string_view GetValue(node_or_edge id) const {
+    arrow::util::string_view arrow_view = property_->GetView(id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
 
   Result<void> BuildFromProperty() override;
-  // virtual Result<void> BuildFromFile(...) override;
+  Result<void> BuildFromPrimitive(EntityIndexPrimitive&& primitive) override;
+  EntityIndexPrimitive ToPrimitive() const override;
+
+  // Assign codes and fill the hash table from ids_, which must already be
+  // grouped by (hash, value, id).
+  void BuildTable();
 
   size_t num_entities_;
   std::shared_ptr<arrow::LargeStringArray> property_;
-  std::multiset<set_key_type, StringCompare> set_;
-};  // namespace katana
+  // Ids of entities with a valid property value, sorted by (hash, value, id).
+  NUMAArray<node_or_edge> ids_;
+  // The ids of the entities with code c are ids_[offsets_[c], offsets_[c+1]).
+  NUMAArray<uint64_t> offsets_;
+  // hashes_[c] is the hash of the value with code c.
+  NUMAArray<uint64_t> hashes_;
+  // Open addressing table with linear probing; a slot holds a code plus one,
+  // or zero if it is empty. The size is a power of two.
+  NUMAArray<uint64_t> slots_;
+  // Owns the mapped arrays when the index was loaded from storage.
+  EntityIndexPrimitive storage_;
+};
 
 // Create a EntityIndex with the appropriate type for 'property'. Does not
 // build the index.
 template <typename node_or_edge>
 Result<std::unique_ptr<EntityIndex<node_or_edge>>> MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property,
+    EntityIndexKind kind = kOrderedIndex);
 
 }  // namespace katana
 
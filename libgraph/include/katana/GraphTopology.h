@@ -1,7 +1,9 @@
 #ifndef KATANA_LIBGRAPH_KATANA_GRAPHTOPOLOGY_H_
 #define KATANA_LIBGRAPH_KATANA_GRAPHTOPOLOGY_H_
 
+#include <limits>
 #include <memory>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -14,6 +16,7 @@
 #include "katana/Logging.h"
 #include "katana/NUMAArray.h"
 #include "katana/RDGTopology.h"
+#include "katana/Range.h"
 #include "katana/Result.h"
 #include "katana/config.h"
 
@@ -73,6 +76,12 @@ public:
       size_t num_edges, const PropertyIndex* edge_prop_indices,
       const PropertyIndex* node_prop_indices) noexcept;
 
+  /// Make a topology over arrays that live in \p storage, e.g., a mapped
+  /// file. Nothing is copied; the topology keeps \p storage alive.
+  GraphTopology(
+      const Edge* adj_indices, size_t num_nodes, const Node* dests,
+      size_t num_edges, std::shared_ptr<void> storage) noexcept;
+
   GraphTopology(AdjIndexVec&& adj_indices, EdgeDestVec&& dests) noexcept;
 
   GraphTopology(
@@ -82,6 +91,16 @@ public:
 
   static GraphTopology Copy(const GraphTopology& that) noexcept;
 
+  /// Tag of the constructors that copy a topology placed across NUMA nodes
+  struct NUMAPartitionedCopy {};
+
+  /// Copy \p that so that each active thread owns a contiguous range of
+  /// nodes, balanced by edges, and the adjacency indices, destinations and
+  /// property indexes of those nodes are in the memory of the NUMA node of
+  /// the thread. Topologies are shared by views and caches, so they are
+  /// placed by copying rather than in place.
+  GraphTopology(const GraphTopology& that, NUMAPartitionedCopy) noexcept;
+
   static GraphTopology CopyWithoutPropertyIndexes(
       const GraphTopology& that) noexcept;
 
@@ -160,6 +179,23 @@ public:
         Node{0}, static_cast<Node>(NumNodes()));
   }
 
+  /// \returns true iff this is a NUMAPartitionedCopy made for the current
+  /// number of active threads
+  bool IsNUMAPartitioned() const noexcept;
+
+  /// Where the range of nodes of each thread begins: thread i owns nodes
+  /// [ranges[i], ranges[i + 1]). These are the ranges of the
+  /// NUMAPartitionedCopy if IsNUMAPartitioned(), and even blocks of nodes
+  /// otherwise.
+  std::vector<uint32_t> OwnerThreadRanges() const noexcept;
+
+  /// Nodes as a do_all range that starts each thread on the nodes it owns,
+  /// see OwnerThreadRanges. With steal(), threads that run out of work take
+  /// nodes from threads on the same socket first.
+  SpecificRange<node_iterator> OwnerComputesNodes() const noexcept {
+    return MakeSpecificRange(begin(), end(), OwnerThreadRanges());
+  }
+
   // Standard container concepts
 
   node_iterator begin() const noexcept { return node_iterator(0); }
@@ -241,6 +277,13 @@ private:
   // PropertyGraph.node_type_set_id(node_prop_indices_[node_id]) to obtain
   // node_type_id. This may not be true when we group properties
   PropIndexVec node_prop_indices_;
+
+  // Owns the memory of adj_indices_ and dests_ when they do not own it
+  // themselves, see the constructor that takes a storage argument.
+  std::shared_ptr<void> storage_;
+
+  // Node ranges of the threads when NUMA partitioned, empty otherwise
+  std::vector<uint32_t> thread_ranges_;
 };
 
 // TODO(amber): In the future, when we group properties e.g., by node or edge type,
@@ -258,6 +301,13 @@ public:
   EdgeShuffleTopology& operator=(const EdgeShuffleTopology&) = delete;
   virtual ~EdgeShuffleTopology();
 
+  EdgeShuffleTopology(
+      const EdgeShuffleTopology& that, NUMAPartitionedCopy tag) noexcept
+      : Base(that, tag),
+        tpose_state_(that.tpose_state_),
+        edge_sort_state_(that.edge_sort_state_),
+        is_valid_(that.is_valid_) {}
+
   bool is_valid() const noexcept { return is_valid_; }
 
   void invalidate() noexcept { is_valid_ = false; }
@@ -373,6 +423,10 @@ private:
 };
 
 /// This is a fully shuffled topology where both the nodes and edges can be sorted
+///
+/// GetLocalNodeID() maps a node back to its id in the original topology. Node
+/// properties are indexed by that id, so results written through a view of a
+/// ShuffleTopology are in the original order.
 class KATANA_EXPORT ShuffleTopology : public EdgeShuffleTopology {
   using Base = EdgeShuffleTopology;
 
@@ -384,6 +438,9 @@ public:
   ShuffleTopology(const ShuffleTopology&) = delete;
   ShuffleTopology& operator=(const ShuffleTopology&) = delete;
 
+  ShuffleTopology(const ShuffleTopology& that, NUMAPartitionedCopy tag) noexcept
+      : Base(that, tag), node_sort_state_(that.node_sort_state_) {}
+
   virtual ~ShuffleTopology();
 
   bool has_nodes_sorted_by(
@@ -407,6 +464,29 @@ public:
   static std::shared_ptr<ShuffleTopology> MakeSortedByNodeType(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
 
+  /// Reverse Cuthill-McKee order: the reverse of a BFS from a low degree node
+  /// of each component that visits the neighbors of a node by ascending
+  /// degree. Neighbors get close ids, which narrows the band of the adjacency
+  /// matrix. The BFS follows both out- and in-edges, i.e., it orders the
+  /// symmetrized graph; isolated nodes get the last ids.
+  static std::shared_ptr<ShuffleTopology> MakeSortedByRCM(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// Community order, in the spirit of Rabbit order and Gorder: nodes of the
+  /// same community, found by a few rounds of label propagation over the
+  /// out-edges, get consecutive ids.
+  static std::shared_ptr<ShuffleTopology> MakeSortedByCommunity(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// Hub sorting: hubs, i.e., nodes with more than the average degree, first
+  /// by descending degree, then the other nodes in their original order
+  static std::shared_ptr<ShuffleTopology> MakeHubSorted(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
+  /// Hub clustering: like hub sorting, but hubs keep their original order
+  static std::shared_ptr<ShuffleTopology> MakeHubClustered(
+      const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
+
   static std::shared_ptr<ShuffleTopology> MakeFromTopo(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo,
       const RDGTopology::NodeSortKind& node_sort_todo,
@@ -423,6 +503,18 @@ public:
     case RDGTopology::NodeSortKind::kSortedByNodeType:
       ret = MakeSortedByNodeType(pg, seed_topo);
       break;
+    case RDGTopology::NodeSortKind::kReverseCuthillMcKee:
+      ret = MakeSortedByRCM(pg, seed_topo);
+      break;
+    case RDGTopology::NodeSortKind::kCommunity:
+      ret = MakeSortedByCommunity(pg, seed_topo);
+      break;
+    case RDGTopology::NodeSortKind::kHubSorted:
+      ret = MakeHubSorted(pg, seed_topo);
+      break;
+    case RDGTopology::NodeSortKind::kHubClustered:
+      ret = MakeHubClustered(pg, seed_topo);
+      break;
     default:
       KATANA_LOG_FATAL("switch case fell through");
     }
@@ -452,70 +544,15 @@ private:
         new_to_old.begin(), new_to_old.end(),
         [&](const auto& i1, const auto& i2) { return cmp(i1, i2); });
 
-    GraphTopology::AdjIndexVec degrees;
-    degrees.allocateInterleaved(seed_topo.NumNodes());
-
-    NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
-    old_to_new_map.allocateInterleaved(seed_topo.NumNodes());
-
-    PropIndexVec node_prop_indices;
-    node_prop_indices.allocateInterleaved(seed_topo.NumNodes());
-
-    // TODO(amber): given 32-bit node ids, put a check here that
-    // new_to_old.size() < 2^32
-    katana::do_all(
-        katana::iterate(size_t{0}, new_to_old.size()),
-        [&](auto i) {
-          // new_to_old[i] gives old node id
-          old_to_new_map[new_to_old[i]] = i;
-          degrees[i] = seed_topo.OutDegree(new_to_old[i]);
-          node_prop_indices[i] = seed_topo.GetNodePropertyIndex(new_to_old[i]);
-        },
-        katana::no_stats());
-
-    KATANA_LOG_DEBUG_ASSERT(
-        std::is_sorted(degrees.begin(), degrees.end(), std::greater<>()));
-
-    katana::ParallelSTL::partial_sum(
-        degrees.begin(), degrees.end(), degrees.begin());
-
-    GraphTopologyTypes::EdgeDestVec new_dest_vec;
-    new_dest_vec.allocateInterleaved(seed_topo.NumEdges());
-
-    GraphTopologyTypes::PropIndexVec edge_prop_indices;
-    edge_prop_indices.allocateInterleaved(seed_topo.NumEdges());
-
-    katana::do_all(
-        katana::iterate(seed_topo.Nodes()),
-        [&](auto old_src_id) {
-          auto new_srd_id = old_to_new_map[old_src_id];
-          auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
-
-          for (auto e : seed_topo.OutEdges(old_src_id)) {
-            auto new_edge_dest = old_to_new_map[seed_topo.OutEdgeDst(e)];
-            KATANA_LOG_DEBUG_ASSERT(new_edge_dest < seed_topo.NumNodes());
-
-            auto new_edge_id = new_out_index;
-            ++new_out_index;
-            KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
-
-            new_dest_vec[new_edge_id] = new_edge_dest;
-
-            // copy over edge_property_index mapping from old edge to new edge
-            edge_prop_indices[new_edge_id] =
-                seed_topo.GetEdgePropertyIndexFromOutEdge(e);
-          }
-          KATANA_LOG_DEBUG_ASSERT(new_out_index == degrees[new_srd_id]);
-        },
-        katana::steal(), katana::no_stats());
-
-    return std::make_shared<ShuffleTopology>(ShuffleTopology{
-        seed_topo.transpose_state(), node_sort_todo,
-        seed_topo.edge_sort_state(), std::move(degrees),
-        std::move(node_prop_indices), std::move(new_dest_vec),
-        std::move(edge_prop_indices)});
+    return MakeNodePermutedTopo(seed_topo, new_to_old, node_sort_todo);
   }
 
+  /// Shuffle the nodes of seed_topo so that node i is new_to_old[i] of
+  /// seed_topo
+  static std::shared_ptr<ShuffleTopology> MakeNodePermutedTopo(
+      const EdgeShuffleTopology& seed_topo, const PropIndexVec& new_to_old,
+      const RDGTopology::NodeSortKind& node_sort_todo) noexcept;
+
   ShuffleTopology(
       const RDGTopology::TransposeKind& tpose_todo,
       const RDGTopology::NodeSortKind& node_sort_todo,
@@ -647,6 +684,10 @@ public:
   EdgeTypeAwareTopology(const EdgeTypeAwareTopology&) = delete;
   EdgeTypeAwareTopology& operator=(const EdgeTypeAwareTopology&) = delete;
 
+  /// The per type adjacency index is placed like the adjacency index
+  EdgeTypeAwareTopology(
+      const EdgeTypeAwareTopology& that, NUMAPartitionedCopy tag) noexcept;
+
   virtual ~EdgeTypeAwareTopology();
 
   static std::shared_ptr<EdgeTypeAwareTopology> MakeFrom(
@@ -885,6 +926,141 @@ private:
   AdjIndexVec per_type_adj_indices_;
 };
 
+/// A read-only GraphTopology whose edge ids are of type EdgeIndex instead of
+/// GraphTopology::Edge. With a 32-bit EdgeIndex, for graphs with fewer than
+/// 2^32 edges, the adjacency index that OutEdges(node) reads is half the size
+/// and the edge ids that algorithms carry around are 32-bit.
+///
+/// A CSRTopology shares the destinations and property indexes of the topology
+/// it is made from and keeps that topology alive. Only the adjacency index is
+/// narrowed into a copy, unless EdgeIndex is GraphTopology::Edge. Copies of a
+/// CSRTopology share its adjacency index, so it can be used like the
+/// topology wrappers below.
+template <typename EdgeIndex>
+class KATANA_EXPORT CSRTopology {
+public:
+  static_assert(
+      std::is_unsigned_v<EdgeIndex> &&
+      sizeof(EdgeIndex) <= sizeof(GraphTopologyTypes::Edge));
+
+  using Node = GraphTopologyTypes::Node;
+  using Edge = EdgeIndex;
+  using PropertyIndex = GraphTopologyTypes::PropertyIndex;
+  using node_iterator = GraphTopologyTypes::node_iterator;
+  using edge_iterator = boost::counting_iterator<Edge>;
+  using nodes_range = GraphTopologyTypes::nodes_range;
+  using edges_range = StandardRange<edge_iterator>;
+  using iterator = node_iterator;
+
+  /// Whether a topology with \p num_edges edges can be indexed by EdgeIndex
+  static bool CanIndex(uint64_t num_edges) noexcept {
+    return num_edges <= std::numeric_limits<EdgeIndex>::max();
+  }
+
+  /// Make a CSRTopology of \p topo, which must satisfy
+  /// CanIndex(topo->NumEdges())
+  static CSRTopology Make(std::shared_ptr<const GraphTopology> topo) noexcept;
+
+  /// Make a CSRTopology of \p topo that reads \p adj_indices, which must be
+  /// NarrowAdjIndices(*topo), so that CSRTopologies of the same topology can
+  /// share one narrowed index (see PGViewCache)
+  static CSRTopology Make(
+      std::shared_ptr<const GraphTopology> topo,
+      std::shared_ptr<const NUMAArray<Edge>> adj_indices) noexcept;
+
+  /// The adjacency index of \p topo narrowed to EdgeIndex and placed like
+  /// the topology, so that the threads of OwnerComputesNodes() loops read
+  /// their part of it locally
+  static std::shared_ptr<const NUMAArray<Edge>> NarrowAdjIndices(
+      const GraphTopology& topo) noexcept;
+
+  uint64_t NumNodes() const noexcept { return topo_->NumNodes(); }
+
+  uint64_t NumEdges() const noexcept { return topo_->NumEdges(); }
+
+  /// Gets all out-edges
+  edges_range OutEdges() const noexcept {
+    return MakeStandardRange<edge_iterator>(Edge{0}, Edge(NumEdges()));
+  }
+
+  /// Gets out-edges of some node.
+  ///
+  /// \param node node to get the edge range of
+  /// \returns iterable edge range for node.
+  edges_range OutEdges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < NumNodes());
+    edge_iterator e_beg{node > 0 ? adj_indices_[node - 1] : Edge{0}};
+    edge_iterator e_end{adj_indices_[node]};
+
+    return MakeStandardRange(e_beg, e_end);
+  }
+
+  Node OutEdgeDst(Edge edge_id) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(edge_id < NumEdges());
+    return dests_[edge_id];
+  }
+
+  Node GetEdgeSrc(const Edge& eid) const noexcept {
+    return topo_->GetEdgeSrc(eid);
+  }
+
+  /// @param node node to get degree for
+  /// @returns Degree of node N
+  size_t OutDegree(Node node) const noexcept { return OutEdges(node).size(); }
+
+  nodes_range Nodes() const noexcept { return topo_->Nodes(); }
+
+  const Edge* AdjData() const noexcept { return adj_indices_; }
+
+  bool IsNUMAPartitioned() const noexcept {
+    return topo_->IsNUMAPartitioned();
+  }
+
+  std::vector<uint32_t> OwnerThreadRanges() const noexcept {
+    return topo_->OwnerThreadRanges();
+  }
+
+  SpecificRange<node_iterator> OwnerComputesNodes() const noexcept {
+    return topo_->OwnerComputesNodes();
+  }
+
+  // Standard container concepts
+
+  node_iterator begin() const noexcept { return node_iterator(0); }
+
+  node_iterator end() const noexcept { return node_iterator(NumNodes()); }
+
+  size_t size() const noexcept { return NumNodes(); }
+
+  bool empty() const noexcept { return NumNodes() == 0; }
+
+  PropertyIndex GetEdgePropertyIndexFromOutEdge(
+      const Edge& eid) const noexcept {
+    return topo_->GetEdgePropertyIndexFromOutEdge(eid);
+  }
+
+  PropertyIndex GetNodePropertyIndex(const Node& nid) const noexcept {
+    return topo_->GetNodePropertyIndex(nid);
+  }
+
+  Node GetLocalNodeID(const Node& nid) const noexcept {
+    return topo_->GetLocalNodeID(nid);
+  }
+
+  PropertyIndex GetLocalEdgeIDFromOutEdge(const Edge& eid) const noexcept {
+    return topo_->GetLocalEdgeIDFromOutEdge(eid);
+  }
+
+  void Print() const noexcept { topo_->Print(); }
+
+private:
+  std::shared_ptr<const GraphTopology> topo_;
+  // Owns adj_indices_ unless it points into topo_
+  std::shared_ptr<const NUMAArray<Edge>> narrowed_adj_indices_;
+  const Edge* adj_indices_{nullptr};
+  const Node* dests_{nullptr};
+};
+
 /****************************/
 /* Topology wrapper classes */
 /****************************/
@@ -926,6 +1102,14 @@ public:
 
   auto Nodes() const noexcept { return topo().Nodes(); }
 
+  auto IsNUMAPartitioned() const noexcept { return topo().IsNUMAPartitioned(); }
+
+  auto OwnerThreadRanges() const noexcept { return topo().OwnerThreadRanges(); }
+
+  auto OwnerComputesNodes() const noexcept {
+    return topo().OwnerComputesNodes();
+  }
+
   // Standard container concepts
 
   auto begin() const noexcept { return topo().begin(); }
@@ -952,6 +1136,11 @@ public:
   }
   void Print() const noexcept { topo_ptr_->Print(); }
 
+  /// The wrapped topology, e.g., to make a CSRTopology of it
+  const std::shared_ptr<const Topo>& shared_topo() const noexcept {
+    return topo_ptr_;
+  }
+
 protected:
   const Topo& topo() const noexcept { return *topo_ptr_.get(); }
 
@@ -1472,6 +1661,36 @@ struct PGViewBuilder<PGViewNodesSortedByDegreeEdgesSortedByDestID> {
   }
 };
 
+// Nodes in a locality improving order, edges sorted by destination view
+
+using NodesReorderedEdgesSortedByDestIDTopology =
+    SortedTopologyWrapper<ShuffleTopology>;
+
+template <RDGTopology::NodeSortKind NodeSort>
+class PGViewNodesReorderedEdgesSortedByDestID
+    : public BasicPropGraphViewWrapper<
+          NodesReorderedEdgesSortedByDestIDTopology> {
+  using Base =
+      BasicPropGraphViewWrapper<NodesReorderedEdgesSortedByDestIDTopology>;
+
+public:
+  using Base::Base;
+};
+
+template <RDGTopology::NodeSortKind NodeSort>
+struct PGViewBuilder<PGViewNodesReorderedEdgesSortedByDestID<NodeSort>> {
+  template <typename ViewCache>
+  static PGViewNodesReorderedEdgesSortedByDestID<NodeSort> BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetShuffTopo(
+        pg, RDGTopology::TransposeKind::kNo, NodeSort,
+        RDGTopology::EdgeSortKind::kSortedByDestID);
+
+    return PGViewNodesReorderedEdgesSortedByDestID<NodeSort>{
+        pg, NodesReorderedEdgesSortedByDestIDTopology{sorted_topo}};
+  }
+};
+
 // Bidirectional view
 
 using SimpleBiDirTopology =
@@ -1535,6 +1754,39 @@ struct PGViewBuilder<PGViewEdgeTypeAwareBiDir> {
   }
 };
 
+// View with the topology of another view and EdgeIndex edge ids
+
+template <typename View, typename EdgeIndex>
+class PGViewWithEdgeIndex
+    : public BasicPropGraphViewWrapper<CSRTopology<EdgeIndex>> {
+  using Base = BasicPropGraphViewWrapper<CSRTopology<EdgeIndex>>;
+
+public:
+  using Base::Base;
+};
+
+template <typename View, typename EdgeIndex>
+struct PGViewBuilder<PGViewWithEdgeIndex<View, EdgeIndex>> {
+  template <typename ViewCache>
+  static PGViewWithEdgeIndex<View, EdgeIndex> BuildView(
+      PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    View view = PGViewBuilder<View>::BuildView(pg, viewCache);
+
+    // Views are built for every algorithm run, so the 32-bit index is kept
+    // next to the topology it narrows rather than rebuilt each time
+    if constexpr (std::is_same_v<EdgeIndex, uint32_t>) {
+      auto adj_indices =
+          viewCache.BuildOrGetNarrowedAdjIndices(view.shared_topo());
+      return PGViewWithEdgeIndex<View, EdgeIndex>{
+          pg, CSRTopology<EdgeIndex>::Make(
+                  view.shared_topo(), std::move(adj_indices))};
+    } else {
+      return PGViewWithEdgeIndex<View, EdgeIndex>{
+          pg, CSRTopology<EdgeIndex>::Make(view.shared_topo())};
+    }
+  }
+};
+
 }  // end namespace internal
 
 struct PropertyGraphViews {
@@ -1546,6 +1798,22 @@ struct PropertyGraphViews {
   using EdgeTypeAwareBiDir = internal::PGViewEdgeTypeAwareBiDir;
   using NodesSortedByDegreeEdgesSortedByDestID =
       internal::PGViewNodesSortedByDegreeEdgesSortedByDestID;
+  using NodesSortedByRCMEdgesSortedByDestID =
+      internal::PGViewNodesReorderedEdgesSortedByDestID<
+          RDGTopology::NodeSortKind::kReverseCuthillMcKee>;
+  using NodesSortedByCommunityEdgesSortedByDestID =
+      internal::PGViewNodesReorderedEdgesSortedByDestID<
+          RDGTopology::NodeSortKind::kCommunity>;
+  using NodesHubSortedEdgesSortedByDestID =
+      internal::PGViewNodesReorderedEdgesSortedByDestID<
+          RDGTopology::NodeSortKind::kHubSorted>;
+  using NodesHubClusteredEdgesSortedByDestID =
+      internal::PGViewNodesReorderedEdgesSortedByDestID<
+          RDGTopology::NodeSortKind::kHubClustered>;
+  /// The topology of View, which must have a single topology, e.g., Default
+  /// or Transposed, with edge ids of type EdgeIndex, see CSRTopology
+  template <typename View, typename EdgeIndex>
+  using WithEdgeIndex = internal::PGViewWithEdgeIndex<View, EdgeIndex>;
 };
 
 class KATANA_EXPORT PGViewCache {
@@ -1557,6 +1825,16 @@ class KATANA_EXPORT PGViewCache {
   std::vector<std::shared_ptr<EdgeTypeAwareTopology>> edge_type_aware_topos_;
   std::shared_ptr<CondensedTypeIDMap> edge_type_id_map_;
   // TODO(amber): define a node_type_id_map_;
+  bool numa_partitioned_{false};
+
+  // 32-bit adjacency indexes of the cached topologies, for the views with
+  // 32-bit edge ids. An index is dropped once the topology it narrows is no
+  // longer cached.
+  struct NarrowedAdjIndices {
+    std::weak_ptr<const GraphTopology> topo;
+    std::shared_ptr<const NUMAArray<uint32_t>> adj_indices;
+  };
+  std::vector<NarrowedAdjIndices> narrowed_adj_indices_;
 
   template <typename>
   friend struct internal::PGViewBuilder;
@@ -1593,6 +1871,14 @@ public:
   // Purge cache and construct an empty topology as the default one.
   void DropAllTopologies() noexcept;
 
+  /// Replace the default and the cached topologies with copies partitioned
+  /// across NUMA nodes, see GraphTopology::NUMAPartitionedCopy. Views built
+  /// earlier keep the topologies they share. Topologies built later are
+  /// partitioned too.
+  void PartitionAcrossNUMANodes() noexcept;
+
+  bool IsNUMAPartitioned() const noexcept { return numa_partitioned_; }
+
 private:
   std::shared_ptr<GraphTopology> GetDefaultTopology() const noexcept;
 
@@ -1623,6 +1909,14 @@ private:
 
   std::shared_ptr<EdgeTypeAwareTopology> BuildOrGetEdgeTypeAwareTopo(
       PropertyGraph* pg, const RDGTopology::TransposeKind& tpose_kind) noexcept;
+
+  /// The adjacency index of \p topo, which should be cached, narrowed to 32
+  /// bits; see CSRTopology::NarrowAdjIndices
+  std::shared_ptr<const NUMAArray<uint32_t>> BuildOrGetNarrowedAdjIndices(
+      const std::shared_ptr<const GraphTopology>& topo) noexcept;
+
+  /// Whether \p topo is the default or one of the cached topologies
+  bool IsCached(const GraphTopology* topo) const noexcept;
 };
 
 /// Creates a uniform-random CSR GraphTopology instance, where each node as
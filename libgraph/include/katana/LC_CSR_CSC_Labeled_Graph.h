@@ -1,6 +1,7 @@
 #pragma once
 
 #include "katana/LC_CSR_CSC_Graph.h"
+#include "katana/Threads.h"
 
 namespace katana {
 
@@ -482,7 +483,7 @@ private:
 
     // ordered map
     std::map<EdgeTy, uint32_t> sortedMap;
-    for (uint32_t i = 0; i < katana::activeThreads; ++i) {
+    for (uint32_t i = 0, num = katana::getActiveThreads(); i < num; ++i) {
       auto& edgeLabelsSet = *edgeLabels.getRemote(i);
       for (auto edgeLabel : edgeLabelsSet) {
         sortedMap[edgeLabel] = 1;
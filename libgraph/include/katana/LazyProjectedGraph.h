@@ -0,0 +1,198 @@
+#ifndef KATANA_LIBGRAPH_KATANA_LAZYPROJECTEDGRAPH_H_
+#define KATANA_LIBGRAPH_KATANA_LAZYPROJECTEDGRAPH_H_
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/GraphTopology.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Range.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A projection of a PropertyGraph that, unlike
+/// PropertyGraph::MakeProjectedGraph, does not copy the topology. It keeps a
+/// bitmask of the projected nodes and a table of the projected edge types, and
+/// skips the other nodes and edges while iterating. Nodes and edges keep their
+/// ids in the original graph, so node data can be indexed by them directly.
+///
+/// Making one is O(nodes) work, which suits projecting the same large graph
+/// often on different types. Since traversals still walk the skipped edges,
+/// sparse projections are better materialized: Materialize() makes the
+/// equivalent compact projected graph on demand and ShouldMaterialize() tells
+/// if the projection is sparse enough for it.
+///
+/// Nodes() is a forward range. Parallel loops should iterate over the ids of
+/// all nodes of the original graph and skip those for which KeepsNode() is
+/// false.
+///
+/// It is not a PropertyGraph: only code written against this interface
+/// traverses it lazily. Analytics routines, the lonestar projection arguments
+/// and the Python project() binding all take a PropertyGraph, so projecting
+/// for them still copies the topology, through Materialize().
+class KATANA_EXPORT LazyProjectedGraph : public GraphTopologyTypes {
+public:
+  /// Iterates over the projected out-edges of a node
+  class EdgeIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Edge;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Edge*;
+    using reference = const Edge&;
+
+    EdgeIterator() = default;
+
+    const Edge& operator*() const noexcept { return edge_; }
+
+    EdgeIterator& operator++() noexcept {
+      ++edge_;
+      SkipFilteredEdges();
+      return *this;
+    }
+
+    EdgeIterator operator++(int) noexcept {
+      EdgeIterator ret = *this;
+      ++*this;
+      return ret;
+    }
+
+    bool operator==(const EdgeIterator& that) const noexcept {
+      return edge_ == that.edge_;
+    }
+    bool operator!=(const EdgeIterator& that) const noexcept {
+      return !(*this == that);
+    }
+
+  private:
+    friend class LazyProjectedGraph;
+
+    EdgeIterator(const LazyProjectedGraph* graph, Edge edge, Edge end) noexcept
+        : graph_(graph), edge_(edge), end_(end) {
+      SkipFilteredEdges();
+    }
+
+    void SkipFilteredEdges() noexcept {
+      while (edge_ != end_ && !graph_->KeepsEdge(edge_)) {
+        ++edge_;
+      }
+    }
+
+    const LazyProjectedGraph* graph_{nullptr};
+    Edge edge_{0};
+    Edge end_{0};
+  };
+
+  using node_iterator = DynamicBitset::iterator;
+  using nodes_range = StandardRange<node_iterator>;
+  using edges_range = StandardRange<EdgeIterator>;
+
+  /// Projections with fewer than this fraction of the nodes of the original
+  /// graph should be materialized
+  static constexpr double kDefaultMinDensity = 0.1;
+
+  LazyProjectedGraph(LazyProjectedGraph&&) = default;
+  LazyProjectedGraph& operator=(LazyProjectedGraph&&) = default;
+
+  LazyProjectedGraph(const LazyProjectedGraph&) = delete;
+  LazyProjectedGraph& operator=(const LazyProjectedGraph&) = delete;
+
+  /// Project \p pg on the nodes that have one of \p node_types and the edges
+  /// between them that have one of \p edge_types; std::nullopt keeps all
+  /// nodes or edges
+  static Result<LazyProjectedGraph> Make(
+      PropertyGraph* pg, const std::optional<SetOfEntityTypeIDs>& node_types,
+      std::optional<SetOfEntityTypeIDs> edge_types);
+
+  static Result<LazyProjectedGraph> Make(
+      PropertyGraph* pg,
+      const std::optional<std::vector<std::string>>& node_types,
+      const std::optional<std::vector<std::string>>& edge_types);
+
+  /// Project \p pg on the nodes set in \p node_filter and the edges between
+  /// them that have one of \p edge_types
+  static Result<LazyProjectedGraph> Make(
+      PropertyGraph* pg, DynamicBitset node_filter,
+      std::optional<SetOfEntityTypeIDs> edge_types = std::nullopt);
+
+  const PropertyGraph& property_graph() const noexcept { return *pg_; }
+
+  /// Number of projected nodes
+  uint64_t NumNodes() const noexcept { return num_nodes_; }
+
+  /// Number of nodes of the original graph, i.e., the range of node ids
+  uint64_t NumOriginalNodes() const noexcept { return node_mask_.size(); }
+
+  bool KeepsNode(Node node) const noexcept { return node_mask_.test(node); }
+
+  /// \returns true iff \p edge, an out-edge of a projected node, is projected
+  bool KeepsEdge(Edge edge) const noexcept {
+    return node_mask_.test(pg_->topology().OutEdgeDst(edge)) &&
+           (edge_type_kept_.empty() ||
+            edge_type_kept_[pg_->GetTypeOfEdgeFromTopoIndex(edge)]);
+  }
+
+  /// The projected nodes in ascending order
+  nodes_range Nodes() const noexcept {
+    return MakeStandardRange(node_mask_.begin(), node_mask_.end());
+  }
+
+  /// The projected out-edges of \p node, which must be projected
+  edges_range OutEdges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(KeepsNode(node));
+    auto edges = pg_->topology().OutEdges(node);
+    return MakeStandardRange(
+        EdgeIterator(this, *edges.begin(), *edges.end()),
+        EdgeIterator(this, *edges.end(), *edges.end()));
+  }
+
+  Node OutEdgeDst(Edge edge) const noexcept {
+    return pg_->topology().OutEdgeDst(edge);
+  }
+
+  /// Fraction of the nodes of the original graph that are projected
+  double density() const noexcept {
+    return NumOriginalNodes() == 0
+               ? 1.0
+               : static_cast<double>(NumNodes()) / NumOriginalNodes();
+  }
+
+  /// \returns true iff traversals would mostly skip nodes and edges, i.e.,
+  /// the density is below \p min_density
+  bool ShouldMaterialize(
+      double min_density = kDefaultMinDensity) const noexcept {
+    return density() < min_density;
+  }
+
+  /// \returns the projection as a PropertyGraph with a compact topology, as
+  /// made by PropertyGraph::MakeProjectedGraph. It is made on the first call
+  /// and owned by this.
+  Result<PropertyGraph*> Materialize();
+
+private:
+  LazyProjectedGraph(
+      PropertyGraph* pg, DynamicBitset&& node_mask,
+      std::optional<SetOfEntityTypeIDs>&& edge_types,
+      std::vector<uint8_t>&& edge_type_kept) noexcept;
+
+  PropertyGraph* pg_;
+  DynamicBitset node_mask_;
+  uint64_t num_nodes_{0};
+  std::optional<SetOfEntityTypeIDs> edge_types_;
+  /// Whether the edges of each edge entity type are projected; empty if all
+  /// are
+  std::vector<uint8_t> edge_type_kept_;
+  std::unique_ptr<PropertyGraph> materialized_;
+};
+
+}  // namespace katana
+
+#endif
@@ -283,7 +283,8 @@ public:
       const std::vector<std::string>& edge_types);
 
   /// Make a projected graph from a property graph. Shares state with
-  /// the original graph.
+  /// the original graph. See LazyProjectedGraph for a projection that does
+  /// not copy the topology.
   static Result<std::unique_ptr<PropertyGraph>> MakeProjectedGraph(
       PropertyGraph& pg, std::optional<std::vector<std::string>> node_types,
       std::optional<std::vector<std::string>> edge_types);
@@ -294,6 +295,14 @@ public:
       PropertyGraph& pg, std::optional<SetOfEntityTypeIDs> node_types,
       std::optional<SetOfEntityTypeIDs> edge_types);
 
+  /// Make a projected graph containing the nodes set in \p node_filter (e.g.,
+  /// the result of an EntityIndex FindBatch or RangeScan) and the edges
+  /// between them, optionally restricted to \p edge_types. Shares state with
+  /// the original graph.
+  static Result<std::unique_ptr<PropertyGraph>> MakeProjectedGraph(
+      PropertyGraph& pg, const DynamicBitset& node_filter,
+      std::optional<SetOfEntityTypeIDs> edge_types = std::nullopt);
+
   /// \return A copy of this with the same set of properties. The copy shares no
   ///       state with this.
   Result<std::unique_ptr<PropertyGraph>> Copy(
@@ -723,6 +732,14 @@ public:
     return pg_view_cache_.DropAllTopologies();
   }
 
+  /// Place the topologies of this graph, and the ones its views build later,
+  /// blocked by node range across NUMA nodes; see
+  /// PGViewCache::PartitionAcrossNUMANodes. Loops over
+  /// OwnerComputesNodes() of a view then mostly read local memory.
+  void PartitionTopologyAcrossNUMANodes() noexcept {
+    pg_view_cache_.PartitionAcrossNUMANodes();
+  }
+
   const GraphTopology& topology() const noexcept {
     return pg_view_cache_.GetDefaultTopologyRef();
   }
@@ -936,14 +953,18 @@ public:
     return node_iterator(node_id);
   }
 
-  // Creates an index over a node property.
-  Result<void> MakeNodeIndex(const std::string& property_name);
+  // Creates an index over a node property. Hash indexes answer equality
+  // queries only and are only available for string properties.
+  Result<void> MakeNodeIndex(
+      const std::string& property_name, EntityIndexKind kind = kOrderedIndex);
 
   // Delete an existing index over a node property.
   Result<void> DeleteNodeIndex(const std::string& property_name);
 
-  // Creates an index over an edge property.
-  Result<void> MakeEdgeIndex(const std::string& property_name);
+  // Creates an index over an edge property. Hash indexes answer equality
+  // queries only and are only available for string properties.
+  Result<void> MakeEdgeIndex(
+      const std::string& property_name, EntityIndexKind kind = kOrderedIndex);
 
   // Delete an existing index over an edge property.
   Result<void> DeleteEdgeIndex(const std::string& property_name);
@@ -1043,6 +1064,10 @@ protected:
     auto n_edges = original_to_transformed_edges_.size();
     edge_bitmask_ = std::make_shared<arrow::Buffer>(
         edge_bitmask_data_.data(), arrow::BitUtil::BytesForBits(n_edges));
+
+    if (parent.pg_view_cache_.IsNUMAPartitioned()) {
+      pg_view_cache_.PartitionAcrossNUMANodes();
+    }
   }
 
   bool IsTransformed() const { return parent_ != nullptr; }
@@ -1061,11 +1086,29 @@ private:
   static std::unique_ptr<PropertyGraph> MakeEmptyProjectedGraph(
       PropertyGraph& pg, const DynamicBitset& bitset);
 
+  /// this function creates a projection of the num_new_nodes nodes set in
+  /// nodes_bitset; original_to_projected_nodes_mapping holds 1 for each of
+  /// those nodes and 0 otherwise
+  static Result<std::unique_ptr<PropertyGraph>> MakeProjectedGraphFromNodes(
+      PropertyGraph& pg, uint32_t num_new_nodes,
+      const DynamicBitset& nodes_bitset,
+      NUMAArray<Node>&& original_to_projected_nodes_mapping,
+      std::optional<SetOfEntityTypeIDs> edge_types);
+
   /// Validate performs a sanity check on the the graph after loading
   Result<void> Validate();
 
   Result<void> DoWriteTopologies();
 
+  /// Stage any indexes that are not already stored in the RDG to be written
+  /// along with it
+  void DoWriteIndexes();
+
+  /// Drop the in-memory and stored indexes over a property whose values are
+  /// about to change
+  void InvalidateNodeIndex(const std::string& property_name);
+  void InvalidateEdgeIndex(const std::string& property_name);
+
   Result<void> DoWrite(
       katana::RDGHandle handle, const std::string& command_line,
       katana::RDG::RDGVersioningPolicy versioning_action,
@@ -0,0 +1,199 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_FRONTIER_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_FRONTIER_H_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/config.h"
+
+namespace katana::analytics {
+
+/// The set of active nodes of a level synchronous algorithm (BFS, SSSP,
+/// k-core, ...). A round iterates over the current frontier with ForEach and
+/// pushes the nodes of the next round with Push; Finish then makes the pushed
+/// nodes the current frontier.
+///
+///   Frontier frontier(graph.NumNodes());
+///   frontier.Push(source);
+///   frontier.Finish();
+///   while (!frontier.empty()) {
+///     frontier.ForEach([&](uint32_t n) { ... frontier.Push(dst); ... });
+///     frontier.Finish();
+///   }
+///
+/// Finish removes duplicates and picks whichever representation is smallest
+/// for the new frontier:
+///
+/// - kSparse: a sorted vector of nodes, for small frontiers
+/// - kDense: a bitmap over all nodes, for large frontiers
+/// - kCompressed: a roaring style set of containers of 2^16 nodes each, where
+///   a container is a sorted array of its nodes or a bitmap, whichever is
+///   smaller, for mid sized frontiers that cluster in some ranges of nodes
+///
+/// Since the bitmap is only picked for frontiers of at least 1/32 of the
+/// nodes and bitmap containers only for containers with more than 4096 nodes,
+/// building, clearing and converting a frontier take time proportional to
+/// its size rather than to the number of nodes. A compressed frontier is
+/// built from the sorted vector, which is freed once the containers hold the
+/// frontier.
+class KATANA_EXPORT Frontier {
+public:
+  using Node = uint32_t;
+
+  enum class Representation { kSparse, kDense, kCompressed };
+
+  explicit Frontier(size_t num_nodes);
+
+  Frontier(const Frontier&) = delete;
+  Frontier& operator=(const Frontier&) = delete;
+
+  /// Add a node to the next frontier. Safe to call from parallel loops,
+  /// including ForEach on this frontier.
+  void Push(Node node) { pushed_.getLocal()->push_back(node); }
+
+  /// Replace the current frontier with the nodes pushed since the last call
+  /// to Finish. Do not call in a parallel region.
+  void Finish();
+
+  /// Make the current frontier contain every node
+  void SetAll();
+
+  /// Empty the current frontier; nodes already pushed are kept
+  void Clear();
+
+  /// Change the representation of the current frontier, e.g., to kDense
+  /// before a pull step that calls Contains for many nodes. The previous
+  /// representation stays valid until the frontier changes.
+  void ConvertTo(Representation representation);
+
+  /// Whether node is in the current frontier. Constant time for kDense,
+  /// logarithmic in the size of the frontier otherwise.
+  bool Contains(Node node) const {
+    if (dense_valid_) {
+      return dense_.test(node);
+    }
+    return SparseContains(node);
+  }
+
+  /// Call fn(node) for every node in the current frontier in parallel.
+  /// Extra arguments are passed to katana::do_all.
+  template <typename F, typename... Args>
+  void ForEach(const F& fn, const Args&... args) const {
+    ForEachIn(representation_, fn, args...);
+  }
+
+  /// The current frontier as a sorted vector
+  std::vector<Node> ToVector() const;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  size_t num_nodes() const { return num_nodes_; }
+  Representation representation() const { return representation_; }
+
+private:
+  static constexpr uint32_t kContainerBits = 16;
+  static constexpr uint32_t kContainerSize = uint32_t{1} << kContainerBits;
+  static constexpr uint32_t kContainerWords = kContainerSize / 64;
+  /// Containers with more nodes than this are bitmaps
+  static constexpr uint32_t kMaxArrayContainer = 4096;
+
+  struct Container {
+    /// Node id >> kContainerBits
+    uint32_t key;
+    uint32_t cardinality;
+    /// Index into array_values_ or bitmap_words_
+    size_t offset;
+
+    bool is_bitmap() const { return cardinality > kMaxArrayContainer; }
+  };
+
+  /// Sort and deduplicate the pushed nodes in sparse_
+  void BuildSparse();
+  /// Move the pushed nodes in sparse_ to the bitmap
+  void BuildDense();
+  /// Compute containers_ from the sorted vector and return their size in
+  /// bytes
+  size_t PlanContainers();
+  void FillContainers();
+  /// Append the nodes of the containers to nodes in ascending order
+  void DecodeContainers(std::vector<Node>* nodes) const;
+  void EnsureDenseAllocated();
+  void ClearDense();
+  /// Contains for the sorted vector and the containers
+  bool SparseContains(Node node) const;
+  /// ForEach using a representation that holds the current frontier
+  template <typename F, typename... Args>
+  void ForEachIn(
+      Representation representation, const F& fn, const Args&... args) const;
+
+  size_t num_nodes_;
+  size_t size_{0};
+  Representation representation_{Representation::kSparse};
+
+  // Which representations currently hold the frontier
+  bool sparse_valid_{true};
+  bool dense_valid_{false};
+  bool compressed_valid_{false};
+
+  std::vector<Node> sparse_;
+  /// All zero unless dense_valid_
+  katana::DynamicBitset dense_;
+  std::vector<Container> containers_;
+  std::vector<uint16_t> array_values_;
+  std::vector<uint64_t> bitmap_words_;
+
+  katana::PerThreadStorage<std::vector<Node>> pushed_;
+};
+
+template <typename F, typename... Args>
+void
+Frontier::ForEachIn(
+    Representation representation, const F& fn, const Args&... args) const {
+  switch (representation) {
+  case Representation::kSparse:
+    katana::do_all(katana::iterate(sparse_), fn, args...);
+    break;
+  case Representation::kDense: {
+    const auto& words = dense_.get_vec();
+    katana::do_all(
+        katana::iterate(size_t{0}, words.size()),
+        [&](size_t w) {
+          for (uint64_t word = words[w].load(std::memory_order_relaxed);
+               word != 0; word &= word - 1) {
+            fn(static_cast<Node>(w * 64 + __builtin_ctzll(word)));
+          }
+        },
+        args...);
+    break;
+  }
+  case Representation::kCompressed:
+    katana::do_all(
+        katana::iterate(containers_),
+        [&](const Container& c) {
+          Node base = c.key << kContainerBits;
+          if (c.is_bitmap()) {
+            const uint64_t* words = &bitmap_words_[c.offset];
+            for (uint32_t w = 0; w < kContainerWords; ++w) {
+              for (uint64_t word = words[w]; word != 0; word &= word - 1) {
+                fn(base + w * 64 + __builtin_ctzll(word));
+              }
+            }
+          } else {
+            const uint16_t* values = &array_values_[c.offset];
+            for (uint32_t i = 0; i < c.cardinality; ++i) {
+              fn(base + values[i]);
+            }
+          }
+        },
+        args...);
+    break;
+  }
+}
+
+}  // namespace katana::analytics
+
+#endif
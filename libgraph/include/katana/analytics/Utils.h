@@ -111,6 +111,25 @@ public:
   ~TemporaryPropertyGuard() { Deinit(); }
 };
 
+//! Passes a type to a generic lambda, see DispatchEdgeIndex
+template <typename T>
+struct TypeTag {
+  using type = T;
+};
+
+//! Calls fn(TypeTag<V>()) with the view V to run an algorithm on pg with:
+//! View with 32-bit edge ids if pg has fewer than 2^32 edges and View
+//! otherwise. Both must be instantiated, so the width is picked when the
+//! graph is known, but each algorithm is compiled for its edge id type.
+template <typename View, typename F>
+auto
+DispatchEdgeIndex(const PropertyGraph& pg, F&& fn) {
+  if (CSRTopology<uint32_t>::CanIndex(pg.NumEdges())) {
+    return fn(TypeTag<PropertyGraphViews::WithEdgeIndex<View, uint32_t>>());
+  }
+  return fn(TypeTag<View>());
+}
+
 KATANA_EXPORT void SplitStringByComma(
     std::string& str, std::vector<std::string>* vec);
 
@@ -17,7 +17,8 @@ public:
     kAsynchronous,
     kSynchronousTile,
     kSynchronous,
-    kSynchronousDirectOpt
+    kSynchronousDirectOpt,
+    kSynchronousDirectOptCompressed
   };
 
   static const int kDefaultEdgeTileSize = 256;
@@ -68,6 +69,17 @@ public:
       uint32_t alpha = kDefaultAlpha, uint32_t beta = kDefaultBeta) {
     return {kCPU, kSynchronousDirectOpt, 0, alpha, beta};
   }
+
+  /// SynchronousDirectOpt over CompressedTopologies of the out- and
+  /// in-neighbors, which have to be built first. The in-neighbors are
+  /// compressed from the CSR topology, so unlike SynchronousDirectOpt this
+  /// does not build and cache a transposed topology in the graph. The CSR
+  /// topology stays loaded while the compressed ones are in use, so they
+  /// take memory in addition to it.
+  static BfsPlan SynchronousDirectOptCompressed(
+      uint32_t alpha = kDefaultAlpha, uint32_t beta = kDefaultBeta) {
+    return {kCPU, kSynchronousDirectOptCompressed, 0, alpha, beta};
+  }
 };
 
 /// Compute BFS parent of nodes in the graph pg starting from start_node. The
@@ -26,7 +26,8 @@ public:
     kBlockedAsynchronous,
     kAfforest,
     kEdgeAfforest,
-    kEdgeTiledAfforest
+    kEdgeTiledAfforest,
+    kLabelPropCompressed
   };
 
   static const ptrdiff_t kDefaultEdgeTileSize = 512;
@@ -76,6 +77,16 @@ public:
     return {kCPU, kLabelProp, 0, 0, 0};
   }
 
+  /// LabelProp over a CompressedTopology of the undirected neighbors of a
+  /// directed graph, which has to be built first and is held in addition to
+  /// the CSR topology. It is compressed from the CSR topology, so unlike
+  /// LabelProp this does not build and cache a transposed topology in the
+  /// graph. Symmetric graphs are run with LabelProp, since their CSR
+  /// topology is the undirected one.
+  static ConnectedComponentsPlan LabelPropCompressed() {
+    return {kCPU, kLabelPropCompressed, 0, 0, 0};
+  }
+
   /// Synchronous connected components algorithm.  Initially all nodes are in
   /// their own component. Then, we merge endpoints of edges to form the spanning
   /// tree. Merging is done in two phases to simplify concurrent updates: (1)
@@ -18,6 +18,7 @@ public:
     kPullResidual,
     kPushSynchronous,
     kPushAsynchronous,
+    kPullTopologicalCompressed,
   };
 
   static constexpr double kDefaultTolerance = 1.0e-3;
@@ -66,6 +67,21 @@ public:
     return {kCPU, kPullTopological, tolerance, max_iterations, alpha};
   }
 
+  /// Topological pull algorithm over a CompressedTopology of the
+  /// in-neighbors, which has to be built first and is held in addition to
+  /// the CSR topology. It is compressed from the CSR topology, so unlike
+  /// PullTopological this does not build and cache a transposed topology in
+  /// the graph.
+  ///
+  /// The graph must be transposed to use this algorithm.
+  static PagerankPlan PullTopologicalCompressed(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha) {
+    return {
+        kCPU, kPullTopologicalCompressed, tolerance, max_iterations, alpha};
+  }
+
   /// Delta-residual pull algorithm
   ///
   /// The graph must be transposed to use this algorithm.
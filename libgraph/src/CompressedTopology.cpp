@@ -0,0 +1,181 @@
+#include "katana/CompressedTopology.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+
+namespace {
+
+using Node = katana::CompressedTopology::Node;
+
+size_t
+VarintSize(uint64_t value) {
+  size_t size = 1;
+  for (; value >= 0x80U; value >>= 7) {
+    ++size;
+  }
+  return size;
+}
+
+uint8_t*
+WriteVarint(uint64_t value, uint8_t* out) {
+  for (; value >= 0x80U; value >>= 7) {
+    *out++ = static_cast<uint8_t>(value | 0x80U);
+  }
+  *out++ = static_cast<uint8_t>(value);
+  return out;
+}
+
+uint64_t
+ZigZag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+/// Calls fn(value) for each varint of the encoding of the sorted neighbors
+/// of node
+template <typename F>
+void
+ForEachVarint(Node node, const std::vector<Node>& neighbors, const F& fn) {
+  fn(neighbors.size());
+  if (neighbors.empty()) {
+    return;
+  }
+  fn(ZigZag(int64_t{neighbors[0]} - int64_t{node}));
+  for (size_t i = 1; i < neighbors.size(); ++i) {
+    fn(neighbors[i] - neighbors[i - 1]);
+  }
+}
+
+/// The sources of the in-edges of the nodes of a topology, grouped by
+/// destination: the in-neighbors of node n are
+/// sources[offsets[n], offsets[n + 1])
+struct InNeighbors {
+  katana::NUMAArray<uint64_t> offsets;
+  katana::NUMAArray<Node> sources;
+
+  void AppendTo(Node n, std::vector<Node>* neighbors) const {
+    neighbors->insert(
+        neighbors->end(), sources.begin() + offsets[n],
+        sources.begin() + offsets[n + 1]);
+  }
+};
+
+InNeighbors
+MakeInNeighbors(const katana::GraphTopology& topology) {
+  const uint64_t num_nodes = topology.NumNodes();
+
+  // cursors[n + 1] counts the in-edges of n, then cursors[n] is where the
+  // next in-neighbor of n goes
+  katana::NUMAArray<std::atomic<uint64_t>> cursors;
+  cursors.allocateBlocked(num_nodes + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes + 1),
+      [&](uint64_t n) { cursors.constructAt(n, 0); }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(topology.OutEdges()),
+      [&](auto e) {
+        cursors[topology.OutEdgeDst(e) + 1].fetch_add(
+            1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  InNeighbors in;
+  in.offsets.allocateBlocked(num_nodes + 1);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes + 1),
+      [&](uint64_t n) { in.offsets[n] = cursors[n].load(); },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      in.offsets.begin(), in.offsets.end(), in.offsets.begin());
+
+  in.sources.allocateBlocked(topology.NumEdges());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) { cursors[n] = in.offsets[n]; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(topology.Nodes()),
+      [&](Node src) {
+        for (auto e : topology.OutEdges(src)) {
+          auto pos = cursors[topology.OutEdgeDst(e)].fetch_add(
+              1, std::memory_order_relaxed);
+          in.sources[pos] = src;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return in;
+}
+
+}  // namespace
+
+katana::CompressedTopology
+katana::CompressedTopology::MakeTransposed(const GraphTopology& topology) {
+  const InNeighbors in = MakeInNeighbors(topology);
+  return Make(topology.NumNodes(), [&](Node n, std::vector<Node>* neighbors) {
+    in.AppendTo(n, neighbors);
+  });
+}
+
+katana::CompressedTopology
+katana::CompressedTopology::MakeUndirected(const GraphTopology& topology) {
+  const InNeighbors in = MakeInNeighbors(topology);
+  return Make(topology.NumNodes(), [&](Node n, std::vector<Node>* neighbors) {
+    for (auto e : topology.OutEdges(n)) {
+      neighbors->push_back(topology.OutEdgeDst(e));
+    }
+    in.AppendTo(n, neighbors);
+  });
+}
+
+katana::CompressedTopology
+katana::CompressedTopology::Make(
+    uint64_t num_nodes, const GetNeighborsFn& get_neighbors) {
+  CompressedTopology ret;
+  ret.offsets_.allocateBlocked(num_nodes + 1);
+  ret.offsets_[0] = 0;
+
+  katana::PerThreadStorage<std::vector<Node>> neighbors;
+  auto get_sorted = [&](Node node) -> std::vector<Node>& {
+    std::vector<Node>& local = *neighbors.getLocal();
+    local.clear();
+    get_neighbors(node, &local);
+    std::sort(local.begin(), local.end());
+    return local;
+  };
+
+  // Size the encoding of every node, then encode each node at the prefix sum
+  // of the sizes before it
+  katana::GAccumulator<uint64_t> num_edges;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t node) {
+        const std::vector<Node>& sorted = get_sorted(node);
+        size_t size = 0;
+        ForEachVarint(
+            node, sorted, [&](uint64_t value) { size += VarintSize(value); });
+        ret.offsets_[node + 1] = size;
+        num_edges += sorted.size();
+      },
+      katana::steal(), katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      ret.offsets_.begin(), ret.offsets_.end(), ret.offsets_.begin());
+  ret.num_edges_ = num_edges.reduce();
+
+  ret.data_.allocateBlocked(ret.offsets_[num_nodes]);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t node) {
+        uint8_t* out = &ret.data_[ret.offsets_[node]];
+        ForEachVarint(node, get_sorted(node), [&](uint64_t value) {
+          out = WriteVarint(value, out);
+        });
+        KATANA_LOG_DEBUG_ASSERT(
+            out == ret.data_.data() + ret.offsets_[node + 1]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return ret;
+}
@@ -1,7 +1,127 @@
 #include "katana/EntityIndex.h"
 
+#include <numeric>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
 
+namespace {
+
+// Returns, in ascending order, the ids in [0, num_entities) whose property
+// value is not null.
+template <typename node_or_edge>
+katana::NUMAArray<node_or_edge>
+ValidEntities(const arrow::Array& property, size_t num_entities) {
+  katana::NUMAArray<node_or_edge> ids;
+
+  if (property.null_count() == 0) {
+    ids.allocateBlocked(num_entities);
+    katana::ParallelSTL::iota(ids.begin(), ids.end(), node_or_edge{0});
+    return ids;
+  }
+
+  // Count the valid entities in each thread's block, then have every thread
+  // copy its ids to its offset in the output.
+  std::vector<size_t> offsets(katana::getActiveThreads() + 1, 0);
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] =
+        katana::block_range(size_t{0}, num_entities, tid, total);
+    size_t count = 0;
+    for (size_t i = begin; i < end; ++i) {
+      if (property.IsValid(i)) {
+        ++count;
+      }
+    }
+    offsets[tid + 1] = count;
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  ids.allocateBlocked(offsets.back());
+  katana::on_each([&](unsigned tid, unsigned total) {
+    auto [begin, end] =
+        katana::block_range(size_t{0}, num_entities, tid, total);
+    size_t out = offsets[tid];
+    for (size_t i = begin; i < end; ++i) {
+      if (property.IsValid(i)) {
+        ids[out++] = static_cast<node_or_edge>(i);
+      }
+    }
+  });
+
+  return ids;
+}
+
+// Returns a bitset over num_entities with the bits of ids[begin, end) set.
+template <typename node_or_edge>
+katana::DynamicBitset
+MarkRange(
+    const katana::NUMAArray<node_or_edge>& ids, size_t num_entities,
+    size_t begin, size_t end) {
+  katana::DynamicBitset bitset;
+  bitset.resize(num_entities);
+  katana::do_all(
+      katana::iterate(begin, end), [&](size_t i) { bitset.set(ids[i]); },
+      katana::no_stats());
+  return bitset;
+}
+
+// Sorts and deduplicates `probes` and then, in parallel, marks the ids of the
+// index positions [begin, end) returned by `bounds` for each probe. Sorting
+// keeps neighbouring probes' binary searches on the same part of the index.
+template <typename node_or_edge, typename Probe, typename BoundsFn>
+katana::DynamicBitset
+MarkProbes(
+    const katana::NUMAArray<node_or_edge>& ids, size_t num_entities,
+    std::vector<Probe>* probes, const BoundsFn& bounds) {
+  katana::ParallelSTL::sort(probes->begin(), probes->end());
+  probes->erase(std::unique(probes->begin(), probes->end()), probes->end());
+
+  katana::DynamicBitset bitset;
+  bitset.resize(num_entities);
+  katana::do_all(
+      katana::iterate(*probes),
+      [&](const Probe& probe) {
+        auto [begin, end] = bounds(probe);
+        for (size_t i = begin; i < end; ++i) {
+          bitset.set(ids[i]);
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return bitset;
+}
+
+katana::Result<void>
+CheckPrimitive(
+    const katana::EntityIndexPrimitive& primitive, uint64_t num_entities,
+    uint64_t id_width, uint64_t key_width, bool is_hash_index) {
+  if (primitive.num_entities() != num_entities) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "stored index over {} has {} entities, expected {}",
+        primitive.property_name(), primitive.num_entities(), num_entities);
+  }
+  if (primitive.id_width() != id_width || primitive.key_width() != key_width) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "stored index over {} has id/key width {}/{}, expected {}/{}",
+        primitive.property_name(), primitive.id_width(), primitive.key_width(),
+        id_width, key_width);
+  }
+  if (primitive.is_hash_index() != is_hash_index) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "stored index over {} is not {} index", primitive.property_name(),
+        is_hash_index ? "a hash" : "an ordered");
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
 namespace katana {
 
 // Switch statement over creation of per-type indexes.
@@ -9,9 +129,22 @@ template <typename node_or_edge>
 Result<std::unique_ptr<EntityIndex<node_or_edge>>>
 MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property) {
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind) {
   std::unique_ptr<EntityIndex<node_or_edge>> index;
 
+  if (kind == kHashIndex) {
+    if (property->type_id() != arrow::Type::LARGE_STRING) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Hash indexes are only supported over strings, not {}",
+          property->type()->ToString());
+    }
+    index = std::make_unique<HashStringEntityIndex<node_or_edge>>(
+        property_name, num_entities, property);
+    return Result<std::unique_ptr<EntityIndex<node_or_edge>>>(
+        std::move(index));
+  }
+
   switch (property->type_id()) {
   case arrow::Type::BOOL:
     index = std::make_unique<PrimitiveEntityIndex<node_or_edge, bool>>(
@@ -55,14 +188,33 @@ PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
-    }
-  }
+  NUMAArray<node_or_edge> valid =
+      ValidEntities<node_or_edge>(*property_, num_entities_);
+
+  // Sort packed (value, id) pairs rather than ids so that comparisons never
+  // go back to the Arrow array.
+  NUMAArray<std::pair<c_type, node_or_edge>> entries;
+  entries.allocateBlocked(valid.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, valid.size()),
+      [&](size_t i) {
+        entries[i] = std::make_pair(property_->Value(valid[i]), valid[i]);
+      },
+      katana::no_stats());
+  valid.destroy();
+  valid.deallocate();
+
+  ParallelSTL::sort(entries.begin(), entries.end());
+
+  keys_.allocateBlocked(entries.size());
+  ids_.allocateBlocked(entries.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, entries.size()),
+      [&](size_t i) {
+        keys_[i] = entries[i].first;
+        ids_[i] = entries[i].second;
+      },
+      katana::no_stats());
 
   return katana::ResultSuccess();
 }
@@ -75,18 +227,288 @@ StringEntityIndex<node_or_edge>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
+  ids_ = ValidEntities<node_or_edge>(*property_, num_entities_);
+
+  ParallelSTL::sort(
+      ids_.begin(), ids_.end(), [this](node_or_edge a, node_or_edge b) {
+        std::string_view val_a = GetValue(a);
+        std::string_view val_b = GetValue(b);
+        return val_a < val_b || (val_a == val_b && a < b);
+      });
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+DynamicBitset
+PrimitiveEntityIndex<node_or_edge, c_type>::FindBatch(
+    const std::vector<c_type>& keys) const {
+  std::vector<c_type> probes(keys);
+  return MarkProbes(ids_, num_entities_, &probes, [this](c_type key) {
+    return std::make_pair(LowerBoundPos(key), UpperBoundPos(key));
+  });
+}
+
+template <typename node_or_edge, typename c_type>
+DynamicBitset
+PrimitiveEntityIndex<node_or_edge, c_type>::RangeScan(
+    c_type lo, c_type hi) const {
+  size_t begin = LowerBoundPos(lo);
+  size_t end = std::max(begin, UpperBoundPos(hi));
+  return MarkRange(ids_, num_entities_, begin, end);
+}
+
+template <typename node_or_edge>
+DynamicBitset
+StringEntityIndex<node_or_edge>::FindBatch(
+    const std::vector<std::string>& keys) const {
+  std::vector<std::string_view> probes(keys.begin(), keys.end());
+  return MarkProbes(ids_, num_entities_, &probes, [this](std::string_view key) {
+    return std::make_pair(LowerBoundPos(key), UpperBoundPos(key));
+  });
+}
+
+template <typename node_or_edge>
+DynamicBitset
+StringEntityIndex<node_or_edge>::RangeScan(
+    std::string_view lo, std::string_view hi) const {
+  size_t begin = LowerBoundPos(lo);
+  size_t end = std::max(begin, UpperBoundPos(hi));
+  return MarkRange(ids_, num_entities_, begin, end);
+}
+
+template <typename node_or_edge>
+DynamicBitset
+StringEntityIndex<node_or_edge>::PrefixScan(std::string_view prefix) const {
+  auto [begin, end] = PrefixPos(prefix);
+  return MarkRange(ids_, num_entities_, begin, end);
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromPrimitive(
+    EntityIndexPrimitive&& primitive) {
+  KATANA_CHECKED(CheckPrimitive(
+      primitive, num_entities_, sizeof(node_or_edge), sizeof(c_type), false));
+  KATANA_CHECKED(primitive.Bind());
+
+  storage_ = std::move(primitive);
+  // NUMAArrays constructed from a buffer do not own it.
+  ids_ = NUMAArray<node_or_edge>(
+      const_cast<void*>(storage_.ids()), storage_.num_keys());
+  keys_ = NUMAArray<c_type>(
+      const_cast<void*>(storage_.keys()), storage_.num_keys());
+  this->loaded_from_storage_ = true;
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+EntityIndexPrimitive
+PrimitiveEntityIndex<node_or_edge, c_type>::ToPrimitive() const {
+  EntityIndexPrimitive primitive;
+  primitive.set_property_name(this->property_name());
+  primitive.set_num_entities(num_entities_);
+  primitive.set_ids(ids_.data(), ids_.size(), sizeof(node_or_edge));
+  primitive.set_keys(keys_.data(), sizeof(c_type));
+  return primitive;
+}
+
+template <typename node_or_edge>
+Result<void>
+StringEntityIndex<node_or_edge>::BuildFromPrimitive(
+    EntityIndexPrimitive&& primitive) {
+  KATANA_CHECKED(CheckPrimitive(
+      primitive, num_entities_, sizeof(node_or_edge), 0, false));
+  KATANA_CHECKED(primitive.Bind());
+
+  storage_ = std::move(primitive);
+  // NUMAArrays constructed from a buffer do not own it.
+  ids_ = NUMAArray<node_or_edge>(
+      const_cast<void*>(storage_.ids()), storage_.num_keys());
+  this->loaded_from_storage_ = true;
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+EntityIndexPrimitive
+StringEntityIndex<node_or_edge>::ToPrimitive() const {
+  EntityIndexPrimitive primitive;
+  primitive.set_property_name(this->property_name());
+  primitive.set_num_entities(num_entities_);
+  primitive.set_ids(ids_.data(), ids_.size(), sizeof(node_or_edge));
+  return primitive;
+}
+
+template <typename node_or_edge>
+Result<void>
+HashStringEntityIndex<node_or_edge>::BuildFromProperty() {
+  if (static_cast<uint64_t>(property_->length()) < num_entities_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Property does not contain all entities");
+  }
+
+  NUMAArray<node_or_edge> valid =
+      ValidEntities<node_or_edge>(*property_, num_entities_);
+
+  // Hash every value once up front; the sort only looks at the strings of
+  // entries whose hashes collide.
+  NUMAArray<std::pair<uint64_t, node_or_edge>> entries;
+  entries.allocateBlocked(valid.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, valid.size()),
+      [&](size_t i) {
+        entries[i] = std::make_pair(Hash(GetValue(valid[i])), valid[i]);
+      },
+      katana::no_stats());
+  valid.destroy();
+  valid.deallocate();
+
+  ParallelSTL::sort(
+      entries.begin(), entries.end(), [this](const auto& a, const auto& b) {
+        if (a.first != b.first) {
+          return a.first < b.first;
+        }
+        std::string_view val_a = GetValue(a.second);
+        std::string_view val_b = GetValue(b.second);
+        return val_a < val_b || (val_a == val_b && a.second < b.second);
+      });
+
+  ids_.allocateBlocked(entries.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, entries.size()),
+      [&](size_t i) { ids_[i] = entries[i].second; }, katana::no_stats());
+
+  BuildTable();
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+void
+HashStringEntityIndex<node_or_edge>::BuildTable() {
+  size_t num_ids = ids_.size();
+
+  NUMAArray<uint64_t> id_hashes;
+  id_hashes.allocateBlocked(num_ids);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_ids),
+      [&](size_t i) { id_hashes[i] = Hash(GetValue(ids_[i])); },
+      katana::no_stats());
+
+  // A position starts a new code when its value differs from the previous
+  // one; a prefix sum over the starts gives each position its code plus one.
+  NUMAArray<uint64_t> codes;
+  codes.allocateBlocked(num_ids);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_ids),
+      [&](size_t i) {
+        codes[i] = i == 0 || id_hashes[i] != id_hashes[i - 1] ||
+                   GetValue(ids_[i]) != GetValue(ids_[i - 1]);
+      },
+      katana::no_stats());
+  ParallelSTL::partial_sum(codes.begin(), codes.end(), codes.begin());
+
+  uint64_t num_codes = num_ids == 0 ? 0 : codes[num_ids - 1];
+  offsets_.allocateBlocked(num_codes + 1);
+  hashes_.allocateBlocked(num_codes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_ids),
+      [&](size_t i) {
+        if (i == 0 || codes[i] != codes[i - 1]) {
+          offsets_[codes[i] - 1] = i;
+          hashes_[codes[i] - 1] = id_hashes[i];
+        }
+      },
+      katana::no_stats());
+  offsets_[num_codes] = num_ids;
+
+  // Keep the table at most half full so that probe sequences stay short.
+  size_t num_slots = 1;
+  while (num_slots < 2 * num_codes) {
+    num_slots *= 2;
+  }
+  slots_.allocateBlocked(num_slots);
+  ParallelSTL::fill(slots_.begin(), slots_.end(), uint64_t{0});
+
+  uint64_t mask = num_slots - 1;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_codes),
+      [&](uint64_t code) {
+        for (uint64_t slot = hashes_[code] & mask;;
+             slot = (slot + 1) & mask) {
+          if (__sync_bool_compare_and_swap(&slots_[slot], 0, code + 1)) {
+            return;
+          }
+        }
+      },
+      katana::no_stats());
+}
+
+template <typename node_or_edge>
+uint64_t
+HashStringEntityIndex<node_or_edge>::FindCode(std::string_view key) const {
+  if (slots_.empty()) {
+    return kNoCode;
+  }
+  uint64_t hash = Hash(key);
+  uint64_t mask = slots_.size() - 1;
+  for (uint64_t slot = hash & mask; slots_[slot] != 0;
+       slot = (slot + 1) & mask) {
+    uint64_t code = slots_[slot] - 1;
+    if (hashes_[code] == hash && GetValue(ids_[offsets_[code]]) == key) {
+      return code;
     }
   }
+  return kNoCode;
+}
+
+template <typename node_or_edge>
+DynamicBitset
+HashStringEntityIndex<node_or_edge>::FindBatch(
+    const std::vector<std::string>& keys) const {
+  std::vector<std::string_view> probes(keys.begin(), keys.end());
+  return MarkProbes(ids_, num_entities_, &probes, [this](std::string_view key) {
+    uint64_t code = FindCode(key);
+    if (code == kNoCode) {
+      return std::make_pair(uint64_t{0}, uint64_t{0});
+    }
+    return std::make_pair(offsets_[code], offsets_[code + 1]);
+  });
+}
+
+template <typename node_or_edge>
+Result<void>
+HashStringEntityIndex<node_or_edge>::BuildFromPrimitive(
+    EntityIndexPrimitive&& primitive) {
+  KATANA_CHECKED(CheckPrimitive(
+      primitive, num_entities_, sizeof(node_or_edge), 0, true));
+  KATANA_CHECKED(primitive.Bind());
+
+  storage_ = std::move(primitive);
+  // NUMAArrays constructed from a buffer do not own it.
+  ids_ = NUMAArray<node_or_edge>(
+      const_cast<void*>(storage_.ids()), storage_.num_keys());
+
+  // The stored ids are already grouped, so only the table needs rebuilding.
+  BuildTable();
+  this->loaded_from_storage_ = true;
 
   return katana::ResultSuccess();
 }
 
+template <typename node_or_edge>
+EntityIndexPrimitive
+HashStringEntityIndex<node_or_edge>::ToPrimitive() const {
+  EntityIndexPrimitive primitive;
+  primitive.set_property_name(this->property_name());
+  primitive.set_num_entities(num_entities_);
+  primitive.set_is_hash_index(true);
+  primitive.set_ids(ids_.data(), ids_.size(), sizeof(node_or_edge));
+  return primitive;
+}
+
 // Forward declare template types to allow implementation in .cpp.
 template class PrimitiveEntityIndex<GraphTopology::Node, bool>;
 template class PrimitiveEntityIndex<GraphTopology::Edge, bool>;
@@ -102,13 +524,16 @@ template class PrimitiveEntityIndex<GraphTopology::Edge, double_t>;
 template class StringEntityIndex<GraphTopology::Node>;
 template class StringEntityIndex<GraphTopology::Edge>;
 
+template class HashStringEntityIndex<GraphTopology::Node>;
+template class HashStringEntityIndex<GraphTopology::Edge>;
+
 template Result<std::unique_ptr<EntityIndex<GraphTopology::Node>>>
 MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind);
 template Result<std::unique_ptr<EntityIndex<GraphTopology::Edge>>>
 MakeTypedEntityIndex(
     const std::string& property_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind);
 
 }  // namespace katana
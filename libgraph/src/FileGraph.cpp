@@ -31,6 +31,8 @@
 
 #include "katana/Logging.h"
 #include "katana/PageAlloc.h"
+#include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/file.h"
 #include "katana/gIO.h"
 
@@ -455,7 +457,8 @@ FileGraph::partFromFile(
 
   // do interleaved numa allocation with current number of threads
   if (numaMap) {
-    unsigned int numThreads = katana::activeThreads;
+    katana::ThreadPool::StartGuard start_guard;
+    unsigned int numThreads = katana::getActiveThreads();
     const size_t hugePageSize = 2 * 1024 * 1024;  // 2MB
 
     void* ptr;
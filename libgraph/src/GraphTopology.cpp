@@ -2,13 +2,22 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <limits>
+#include <typeinfo>
 
+#include "katana/Bag.h"
+#include "katana/GraphHelpers.h"
 #include "katana/Logging.h"
+#include "katana/PerThreadStorage.h"
 #include "katana/PropertyGraph.h"
 #include "katana/RDGTopology.h"
 #include "katana/Random.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
+#include "katana/Threads.h"
 
 katana::GraphTopology::~GraphTopology() = default;
 
@@ -63,6 +72,14 @@ katana::GraphTopology::GraphTopology(
   }
 }
 
+katana::GraphTopology::GraphTopology(
+    const Edge* adj_indices, size_t num_nodes, const Node* dests,
+    size_t num_edges, std::shared_ptr<void> storage) noexcept
+    // NUMAArrays constructed from a buffer do not own it.
+    : adj_indices_(const_cast<Edge*>(adj_indices), num_nodes),
+      dests_(const_cast<Node*>(dests), num_edges),
+      storage_(std::move(storage)) {}
+
 katana::GraphTopology::GraphTopology(
     AdjIndexVec&& adj_indices, EdgeDestVec&& dests) noexcept
     : adj_indices_(std::move(adj_indices)), dests_(std::move(dests)) {}
@@ -104,6 +121,127 @@ katana::GraphTopology::GetNodePropertyIndex(const Node& nid) const noexcept {
   return node_prop_indices_.empty() ? nid : node_prop_indices_[nid];
 }
 
+namespace {
+
+/// A copy of \p array where thread i pages in and copies the elements
+/// [ranges[i], ranges[i + 1])
+template <typename T, typename RangeArray>
+katana::NUMAArray<T>
+PlacedCopy(const katana::NUMAArray<T>& array, const RangeArray& ranges) {
+  katana::NUMAArray<T> placed;
+  if (array.empty()) {
+    return placed;
+  }
+  placed.allocateSpecified(array.size(), ranges);
+  katana::on_each([&](unsigned tid, unsigned) {
+    std::copy(
+        array.data() + ranges[tid], array.data() + ranges[tid + 1],
+        placed.data() + ranges[tid]);
+  });
+  return placed;
+}
+
+}  // namespace
+
+katana::GraphTopology::GraphTopology(
+    const GraphTopology& that, NUMAPartitionedCopy) noexcept {
+  uint32_t num_threads = katana::getActiveThreads();
+  // Pull style loops do about as much work per node as per edge
+  constexpr uint32_t kNodeAlpha = 1;
+  std::vector<uint32_t> node_ranges = katana::determineUnitRangesFromPrefixSum(
+      num_threads, that.adj_indices_, that.NumNodes(), kNodeAlpha);
+  std::vector<uint64_t> edge_ranges(num_threads + 1);
+  for (uint32_t i = 0; i <= num_threads; ++i) {
+    edge_ranges[i] =
+        node_ranges[i] == 0 ? 0 : that.adj_indices_[node_ranges[i] - 1];
+  }
+
+  adj_indices_ = PlacedCopy(that.adj_indices_, node_ranges);
+  dests_ = PlacedCopy(that.dests_, edge_ranges);
+  node_prop_indices_ = PlacedCopy(that.node_prop_indices_, node_ranges);
+  edge_prop_indices_ = PlacedCopy(that.edge_prop_indices_, edge_ranges);
+  thread_ranges_ = std::move(node_ranges);
+}
+
+bool
+katana::GraphTopology::IsNUMAPartitioned() const noexcept {
+  return thread_ranges_.size() == katana::getActiveThreads() + 1;
+}
+
+std::vector<uint32_t>
+katana::GraphTopology::OwnerThreadRanges() const noexcept {
+  if (IsNUMAPartitioned()) {
+    return thread_ranges_;
+  }
+  uint32_t num_threads = katana::getActiveThreads();
+  std::vector<uint32_t> ranges(num_threads + 1);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    ranges[i] =
+        katana::block_range(Node{0}, Node(NumNodes()), i, num_threads).first;
+  }
+  ranges[num_threads] = NumNodes();
+  return ranges;
+}
+
+template <typename EdgeIndex>
+std::shared_ptr<const katana::NUMAArray<EdgeIndex>>
+katana::CSRTopology<EdgeIndex>::NarrowAdjIndices(
+    const GraphTopology& topo) noexcept {
+  KATANA_LOG_ASSERT(CanIndex(topo.NumEdges()));
+  auto narrowed = std::make_shared<NUMAArray<EdgeIndex>>();
+  if (topo.empty()) {
+    return narrowed;
+  }
+  std::vector<uint32_t> ranges = topo.OwnerThreadRanges();
+  narrowed->allocateSpecified(topo.NumNodes(), ranges);
+
+  const GraphTopology::Edge* wide = topo.AdjData();
+  katana::do_all(
+      topo.OwnerComputesNodes(),
+      [&](Node n) { (*narrowed)[n] = static_cast<EdgeIndex>(wide[n]); },
+      katana::no_stats());
+  return narrowed;
+}
+
+template <typename EdgeIndex>
+katana::CSRTopology<EdgeIndex>
+katana::CSRTopology<EdgeIndex>::Make(
+    std::shared_ptr<const GraphTopology> topo) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(topo);
+  if constexpr (std::is_same_v<EdgeIndex, GraphTopology::Edge>) {
+    return Make(std::move(topo), nullptr);
+  } else {
+    auto adj_indices = NarrowAdjIndices(*topo);
+    return Make(std::move(topo), std::move(adj_indices));
+  }
+}
+
+template <typename EdgeIndex>
+katana::CSRTopology<EdgeIndex>
+katana::CSRTopology<EdgeIndex>::Make(
+    std::shared_ptr<const GraphTopology> topo,
+    std::shared_ptr<const NUMAArray<Edge>> adj_indices) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(topo);
+  KATANA_LOG_ASSERT(CanIndex(topo->NumEdges()));
+
+  CSRTopology ret;
+  ret.dests_ = topo->DestData();
+  if constexpr (std::is_same_v<EdgeIndex, GraphTopology::Edge>) {
+    ret.adj_indices_ = topo->AdjData();
+  } else {
+    KATANA_LOG_DEBUG_ASSERT(
+        adj_indices && adj_indices->size() == topo->NumNodes());
+    ret.adj_indices_ = adj_indices->data();
+    ret.narrowed_adj_indices_ = std::move(adj_indices);
+  }
+  ret.topo_ = std::move(topo);
+
+  return ret;
+}
+
+template class katana::CSRTopology<uint32_t>;
+template class katana::CSRTopology<uint64_t>;
+
 katana::ShuffleTopology::~ShuffleTopology() = default;
 
 std::shared_ptr<katana::ShuffleTopology>
@@ -337,41 +475,123 @@ katana::EdgeShuffleTopology::FindAllEdges(
   return ret_range;
 }
 
+namespace {
+
+/// Adjacency lists longer than this are sorted by all threads together
+constexpr uint64_t kParallelSortDegree = uint64_t{1} << 14;
+
+/// An edge and the key it is sorted by. Ties are broken by property index so
+/// that the order does not depend on the number of threads.
+template <typename Key>
+struct SortableEdge {
+  Key key;
+  katana::GraphTopologyTypes::Node dest;
+  katana::GraphTopologyTypes::PropertyIndex prop_index;
+
+  bool operator<(const SortableEdge& that) const noexcept {
+    if (key < that.key) {
+      return true;
+    }
+    if (that.key < key) {
+      return false;
+    }
+    return prop_index < that.prop_index;
+  }
+};
+
+/// Sort the out-edges of each node of topo, i.e., the ranges of dests and
+/// prop_indices, by key_fn(dest, prop_index).
+///
+/// The key of an edge is computed once instead of at every comparison, and
+/// edges are sorted as plain structs rather than through a zip iterator.
+/// Each adjacency list is sorted by one thread, except for those of hub
+/// nodes, which would leave one thread sorting while the others wait; they
+/// are sorted one at a time by all threads.
+template <typename KeyFn>
 void
-katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
+SortOutEdges(
+    const katana::GraphTopology& topo,
+    katana::GraphTopologyTypes::EdgeDestVec* dests,
+    katana::GraphTopologyTypes::PropIndexVec* prop_indices,
+    const KeyFn& key_fn) {
+  using Node = katana::GraphTopologyTypes::Node;
+  using Edge = katana::GraphTopologyTypes::Edge;
+  using Key = std::invoke_result_t<
+      KeyFn, Node, katana::GraphTopologyTypes::PropertyIndex>;
+  using Item = SortableEdge<Key>;
+
+  auto make_item = [&](Edge e) {
+    return Item{
+        key_fn((*dests)[e], (*prop_indices)[e]), (*dests)[e],
+        (*prop_indices)[e]};
+  };
+
+  katana::PerThreadStorage<std::vector<Item>> scratch;
+  katana::InsertBag<Node> hubs;
+
   katana::do_all(
-      katana::iterate(Nodes()),
+      katana::iterate(topo.Nodes()),
       [&](Node node) {
-        // get this node's first and last edge
-        auto e_beg = *OutEdges(node).begin();
-        auto e_end = *OutEdges(node).end();
-
-        // get iterators to locations to sort in the vector
-        auto begin_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_beg, GetDests().begin() + e_beg);
-
-        auto end_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_end, GetDests().begin() + e_end);
-
-        // rearrange vector indices based on how the destinations of this
-        // graph will eventually be sorted sort function not based on vector
-        // being passed, but rather the type and destination of the graph
-        std::sort(
-            begin_sort_iter, end_sort_iter,
-            [&](const auto& tup1, const auto& tup2) {
-              auto dst1 = std::get<1>(tup1);
-              auto dst2 = std::get<1>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(dst1), GraphTopology::Node>);
-              static_assert(
-                  std::is_same_v<decltype(dst2), GraphTopology::Node>);
-              return dst1 < dst2;
-            });
-
-        KATANA_LOG_DEBUG_ASSERT(std::is_sorted(
-            GetDests().begin() + e_beg, GetDests().begin() + e_end));
+        auto e_beg = *topo.OutEdges(node).begin();
+        auto e_end = *topo.OutEdges(node).end();
+        if (e_end - e_beg > kParallelSortDegree) {
+          hubs.push(node);
+          return;
+        }
+        if (e_end - e_beg < 2) {
+          return;
+        }
+
+        std::vector<Item>& items = *scratch.getLocal();
+        items.clear();
+        for (auto e = e_beg; e != e_end; ++e) {
+          items.push_back(make_item(e));
+        }
+        std::sort(items.begin(), items.end());
+        for (size_t i = 0; i < items.size(); ++i) {
+          (*dests)[e_beg + i] = items[i].dest;
+          (*prop_indices)[e_beg + i] = items[i].prop_index;
+        }
       },
       katana::steal(), katana::no_stats());
+
+  for (Node node : hubs) {
+    auto e_beg = *topo.OutEdges(node).begin();
+    auto e_end = *topo.OutEdges(node).end();
+
+    katana::NUMAArray<Item> items;
+    items.allocateInterleaved(e_end - e_beg);
+    katana::do_all(
+        katana::iterate(e_beg, e_end),
+        [&](Edge e) { items.constructAt(e - e_beg, make_item(e)); },
+        katana::no_stats());
+
+    katana::ParallelSTL::sort(items.begin(), items.end());
+
+    katana::do_all(
+        katana::iterate(e_beg, e_end),
+        [&](Edge e) {
+          (*dests)[e] = items[e - e_beg].dest;
+          (*prop_indices)[e] = items[e - e_beg].prop_index;
+        },
+        katana::no_stats());
+  }
+}
+
+}  // namespace
+
+void
+katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
+  SortOutEdges(
+      *this, &GetDests(), &edge_prop_indices_,
+      [](Node dest, PropertyIndex) { return dest; });
+
+  KATANA_LOG_DEBUG_ASSERT(std::all_of(
+      Nodes().begin(), Nodes().end(), [&](Node node) {
+        return std::is_sorted(
+            GetDests().begin() + *OutEdges(node).begin(),
+            GetDests().begin() + *OutEdges(node).end());
+      }));
   // remember to update sort state
   edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByDestID;
 }
@@ -379,52 +599,12 @@ katana::EdgeShuffleTopology::SortEdgesByDestID() noexcept {
 void
 katana::EdgeShuffleTopology::SortEdgesByTypeThenDest(
     const PropertyGraph* pg) noexcept {
-  katana::do_all(
-      katana::iterate(Nodes()),
-      [&](Node node) {
-        // get this node's first and last edge
-        auto e_beg = *OutEdges(node).begin();
-        auto e_end = *OutEdges(node).end();
-
-        // get iterators to locations to sort in the vector
-        auto begin_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_beg, GetDests().begin() + e_beg);
-
-        auto end_sort_iter = katana::make_zip_iterator(
-            edge_prop_indices_.begin() + e_end, GetDests().begin() + e_end);
-
-        // rearrange vector indices based on how the destinations of this
-        // graph will eventually be sorted sort function not based on vector
-        // being passed, but rather the type and destination of the graph
-        std::sort(
-            begin_sort_iter, end_sort_iter,
-            [&](const auto& tup1, const auto& tup2) {
-              // get edge type and destinations
-              auto e1 = std::get<0>(tup1);
-              auto e2 = std::get<0>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(e1), GraphTopology::PropertyIndex>);
-              static_assert(
-                  std::is_same_v<decltype(e2), GraphTopology::PropertyIndex>);
-
-              katana::EntityTypeID data1 =
-                  pg->GetTypeOfEdgeFromPropertyIndex(e1);
-              katana::EntityTypeID data2 =
-                  pg->GetTypeOfEdgeFromPropertyIndex(e2);
-              if (data1 != data2) {
-                return data1 < data2;
-              }
-
-              auto dst1 = std::get<1>(tup1);
-              auto dst2 = std::get<1>(tup2);
-              static_assert(
-                  std::is_same_v<decltype(dst1), GraphTopology::Node>);
-              static_assert(
-                  std::is_same_v<decltype(dst2), GraphTopology::Node>);
-              return dst1 < dst2;
-            });
-      },
-      katana::steal(), katana::no_stats());
+  SortOutEdges(
+      *this, &GetDests(), &edge_prop_indices_,
+      [pg](Node dest, PropertyIndex prop_index) {
+        return std::make_pair(
+            pg->GetTypeOfEdgeFromPropertyIndex(prop_index), dest);
+      });
 
   // remember to update sort state
   edge_sort_state_ = katana::RDGTopology::EdgeSortKind::kSortedByEdgeType;
@@ -437,6 +617,243 @@ katana::EdgeShuffleTopology::SortEdgesByDestType(
   KATANA_LOG_FATAL("Not implemented yet");
 }
 
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+
+/// The in-edges of a topology, grouped by destination: the sources of the
+/// in-edges of node n are sources[offsets[n], offsets[n + 1])
+struct InEdges {
+  std::vector<uint64_t> offsets;
+  katana::NUMAArray<Node> sources;
+
+  uint64_t InDegree(Node n) const { return offsets[n + 1] - offsets[n]; }
+};
+
+InEdges
+MakeInEdges(const katana::EdgeShuffleTopology& topo) {
+  const size_t num_nodes = topo.NumNodes();
+
+  // cursors[n + 1] counts the in-edges of n, then cursors[n] is the next free
+  // slot for the in-edges of n
+  std::vector<std::atomic<uint64_t>> cursors(num_nodes + 1);
+  katana::do_all(
+      katana::iterate(topo.OutEdges()),
+      [&](auto e) {
+        cursors[topo.OutEdgeDst(e) + 1].fetch_add(
+            1, std::memory_order_relaxed);
+      },
+      katana::no_stats());
+
+  InEdges in;
+  in.offsets.resize(num_nodes + 1);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes + 1),
+      [&](size_t n) { in.offsets[n] = cursors[n].load(); }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      in.offsets.begin(), in.offsets.end(), in.offsets.begin());
+
+  in.sources.allocateInterleaved(topo.NumEdges());
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { cursors[n] = in.offsets[n]; }, katana::no_stats());
+  katana::do_all(
+      katana::iterate(topo.Nodes()),
+      [&](Node src) {
+        for (auto e : topo.OutEdges(src)) {
+          auto pos = cursors[topo.OutEdgeDst(e)].fetch_add(
+              1, std::memory_order_relaxed);
+          in.sources[pos] = src;
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return in;
+}
+
+/// The nodes of topo in Reverse Cuthill-McKee order, as new_to_old.
+///
+/// Cuthill-McKee is defined on undirected graphs, so it runs on the
+/// symmetrized graph: the neighbors of a node are its out- and in-neighbors
+/// and its degree is the sum of both degrees. A directed graph gets the same
+/// order as its undirected version.
+///
+/// The BFS levels are expanded in parallel: a node of the next level is
+/// claimed by the node at the lowest position of the current level that
+/// reaches it, then the level is sorted by claiming position, degree and id,
+/// which is the order a sequential Cuthill-McKee visits it in.
+katana::GraphTopologyTypes::PropIndexVec
+ReverseCuthillMcKeeOrder(const katana::EdgeShuffleTopology& topo) {
+  constexpr uint64_t kUnclaimed = std::numeric_limits<uint64_t>::max();
+  const size_t num_nodes = topo.NumNodes();
+
+  const InEdges in = MakeInEdges(topo);
+  auto degree = [&](Node n) { return topo.OutDegree(n) + in.InDegree(n); };
+
+  // A low degree node is a cheap stand-in for a pseudo-peripheral node, so
+  // each component is started from its lowest degree node.
+  std::vector<Node> roots(num_nodes);
+  katana::ParallelSTL::iota(roots.begin(), roots.end(), Node{0});
+  katana::ParallelSTL::sort(roots.begin(), roots.end(), [&](Node a, Node b) {
+    auto da = degree(a);
+    auto db = degree(b);
+    return da != db ? da < db : a < b;
+  });
+
+  // Isolated nodes are components of their own and sort first, so they are
+  // placed together without a BFS each.
+  const size_t num_isolated =
+      std::partition_point(
+          roots.begin(), roots.end(), [&](Node n) { return degree(n) == 0; }) -
+      roots.begin();
+  std::vector<Node> order(roots.begin(), roots.begin() + num_isolated);
+  order.reserve(num_nodes);
+
+  // Position in order of the node that claimed each node
+  katana::NUMAArray<std::atomic<uint64_t>> claimed_by;
+  claimed_by.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) { claimed_by.constructAt(n, kUnclaimed); },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(size_t{0}, num_isolated),
+      [&](size_t pos) { claimed_by[order[pos]] = pos; }, katana::no_stats());
+
+  katana::InsertBag<Node> next;
+
+  // Nodes of earlier levels are claimed by positions below the current level,
+  // so only unvisited nodes and nodes claimed by this level are updated.
+  auto claim = [&](Node n, uint64_t pos) {
+    auto& claimant = claimed_by[n];
+    uint64_t cur = claimant.load(std::memory_order_relaxed);
+    while (pos < cur) {
+      if (claimant.compare_exchange_weak(cur, pos, std::memory_order_relaxed)) {
+        if (cur == kUnclaimed) {
+          next.push(n);
+        }
+        break;
+      }
+    }
+  };
+
+  for (size_t r = num_isolated; r < num_nodes; ++r) {
+    const Node root = roots[r];
+    if (claimed_by[root] != kUnclaimed) {
+      continue;
+    }
+    claimed_by[root] = order.size();
+    order.push_back(root);
+
+    for (size_t level_begin = order.size() - 1; level_begin < order.size();) {
+      const size_t level_end = order.size();
+
+      katana::do_all(
+          katana::iterate(level_begin, level_end),
+          [&](size_t pos) {
+            const Node n = order[pos];
+            for (auto e : topo.OutEdges(n)) {
+              claim(topo.OutEdgeDst(e), pos);
+            }
+            for (auto i = in.offsets[n]; i < in.offsets[n + 1]; ++i) {
+              claim(in.sources[i], pos);
+            }
+          },
+          katana::steal(), katana::no_stats());
+
+      order.insert(order.end(), next.begin(), next.end());
+      next.clear();
+      katana::ParallelSTL::sort(
+          order.begin() + level_end, order.end(), [&](Node a, Node b) {
+            uint64_t ca = claimed_by[a];
+            uint64_t cb = claimed_by[b];
+            if (ca != cb) {
+              return ca < cb;
+            }
+            auto da = degree(a);
+            auto db = degree(b);
+            return da != db ? da < db : a < b;
+          });
+      level_begin = level_end;
+    }
+  }
+  KATANA_LOG_DEBUG_ASSERT(order.size() == num_nodes);
+
+  katana::GraphTopologyTypes::PropIndexVec new_to_old;
+  new_to_old.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t i) { new_to_old[i] = order[num_nodes - 1 - i]; },
+      katana::no_stats());
+  return new_to_old;
+}
+
+/// The community of each node of topo, found by synchronous label
+/// propagation: each round, every node takes the most frequent label among
+/// itself and its out-neighbors, the smallest one on ties.
+katana::NUMAArray<Node>
+CommunityLabels(const katana::EdgeShuffleTopology& topo) {
+  // Label propagation settles within a few rounds on real graphs; later
+  // rounds would barely change the order.
+  constexpr unsigned kMaxRounds = 10;
+
+  katana::NUMAArray<Node> labels;
+  labels.allocateInterleaved(topo.NumNodes());
+  katana::NUMAArray<Node> next_labels;
+  next_labels.allocateInterleaved(topo.NumNodes());
+  katana::ParallelSTL::iota(labels.begin(), labels.end(), Node{0});
+
+  katana::PerThreadStorage<std::vector<Node>> scratch;
+  katana::GAccumulator<size_t> changed;
+
+  for (unsigned round = 0; round < kMaxRounds; ++round) {
+    changed.reset();
+    katana::do_all(
+        katana::iterate(topo.Nodes()),
+        [&](Node n) {
+          std::vector<Node>& candidates = *scratch.getLocal();
+          candidates.clear();
+          candidates.push_back(labels[n]);
+          for (auto e : topo.OutEdges(n)) {
+            candidates.push_back(labels[topo.OutEdgeDst(e)]);
+          }
+          std::sort(candidates.begin(), candidates.end());
+
+          Node best = candidates.front();
+          size_t best_count = 0;
+          for (auto it = candidates.begin(); it != candidates.end();) {
+            auto run_end = std::upper_bound(it, candidates.end(), *it);
+            size_t count = run_end - it;
+            if (count > best_count) {
+              best = *it;
+              best_count = count;
+            }
+            it = run_end;
+          }
+
+          next_labels[n] = best;
+          if (best != labels[n]) {
+            changed += 1;
+          }
+        },
+        katana::steal(), katana::no_stats());
+
+    std::swap(labels, next_labels);
+    if (changed.reduce() == 0) {
+      break;
+    }
+  }
+
+  return labels;
+}
+
+/// Nodes with more out-edges than this are hubs
+uint64_t
+HubDegree(const katana::EdgeShuffleTopology& topo) {
+  return topo.NumNodes() == 0 ? 0 : topo.NumEdges() / topo.NumNodes();
+}
+
+}  // namespace
+
 std::shared_ptr<katana::ShuffleTopology>
 katana::ShuffleTopology::MakeSortedByDegree(
     const PropertyGraph*,
@@ -474,6 +891,141 @@ katana::ShuffleTopology::MakeSortedByNodeType(
       seed_topo, cmp, katana::RDGTopology::NodeSortKind::kSortedByNodeType);
 }
 
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeSortedByRCM(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  return MakeNodePermutedTopo(
+      seed_topo, ReverseCuthillMcKeeOrder(seed_topo),
+      katana::RDGTopology::NodeSortKind::kReverseCuthillMcKee);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeSortedByCommunity(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  katana::NUMAArray<Node> labels = CommunityLabels(seed_topo);
+  auto cmp = [&](const auto& i1, const auto& i2) {
+    if (labels[i1] != labels[i2]) {
+      return labels[i1] < labels[i2];
+    }
+    return i1 < i2;
+  };
+
+  return MakeNodeSortedTopo(
+      seed_topo, cmp, katana::RDGTopology::NodeSortKind::kCommunity);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeHubSorted(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  const uint64_t hub_degree = HubDegree(seed_topo);
+  auto cmp = [&](const auto& i1, const auto& i2) {
+    auto d1 = seed_topo.OutDegree(i1);
+    auto d2 = seed_topo.OutDegree(i2);
+    bool hub1 = d1 > hub_degree;
+    bool hub2 = d2 > hub_degree;
+    if (hub1 != hub2) {
+      return hub1;
+    }
+    if (hub1 && d1 != d2) {
+      return d1 > d2;
+    }
+    return i1 < i2;
+  };
+
+  return MakeNodeSortedTopo(
+      seed_topo, cmp, katana::RDGTopology::NodeSortKind::kHubSorted);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeHubClustered(
+    const PropertyGraph*,
+    const katana::EdgeShuffleTopology& seed_topo) noexcept {
+  const uint64_t hub_degree = HubDegree(seed_topo);
+  auto cmp = [&](const auto& i1, const auto& i2) {
+    bool hub1 = seed_topo.OutDegree(i1) > hub_degree;
+    bool hub2 = seed_topo.OutDegree(i2) > hub_degree;
+    if (hub1 != hub2) {
+      return hub1;
+    }
+    return i1 < i2;
+  };
+
+  return MakeNodeSortedTopo(
+      seed_topo, cmp, katana::RDGTopology::NodeSortKind::kHubClustered);
+}
+
+std::shared_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeNodePermutedTopo(
+    const katana::EdgeShuffleTopology& seed_topo,
+    const PropIndexVec& new_to_old,
+    const katana::RDGTopology::NodeSortKind& node_sort_todo) noexcept {
+  GraphTopology::AdjIndexVec degrees;
+  degrees.allocateInterleaved(seed_topo.NumNodes());
+
+  NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
+  old_to_new_map.allocateInterleaved(seed_topo.NumNodes());
+
+  PropIndexVec node_prop_indices;
+  node_prop_indices.allocateInterleaved(seed_topo.NumNodes());
+
+  // TODO(amber): given 32-bit node ids, put a check here that
+  // new_to_old.size() < 2^32
+  katana::do_all(
+      katana::iterate(size_t{0}, new_to_old.size()),
+      [&](auto i) {
+        // new_to_old[i] gives old node id
+        old_to_new_map[new_to_old[i]] = i;
+        degrees[i] = seed_topo.OutDegree(new_to_old[i]);
+        node_prop_indices[i] = seed_topo.GetNodePropertyIndex(new_to_old[i]);
+      },
+      katana::no_stats());
+
+  KATANA_LOG_DEBUG_ASSERT(
+      node_sort_todo != katana::RDGTopology::NodeSortKind::kSortedByDegree ||
+      std::is_sorted(degrees.begin(), degrees.end(), std::greater<>()));
+
+  katana::ParallelSTL::partial_sum(
+      degrees.begin(), degrees.end(), degrees.begin());
+
+  GraphTopologyTypes::EdgeDestVec new_dest_vec;
+  new_dest_vec.allocateInterleaved(seed_topo.NumEdges());
+
+  GraphTopologyTypes::PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(seed_topo.NumEdges());
+
+  katana::do_all(
+      katana::iterate(seed_topo.Nodes()),
+      [&](auto old_src_id) {
+        auto new_srd_id = old_to_new_map[old_src_id];
+        auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
+
+        for (auto e : seed_topo.OutEdges(old_src_id)) {
+          auto new_edge_dest = old_to_new_map[seed_topo.OutEdgeDst(e)];
+          KATANA_LOG_DEBUG_ASSERT(new_edge_dest < seed_topo.NumNodes());
+
+          auto new_edge_id = new_out_index;
+          ++new_out_index;
+          KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
+
+          new_dest_vec[new_edge_id] = new_edge_dest;
+
+          // copy over edge_property_index mapping from old edge to new edge
+          edge_prop_indices[new_edge_id] =
+              seed_topo.GetEdgePropertyIndexFromOutEdge(e);
+        }
+        KATANA_LOG_DEBUG_ASSERT(new_out_index == degrees[new_srd_id]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return std::make_shared<ShuffleTopology>(ShuffleTopology{
+      seed_topo.transpose_state(), node_sort_todo, seed_topo.edge_sort_state(),
+      std::move(degrees), std::move(node_prop_indices), std::move(new_dest_vec),
+      std::move(edge_prop_indices)});
+}
+
 std::shared_ptr<katana::ShuffleTopology>
 katana::ShuffleTopology::Make(katana::RDGTopology* rdg_topo) {
   KATANA_LOG_DEBUG_ASSERT(rdg_topo);
@@ -549,7 +1101,7 @@ katana::CondensedTypeIDMap::MakeFromEdgeTypes(
 
   // ordered map
   std::set<katana::EntityTypeID> mergedSet;
-  for (uint32_t i = 0; i < katana::activeThreads; ++i) {
+  for (uint32_t i = 0, num = katana::getActiveThreads(); i < num; ++i) {
     auto& edgeTypesSet = *edgeTypes.getRemote(i);
     for (auto edgeType : edgeTypesSet) {
       mergedSet.insert(edgeType);
@@ -576,6 +1128,18 @@ katana::CondensedTypeIDMap::MakeFromEdgeTypes(
 
 katana::EdgeTypeAwareTopology::~EdgeTypeAwareTopology() = default;
 
+katana::EdgeTypeAwareTopology::EdgeTypeAwareTopology(
+    const EdgeTypeAwareTopology& that, NUMAPartitionedCopy tag) noexcept
+    : Base(that, tag), edge_type_index_(that.edge_type_index_) {
+  // There are num_unique_types() prefix sums per node
+  std::vector<uint64_t> ranges;
+  for (uint32_t node : OwnerThreadRanges()) {
+    ranges.emplace_back(
+        uint64_t{node} * edge_type_index_->num_unique_types());
+  }
+  per_type_adj_indices_ = PlacedCopy(that.per_type_adj_indices_, ranges);
+}
+
 katana::EdgeTypeAwareTopology::AdjIndexVec
 katana::EdgeTypeAwareTopology::CreatePerEdgeTypeAdjacencyIndex(
     const PropertyGraph& pg, const CondensedTypeIDMap& edge_type_index,
@@ -727,6 +1291,90 @@ katana::PGViewCache::DropAllTopologies() noexcept {
   fully_shuff_topos_.clear();
   edge_type_aware_topos_.clear();
   edge_type_id_map_.reset();
+  narrowed_adj_indices_.clear();
+}
+
+bool
+katana::PGViewCache::IsCached(const GraphTopology* topo) const noexcept {
+  auto is_topo = [topo](const auto& cached) { return cached.get() == topo; };
+  return original_topo_.get() == topo ||
+         std::any_of(
+             edge_shuff_topos_.begin(), edge_shuff_topos_.end(), is_topo) ||
+         std::any_of(
+             fully_shuff_topos_.begin(), fully_shuff_topos_.end(), is_topo) ||
+         std::any_of(
+             edge_type_aware_topos_.begin(), edge_type_aware_topos_.end(),
+             is_topo);
+}
+
+std::shared_ptr<const katana::NUMAArray<uint32_t>>
+katana::PGViewCache::BuildOrGetNarrowedAdjIndices(
+    const std::shared_ptr<const GraphTopology>& topo) noexcept {
+  // Drop the indexes of topologies that were dropped or replaced, e.g., by
+  // PartitionAcrossNUMANodes. Views built earlier keep theirs alive.
+  auto stale = [this](const NarrowedAdjIndices& entry) {
+    auto narrowed_topo = entry.topo.lock();
+    return !narrowed_topo || !IsCached(narrowed_topo.get());
+  };
+  narrowed_adj_indices_.erase(
+      std::remove_if(
+          narrowed_adj_indices_.begin(), narrowed_adj_indices_.end(), stale),
+      narrowed_adj_indices_.end());
+
+  for (const auto& entry : narrowed_adj_indices_) {
+    if (entry.topo.lock() == topo) {
+      return entry.adj_indices;
+    }
+  }
+
+  auto adj_indices = CSRTopology<uint32_t>::NarrowAdjIndices(*topo);
+  if (IsCached(topo.get())) {
+    narrowed_adj_indices_.emplace_back(NarrowedAdjIndices{topo, adj_indices});
+  }
+  return adj_indices;
+}
+
+namespace {
+
+/// Replace \p topo with a copy partitioned across NUMA nodes unless it
+/// already is
+template <typename Topo>
+void
+MakeNUMAPartitioned(std::shared_ptr<Topo>* topo) {
+  if (!(*topo)->IsNUMAPartitioned()) {
+    *topo = std::make_shared<Topo>(
+        **topo, katana::GraphTopology::NUMAPartitionedCopy{});
+  }
+}
+
+}  // namespace
+
+void
+katana::PGViewCache::PartitionAcrossNUMANodes() noexcept {
+  numa_partitioned_ = true;
+
+  // The default topology may be one of the cached ones, see
+  // ReseatDefaultTopo, and must stay the same object as its replacement
+  std::shared_ptr<GraphTopology> new_original;
+  auto replace_all = [&](auto& topos) {
+    for (auto& topo : topos) {
+      bool is_original = topo == original_topo_;
+      MakeNUMAPartitioned(&topo);
+      if (is_original) {
+        new_original = topo;
+      }
+    }
+  };
+  replace_all(edge_shuff_topos_);
+  replace_all(fully_shuff_topos_);
+  replace_all(edge_type_aware_topos_);
+
+  if (new_original) {
+    original_topo_ = std::move(new_original);
+  } else {
+    KATANA_LOG_DEBUG_ASSERT(typeid(*original_topo_) == typeid(GraphTopology));
+    MakeNUMAPartitioned(&original_topo_);
+  }
 }
 
 std::shared_ptr<katana::CondensedTypeIDMap>
@@ -806,6 +1454,9 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopoImpl(
   auto new_topo = (!res) ? EdgeShuffleTopology::Make(pg, tpose_kind, sort_kind)
                          : EdgeShuffleTopology::Make(res.value());
   KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, new_topo.get()));
+  if (numa_partitioned_) {
+    MakeNUMAPartitioned(&new_topo);
+  }
 
   if (pop) {
     return new_topo;
@@ -863,6 +1514,9 @@ katana::PGViewCache::BuildOrGetShuffTopo(
     }
 
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, fully_shuff_topos_.back().get()));
+    if (numa_partitioned_) {
+      MakeNUMAPartitioned(&fully_shuff_topos_.back());
+    }
     return fully_shuff_topos_.back();
   }
 }
@@ -0,0 +1,124 @@
+#include "katana/LazyProjectedGraph.h"
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// Whether each entity type of a graph has one of \p types, according to
+/// \p is_subtype_of(type, entity_type)
+template <typename IsSubtypeOf>
+std::vector<uint8_t>
+KeptEntityTypes(
+    size_t num_entity_types, const katana::SetOfEntityTypeIDs& types,
+    const IsSubtypeOf& is_subtype_of) {
+  std::vector<uint8_t> kept(num_entity_types, 0);
+  for (size_t entity_type = 0; entity_type < num_entity_types; ++entity_type) {
+    for (auto type : types) {
+      if (is_subtype_of(
+              static_cast<katana::EntityTypeID>(type),
+              static_cast<katana::EntityTypeID>(entity_type))) {
+        kept[entity_type] = 1;
+        break;
+      }
+    }
+  }
+  return kept;
+}
+
+}  // namespace
+
+katana::LazyProjectedGraph::LazyProjectedGraph(
+    PropertyGraph* pg, DynamicBitset&& node_mask,
+    std::optional<SetOfEntityTypeIDs>&& edge_types,
+    std::vector<uint8_t>&& edge_type_kept) noexcept
+    : pg_(pg),
+      node_mask_(std::move(node_mask)),
+      edge_types_(std::move(edge_types)),
+      edge_type_kept_(std::move(edge_type_kept)) {
+  num_nodes_ = node_mask_.count();
+}
+
+katana::Result<katana::LazyProjectedGraph>
+katana::LazyProjectedGraph::Make(
+    PropertyGraph* pg, const std::optional<SetOfEntityTypeIDs>& node_types,
+    std::optional<SetOfEntityTypeIDs> edge_types) {
+  DynamicBitset node_mask;
+  node_mask.resize(pg->NumNodes());
+
+  if (!node_types) {
+    // resize() clears the bits, so this sets all of them
+    node_mask.bitwise_not();
+  } else {
+    // Look up the types of each node entity type once rather than for every
+    // node.
+    std::vector<uint8_t> node_type_kept = KeptEntityTypes(
+        pg->GetNumNodeEntityTypes(), node_types.value(),
+        [pg](EntityTypeID type, EntityTypeID entity_type) {
+          return pg->IsNodeSubtypeOf(type, entity_type);
+        });
+    katana::do_all(
+        katana::iterate(pg->topology().Nodes()),
+        [&](Node node) {
+          if (node_type_kept[pg->GetTypeOfNode(node)]) {
+            node_mask.set(node);
+          }
+        },
+        katana::no_stats());
+  }
+
+  return Make(pg, std::move(node_mask), std::move(edge_types));
+}
+
+katana::Result<katana::LazyProjectedGraph>
+katana::LazyProjectedGraph::Make(
+    PropertyGraph* pg,
+    const std::optional<std::vector<std::string>>& node_types,
+    const std::optional<std::vector<std::string>>& edge_types) {
+  std::optional<SetOfEntityTypeIDs> node_type_ids;
+  if (node_types) {
+    node_type_ids = KATANA_CHECKED(
+        pg->GetNodeTypeManager().GetEntityTypeIDs(node_types.value()));
+  }
+  std::optional<SetOfEntityTypeIDs> edge_type_ids;
+  if (edge_types) {
+    edge_type_ids = KATANA_CHECKED(
+        pg->GetEdgeTypeManager().GetEntityTypeIDs(edge_types.value()));
+  }
+  return Make(pg, node_type_ids, std::move(edge_type_ids));
+}
+
+katana::Result<katana::LazyProjectedGraph>
+katana::LazyProjectedGraph::Make(
+    PropertyGraph* pg, DynamicBitset node_filter,
+    std::optional<SetOfEntityTypeIDs> edge_types) {
+  if (node_filter.size() != pg->NumNodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "node filter has {} bits but the graph has {} nodes",
+        node_filter.size(), pg->NumNodes());
+  }
+
+  std::vector<uint8_t> edge_type_kept;
+  if (edge_types) {
+    edge_type_kept = KeptEntityTypes(
+        pg->GetNumEdgeEntityTypes(), edge_types.value(),
+        [pg](EntityTypeID type, EntityTypeID entity_type) {
+          return pg->IsEdgeSubtypeOf(type, entity_type);
+        });
+  }
+
+  return LazyProjectedGraph(
+      pg, std::move(node_filter), std::move(edge_types),
+      std::move(edge_type_kept));
+}
+
+katana::Result<katana::PropertyGraph*>
+katana::LazyProjectedGraph::Materialize() {
+  if (!materialized_) {
+    materialized_ = KATANA_CHECKED(
+        PropertyGraph::MakeProjectedGraph(*pg_, node_mask_, edge_types_));
+  }
+  return materialized_.get();
+}
@@ -66,10 +66,6 @@ katana::Result<katana::PropertyGraph::EntityTypeIDArray>
 MapEntityTypeIDsArray(
     const katana::FileView& file_view, size_t num_entries,
     bool is_headerless_entity_type_id_array) {
-  // allocate type IDs array
-  katana::PropertyGraph::EntityTypeIDArray entity_type_id_array;
-  entity_type_id_array.allocateInterleaved(num_entries);
-
   const katana::EntityTypeID* type_IDs_array = nullptr;
 
   if (is_headerless_entity_type_id_array) {
@@ -88,6 +84,18 @@ MapEntityTypeIDsArray(
     KATANA_LOG_DEBUG_ASSERT(type_IDs_array != nullptr);
   }
 
+  if (file_view.mapped()) {
+    // Use a mapped file in place. The file view belongs to the RDG, which
+    // lives as long as the PropertyGraph that owns this array.
+    katana::PropertyGraph::EntityTypeIDArray mapped_array(
+        const_cast<katana::EntityTypeID*>(type_IDs_array), num_entries);
+    return katana::MakeResult(std::move(mapped_array));
+  }
+
+  // allocate type IDs array
+  katana::PropertyGraph::EntityTypeIDArray entity_type_id_array;
+  entity_type_id_array.allocateInterleaved(num_entries);
+
   katana::ParallelSTL::copy(
       &type_IDs_array[0], &type_IDs_array[num_entries],
       entity_type_id_array.begin());
@@ -149,6 +157,29 @@ FillBitMask(
   });
 }
 
+/// Fill in `index`, preferring a copy stored in the RDG over building it from
+/// the property.
+template <typename node_or_edge>
+katana::Result<void>
+BuildEntityIndex(
+    katana::RDG* rdg, bool is_node_index,
+    katana::EntityIndex<node_or_edge>* index) {
+  if (rdg != nullptr) {
+    std::optional<katana::EntityIndexPrimitive> stored = KATANA_CHECKED(
+        rdg->LoadEntityIndexPrimitive(is_node_index, index->property_name()));
+    if (stored) {
+      auto res = index->BuildFromPrimitive(std::move(stored.value()));
+      if (res) {
+        return katana::ResultSuccess();
+      }
+      KATANA_LOG_WARN(
+          "ignoring stored index over {}: {}", index->property_name(),
+          res.error());
+    }
+  }
+  return index->BuildFromProperty();
+}
+
 }  // namespace
 
 katana::PropertyGraph::~PropertyGraph() = default;
@@ -166,10 +197,21 @@ katana::PropertyGraph::Make(
 
   KATANA_LOG_DEBUG_ASSERT(CheckTopology(
       csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges()));
-  katana::GraphTopology topo = katana::GraphTopology(
-      csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges());
+  katana::GraphTopology topo;
+  if (csr->file_storage().mapped()) {
+    // The topology file is mapped directly, so use it in place: the topology
+    // takes over the mapping rather than copying out of it.
+    auto storage =
+        std::make_shared<katana::FileView>(std::move(csr->file_storage()));
+    topo = katana::GraphTopology(
+        csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges(),
+        std::move(storage));
+  } else {
+    // The GraphTopology constructor copies all of the required topology data.
+    topo = katana::GraphTopology(
+        csr->adj_indices(), csr->num_nodes(), csr->dests(), csr->num_edges());
+  }
 
-  // The GraphTopology constructor copies all of the required topology data.
   // Clean up the RDGTopologies memory
   KATANA_CHECKED(csr->unbind_file_storage());
 
@@ -229,8 +271,12 @@ katana::PropertyGraph::Make(
     std::unique_ptr<RDGFile> rdg_file, katana::TxnContext* txn_ctx,
     const katana::RDGLoadOptions& opts) {
   auto rdg = KATANA_CHECKED(RDG::Make(*rdg_file, opts));
-  return katana::PropertyGraph::Make(
-      std::move(rdg_file), std::move(rdg), txn_ctx);
+  auto pg = KATANA_CHECKED(katana::PropertyGraph::Make(
+      std::move(rdg_file), std::move(rdg), txn_ctx));
+  if (opts.partition_topology_across_numa_nodes) {
+    pg->PartitionTopologyAcrossNUMANodes();
+  }
+  return MakeResult(std::move(pg));
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -390,7 +436,6 @@ katana::PropertyGraph::MakeProjectedGraph(
 
   // calculate number of new nodes
   uint32_t num_new_nodes = 0;
-  uint32_t num_new_edges = 0;
 
   katana::DynamicBitset bitset_nodes;
   bitset_nodes.resize(topology.NumNodes());
@@ -433,6 +478,51 @@ katana::PropertyGraph::MakeProjectedGraph(
     }
   }
 
+  return MakeProjectedGraphFromNodes(
+      pg, num_new_nodes, bitset_nodes,
+      std::move(original_to_projected_nodes_mapping), std::move(edge_types));
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::MakeProjectedGraph(
+    PropertyGraph& pg, const DynamicBitset& node_filter,
+    std::optional<SetOfEntityTypeIDs> edge_types) {
+  const auto& topology = pg.topology();
+  if (node_filter.size() != topology.NumNodes()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "node filter has {} bits but the graph has {} nodes",
+        node_filter.size(), topology.NumNodes());
+  }
+  if (topology.empty()) {
+    return MakeEmptyProjectedGraph(pg, katana::DynamicBitset{});
+  }
+
+  NUMAArray<Node> original_to_projected_nodes_mapping;
+  original_to_projected_nodes_mapping.allocateInterleaved(topology.NumNodes());
+  katana::do_all(katana::iterate(topology.Nodes()), [&](auto src) {
+    original_to_projected_nodes_mapping[src] = node_filter.test(src) ? 1 : 0;
+  });
+
+  auto num_new_nodes = static_cast<uint32_t>(node_filter.count());
+  if (num_new_nodes == 0) {
+    return MakeEmptyProjectedGraph(pg, node_filter);
+  }
+
+  return MakeProjectedGraphFromNodes(
+      pg, num_new_nodes, node_filter,
+      std::move(original_to_projected_nodes_mapping), std::move(edge_types));
+}
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::PropertyGraph::MakeProjectedGraphFromNodes(
+    PropertyGraph& pg, uint32_t num_new_nodes,
+    const DynamicBitset& bitset_nodes,
+    NUMAArray<Node>&& original_to_projected_nodes_mapping,
+    std::optional<SetOfEntityTypeIDs> edge_types) {
+  const auto& topology = pg.topology();
+  uint32_t num_new_edges = 0;
+
   // fill old to new nodes mapping
   katana::ParallelSTL::partial_sum(
       original_to_projected_nodes_mapping.begin(),
@@ -763,6 +853,28 @@ katana::PropertyGraph::DoWriteTopologies() {
   return katana::ResultSuccess();
 }
 
+void
+katana::PropertyGraph::DoWriteIndexes() {
+  // An index that was built rather than loaded replaces any stored copy,
+  // which may have been rejected by BuildEntityIndex
+  for (const auto& index : node_indexes_) {
+    if (!index->loaded_from_storage()) {
+      rdg_->RemoveEntityIndexPrimitive(true, index->property_name());
+      katana::EntityIndexPrimitive primitive = index->ToPrimitive();
+      primitive.set_is_node_index(true);
+      rdg_->StageEntityIndexPrimitive(std::move(primitive));
+    }
+  }
+  for (const auto& index : edge_indexes_) {
+    if (!index->loaded_from_storage()) {
+      rdg_->RemoveEntityIndexPrimitive(false, index->property_name());
+      katana::EntityIndexPrimitive primitive = index->ToPrimitive();
+      primitive.set_is_node_index(false);
+      rdg_->StageEntityIndexPrimitive(std::move(primitive));
+    }
+  }
+}
+
 katana::Result<void>
 katana::PropertyGraph::DoWrite(
     katana::RDGHandle handle, const std::string& command_line,
@@ -774,6 +886,7 @@ katana::PropertyGraph::DoWrite(
       rdg_->edge_entity_type_id_array_file_storage().Valid());
 
   KATANA_CHECKED(DoWriteTopologies());
+  DoWriteIndexes();
 
   //TODO(emcginnis): we don't actually have any lifetime tracking for the in memory
   // entity_type_id arrays, which means we don't actually know when the array
@@ -1178,12 +1291,22 @@ katana::PropertyGraph::UpsertNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalNodes(), props->num_rows());
   }
-  return rdg_->UpsertNodeProperties(props, txn_ctx);
+  KATANA_CHECKED(rdg_->UpsertNodeProperties(props, txn_ctx));
+  for (const auto& field : props->schema()->fields()) {
+    InvalidateNodeIndex(field->name());
+  }
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(int i, katana::TxnContext* txn_ctx) {
-  return rdg_->RemoveNodeProperty(i, txn_ctx);
+  std::string name;
+  if (i >= 0 && i < rdg_->node_properties()->num_columns()) {
+    name = rdg_->node_properties()->field(i)->name();
+  }
+  KATANA_CHECKED(rdg_->RemoveNodeProperty(i, txn_ctx));
+  InvalidateNodeIndex(name);
+  return ResultSuccess();
 }
 
 katana::Result<void>
@@ -1192,8 +1315,8 @@ katana::PropertyGraph::RemoveNodeProperty(
   auto col_names = rdg_->node_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_->RemoveNodeProperty(
-        std::distance(col_names.cbegin(), pos), txn_ctx);
+    return RemoveNodeProperty(
+        static_cast<int>(std::distance(col_names.cbegin(), pos)), txn_ctx);
   }
   return katana::ErrorCode::PropertyNotFound;
 }
@@ -1244,12 +1367,22 @@ katana::PropertyGraph::UpsertEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         NumOriginalEdges(), props->num_rows());
   }
-  return rdg_->UpsertEdgeProperties(props, txn_ctx);
+  KATANA_CHECKED(rdg_->UpsertEdgeProperties(props, txn_ctx));
+  for (const auto& field : props->schema()->fields()) {
+    InvalidateEdgeIndex(field->name());
+  }
+  return ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(int i, katana::TxnContext* txn_ctx) {
-  return rdg_->RemoveEdgeProperty(i, txn_ctx);
+  std::string name;
+  if (i >= 0 && i < rdg_->edge_properties()->num_columns()) {
+    name = rdg_->edge_properties()->field(i)->name();
+  }
+  KATANA_CHECKED(rdg_->RemoveEdgeProperty(i, txn_ctx));
+  InvalidateEdgeIndex(name);
+  return ResultSuccess();
 }
 
 katana::Result<void>
@@ -1258,8 +1391,8 @@ katana::PropertyGraph::RemoveEdgeProperty(
   auto col_names = rdg_->edge_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_->RemoveEdgeProperty(
-        std::distance(col_names.cbegin(), pos), txn_ctx);
+    return RemoveEdgeProperty(
+        static_cast<int>(std::distance(col_names.cbegin(), pos)), txn_ctx);
   }
   return katana::ErrorCode::PropertyNotFound;
 }
@@ -1286,7 +1419,8 @@ katana::PropertyGraph::EnsureEdgePropertyLoaded(const std::string& name) {
 
 // Build an index over nodes.
 katana::Result<void>
-katana::PropertyGraph::MakeNodeIndex(const std::string& property_name) {
+katana::PropertyGraph::MakeNodeIndex(
+    const std::string& property_name, katana::EntityIndexKind kind) {
   for (const auto& existing_index : node_indexes_) {
     if (existing_index->property_name() == property_name) {
       return KATANA_ERROR(
@@ -1304,9 +1438,10 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& property_name) {
   // Create an index based on the type of the field.
   std::shared_ptr<katana::EntityIndex<GraphTopology::Node>> index =
       KATANA_CHECKED(katana::MakeTypedEntityIndex<katana::GraphTopology::Node>(
-          property_name, NumNodes(), property));
+          property_name, NumNodes(), property, kind));
 
-  KATANA_CHECKED(index->BuildFromProperty());
+  KATANA_CHECKED(BuildEntityIndex(
+      IsTransformed() ? nullptr : rdg_.get(), true, index.get()));
 
   node_indexes_.push_back(std::move(index));
 
@@ -1315,6 +1450,9 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& property_name) {
 
 katana::Result<void>
 katana::PropertyGraph::DeleteNodeIndex(const std::string& property_name) {
+  if (!IsTransformed()) {
+    rdg_->RemoveEntityIndexPrimitive(true, property_name);
+  }
   for (auto it = node_indexes_.begin(); it != node_indexes_.end(); it++) {
     if ((*it)->property_name() == property_name) {
       node_indexes_.erase(it);
@@ -1331,7 +1469,8 @@ katana::PropertyGraph::DeleteNodeIndex(const std::string& property_name) {
 
 // Build an index over edges.
 katana::Result<void>
-katana::PropertyGraph::MakeEdgeIndex(const std::string& property_name) {
+katana::PropertyGraph::MakeEdgeIndex(
+    const std::string& property_name, katana::EntityIndexKind kind) {
   for (const auto& existing_index : edge_indexes_) {
     if (existing_index->property_name() == property_name) {
       return KATANA_ERROR(
@@ -1349,9 +1488,10 @@ katana::PropertyGraph::MakeEdgeIndex(const std::string& property_name) {
   // Create an index based on the type of the field.
   std::unique_ptr<katana::EntityIndex<katana::GraphTopology::Edge>> index =
       KATANA_CHECKED(katana::MakeTypedEntityIndex<katana::GraphTopology::Edge>(
-          property_name, NumEdges(), property));
+          property_name, NumEdges(), property, kind));
 
-  KATANA_CHECKED(index->BuildFromProperty());
+  KATANA_CHECKED(BuildEntityIndex(
+      IsTransformed() ? nullptr : rdg_.get(), false, index.get()));
 
   edge_indexes_.push_back(std::move(index));
 
@@ -1360,6 +1500,9 @@ katana::PropertyGraph::MakeEdgeIndex(const std::string& property_name) {
 
 katana::Result<void>
 katana::PropertyGraph::DeleteEdgeIndex(const std::string& property_name) {
+  if (!IsTransformed()) {
+    rdg_->RemoveEntityIndexPrimitive(false, property_name);
+  }
   for (auto it = edge_indexes_.begin(); it != edge_indexes_.end(); it++) {
     if ((*it)->property_name() == property_name) {
       edge_indexes_.erase(it);
@@ -1369,6 +1512,34 @@ katana::PropertyGraph::DeleteEdgeIndex(const std::string& property_name) {
   return KATANA_ERROR(katana::ErrorCode::NotFound, "edge index not found");
 }
 
+void
+katana::PropertyGraph::InvalidateNodeIndex(const std::string& property_name) {
+  node_indexes_.erase(
+      std::remove_if(
+          node_indexes_.begin(), node_indexes_.end(),
+          [&](const auto& index) {
+            return index->property_name() == property_name;
+          }),
+      node_indexes_.end());
+  if (!IsTransformed()) {
+    rdg_->RemoveEntityIndexPrimitive(true, property_name);
+  }
+}
+
+void
+katana::PropertyGraph::InvalidateEdgeIndex(const std::string& property_name) {
+  edge_indexes_.erase(
+      std::remove_if(
+          edge_indexes_.begin(), edge_indexes_.end(),
+          [&](const auto& index) {
+            return index->property_name() == property_name;
+          }),
+      edge_indexes_.end());
+  if (!IsTransformed()) {
+    rdg_->RemoveEntityIndexPrimitive(false, property_name);
+  }
+}
+
 katana::Result<std::unique_ptr<katana::NUMAArray<uint64_t>>>
 katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
   // TODO(amber): This function will soon change so that it produces a new sorted
@@ -0,0 +1,297 @@
+#include "katana/analytics/Frontier.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "katana/ParallelSTL.h"
+
+katana::analytics::Frontier::Frontier(size_t num_nodes)
+    : num_nodes_(num_nodes) {
+  KATANA_LOG_ASSERT(num_nodes <= std::numeric_limits<Node>::max());
+}
+
+void
+katana::analytics::Frontier::Finish() {
+  Clear();
+
+  // Gather the pushed nodes into sparse_, unsorted and with duplicates
+  std::vector<size_t> offsets(pushed_.size() + 1);
+  for (unsigned i = 0; i < pushed_.size(); ++i) {
+    offsets[i + 1] = offsets[i] + pushed_.getRemote(i)->size();
+  }
+  size_t num_pushed = offsets.back();
+  if (num_pushed == 0) {
+    return;
+  }
+  sparse_.resize(num_pushed);
+  katana::do_all(
+      katana::iterate(0U, pushed_.size()),
+      [&](unsigned i) {
+        std::vector<Node>& pushed = *pushed_.getRemote(i);
+        std::copy(pushed.begin(), pushed.end(), sparse_.begin() + offsets[i]);
+        pushed.clear();
+      },
+      katana::steal(), katana::no_stats());
+
+  if (num_pushed * 32 >= num_nodes_) {
+    BuildDense();
+    return;
+  }
+
+  BuildSparse();
+
+  // Roaring style containers only pay off when they are much smaller than the
+  // sorted vector, which takes 4 bytes per node, i.e., when many containers
+  // are bitmaps
+  size_t compressed_bytes = PlanContainers();
+  if (2 * compressed_bytes < sizeof(Node) * size_) {
+    FillContainers();
+    // Keeping the sorted vector would cost more memory than the containers
+    // save
+    std::vector<Node>().swap(sparse_);
+    sparse_valid_ = false;
+    compressed_valid_ = true;
+    representation_ = Representation::kCompressed;
+  } else {
+    containers_.clear();
+  }
+}
+
+void
+katana::analytics::Frontier::SetAll() {
+  Clear();
+  if (num_nodes_ == 0) {
+    return;
+  }
+  EnsureDenseAllocated();
+  // Restores the invariant that the unused bits of the last word are 0
+  dense_.bitwise_not();
+  size_ = num_nodes_;
+  sparse_valid_ = false;
+  dense_valid_ = true;
+  representation_ = Representation::kDense;
+}
+
+void
+katana::analytics::Frontier::Clear() {
+  if (dense_valid_) {
+    ClearDense();
+  }
+  sparse_.clear();
+  containers_.clear();
+  array_values_.clear();
+  bitmap_words_.clear();
+  size_ = 0;
+  sparse_valid_ = true;
+  dense_valid_ = false;
+  compressed_valid_ = false;
+  representation_ = Representation::kSparse;
+}
+
+void
+katana::analytics::Frontier::ConvertTo(Representation representation) {
+  switch (representation) {
+  case Representation::kSparse:
+    if (!sparse_valid_) {
+      sparse_.clear();
+      if (compressed_valid_) {
+        DecodeContainers(&sparse_);
+      } else {
+        dense_.AppendOffsets(&sparse_);
+      }
+      sparse_valid_ = true;
+    }
+    break;
+  case Representation::kDense:
+    if (!dense_valid_) {
+      EnsureDenseAllocated();
+      ForEach([&](Node node) { dense_.set(node); }, katana::no_stats());
+      dense_valid_ = true;
+    }
+    break;
+  case Representation::kCompressed:
+    if (!compressed_valid_) {
+      ConvertTo(Representation::kSparse);
+      PlanContainers();
+      FillContainers();
+      compressed_valid_ = true;
+    }
+    break;
+  }
+  representation_ = representation;
+}
+
+std::vector<katana::analytics::Frontier::Node>
+katana::analytics::Frontier::ToVector() const {
+  if (sparse_valid_) {
+    return sparse_;
+  }
+  if (compressed_valid_) {
+    std::vector<Node> nodes;
+    DecodeContainers(&nodes);
+    return nodes;
+  }
+  return dense_.GetOffsets<Node>();
+}
+
+void
+katana::analytics::Frontier::BuildSparse() {
+  katana::ParallelSTL::sort(sparse_.begin(), sparse_.end());
+  sparse_.erase(std::unique(sparse_.begin(), sparse_.end()), sparse_.end());
+  size_ = sparse_.size();
+}
+
+void
+katana::analytics::Frontier::BuildDense() {
+  EnsureDenseAllocated();
+  katana::do_all(
+      katana::iterate(sparse_), [&](Node node) { dense_.set(node); },
+      katana::no_stats());
+  sparse_.clear();
+  size_ = dense_.count();
+  sparse_valid_ = false;
+  dense_valid_ = true;
+  representation_ = Representation::kDense;
+}
+
+size_t
+katana::analytics::Frontier::PlanContainers() {
+  containers_.clear();
+  size_t array_offset = 0;
+  size_t bitmap_offset = 0;
+  for (size_t i = 0; i < sparse_.size();) {
+    uint32_t key = sparse_[i] >> kContainerBits;
+    size_t end = i + 1;
+    while (end < sparse_.size() && (sparse_[end] >> kContainerBits) == key) {
+      ++end;
+    }
+    Container c{key, static_cast<uint32_t>(end - i), 0};
+    if (c.is_bitmap()) {
+      c.offset = bitmap_offset;
+      bitmap_offset += kContainerWords;
+    } else {
+      c.offset = array_offset;
+      array_offset += c.cardinality;
+    }
+    containers_.push_back(c);
+    i = end;
+  }
+  return containers_.size() * sizeof(Container) +
+         array_offset * sizeof(uint16_t) + bitmap_offset * sizeof(uint64_t);
+}
+
+void
+katana::analytics::Frontier::FillContainers() {
+  size_t num_array_values = 0;
+  size_t num_bitmap_words = 0;
+  for (const Container& c : containers_) {
+    if (c.is_bitmap()) {
+      num_bitmap_words = c.offset + kContainerWords;
+    } else {
+      num_array_values = c.offset + c.cardinality;
+    }
+  }
+  array_values_.resize(num_array_values);
+  bitmap_words_.assign(num_bitmap_words, 0);
+
+  // Containers hold consecutive runs of the sorted vector
+  std::vector<size_t> starts(containers_.size());
+  for (size_t i = 1; i < containers_.size(); ++i) {
+    starts[i] = starts[i - 1] + containers_[i - 1].cardinality;
+  }
+
+  katana::do_all(
+      katana::iterate(size_t{0}, containers_.size()),
+      [&](size_t i) {
+        const Container& c = containers_[i];
+        const Node* nodes = &sparse_[starts[i]];
+        if (c.is_bitmap()) {
+          uint64_t* words = &bitmap_words_[c.offset];
+          for (uint32_t j = 0; j < c.cardinality; ++j) {
+            uint32_t low = nodes[j] & (kContainerSize - 1);
+            words[low / 64] |= uint64_t{1} << (low % 64);
+          }
+        } else {
+          uint16_t* values = &array_values_[c.offset];
+          for (uint32_t j = 0; j < c.cardinality; ++j) {
+            values[j] = nodes[j] & (kContainerSize - 1);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+void
+katana::analytics::Frontier::DecodeContainers(std::vector<Node>* nodes) const {
+  std::vector<size_t> starts(containers_.size() + 1);
+  for (size_t i = 0; i < containers_.size(); ++i) {
+    starts[i + 1] = starts[i] + containers_[i].cardinality;
+  }
+  size_t old_size = nodes->size();
+  nodes->resize(old_size + starts.back());
+  Node* out = nodes->data() + old_size;
+
+  katana::do_all(
+      katana::iterate(size_t{0}, containers_.size()),
+      [&](size_t i) {
+        const Container& c = containers_[i];
+        Node base = c.key << kContainerBits;
+        Node* dst = out + starts[i];
+        if (c.is_bitmap()) {
+          const uint64_t* words = &bitmap_words_[c.offset];
+          for (uint32_t w = 0; w < kContainerWords; ++w) {
+            for (uint64_t word = words[w]; word != 0; word &= word - 1) {
+              *dst++ = base + w * 64 + __builtin_ctzll(word);
+            }
+          }
+        } else {
+          const uint16_t* values = &array_values_[c.offset];
+          for (uint32_t j = 0; j < c.cardinality; ++j) {
+            *dst++ = base + values[j];
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+}
+
+void
+katana::analytics::Frontier::EnsureDenseAllocated() {
+  if (dense_.size() != num_nodes_) {
+    dense_.resize(num_nodes_);
+  }
+}
+
+void
+katana::analytics::Frontier::ClearDense() {
+  // Finish() goes dense on the number of pushes, duplicates included, so a
+  // small frontier may have only the bitmap
+  if (size_ * 32 < num_nodes_ && (sparse_valid_ || compressed_valid_)) {
+    // The bitmap was converted from a small frontier; unset just its nodes
+    ForEachIn(
+        sparse_valid_ ? Representation::kSparse : Representation::kCompressed,
+        [&](Node node) { dense_.reset(node); }, katana::no_stats());
+  } else {
+    dense_.reset();
+  }
+}
+
+bool
+katana::analytics::Frontier::SparseContains(Node node) const {
+  KATANA_LOG_DEBUG_ASSERT(node < num_nodes_);
+  if (!compressed_valid_) {
+    return std::binary_search(sparse_.begin(), sparse_.end(), node);
+  }
+  uint32_t key = node >> kContainerBits;
+  auto it = std::lower_bound(
+      containers_.begin(), containers_.end(), key,
+      [](const Container& c, uint32_t k) { return c.key < k; });
+  if (it == containers_.end() || it->key != key) {
+    return false;
+  }
+  uint32_t low = node & (kContainerSize - 1);
+  if (it->is_bitmap()) {
+    return (bitmap_words_[it->offset + low / 64] >> (low % 64)) & 1;
+  }
+  const uint16_t* values = &array_values_[it->offset];
+  return std::binary_search(values, values + it->cardinality, low);
+}
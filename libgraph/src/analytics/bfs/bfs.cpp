@@ -20,14 +20,16 @@
 #include "katana/analytics/bfs/bfs.h"
 
 #include <deque>
+#include <optional>
 #include <type_traits>
 
-#include "katana/DynamicBitset.h"
+#include "katana/CompressedTopology.h"
 #include "katana/ErrorCode.h"
 #include "katana/Result.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/Frontier.h"
 
 using namespace katana::analytics;
 
@@ -74,18 +76,6 @@ struct EdgeTileMaker {
   }
 };
 
-struct NodePushWrap {
-  template <typename C>
-  void operator()(C& cont, const GNode& n, const char* const /*tag*/) const {
-    (*this)(cont, n);
-  }
-
-  template <typename C>
-  void operator()(C& cont, const GNode& n) const {
-    cont.push(n);
-  }
-};
-
 struct EdgeTilePushWrap {
   Graph* graph;
   BfsImplementation& impl;
@@ -116,28 +106,6 @@ struct OneTilePushWrap {
   }
 };
 
-template <typename WL>
-void
-WlToBitset(const WL& wl, katana::DynamicBitset* bitset) {
-  katana::do_all(
-      katana::iterate(wl), [&](const GNode& src) { bitset->set(src); },
-      katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
-}
-
-template <typename G, typename WL>
-void
-BitsetToWl(const G& graph, const katana::DynamicBitset& bitset, WL* wl) {
-  wl->clear();
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        if (bitset.test(src)) {
-          wl->push(src);
-        }
-      },
-      katana::chunk_size<kChunkSize>(), katana::loopname("BitsetToWl"));
-}
-
 template <typename T, typename P, typename R>
 void
 AsynchronousAlgo(
@@ -216,36 +184,24 @@ AsynchronousAlgo(
   }
 }
 
-template <typename P>
 void
 SynchronousDirectOpt(
     const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
-    const GNode source, const P& pushWrap, const uint32_t alpha,
-    const uint32_t beta) {
-  using Cont = katana::InsertBag<GNode>;
-  using Loop = katana::DoAll;
+    const GNode source, const uint32_t alpha, const uint32_t beta) {
+  using Representation = Frontier::Representation;
 
   katana::GAccumulator<uint32_t> work_items;
-  katana::StatTimer bitset_to_wl_timer("Bitset_To_WL_Timer");
-  katana::StatTimer wl_to_bitset_timer("WL_To_Bitset_Timer");
-
-  Loop loop;
-
-  katana::DynamicBitset front_bitset;
-  katana::DynamicBitset next_bitset;
+  katana::StatTimer to_dense_timer("Frontier_To_Dense_Timer");
 
   uint32_t num_nodes = bidir_view.NumNodes();
   uint64_t num_edges = bidir_view.NumEdges();
 
-  front_bitset.resize(num_nodes);
-  next_bitset.resize(num_nodes);
-
-  auto frontier = std::make_unique<Cont>();
-  auto next_frontier = std::make_unique<Cont>();
+  Frontier frontier(num_nodes);
 
   (*node_data)[source] = source;
 
-  pushWrap(*next_frontier, source, "parallel");
+  frontier.Push(source);
+  frontier.Finish();
 
   work_items += 1;
 
@@ -253,21 +209,17 @@ SynchronousDirectOpt(
   int64_t scout_count = bidir_view.OutDegree(source);
   uint64_t old_num_work_items{0};
 
-  katana::GAccumulator<uint64_t> writes_pull;
-  katana::GAccumulator<uint64_t> writes_push;
-
-  while (!next_frontier->empty()) {
-    std::swap(frontier, next_frontier);
-    next_frontier->clear();
+  while (!frontier.empty()) {
     if (scout_count > edges_to_check / alpha) {
-      wl_to_bitset_timer.start();
-      WlToBitset(*frontier, &front_bitset);
-      wl_to_bitset_timer.stop();
       do {
         old_num_work_items = work_items.reduce();
         work_items.reset();
 
-        loop(
+        to_dense_timer.start();
+        frontier.ConvertTo(Representation::kDense);
+        to_dense_timer.stop();
+
+        katana::do_all(
             katana::iterate(bidir_view),
             [&](const GNode& dst) {
               GNode& ddata = (*node_data)[dst];
@@ -275,10 +227,10 @@ SynchronousDirectOpt(
                 for (auto e : bidir_view.InEdges(dst)) {
                   auto src = bidir_view.InEdgeSrc(e);
 
-                  if (front_bitset.test(src)) {
+                  if (frontier.Contains(src)) {
                     // assign parents on the bfs path.
                     ddata = src;
-                    next_bitset.set(dst);
+                    frontier.Push(dst);
                     work_items += 1;
                     break;
                   }
@@ -287,20 +239,15 @@ SynchronousDirectOpt(
             },
             katana::steal(), katana::chunk_size<kChunkSize>(),
             katana::loopname(std::string("SyncDO-pull").c_str()));
-        std::swap(front_bitset, next_bitset);
-        next_bitset.reset();
+        frontier.Finish();
       } while (work_items.reduce() >= old_num_work_items ||
                (work_items.reduce() > num_nodes / beta));
-      bitset_to_wl_timer.start();
-      BitsetToWl(bidir_view, front_bitset, next_frontier.get());
-      bitset_to_wl_timer.stop();
       scout_count = 1;
     } else {
       edges_to_check -= scout_count;
       work_items.reset();
 
-      loop(
-          katana::iterate(*frontier),
+      frontier.ForEach(
           [&](const GNode& src) {
             for (auto e : bidir_view.OutEdges(src)) {
               auto dst = bidir_view.OutEdgeDst(e);
@@ -308,7 +255,7 @@ SynchronousDirectOpt(
               if (ddata == BfsImplementation::kDistanceInfinity) {
                 GNode old_parent = ddata;
                 if (__sync_bool_compare_and_swap(&ddata, old_parent, src)) {
-                  next_frontier->push(dst);
+                  frontier.Push(dst);
                   work_items += bidir_view.OutDegree(dst);
                 }
               }
@@ -316,6 +263,88 @@ SynchronousDirectOpt(
           },
           katana::steal(), katana::chunk_size<kChunkSize>(),
           katana::loopname(std::string("SyncDO-push").c_str()));
+      frontier.Finish();
+      scout_count = work_items.reduce();
+    }
+  }
+}
+
+/// SynchronousDirectOpt on compressed out- and in-neighbors
+void
+SynchronousDirectOptCompressed(
+    const katana::CompressedTopology& out, const katana::CompressedTopology& in,
+    katana::NUMAArray<GNode>* node_data, const GNode source,
+    const uint32_t alpha, const uint32_t beta) {
+  using Representation = Frontier::Representation;
+
+  katana::GAccumulator<uint32_t> work_items;
+
+  uint32_t num_nodes = out.NumNodes();
+  uint64_t num_edges = out.NumEdges();
+
+  Frontier frontier(num_nodes);
+
+  (*node_data)[source] = source;
+
+  frontier.Push(source);
+  frontier.Finish();
+
+  work_items += 1;
+
+  int64_t edges_to_check = num_edges;
+  int64_t scout_count = out.OutDegree(source);
+  uint64_t old_num_work_items{0};
+
+  while (!frontier.empty()) {
+    if (scout_count > edges_to_check / alpha) {
+      do {
+        old_num_work_items = work_items.reduce();
+        work_items.reset();
+
+        frontier.ConvertTo(Representation::kDense);
+
+        katana::do_all(
+            katana::iterate(in),
+            [&](const GNode& dst) {
+              GNode& ddata = (*node_data)[dst];
+              if (ddata == BfsImplementation::kDistanceInfinity) {
+                for (GNode src : in.OutNeighbors(dst)) {
+                  if (frontier.Contains(src)) {
+                    // assign parents on the bfs path.
+                    ddata = src;
+                    frontier.Push(dst);
+                    work_items += 1;
+                    break;
+                  }
+                }
+              }
+            },
+            katana::steal(), katana::chunk_size<kChunkSize>(),
+            katana::loopname("SyncDOCompressed-pull"));
+        frontier.Finish();
+      } while (work_items.reduce() >= old_num_work_items ||
+               (work_items.reduce() > num_nodes / beta));
+      scout_count = 1;
+    } else {
+      edges_to_check -= scout_count;
+      work_items.reset();
+
+      frontier.ForEach(
+          [&](const GNode& src) {
+            for (GNode dst : out.OutNeighbors(src)) {
+              GNode& ddata = (*node_data)[dst];
+              if (ddata == BfsImplementation::kDistanceInfinity) {
+                GNode old_parent = ddata;
+                if (__sync_bool_compare_and_swap(&ddata, old_parent, src)) {
+                  frontier.Push(dst);
+                  work_items += out.OutDegree(dst);
+                }
+              }
+            }
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::loopname("SyncDOCompressed-push"));
+      frontier.Finish();
       scout_count = work_items.reduce();
     }
   }
@@ -369,7 +398,7 @@ ComputeParentFromDistance(
 
 katana::Result<void>
 RunAlgo(
-    BfsPlan algo, Graph* graph, const BiDirGraphView& bidir_view,
+    BfsPlan algo, Graph* graph, const BiDirGraphView* bidir_view,
     const GNode& source) {
   BfsImplementation impl{algo.edge_tile_size()};
   katana::StatTimer exec_time("BFS");
@@ -383,8 +412,31 @@ RunAlgo(
 
     exec_time.start();
     SynchronousDirectOpt(
-        bidir_view, &node_data, source, NodePushWrap(), algo.alpha(),
-        algo.beta());
+        *bidir_view, &node_data, source, algo.alpha(), algo.beta());
+    exec_time.stop();
+
+    UpdateGraphNodeData(graph, node_data);
+    break;
+  }
+  case BfsPlan::kSynchronousDirectOptCompressed: {
+    // Both are compressed from the CSR topology, without a transposed
+    // topology; the in-neighbors first, so that their temporary arrays are
+    // freed before the out-neighbors are compressed.
+    const katana::GraphTopology& topology =
+        graph->GetPropertyGraph().topology();
+    katana::CompressedTopology in =
+        katana::CompressedTopology::MakeTransposed(topology);
+    katana::CompressedTopology out = katana::CompressedTopology::Make(topology);
+    katana::ReportStatSingle(
+        "BFS", "CompressedTopologyBytes", out.SizeInBytes() + in.SizeInBytes());
+
+    katana::NUMAArray<GNode> node_data;
+    node_data.allocateInterleaved(graph->NumNodes());
+    InitNodeDataVec(BfsImplementation::kDistanceInfinity, &node_data);
+
+    exec_time.start();
+    SynchronousDirectOptCompressed(
+        out, in, &node_data, source, algo.alpha(), algo.beta());
     exec_time.stop();
 
     UpdateGraphNodeData(graph, node_data);
@@ -402,7 +454,7 @@ RunAlgo(
     exec_time.start();
     AsynchronousAlgo<UpdateRequest>(
         *graph, source, &node_dist, ReqPushWrap(), OutEdgeRangeFn{graph});
-    ComputeParentFromDistance(bidir_view, &node_parent, node_dist, source);
+    ComputeParentFromDistance(*bidir_view, &node_parent, node_dist, source);
     exec_time.stop();
 
     UpdateGraphNodeData(graph, node_parent);
@@ -419,13 +471,14 @@ RunAlgo(
 
 katana::Result<void>
 BfsImpl(
-    Graph* graph, const BiDirGraphView& bidir_view, size_t start_node,
+    Graph* graph, const BiDirGraphView* bidir_view, size_t start_node,
     BfsPlan algo) {
   if (start_node >= graph->NumNodes()) {
     return katana::ErrorCode::InvalidArgument;
   }
 
   if (algo.algorithm() != BfsPlan::kSynchronousDirectOpt &&
+      algo.algorithm() != BfsPlan::kSynchronousDirectOptCompressed &&
       algo.algorithm() != BfsPlan::kAsynchronous) {
     return KATANA_ERROR(
         katana::ErrorCode::NotImplemented, "Unsupported algorithm: {}",
@@ -461,8 +514,13 @@ katana::analytics::Bfs(
   }
 
   auto graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
-  auto bidir_view =
-      KATANA_CHECKED(BiDirGraphView::Make(pg, {output_property_name}, {}));
+  // SynchronousDirectOptCompressed pulls from compressed in-neighbors, so it
+  // does not build the transposed topology of the bidirectional view.
+  std::optional<BiDirGraphView> bidir_view;
+  if (algo.algorithm() != BfsPlan::kSynchronousDirectOptCompressed) {
+    bidir_view =
+        KATANA_CHECKED(BiDirGraphView::Make(pg, {output_property_name}, {}));
+  }
 
   /*
   auto pg_result = Graph::Make(pg, {output_property_name}, {});
@@ -471,7 +529,8 @@ katana::analytics::Bfs(
   }
   */
 
-  return BfsImpl(&graph, bidir_view, start_node, algo);
+  return BfsImpl(
+      &graph, bidir_view ? &bidir_view.value() : nullptr, start_node, algo);
 }
 
 template <typename LevelVec>
@@ -175,9 +175,12 @@ katana::analytics::Cdlp(
   switch (plan.algorithm()) {
   case CdlpPlan::kSynchronous:
     if (is_symmetric)
-      return CdlpWithWrap<
-          CdlpSynchronousAlgo<katana::PropertyGraphViews::Default>>(
-          pg, output_property_name, max_iterations, txn_ctx);
+      return DispatchEdgeIndex<katana::PropertyGraphViews::Default>(
+          *pg, [&](auto view) {
+            using GraphView = typename decltype(view)::type;
+            return CdlpWithWrap<CdlpSynchronousAlgo<GraphView>>(
+                pg, output_property_name, max_iterations, txn_ctx);
+          });
     else
       return CdlpWithWrap<
           CdlpSynchronousAlgo<katana::PropertyGraphViews::Undirected>>(
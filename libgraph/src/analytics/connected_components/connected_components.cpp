@@ -20,7 +20,9 @@
 #include "katana/analytics/connected_components/connected_components.h"
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/CompressedTopology.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Frontier.h"
 
 using namespace katana::analytics;
 
@@ -31,7 +33,6 @@ namespace {
 // // TODO(amber): Switch to Undirected View after comparing performance changes
 // using PropGraphView = katana::PropertyGraphViews::Default;
 
-const unsigned int kInfinity = std::numeric_limits<unsigned int>::max();
 struct ConnectedComponentsNode
     : public katana::UnionFindNode<ConnectedComponentsNode> {
   using ComponentType = ConnectedComponentsNode*;
@@ -108,48 +109,98 @@ struct ConnectedComponentsLabelPropAlgo {
   typedef katana::TypedPropertyGraphView<GraphViewTy, NodeData, EdgeData> Graph;
   typedef typename Graph::Node GNode;
 
-  katana::NUMAArray<ComponentType> old_component_;
   ConnectedComponentsPlan& plan_;
   ConnectedComponentsLabelPropAlgo(ConnectedComponentsPlan& plan)
       : plan_(plan) {}
 
   void Initialize(Graph* graph) {
-    old_component_.allocateBlocked(graph->size());
     katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
       graph->template GetData<NodeComponent>(node).store(node);
-      old_component_[node] = kInfinity;
     });
   }
 
   void Deallocate(Graph*) {}
 
   void operator()(Graph* graph) {
-    katana::GReduceLogicalOr changed;
-    do {
-      changed.reset();
-      katana::do_all(
-          katana::iterate(*graph),
+    // Nodes whose component changed since they last sent it to their
+    // neighbors; rounds touch only these rather than every node
+    Frontier frontier(graph->size());
+    frontier.SetAll();
+    while (!frontier.empty()) {
+      frontier.ForEach(
           [&](const GNode& src) {
-            auto& sdata_current_comp =
+            ComponentType label_new =
                 graph->template GetData<NodeComponent>(src);
-            auto& sdata_old_comp = old_component_[src];
-            if (sdata_old_comp > sdata_current_comp) {
-              sdata_old_comp = sdata_current_comp;
-
-              changed.update(true);
-
-              for (auto e : Edges(*graph, src)) {
-                auto dest = EdgeDst(*graph, e);
-                auto& ddata_current_comp =
-                    graph->template GetData<NodeComponent>(dest);
-                ComponentType label_new = sdata_current_comp;
-                katana::atomicMin(ddata_current_comp, label_new);
+            for (auto e : Edges(*graph, src)) {
+              auto dest = EdgeDst(*graph, e);
+              auto& ddata_current_comp =
+                  graph->template GetData<NodeComponent>(dest);
+              if (katana::atomicMin(ddata_current_comp, label_new) >
+                  label_new) {
+                frontier.Push(dest);
               }
             }
           },
-          katana::disable_conflict_detection(), katana::steal(),
+          katana::steal(),
           katana::loopname("ConnectedComponentsLabelPropAlgo"));
-    } while (changed.reduce());
+      frontier.Finish();
+    }
+  }
+};
+
+/// ConnectedComponentsLabelPropAlgo over a CompressedTopology of the
+/// undirected neighbors of a directed graph, compressed from its CSR topology
+/// so that the transposed topology of the undirected view is not built
+struct ConnectedComponentsLabelPropCompressedAlgo {
+  using ComponentType = uint64_t;
+  struct NodeComponent : public katana::AtomicPODProperty<ComponentType> {};
+
+  using NodeData = std::tuple<NodeComponent>;
+  using EdgeData = std::tuple<>;
+  typedef katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, NodeData, EdgeData>
+      Graph;
+  typedef Graph::Node GNode;
+
+  ConnectedComponentsPlan& plan_;
+  katana::CompressedTopology topology_;
+  ConnectedComponentsLabelPropCompressedAlgo(ConnectedComponentsPlan& plan)
+      : plan_(plan) {}
+
+  void Initialize(Graph* graph) {
+    topology_ =
+        katana::CompressedTopology::MakeUndirected(*graph->shared_topo());
+    katana::ReportStatSingle(
+        "ConnectedComponent", "CompressedTopologyBytes",
+        topology_.SizeInBytes());
+    katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
+      graph->template GetData<NodeComponent>(node).store(node);
+    });
+  }
+
+  void Deallocate(Graph*) { topology_ = katana::CompressedTopology(); }
+
+  void operator()(Graph* graph) {
+    Frontier frontier(graph->size());
+    frontier.SetAll();
+    while (!frontier.empty()) {
+      frontier.ForEach(
+          [&](const GNode& src) {
+            ComponentType label_new =
+                graph->template GetData<NodeComponent>(src);
+            for (GNode dest : topology_.OutNeighbors(src)) {
+              auto& ddata_current_comp =
+                  graph->template GetData<NodeComponent>(dest);
+              if (katana::atomicMin(ddata_current_comp, label_new) >
+                  label_new) {
+                frontier.Push(dest);
+              }
+            }
+          },
+          katana::steal(),
+          katana::loopname("ConnectedComponentsLabelPropCompressedAlgo"));
+      frontier.Finish();
+    }
   }
 };
 
@@ -1227,10 +1278,24 @@ katana::analytics::ConnectedComponents(
     PropertyGraph* pg, const std::string& output_property_name,
     katana::TxnContext* txn_ctx, const bool& is_symmetric,
     ConnectedComponentsPlan plan) {
+  if (plan.algorithm() == ConnectedComponentsPlan::kLabelPropCompressed) {
+    if (!is_symmetric) {
+      return ConnectedComponentsWithWrap<
+          ConnectedComponentsLabelPropCompressedAlgo>(
+          pg, output_property_name, txn_ctx, plan);
+    }
+    // The CSR topology of a symmetric graph already holds the undirected
+    // neighbors, and the compressed copy would be held next to it.
+    plan = ConnectedComponentsPlan::LabelProp();
+  }
+
   if (is_symmetric) {
-    using GraphView = katana::PropertyGraphViews::Default;
-    return ConnectedComponentsSelectAlgorithm<GraphView>(
-        pg, output_property_name, txn_ctx, plan);
+    return DispatchEdgeIndex<katana::PropertyGraphViews::Default>(
+        *pg, [&](auto view) {
+          using GraphView = typename decltype(view)::type;
+          return ConnectedComponentsSelectAlgorithm<GraphView>(
+              pg, output_property_name, txn_ctx, plan);
+        });
   } else {
     using GraphView = katana::PropertyGraphViews::Undirected;
     return ConnectedComponentsSelectAlgorithm<GraphView>(
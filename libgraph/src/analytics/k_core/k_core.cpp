@@ -22,6 +22,7 @@
 #include "katana/ArrowRandomAccessBuilder.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Frontier.h"
 
 using namespace katana::analytics;
 
@@ -63,15 +64,13 @@ DegreeCounting(GraphTy* graph) {
  * Setup initial worklist of dead nodes.
  *
  * @param graph Graph to operate on
- * @param initial_worklist Empty worklist to be filled with dead nodes.
+ * @param push Called in parallel to add each dead node to the worklist.
  * @param k_core_number Each node in the core is expected to have degree <= k_core_number.
  */
-template <typename GraphTy>
+template <typename GraphTy, typename PushFn>
 void
 SetupInitialWorklist(
-    const GraphTy& graph,
-    katana::InsertBag<typename GraphTy::Node>& initial_worklist,
-    uint32_t k_core_number) {
+    const GraphTy& graph, const PushFn& push, uint32_t k_core_number) {
   using GNode = typename GraphTy::Node;
   katana::do_all(
       katana::iterate(graph),
@@ -79,17 +78,17 @@ SetupInitialWorklist(
         const auto& node_current_degree =
             graph.template GetData<KCoreNodeCurrentDegree>(node);
         if (node_current_degree < k_core_number) {
-          //! Dead node, add to initial_worklist for processing later.
-          initial_worklist.emplace(node);
+          //! Dead node, add to initial worklist for processing later.
+          push(node);
         }
       },
       katana::loopname("InitialWorklistSetup"), katana::no_stats());
 }
 
 /**
- * Starting with initial dead nodes as current worklist; decrement degree;
- * add to next worklist; switch next with current and repeat until worklist
- * is empty (i.e. no more dead nodes).
+ * Starting with initial dead nodes as current frontier; decrement degree;
+ * add to next frontier; make next the current frontier and repeat until the
+ * frontier is empty (i.e. no more dead nodes).
  *
  * @param graph Graph to operate on
  * @param k_core_number Each node in the core is expected to have degree <= k_core_number
@@ -98,19 +97,15 @@ template <typename GraphTy>
 void
 SyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
   using GNode = typename GraphTy::Node;
-  auto current = std::make_unique<katana::InsertBag<GNode>>();
-  auto next = std::make_unique<katana::InsertBag<GNode>>();
+  Frontier frontier(graph->NumNodes());
 
   //! Setup worklist.
-  SetupInitialWorklist(*graph, *next, k_core_number);
-
-  while (!next->empty()) {
-    //! Make "next" into current.
-    std::swap(current, next);
-    next->clear();
+  SetupInitialWorklist(
+      *graph, [&](const GNode& node) { frontier.Push(node); }, k_core_number);
+  frontier.Finish();
 
-    katana::do_all(
-        katana::iterate(*current),
+  while (!frontier.empty()) {
+    frontier.ForEach(
         [&](const GNode& dead_node) {
           //! Decrement degree of all neighbors.
           for (auto e : Edges(*graph, dead_node)) {
@@ -121,13 +116,14 @@ SyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
 
             if (old_degree == k_core_number) {
               //! This thread was responsible for putting degree of destination
-              //! below threshold; add to worklist.
-              next->emplace(dest);
+              //! below threshold; add to next frontier.
+              frontier.Push(dest);
             }
           }
         },
         katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
         katana::loopname("KCore Synchronous"));
+    frontier.Finish();
   }
 }
 
@@ -145,7 +141,9 @@ AsyncCascadeKCore(GraphTy* graph, uint32_t k_core_number) {
   using GNode = typename GraphTy::Node;
   katana::InsertBag<GNode> initial_worklist;
   //! Setup worklist.
-  SetupInitialWorklist(*graph, initial_worklist, k_core_number);
+  SetupInitialWorklist(
+      *graph, [&](const GNode& node) { initial_worklist.emplace(node); },
+      k_core_number);
 
   katana::for_each(
       katana::iterate(initial_worklist),
@@ -238,12 +236,15 @@ katana::analytics::KCore(
           txn_ctx, {temporary_property.name()}));
 
   if (is_symmetric) {
-    using Graph = katana::TypedPropertyGraphView<
-        katana::PropertyGraphViews::Default, NodeData, EdgeData>;
-    Graph graph =
-        KATANA_CHECKED(Graph::Make(pg, {temporary_property.name()}, {}));
-
-    KATANA_CHECKED(KCoreImpl(&graph, plan, k_core_number));
+    KATANA_CHECKED(DispatchEdgeIndex<katana::PropertyGraphViews::Default>(
+        *pg, [&](auto view) -> katana::Result<void> {
+          using Graph = katana::TypedPropertyGraphView<
+              typename decltype(view)::type, NodeData, EdgeData>;
+          Graph graph =
+              KATANA_CHECKED(Graph::Make(pg, {temporary_property.name()}, {}));
+
+          return KCoreImpl(&graph, plan, k_core_number);
+        }));
   } else {
     using Graph = katana::TypedPropertyGraphView<
         katana::PropertyGraphViews::Undirected, NodeData, EdgeData>;
@@ -53,6 +53,7 @@ constexpr static const bool kTrackWork = false;
 constexpr static const unsigned kChunkSize = 64U;
 
 using PSchunk = katana::PerSocketChunkFIFO<kChunkSize>;
+using Chunk = katana::ChunkFIFO<kChunkSize>;
 
 class PathAlloc {
 public:
@@ -209,9 +210,6 @@ DeltaStepAlgo(
       GraphTy, Weight, const Path, true>;
   using kSSSPUpdateRequestIndexer = typename kSSSP::UpdateRequestIndexer;
 
-  using OBIM =
-      katana::OrderedByIntegerMetric<kSSSPUpdateRequestIndexer, PSchunk>;
-
   //! [reducible for self-defined stats]
   katana::GAccumulator<size_t> bad_work;
   //! [reducible for self-defined stats]
@@ -269,7 +267,7 @@ DeltaStepAlgo(
           }
         }
       },
-      katana::wl<OBIM>(kSSSPUpdateRequestIndexer{step_shift}),
+      katana::wl<OBIMTy>(kSSSPUpdateRequestIndexer{step_shift}),
       katana::disable_conflict_detection(), katana::loopname("kSSSP"));
 
   if (kTrackWork) {
@@ -320,8 +318,8 @@ KssspImpl(
   using kSSSPOutEdgeRangeFn = typename kSSSP::OutEdgeRangeFn;
   using kSSSPTileRangeFn = typename kSSSP::TileRangeFn;
 
-  using OBIM =
-      katana::OrderedByIntegerMetric<kSSSPUpdateRequestIndexer, PSchunk>;
+  using OBIM = katana::PerSocketOrderedByIntegerMetric<
+      kSSSPUpdateRequestIndexer, Chunk>;
   using OBIM_Barrier = typename katana::OrderedByIntegerMetric<
       kSSSPUpdateRequestIndexer, PSchunk>::template with_barrier<true>::type;
 
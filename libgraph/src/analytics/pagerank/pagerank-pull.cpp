@@ -19,6 +19,7 @@
 
 #include <arrow/type.h>
 
+#include "katana/CompressedTopology.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
@@ -45,14 +46,50 @@ using EdgeData = std::tuple<>;
 using Graph = katana::TypedPropertyGraphView<
     katana::PropertyGraphViews::Transposed, NodeData, EdgeData>;
 
+//! The graph with the CSR topology it was loaded with, for the compressed
+//! plan, which pulls from compressed in-neighbors instead of a transposed
+//! topology
+using CSRGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, NodeData, EdgeData>;
+
+//! Allocate node data blocked by the node ranges that threads own, so that
+//! it is local to the threads of OwnerComputesNodes() loops when the graph is
+//! partitioned across NUMA nodes.
+template <typename GraphTy, typename T>
+void
+AllocateOwned(const GraphTy& graph, katana::NUMAArray<T>* array) {
+  std::vector<uint32_t> ranges = graph.OwnerThreadRanges();
+  array->allocateSpecified(graph.size(), ranges);
+}
+
+//! Call fn(dest) for every out-neighbor dest of src in the transposed graph.
+//! Topology is the Graph or a CSRTopology of it.
+template <typename Topology, typename F>
+void
+ForEachNeighbor(const Topology& topology, Graph::Node src, const F& fn) {
+  for (auto nbr : topology.OutEdges(src)) {
+    fn(topology.OutEdgeDst(nbr));
+  }
+}
+
+template <typename F>
+void
+ForEachNeighbor(
+    const katana::CompressedTopology& topology, Graph::Node src, const F& fn) {
+  for (auto dest : topology.OutNeighbors(src)) {
+    fn(dest);
+  }
+}
+
 //! Initialize nodes for the topological algorithm.
+template <typename GraphTy>
 katana::Result<void>
 InitNodeDataTopological(
-    const Graph& graph, PagerankValueAndOutDegreeArray* node_data) {
-  using GNode = typename Graph::Node;
+    const GraphTy& graph, PagerankValueAndOutDegreeArray* node_data) {
+  using GNode = typename GraphTy::Node;
   PRTy init_value = 1.0f / graph.size();
   katana::do_all(
-      katana::iterate(graph),
+      graph.OwnerComputesNodes(),
       [&](const GNode& n) {
         (*node_data)[n].value = init_value;
         (*node_data)[n].out = 0;
@@ -68,7 +105,7 @@ InitNodeDataResidual(
     NodeOutDegreeArray* node_out_degree, katana::analytics::PagerankPlan plan) {
   using GNode = typename Graph::Node;
   katana::do_all(
-      katana::iterate(*graph),
+      graph->OwnerComputesNodes(),
       [&](const GNode& n) {
         auto& sdata = graph->template GetData<NodeValue>(n);
         sdata = 0;
@@ -82,34 +119,35 @@ InitNodeDataResidual(
 
 //! Computing outdegrees in the tranpose graph is equivalent to computing the
 //! indegrees in the original graph.
+//! Topology is the Graph, a CSRTopology or a CompressedTopology of it.
+template <typename Topology>
 katana::Result<void>
-ComputeOutDeg(const Graph& graph, PagerankValueAndOutDegreeArray* node_data) {
+ComputeOutDeg(
+    const Topology& topology, PagerankValueAndOutDegreeArray* node_data) {
   using GNode = typename Graph::Node;
   katana::StatTimer out_degree_timer("computeOutDegFunc");
   out_degree_timer.start();
 
   katana::NUMAArray<std::atomic<size_t>> vec;
-  vec.allocateInterleaved(graph.size());
+  vec.allocateInterleaved(topology.size());
 
   katana::do_all(
-      katana::iterate(graph),
+      katana::iterate(topology),
       [&](const GNode& src) { vec.constructAt(src, 0ul); },
       katana::loopname("InitDegVec"));
 
   katana::do_all(
-      katana::iterate(graph),
+      katana::iterate(topology),
       [&](const GNode& src) {
-        for (auto nbr : graph.OutEdges(src)) {
-          auto dest = graph.OutEdgeDst(nbr);
-          vec[dest].fetch_add(1ul);
-        }
+        ForEachNeighbor(
+            topology, src, [&](GNode dest) { vec[dest].fetch_add(1ul); });
       },
       katana::steal(),
       katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
       katana::loopname("ComputeOutDeg"));
 
   katana::do_all(
-      katana::iterate(graph),
+      katana::iterate(topology),
       [&](const GNode& src) { (*node_data)[src].out = vec[src]; },
       katana::loopname("CopyDeg"));
 
@@ -117,34 +155,33 @@ ComputeOutDeg(const Graph& graph, PagerankValueAndOutDegreeArray* node_data) {
   return katana::ResultSuccess();
 }
 
+template <typename Topology>
 katana::Result<void>
-ComputeOutDeg(const Graph& graph, NodeOutDegreeArray* node_data) {
+ComputeOutDeg(const Topology& topology, NodeOutDegreeArray* node_data) {
   using GNode = typename Graph::Node;
   katana::StatTimer out_degree_timer("computeOutDegFunc");
   out_degree_timer.start();
 
   katana::NUMAArray<std::atomic<size_t>> vec;
-  vec.allocateInterleaved(graph.size());
+  vec.allocateInterleaved(topology.size());
 
   katana::do_all(
-      katana::iterate(graph),
+      katana::iterate(topology),
       [&](const GNode& src) { vec.constructAt(src, 0ul); },
       katana::loopname("InitDegVec"));
 
   katana::do_all(
-      katana::iterate(graph),
+      katana::iterate(topology),
       [&](const GNode& src) {
-        for (auto nbr : graph.OutEdges(src)) {
-          auto dest = graph.OutEdgeDst(nbr);
-          vec[dest].fetch_add(1ul);
-        }
+        ForEachNeighbor(
+            topology, src, [&](GNode dest) { vec[dest].fetch_add(1ul); });
       },
       katana::steal(),
       katana::chunk_size<katana::analytics::PagerankPlan::kChunkSize>(),
       katana::loopname("ComputeOutDeg"));
 
   katana::do_all(
-      katana::iterate(graph),
+      katana::iterate(topology),
       [&](const GNode& src) { (*node_data)[src] = vec[src]; },
       katana::loopname("CopyDeg"));
 
@@ -158,11 +195,15 @@ ComputeOutDeg(const Graph& graph, NodeOutDegreeArray* node_data) {
  * the current one.
  * If the residual is smaller than the tolerance, that is not reflected to
  * the next pagerank.
+ * Neighbors are read from topology, which is the graph or a CSRTopology of
+ * it.
  */
 //! [scalarreduction]
+template <typename Topology>
 katana::Result<void>
 ComputePRResidual(
-    Graph* graph, DeltaArray* delta, ResidualArray* residual,
+    Graph* graph, const Topology& topology, DeltaArray* delta,
+    ResidualArray* residual,
     const NodeOutDegreeArray& node_out_degree,
     katana::analytics::PagerankPlan plan) {
   katana::StatTimer exec_time("PagerankPullResidual");
@@ -173,7 +214,7 @@ ComputePRResidual(
 
   while (true) {
     katana::do_all(
-        katana::iterate(*graph),
+        graph->OwnerComputesNodes(),
         [&](const GNode& src) {
           auto& sdata = graph->template GetData<NodeValue>(src);
           (*delta)[src] = 0;
@@ -194,15 +235,14 @@ ComputePRResidual(
         katana::loopname("PageRank_delta"));
 
     katana::do_all(
-        katana::iterate(*graph),
+        graph->OwnerComputesNodes(),
         [&](const GNode& src) {
           float sum = 0;
-          for (auto nbr : graph->OutEdges(src)) {
-            auto dest = graph->OutEdgeDst(nbr);
+          ForEachNeighbor(topology, src, [&](GNode dest) {
             if ((*delta)[dest] > 0) {
               sum += (*delta)[dest];
             }
-          }
+          });
           if (sum > 0) {
             (*residual)[src] = sum;
           }
@@ -228,30 +268,33 @@ ComputePRResidual(
 /**
  * PageRank pull topological.
  * Always calculate the new pagerank for each iteration.
+ * Neighbors are read from topology, which is the graph, a CSRTopology of it
+ * or a CompressedTopology of the in-neighbors of its CSR topology.
  */
+template <typename GraphTy, typename Topology>
 katana::Result<void>
 ComputePRTopological(
-    Graph* graph, katana::analytics::PagerankPlan plan,
+    GraphTy* graph, const Topology& topology,
+    katana::analytics::PagerankPlan plan,
     PagerankValueAndOutDegreeArray* node_data) {
   katana::StatTimer exec_time("PagerankPullTopological");
   exec_time.start();
 
-  using GNode = typename Graph::Node;
+  using GNode = typename GraphTy::Node;
   unsigned int iteration = 0;
   katana::GAccumulator<float> accum;
 
   float base_score = (1.0f - plan.alpha());
   while (true) {
     katana::do_all(
-        katana::iterate(*graph),
+        graph->OwnerComputesNodes(),
         [&](const GNode& src) {
           float sum = 0.0;
 
-          for (auto jj : graph->OutEdges(src)) {
-            auto dest = graph->OutEdgeDst(jj);
+          ForEachNeighbor(topology, src, [&](GNode dest) {
             auto& ddata = (*node_data)[dest];
             sum += ddata.value / ddata.out;
-          }
+          });
 
           //! New value of pagerank after computing contributions from
           //! incoming edges in the original graph.
@@ -296,6 +339,22 @@ ComputePRTopological(
   return katana::ResultSuccess();
 }
 
+//! Calls fn(topology) with the transposed topology of pg with 32-bit edge
+//! ids if it has fewer than 2^32 edges, which halves the edge index read by
+//! the pull loops, and with graph otherwise. The 32-bit index is cached with
+//! the topology, so repeated runs do not rebuild it.
+template <typename F>
+katana::Result<void>
+WithNarrowestTopology(
+    katana::PropertyGraph* pg, const Graph& graph, const F& fn) {
+  if (katana::CSRTopology<uint32_t>::CanIndex(graph.NumEdges())) {
+    using NarrowView = katana::PropertyGraphViews::WithEdgeIndex<
+        katana::PropertyGraphViews::Transposed, uint32_t>;
+    return fn(pg->BuildView<NarrowView>());
+  }
+  return fn(graph);
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -312,12 +371,44 @@ PagerankPullTopological(
 
   // NUMA-aware temporary node data
   PagerankValueAndOutDegreeArray node_data;
-  node_data.allocateInterleaved(graph.size());
+  AllocateOwned(graph, &node_data);
+
+  KATANA_CHECKED(InitNodeDataTopological(graph, &node_data));
+
+  return WithNarrowestTopology(
+      pg, graph, [&](const auto& topology) -> katana::Result<void> {
+        KATANA_CHECKED(ComputeOutDeg(topology, &node_data));
+        return ComputePRTopological(&graph, topology, plan, &node_data);
+      });
+}
+
+katana::Result<void>
+PagerankPullTopologicalCompressed(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  KATANA_CHECKED(pg->ConstructNodeProperties<std::tuple<NodeValue>>(
+      txn_ctx, {output_property_name}));
+
+  // Pulling from compressed in-neighbors of the CSR topology, rather than
+  // compressing the transposed view, does not build a transposed topology.
+  CSRGraph graph =
+      KATANA_CHECKED(CSRGraph::Make(pg, {output_property_name}, {}));
+  katana::CompressedTopology topology =
+      katana::CompressedTopology::MakeTransposed(pg->topology());
+  katana::ReportStatSingle(
+      "PageRank", "CompressedTopologyBytes", topology.SizeInBytes());
+
+  katana::EnsurePreallocated(2, 3 * graph.size() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  // NUMA-aware temporary node data
+  PagerankValueAndOutDegreeArray node_data;
+  AllocateOwned(graph, &node_data);
 
   KATANA_CHECKED(InitNodeDataTopological(graph, &node_data));
-  KATANA_CHECKED(ComputeOutDeg(graph, &node_data));
+  KATANA_CHECKED(ComputeOutDeg(topology, &node_data));
 
-  return ComputePRTopological(&graph, plan, &node_data);
+  return ComputePRTopological(&graph, topology, plan, &node_data);
 }
 
 katana::Result<void>
@@ -334,16 +425,20 @@ PagerankPullResidual(
 
   // NUMA-aware temporary node data
   NodeOutDegreeArray node_out_degree;
-  node_out_degree.allocateInterleaved(graph.size());
+  AllocateOwned(graph, &node_out_degree);
 
   DeltaArray delta;
-  delta.allocateInterleaved(graph.size());
+  AllocateOwned(graph, &delta);
   ResidualArray residual;
-  residual.allocateInterleaved(graph.size());
+  AllocateOwned(graph, &residual);
 
   KATANA_CHECKED(
       InitNodeDataResidual(&graph, &delta, &residual, &node_out_degree, plan));
-  KATANA_CHECKED(ComputeOutDeg(graph, &node_out_degree));
 
-  return ComputePRResidual(&graph, &delta, &residual, node_out_degree, plan);
+  return WithNarrowestTopology(
+      pg, graph, [&](const auto& topology) -> katana::Result<void> {
+        KATANA_CHECKED(ComputeOutDeg(topology, &node_out_degree));
+        return ComputePRResidual(
+            &graph, topology, &delta, &residual, node_out_degree, plan);
+      });
 }
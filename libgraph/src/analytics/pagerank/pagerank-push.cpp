@@ -34,63 +34,65 @@ using EdgeData = std::tuple<>;
 // typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
 // typedef typename Graph::Node GNode;
 
-using Graph = katana::TypedPropertyGraphView<
-    katana::PropertyGraphViews::Default, NodeData, EdgeData>;
-using GNode = typename Graph::Node;
+template <typename GraphView>
+using Graph = katana::TypedPropertyGraphView<GraphView, NodeData, EdgeData>;
 
+template <typename Graph>
 void
 InitializeNodeResidual(
     Graph* graph, const katana::analytics::PagerankPlan& plan) {
+  using GNode = typename Graph::Node;
   katana::do_all(
       katana::iterate(*graph),
       [&](const GNode& n) {
-        graph->GetData<NodeResidual>(n) = plan.initial_residual();
-        graph->GetData<NodeValue>(n) = 0;
+        graph->template GetData<NodeResidual>(n) = plan.initial_residual();
+        graph->template GetData<NodeValue>(n) = 0;
       },
       katana::no_stats(), katana::loopname("Initialize"));
 }
 
-}  // namespace
-
+//! Calls fn(&graph) with a typed view of pg with the edge ids of
+//! DispatchEdgeIndex.
+template <typename F>
 katana::Result<void>
-PagerankPushAsynchronous(
-    katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
-  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
-  katana::ReportPageAllocGuard page_alloc;
-
-  katana::analytics::TemporaryPropertyGuard temporary_property{
-      pg->NodeMutablePropertyView()};
-
-  if (auto result = pg->ConstructNodeProperties<NodeData>(
-          txn_ctx, {output_property_name, temporary_property.name()});
-      !result) {
-    return result.error();
-  }
-
-  Graph graph = KATANA_CHECKED(
-      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+WithGraph(
+    katana::PropertyGraph* pg, const std::vector<std::string>& node_properties,
+    const F& fn) {
+  return katana::analytics::DispatchEdgeIndex<
+      katana::PropertyGraphViews::Default>(
+      *pg, [&](auto view) -> katana::Result<void> {
+        using GraphView = typename decltype(view)::type;
+        auto graph =
+            KATANA_CHECKED(Graph<GraphView>::Make(pg, node_properties, {}));
+        return fn(&graph);
+      });
+}
 
-  InitializeNodeResidual(&graph, plan);
+template <typename Graph>
+katana::Result<void>
+PushAsynchronous(Graph* graph, const katana::analytics::PagerankPlan& plan) {
+  using GNode = typename Graph::Node;
+  InitializeNodeResidual(graph, plan);
 
   typedef katana::PerSocketChunkFIFO<
       katana::analytics::PagerankPlan::kChunkSize>
       WL;
   katana::for_each(
-      katana::iterate(graph),
+      katana::iterate(*graph),
       [&](const GNode& src, auto& ctx) {
-        auto& src_residual = graph.GetData<NodeResidual>(src);
+        auto& src_residual = graph->template GetData<NodeResidual>(src);
         if (src_residual > plan.tolerance()) {
           PRTy old_residual = src_residual.exchange(0.0);
-          auto& src_value = graph.GetData<NodeValue>(src);
+          auto& src_value = graph->template GetData<NodeValue>(src);
           src_value += old_residual;
-          int src_nout = graph.OutDegree(src);
+          int src_nout = graph->OutDegree(src);
           if (src_nout > 0) {
             PRTy delta = old_residual * plan.alpha() / src_nout;
             //! For each out-going neighbors.
-            for (const auto& jj : graph.OutEdges(src)) {
-              auto dest = graph.OutEdgeDst(jj);
-              auto& dest_residual = graph.GetData<NodeResidual>(dest);
+            for (const auto& jj : graph->OutEdges(src)) {
+              auto dest = graph->OutEdgeDst(jj);
+              auto& dest_residual =
+                  graph->template GetData<NodeResidual>(dest);
               if (delta > 0) {
                 auto old = atomicAdd(dest_residual, delta);
                 if ((old < plan.tolerance()) &&
@@ -108,31 +110,16 @@ PagerankPushAsynchronous(
   return katana::ResultSuccess();
 }
 
+template <typename Graph>
 katana::Result<void>
-PagerankPushSynchronous(
-    katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
-  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
-  katana::ReportPageAllocGuard page_alloc;
-
-  katana::analytics::TemporaryPropertyGuard temporary_property{
-      pg->NodeMutablePropertyView()};
-
-  if (auto result = pg->ConstructNodeProperties<NodeData>(
-          txn_ctx, {output_property_name, temporary_property.name()});
-      !result) {
-    return result.error();
-  }
-
-  Graph graph = KATANA_CHECKED(
-      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
-
-  InitializeNodeResidual(&graph, plan);
+PushSynchronous(Graph* graph, const katana::analytics::PagerankPlan& plan) {
+  using GNode = typename Graph::Node;
+  InitializeNodeResidual(graph, plan);
 
   struct Update {
     PRTy delta;
-    Graph::edge_iterator beg;
-    Graph::edge_iterator end;
+    typename Graph::edge_iterator beg;
+    typename Graph::edge_iterator end;
   };
 
   constexpr ptrdiff_t kEdgeTileSize = 128;
@@ -141,26 +128,26 @@ PagerankPushSynchronous(
   katana::InsertBag<GNode> active_nodes;
 
   katana::do_all(
-      katana::iterate(graph), [&](const auto& src) { active_nodes.push(src); },
-      katana::no_stats());
+      katana::iterate(*graph),
+      [&](const auto& src) { active_nodes.push(src); }, katana::no_stats());
 
   size_t iter = 0;
   for (; !active_nodes.empty() && iter < plan.max_iterations(); ++iter) {
     katana::do_all(
         katana::iterate(active_nodes),
         [&](const GNode& src) {
-          auto& sdata_residual = graph.GetData<NodeResidual>(src);
+          auto& sdata_residual = graph->template GetData<NodeResidual>(src);
 
           if (sdata_residual > plan.tolerance()) {
             PRTy old_residual = sdata_residual;
-            graph.GetData<NodeValue>(src) += old_residual;
+            graph->template GetData<NodeValue>(src) += old_residual;
             sdata_residual = 0.0;
 
-            int src_nout = graph.OutEdges(src).size();
+            int src_nout = graph->OutEdges(src).size();
             PRTy delta = old_residual * plan.alpha() / src_nout;
 
-            auto beg = graph.OutEdges(src).begin();
-            const auto end = graph.OutEdges(src).end();
+            auto beg = graph->OutEdges(src).begin();
+            const auto end = graph->OutEdges(src).end();
 
             KATANA_LOG_ASSERT(beg <= end);
 
@@ -189,8 +176,8 @@ PagerankPushSynchronous(
         [&](const Update& up) {
           //! For each out-going neighbors.
           for (auto jj = up.beg; jj != up.end; ++jj) {
-            auto dest = graph.OutEdgeDst(*jj);
-            auto& ddata_residual = graph.GetData<NodeResidual>(dest);
+            auto dest = graph->OutEdgeDst(*jj);
+            auto& ddata_residual = graph->template GetData<NodeResidual>(dest);
             auto old = atomicAdd(ddata_residual, up.delta);
             //! If fabs(old) is greater than tolerance, then it would
             //! already have been processed in the previous do_all
@@ -209,3 +196,47 @@ PagerankPushSynchronous(
   }
   return katana::ResultSuccess();
 }
+
+}  // namespace
+
+katana::Result<void>
+PagerankPushAsynchronous(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  if (auto result = pg->ConstructNodeProperties<NodeData>(
+          txn_ctx, {output_property_name, temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  return WithGraph(
+      pg, {output_property_name, temporary_property.name()},
+      [&](auto* graph) { return PushAsynchronous(graph, plan); });
+}
+
+katana::Result<void>
+PagerankPushSynchronous(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  katana::EnsurePreallocated(5, 5 * pg->NumNodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  if (auto result = pg->ConstructNodeProperties<NodeData>(
+          txn_ctx, {output_property_name, temporary_property.name()});
+      !result) {
+    return result.error();
+  }
+
+  return WithGraph(
+      pg, {output_property_name, temporary_property.name()},
+      [&](auto* graph) { return PushSynchronous(graph, plan); });
+}
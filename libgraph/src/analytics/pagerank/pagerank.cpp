@@ -29,6 +29,9 @@ katana::analytics::Pagerank(
     return PagerankPullResidual(pg, output_property_name, plan, txn_ctx);
   case PagerankPlan::kPullTopological:
     return PagerankPullTopological(pg, output_property_name, plan, txn_ctx);
+  case PagerankPlan::kPullTopologicalCompressed:
+    return PagerankPullTopologicalCompressed(
+        pg, output_property_name, plan, txn_ctx);
   case PagerankPlan::kPushAsynchronous:
     return PagerankPushAsynchronous(pg, output_property_name, plan, txn_ctx);
   case PagerankPlan::kPushSynchronous:
@@ -23,6 +23,7 @@
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
+#include "katana/analytics/Frontier.h"
 #include "katana/gstl.h"
 
 using namespace katana::analytics;
@@ -66,7 +67,9 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
   static constexpr Dist kDistanceInfinity = Base::kDistanceInfinity;
 
   using PSchunk = katana::PerSocketChunkFIFO<kChunkSize>;
-  using OBIM = katana::OrderedByIntegerMetric<UpdateRequestIndexer, PSchunk>;
+  using Chunk = katana::ChunkFIFO<kChunkSize>;
+  using OBIM =
+      katana::PerSocketOrderedByIntegerMetric<UpdateRequestIndexer, Chunk>;
   using OBIMBarrier = typename katana::OrderedByIntegerMetric<
       UpdateRequestIndexer, PSchunk>::template with_barrier<true>::type;
 
@@ -157,22 +160,24 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
 
     katana::GAccumulator<size_t> fused_rounds;
 
-    katana::InsertBag<Node> wl;
-    wl.push_back(source);
+    // Nodes relaxed by several threads into the same bucket are in the
+    // frontier once
+    Frontier frontier(graph->NumNodes());
+    frontier.Push(source);
+    frontier.Finish();
 
     size_t cur_bucket = 0;
 
     for (size_t rounds = 1; true; ++rounds) {
       Dist cur_dist = cur_bucket * (1 << stepShift);
-      katana::do_all(
-          katana::iterate(wl),
+      frontier.ForEach(
           [&](const Node& n) {
             Dist sdist = (*node_data)[n];
             if (sdist >= cur_dist) {
               relax(n, sdist, *buckets.getLocal());
             }
           },
-          katana::wl<PSchunk>, katana::steal());
+          katana::steal());
 
       katana::GReduceMin<size_t> least_bucket;
 
@@ -199,8 +204,6 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
         }
       });
 
-      wl.clear();
-
       cur_bucket = least_bucket.reduce();
       if (cur_bucket == std::numeric_limits<size_t>::max()) {
         katana::ReportStatSingle("SSSP", "rounds", rounds);
@@ -217,11 +220,12 @@ struct SsspImplementation : public katana::analytics::BfsSsspImplementationBase<
           return;
         }
         for (Node n : b[cur_bucket]) {
-          wl.push(n);
+          frontier.Push(n);
         }
         b[cur_bucket].clear();
         b[cur_bucket].shrink_to_fit();
       });
+      frontier.Finish();
     }
   }
 
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "katana/CompressedTopology.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using Edge = katana::GraphTopology::Edge;
+
+/// A graph with nodes of no, few and many neighbors, duplicate neighbors and
+/// neighbors both before and after their source
+katana::GraphTopology
+MakeRandomTopology(size_t num_nodes) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<Node> node(0, num_nodes - 1);
+  std::vector<std::vector<Node>> neighbors(num_nodes);
+  for (Node n = 0; n < num_nodes; ++n) {
+    size_t degree = n % 7 == 0 ? 0 : n % 101 == 1 ? 5000 : n % 13;
+    for (size_t i = 0; i < degree; ++i) {
+      neighbors[n].push_back(node(gen));
+    }
+    if (degree > 2) {
+      neighbors[n].push_back(neighbors[n][0]);
+    }
+  }
+
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateBlocked(num_nodes);
+  size_t num_edges = 0;
+  for (Node n = 0; n < num_nodes; ++n) {
+    num_edges += neighbors[n].size();
+    adj_indices[n] = num_edges;
+  }
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateBlocked(num_edges);
+  Edge e = 0;
+  for (Node n = 0; n < num_nodes; ++n) {
+    for (Node dst : neighbors[n]) {
+      dests[e++] = dst;
+    }
+  }
+  return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
+std::vector<Node>
+Decode(const katana::CompressedTopology& compressed, Node n) {
+  std::vector<Node> decoded;
+  for (Node dst : compressed.OutNeighbors(n)) {
+    decoded.push_back(dst);
+  }
+  KATANA_LOG_ASSERT(compressed.OutDegree(n) == decoded.size());
+  return decoded;
+}
+
+void
+TestCompress(size_t num_nodes) {
+  katana::GraphTopology topo = MakeRandomTopology(num_nodes);
+  katana::CompressedTopology compressed =
+      katana::CompressedTopology::Make(topo);
+
+  KATANA_LOG_ASSERT(compressed.NumNodes() == topo.NumNodes());
+  KATANA_LOG_ASSERT(compressed.NumEdges() == topo.NumEdges());
+  KATANA_LOG_VASSERT(
+      num_nodes == 1 ||
+          compressed.SizeInBytes() <
+              topo.NumNodes() * sizeof(Edge) + topo.NumEdges() * sizeof(Node),
+      "compressed to {} bytes", compressed.SizeInBytes());
+
+  katana::do_all(katana::iterate(compressed), [&](Node n) {
+    std::vector<Node> expected;
+    for (Edge e : topo.OutEdges(n)) {
+      expected.push_back(topo.OutEdgeDst(e));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    KATANA_LOG_VASSERT(Decode(compressed, n) == expected, "node {}", n);
+  });
+}
+
+/// Check the in-neighbors and the undirected neighbors compressed without a
+/// transposed topology
+void
+TestCompressTransposed(size_t num_nodes) {
+  katana::GraphTopology topo = MakeRandomTopology(num_nodes);
+  katana::CompressedTopology transposed =
+      katana::CompressedTopology::MakeTransposed(topo);
+  katana::CompressedTopology undirected =
+      katana::CompressedTopology::MakeUndirected(topo);
+
+  std::vector<std::vector<Node>> in_neighbors(num_nodes);
+  for (Node n = 0; n < num_nodes; ++n) {
+    for (Edge e : topo.OutEdges(n)) {
+      in_neighbors[topo.OutEdgeDst(e)].push_back(n);
+    }
+  }
+
+  KATANA_LOG_ASSERT(transposed.NumNodes() == topo.NumNodes());
+  KATANA_LOG_ASSERT(transposed.NumEdges() == topo.NumEdges());
+  KATANA_LOG_ASSERT(undirected.NumNodes() == topo.NumNodes());
+  KATANA_LOG_ASSERT(undirected.NumEdges() == 2 * topo.NumEdges());
+
+  katana::do_all(katana::iterate(transposed), [&](Node n) {
+    std::vector<Node> expected = in_neighbors[n];
+    std::sort(expected.begin(), expected.end());
+    KATANA_LOG_VASSERT(Decode(transposed, n) == expected, "node {}", n);
+
+    for (Edge e : topo.OutEdges(n)) {
+      expected.push_back(topo.OutEdgeDst(e));
+    }
+    std::sort(expected.begin(), expected.end());
+    KATANA_LOG_VASSERT(Decode(undirected, n) == expected, "node {}", n);
+  });
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  katana::CompressedTopology empty =
+      katana::CompressedTopology::Make(katana::GraphTopology{});
+  KATANA_LOG_ASSERT(empty.NumNodes() == 0);
+  KATANA_LOG_ASSERT(empty.NumEdges() == 0);
+
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    TestCompress(1);
+    TestCompress(100003);
+    TestCompressTransposed(1);
+    TestCompressTransposed(100003);
+  }
+
+  return 0;
+}
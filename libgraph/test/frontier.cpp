@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/analytics/Frontier.h"
+
+namespace {
+
+using Frontier = katana::analytics::Frontier;
+using Node = Frontier::Node;
+using Representation = Frontier::Representation;
+
+/// Push every node of nodes twice from a parallel loop
+void
+PushTwice(const std::vector<Node>& nodes, Frontier* frontier) {
+  katana::do_all(katana::iterate(nodes), [&](Node n) {
+    frontier->Push(n);
+    frontier->Push(n);
+  });
+}
+
+/// Checks every way of reading the frontier against the sorted set expected
+void
+CheckContents(const Frontier& frontier, const std::vector<Node>& expected) {
+  KATANA_LOG_ASSERT(frontier.size() == expected.size());
+  KATANA_LOG_ASSERT(frontier.ToVector() == expected);
+
+  std::vector<std::atomic<int>> seen(frontier.num_nodes());
+  frontier.ForEach([&](Node n) { seen[n] += 1; }, katana::steal());
+  for (Node n = 0; n < frontier.num_nodes(); ++n) {
+    bool in = std::binary_search(expected.begin(), expected.end(), n);
+    KATANA_LOG_VASSERT(seen[n] == (in ? 1 : 0), "node {} seen {}", n, seen[n]);
+    KATANA_LOG_VASSERT(frontier.Contains(n) == in, "node {}", n);
+  }
+}
+
+std::vector<Node>
+RandomNodes(size_t num_nodes, size_t count, std::mt19937* gen) {
+  std::uniform_int_distribution<Node> node(0, num_nodes - 1);
+  std::vector<Node> ret;
+  for (size_t i = 0; i < count; ++i) {
+    ret.push_back(node(*gen));
+  }
+  std::sort(ret.begin(), ret.end());
+  ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+  return ret;
+}
+
+void
+TestRepresentations(size_t num_nodes) {
+  std::mt19937 gen(0);
+  Frontier frontier(num_nodes);
+
+  std::vector<Node> sparse = RandomNodes(num_nodes, 100, &gen);
+  // Two bitmap containers and a few stray nodes
+  std::vector<Node> clustered = RandomNodes(num_nodes, 20, &gen);
+  for (Node n = 1 << 16; n < (1 << 16) + 5000; ++n) {
+    clustered.push_back(n);
+    clustered.push_back(n + (2 << 16));
+  }
+  std::sort(clustered.begin(), clustered.end());
+  clustered.erase(
+      std::unique(clustered.begin(), clustered.end()), clustered.end());
+  std::vector<Node> dense = RandomNodes(num_nodes, num_nodes / 4, &gen);
+  // Few enough nodes to be cleared one by one, but pushed twice often enough
+  // that Finish() builds only the bitmap
+  std::vector<Node> duplicated = RandomNodes(num_nodes, num_nodes / 48, &gen);
+  KATANA_LOG_ASSERT(duplicated.size() * 64 >= num_nodes);
+  KATANA_LOG_ASSERT(duplicated.size() * 32 < num_nodes);
+
+  struct Case {
+    const std::vector<Node>* nodes;
+    Representation expected;
+  };
+  // Go through every transition between representations, each time
+  // converting to every other one
+  for (const Case& c :
+       {Case{&sparse, Representation::kSparse},
+        Case{&dense, Representation::kDense},
+        Case{&clustered, Representation::kCompressed},
+        Case{&sparse, Representation::kSparse},
+        Case{&clustered, Representation::kCompressed},
+        Case{&dense, Representation::kDense},
+        Case{&sparse, Representation::kSparse}}) {
+    PushTwice(*c.nodes, &frontier);
+    frontier.Finish();
+    KATANA_LOG_ASSERT(frontier.representation() == c.expected);
+    CheckContents(frontier, *c.nodes);
+
+    for (Representation r :
+         {Representation::kDense, Representation::kCompressed,
+          Representation::kSparse}) {
+      frontier.ConvertTo(r);
+      KATANA_LOG_ASSERT(frontier.representation() == r);
+      CheckContents(frontier, *c.nodes);
+    }
+  }
+
+  // The next Finish() must clear the whole bitmap of duplicated, which has
+  // no other representation to find its nodes in
+  PushTwice(duplicated, &frontier);
+  frontier.Finish();
+  KATANA_LOG_ASSERT(frontier.representation() == Representation::kDense);
+  KATANA_LOG_ASSERT(frontier.size() == duplicated.size());
+  PushTwice(sparse, &frontier);
+  frontier.Finish();
+  frontier.ConvertTo(Representation::kDense);
+  CheckContents(frontier, sparse);
+
+  frontier.Finish();
+  KATANA_LOG_ASSERT(frontier.empty());
+  frontier.ConvertTo(Representation::kDense);
+  CheckContents(frontier, {});
+
+  frontier.SetAll();
+  std::vector<Node> all(num_nodes);
+  for (Node n = 0; n < num_nodes; ++n) {
+    all[n] = n;
+  }
+  CheckContents(frontier, all);
+  frontier.Clear();
+  frontier.ConvertTo(Representation::kDense);
+  CheckContents(frontier, {});
+}
+
+/// A BFS that pushes from ForEach on the frontier it iterates
+void
+TestLevels(size_t num_nodes) {
+  // Node n links to 2n + 1 and 2n + 2
+  std::vector<uint32_t> level(num_nodes, 0);
+  Frontier frontier(num_nodes);
+  frontier.Push(0);
+  frontier.Finish();
+  for (uint32_t l = 1; !frontier.empty(); ++l) {
+    frontier.ForEach([&](Node n) {
+      for (size_t c = 2 * size_t{n} + 1; c <= 2 * size_t{n} + 2; ++c) {
+        if (c < num_nodes) {
+          level[c] = l;
+          frontier.Push(c);
+        }
+      }
+    });
+    frontier.Finish();
+  }
+  for (size_t n = 1; n < num_nodes; ++n) {
+    KATANA_LOG_ASSERT(level[n] == level[(n - 1) / 2] + 1);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    TestRepresentations((1 << 20) + 3);
+    TestLevels(1000003);
+  }
+
+  return 0;
+}
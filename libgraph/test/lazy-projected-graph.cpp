@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/EntityTypeManager.h"
+#include "katana/LazyProjectedGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+/// Check that lazy projects the same nodes and edges, with the same types, as
+/// projected, a projection of the same graph made by
+/// PropertyGraph::MakeProjectedGraph
+void
+TestSameProjection(
+    const katana::LazyProjectedGraph& lazy,
+    const katana::PropertyGraph& projected) {
+  const katana::PropertyGraph& pg = lazy.property_graph();
+  const katana::GraphTopology& topo = projected.topology();
+
+  KATANA_LOG_ASSERT(topo.NumNodes() == lazy.NumNodes());
+
+  std::vector<katana::GraphTopology::Node> lazy_nodes;
+  for (auto node : lazy.Nodes()) {
+    lazy_nodes.push_back(node);
+  }
+  KATANA_LOG_ASSERT(lazy_nodes.size() == lazy.NumNodes());
+
+  using EdgeKey = std::pair<katana::GraphTopology::Node, katana::EntityTypeID>;
+  uint64_t num_edges = 0;
+  for (auto node : topo.Nodes()) {
+    // Projected nodes are in the order of their original ids.
+    auto original = topo.GetLocalNodeID(node);
+    KATANA_LOG_ASSERT(original == lazy_nodes[node]);
+    KATANA_LOG_ASSERT(lazy.KeepsNode(original));
+    KATANA_LOG_ASSERT(
+        projected.GetTypeOfNode(node) == pg.GetTypeOfNode(original));
+
+    std::vector<EdgeKey> expected;
+    for (auto e : topo.OutEdges(node)) {
+      expected.emplace_back(
+          topo.GetLocalNodeID(topo.OutEdgeDst(e)),
+          projected.GetTypeOfEdgeFromTopoIndex(e));
+    }
+    std::vector<EdgeKey> found;
+    for (auto e : lazy.OutEdges(original)) {
+      found.emplace_back(lazy.OutEdgeDst(e), pg.GetTypeOfEdgeFromTopoIndex(e));
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    KATANA_LOG_ASSERT(expected == found);
+    num_edges += found.size();
+  }
+  KATANA_LOG_ASSERT(num_edges == topo.NumEdges());
+}
+
+/// Check that the projection of lazy is the same as its materialized graph
+void
+TestSameAsMaterialized(katana::LazyProjectedGraph* lazy) {
+  auto materialized_res = lazy->Materialize();
+  KATANA_LOG_ASSERT(materialized_res);
+  const katana::PropertyGraph* materialized = materialized_res.value();
+  TestSameProjection(*lazy, *materialized);
+
+  // Materialize is done once
+  auto again = lazy->Materialize();
+  KATANA_LOG_ASSERT(again && again.value() == materialized);
+}
+
+/// Make a graph whose nodes have the types A, B, C and the intersection type
+/// A & B in turn, and whose edges have the types x, y and x & y in turn
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+MakeTypedGraph(size_t num_nodes, size_t edges_per_node) {
+  katana::GraphTopology topo =
+      katana::CreateUniformRandomTopology(num_nodes, edges_per_node);
+
+  katana::EntityTypeManager node_type_manager;
+  std::vector<katana::EntityTypeID> node_types{
+      KATANA_CHECKED(node_type_manager.AddAtomicEntityType("A")),
+      KATANA_CHECKED(node_type_manager.AddAtomicEntityType("B")),
+      KATANA_CHECKED(node_type_manager.AddAtomicEntityType("C")),
+      KATANA_CHECKED(node_type_manager.GetOrAddNonAtomicEntityTypeFromStrings(
+          std::vector<std::string>{"A", "B"}))};
+  katana::EntityTypeManager edge_type_manager;
+  std::vector<katana::EntityTypeID> edge_types{
+      KATANA_CHECKED(edge_type_manager.AddAtomicEntityType("x")),
+      KATANA_CHECKED(edge_type_manager.AddAtomicEntityType("y")),
+      KATANA_CHECKED(edge_type_manager.GetOrAddNonAtomicEntityTypeFromStrings(
+          std::vector<std::string>{"x", "y"}))};
+
+  katana::PropertyGraph::EntityTypeIDArray node_type_ids;
+  node_type_ids.allocateInterleaved(topo.NumNodes());
+  for (size_t i = 0; i < topo.NumNodes(); ++i) {
+    node_type_ids[i] = node_types[i % node_types.size()];
+  }
+  katana::PropertyGraph::EntityTypeIDArray edge_type_ids;
+  edge_type_ids.allocateInterleaved(topo.NumEdges());
+  for (size_t i = 0; i < topo.NumEdges(); ++i) {
+    edge_type_ids[i] = edge_types[i % edge_types.size()];
+  }
+
+  return katana::PropertyGraph::Make(
+      std::move(topo), std::move(node_type_ids), std::move(edge_type_ids),
+      std::move(node_type_manager), std::move(edge_type_manager));
+}
+
+/// Check that projecting pg on types lazily keeps the same nodes and edges as
+/// PropertyGraph::MakeProjectedGraph, including the nodes and edges whose
+/// type is an intersection of one of the projected types, and return the
+/// number of projected nodes
+size_t
+TestTypeProjection(
+    katana::PropertyGraph* pg,
+    const std::optional<std::vector<std::string>>& node_types,
+    const std::optional<std::vector<std::string>>& edge_types) {
+  auto lazy_res = katana::LazyProjectedGraph::Make(pg, node_types, edge_types);
+  KATANA_LOG_ASSERT(lazy_res);
+  katana::LazyProjectedGraph lazy = std::move(lazy_res.value());
+
+  auto projected_res =
+      katana::PropertyGraph::MakeProjectedGraph(*pg, node_types, edge_types);
+  KATANA_LOG_ASSERT(projected_res);
+  TestSameProjection(lazy, *projected_res.value());
+  TestSameAsMaterialized(&lazy);
+
+  std::optional<katana::SetOfEntityTypeIDs> node_type_ids;
+  if (node_types) {
+    auto ids_res =
+        pg->GetNodeTypeManager().GetEntityTypeIDs(node_types.value());
+    KATANA_LOG_ASSERT(ids_res);
+    node_type_ids = std::move(ids_res.value());
+  }
+  for (auto node : pg->topology().Nodes()) {
+    bool has_type = !node_type_ids;
+    if (node_type_ids) {
+      for (auto type : node_type_ids.value()) {
+        has_type = has_type || pg->DoesNodeHaveType(node, type);
+      }
+    }
+    KATANA_LOG_ASSERT(lazy.KeepsNode(node) == has_type);
+  }
+
+  return lazy.NumNodes();
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  constexpr size_t kNumNodes = 1000;
+  constexpr size_t kEdgesPerNode = 5;
+
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  auto all_res = katana::LazyProjectedGraph::Make(
+      pg.get(), std::optional<katana::SetOfEntityTypeIDs>(),
+      std::optional<katana::SetOfEntityTypeIDs>());
+  KATANA_LOG_ASSERT(all_res);
+  KATANA_LOG_ASSERT(all_res.value().NumNodes() == kNumNodes);
+  KATANA_LOG_ASSERT(!all_res.value().ShouldMaterialize());
+  TestSameAsMaterialized(&all_res.value());
+
+  for (size_t stride : {2, 3, 20}) {
+    katana::DynamicBitset filter;
+    filter.resize(kNumNodes);
+    for (size_t i = 0; i < kNumNodes; i += stride) {
+      filter.set(i);
+    }
+
+    auto lazy_res =
+        katana::LazyProjectedGraph::Make(pg.get(), std::move(filter));
+    KATANA_LOG_ASSERT(lazy_res);
+    katana::LazyProjectedGraph lazy = std::move(lazy_res.value());
+    KATANA_LOG_ASSERT(lazy.NumNodes() == (kNumNodes + stride - 1) / stride);
+    KATANA_LOG_ASSERT(lazy.ShouldMaterialize() == (stride > 10));
+    TestSameAsMaterialized(&lazy);
+  }
+
+  auto typed_res = MakeTypedGraph(kNumNodes, kEdgesPerNode);
+  KATANA_LOG_ASSERT(typed_res);
+  std::unique_ptr<katana::PropertyGraph> typed = std::move(typed_res.value());
+  using Types = std::optional<std::vector<std::string>>;
+  // Nodes of type A & B are projected on A and on B
+  KATANA_LOG_ASSERT(
+      TestTypeProjection(typed.get(), Types({"A"}), std::nullopt) ==
+      kNumNodes / 2);
+  KATANA_LOG_ASSERT(
+      TestTypeProjection(typed.get(), Types({"B", "C"}), Types({"x"})) ==
+      kNumNodes * 3 / 4);
+  KATANA_LOG_ASSERT(
+      TestTypeProjection(typed.get(), std::nullopt, Types({"y"})) ==
+      kNumNodes);
+  TestTypeProjection(typed.get(), Types({"C"}), Types({"x", "y"}));
+
+  katana::DynamicBitset wrong_size;
+  wrong_size.resize(kNumNodes + 1);
+  KATANA_LOG_ASSERT(
+      !katana::LazyProjectedGraph::Make(pg.get(), std::move(wrong_size)));
+
+  return 0;
+}
@@ -1,8 +1,13 @@
+#include <random>
+#include <vector>
+
 #include <benchmark/benchmark.h>
 
 #include "TestTypedPropertyGraph.h"
+#include "katana/GraphTopology.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
+#include "katana/Random.h"
 #include "katana/SharedMemSys.h"
 #include "katana/TypedPropertyGraph.h"
 
@@ -133,8 +138,88 @@ IterateBaseline(benchmark::State& state) {
   }
 }
 
+/// MakeRmatGraph makes a graph with 2^scale nodes and edge_factor * 2^scale
+/// edges drawn with the Graph500 RMAT probabilities, so that degrees are
+/// skewed and the lowest nodes are hubs.
+std::unique_ptr<katana::PropertyGraph>
+MakeRmatGraph(size_t scale, size_t edge_factor) {
+  const size_t num_nodes = size_t{1} << scale;
+  const size_t num_edges = num_nodes * edge_factor;
+
+  auto& gen = katana::GetGenerator();
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  std::vector<std::pair<uint32_t, uint32_t>> edges(num_edges);
+  for (auto& [src, dst] : edges) {
+    src = 0;
+    dst = 0;
+    for (size_t bit = 0; bit < scale; ++bit) {
+      double r = dist(gen);
+      // a = 0.57, b = 0.19, c = 0.19, d = 0.05
+      if (r >= 0.57 && r < 0.76) {
+        dst |= 1U << bit;
+      } else if (r >= 0.76 && r < 0.95) {
+        src |= 1U << bit;
+      } else if (r >= 0.95) {
+        src |= 1U << bit;
+        dst |= 1U << bit;
+      }
+    }
+  }
+
+  std::vector<uint64_t> indices(num_nodes);
+  for (const auto& edge : edges) {
+    ++indices[edge.first];
+  }
+  for (size_t i = 1; i < num_nodes; ++i) {
+    indices[i] += indices[i - 1];
+  }
+  std::vector<uint32_t> dests(num_edges);
+  std::vector<uint64_t> next(indices.size());
+  for (size_t i = 1; i < num_nodes; ++i) {
+    next[i] = indices[i - 1];
+  }
+  for (const auto& edge : edges) {
+    dests[next[edge.first]++] = edge.second;
+  }
+
+  katana::GraphTopology topo{
+      indices.data(), indices.size(), dests.data(), dests.size()};
+
+  auto g_res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(g_res);
+  return std::move(g_res.value());
+}
+
+void
+MakeSortArguments(benchmark::internal::Benchmark* b) {
+  for (long scale : {16, 20}) {
+    for (auto sort_kind :
+         {katana::RDGTopology::EdgeSortKind::kSortedByDestID,
+          katana::RDGTopology::EdgeSortKind::kSortedByEdgeType}) {
+      b->Args({scale, static_cast<long>(sort_kind)});
+    }
+  }
+}
+
+void
+SortEdges(benchmark::State& state) {
+  auto scale = state.range(0);
+  auto sort_kind = static_cast<katana::RDGTopology::EdgeSortKind>(
+      state.range(1));
+
+  std::unique_ptr<katana::PropertyGraph> g = MakeRmatGraph(scale, 16);
+
+  for (auto _ : state) {
+    auto topo = katana::EdgeShuffleTopology::Make(
+        g.get(), katana::RDGTopology::TransposeKind::kNo, sort_kind);
+    benchmark::DoNotOptimize(topo);
+  }
+  state.SetItemsProcessed(state.iterations() * g->NumEdges());
+}
+
 BENCHMARK(IterateBaseline)->Apply(MakeArguments);
 BENCHMARK(IterateProperty)->Apply(MakeArguments);
+BENCHMARK(SortEdges)->Apply(MakeSortArguments)->Unit(benchmark::kMillisecond);
 
 }  // namespace
 
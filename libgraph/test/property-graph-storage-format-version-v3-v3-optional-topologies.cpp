@@ -33,5 +33,17 @@ main(int argc, char** argv) {
   TestOptionalTopologyStorageEdgeShuffleTopology(ldbc_003InputFile);
   TestOptionalTopologyStorageShuffleTopology(ldbc_003InputFile);
   TestOptionalTopologyStorageEdgeTypeAwareTopology(ldbc_003InputFile);
+  TestOptionalTopologyStorageNodeOrder<
+      katana::PropertyGraphViews::NodesSortedByRCMEdgesSortedByDestID>(
+      ldbc_003InputFile);
+  TestOptionalTopologyStorageNodeOrder<
+      katana::PropertyGraphViews::NodesSortedByCommunityEdgesSortedByDestID>(
+      ldbc_003InputFile);
+  TestOptionalTopologyStorageNodeOrder<
+      katana::PropertyGraphViews::NodesHubSortedEdgesSortedByDestID>(
+      ldbc_003InputFile);
+  TestOptionalTopologyStorageNodeOrder<
+      katana::PropertyGraphViews::NodesHubClusteredEdgesSortedByDestID>(
+      ldbc_003InputFile);
   return 0;
 }
@@ -1,3 +1,12 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "katana/Galois.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
@@ -12,6 +21,328 @@ TestEdgeSource(const katana::GraphTopology& topo) noexcept {
   }
 }
 
+void
+TestOwnerComputesNodes(const katana::GraphTopology& topo) noexcept {
+  std::vector<uint32_t> ranges = topo.OwnerThreadRanges();
+  KATANA_LOG_ASSERT(ranges.size() == katana::getActiveThreads() + 1);
+  KATANA_LOG_ASSERT(ranges.front() == 0);
+  KATANA_LOG_ASSERT(ranges.back() == topo.NumNodes());
+  KATANA_LOG_ASSERT(std::is_sorted(ranges.begin(), ranges.end()));
+
+  std::vector<std::atomic<int>> visits(topo.NumNodes());
+  katana::do_all(topo.OwnerComputesNodes(), [&](auto n) { visits[n] += 1; });
+  katana::do_all(
+      topo.OwnerComputesNodes(), [&](auto n) { visits[n] += 1; },
+      katana::steal(), katana::chunk_size<8>());
+  for (const auto& v : visits) {
+    KATANA_LOG_ASSERT(v == 2);
+  }
+}
+
+void
+TestNUMAPartition(const katana::GraphTopology& original) noexcept {
+  KATANA_LOG_ASSERT(!original.IsNUMAPartitioned());
+  TestOwnerComputesNodes(original);
+
+  katana::GraphTopology topo(
+      original, katana::GraphTopology::NUMAPartitionedCopy{});
+  KATANA_LOG_ASSERT(topo.IsNUMAPartitioned());
+  KATANA_LOG_ASSERT(!original.IsNUMAPartitioned());
+  KATANA_LOG_ASSERT(topo.Equals(original));
+  TestOwnerComputesNodes(topo);
+
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::GraphTopology::Copy(original));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  auto before = pg->BuildView<katana::PropertyGraphViews::Transposed>();
+  KATANA_LOG_ASSERT(!before.IsNUMAPartitioned());
+
+  pg->PartitionTopologyAcrossNUMANodes();
+  KATANA_LOG_ASSERT(pg->topology().IsNUMAPartitioned());
+  // Views built earlier keep the topology they were built with
+  KATANA_LOG_ASSERT(!before.IsNUMAPartitioned());
+  KATANA_LOG_ASSERT(before.NumEdges() == original.NumEdges());
+
+  // and views built later share the partitioned copy
+  auto transposed = pg->BuildView<katana::PropertyGraphViews::Transposed>();
+  KATANA_LOG_ASSERT(transposed.IsNUMAPartitioned());
+  KATANA_LOG_ASSERT(transposed.NumEdges() == original.NumEdges());
+  for (auto node : transposed.Nodes()) {
+    KATANA_LOG_ASSERT(
+        transposed.OutDegree(node) == before.OutDegree(node));
+  }
+
+  // Topologies that views build from a partitioned graph are partitioned too
+  auto sorted =
+      pg->BuildView<katana::PropertyGraphViews::EdgesSortedByDestID>();
+  KATANA_LOG_ASSERT(sorted.IsNUMAPartitioned());
+}
+
+template <typename EdgeIndex>
+void
+TestCSRTopology(const katana::GraphTopology& original) noexcept {
+  auto shared = std::make_shared<const katana::GraphTopology>(
+      katana::GraphTopology::Copy(original));
+  auto topo = katana::CSRTopology<EdgeIndex>::Make(shared);
+  KATANA_LOG_ASSERT(topo.NumNodes() == original.NumNodes());
+  KATANA_LOG_ASSERT(topo.NumEdges() == original.NumEdges());
+  for (auto node : original.Nodes()) {
+    auto edges = original.OutEdges(node);
+    auto narrow_edges = topo.OutEdges(node);
+    KATANA_LOG_ASSERT(*narrow_edges.begin() == *edges.begin());
+    KATANA_LOG_ASSERT(*narrow_edges.end() == *edges.end());
+    for (auto e : edges) {
+      KATANA_LOG_ASSERT(topo.OutEdgeDst(e) == original.OutEdgeDst(e));
+      KATANA_LOG_ASSERT(topo.GetEdgeSrc(e) == node);
+    }
+  }
+
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::GraphTopology::Copy(original));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  auto transposed = pg->BuildView<katana::PropertyGraphViews::Transposed>();
+  auto narrow_transposed =
+      pg->BuildView<katana::PropertyGraphViews::WithEdgeIndex<
+          katana::PropertyGraphViews::Transposed, EdgeIndex>>();
+  KATANA_LOG_ASSERT(narrow_transposed.NumEdges() == transposed.NumEdges());
+  for (auto node : transposed.Nodes()) {
+    KATANA_LOG_ASSERT(
+        narrow_transposed.OutDegree(node) == transposed.OutDegree(node));
+    for (auto e : transposed.OutEdges(node)) {
+      KATANA_LOG_ASSERT(
+          narrow_transposed.OutEdgeDst(e) == transposed.OutEdgeDst(e));
+    }
+  }
+
+  if constexpr (std::is_same_v<EdgeIndex, uint32_t>) {
+    // The narrowed index is cached with the topology it narrows
+    auto again = pg->BuildView<katana::PropertyGraphViews::WithEdgeIndex<
+        katana::PropertyGraphViews::Transposed, EdgeIndex>>();
+    KATANA_LOG_ASSERT(again.AdjData() == narrow_transposed.AdjData());
+
+    // and rebuilt when that topology is replaced
+    pg->PartitionTopologyAcrossNUMANodes();
+    auto rebuilt = pg->BuildView<katana::PropertyGraphViews::WithEdgeIndex<
+        katana::PropertyGraphViews::Transposed, EdgeIndex>>();
+    KATANA_LOG_ASSERT(rebuilt.AdjData() != narrow_transposed.AdjData());
+    KATANA_LOG_ASSERT(rebuilt.NumEdges() == transposed.NumEdges());
+  }
+}
+
+/// Check that View relabels the nodes of original and that GetLocalNodeID()
+/// maps them back
+template <typename View>
+void
+TestNodeReordering(const katana::GraphTopology& original) noexcept {
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::GraphTopology::Copy(original));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  auto view = pg->BuildView<View>();
+  KATANA_LOG_ASSERT(view.NumNodes() == original.NumNodes());
+  KATANA_LOG_ASSERT(view.NumEdges() == original.NumEdges());
+
+  std::vector<int> seen(original.NumNodes());
+  for (auto node : view.Nodes()) {
+    auto old_node = view.GetLocalNodeID(node);
+    seen[old_node] += 1;
+
+    std::vector<katana::GraphTopology::Node> expected;
+    for (auto e : original.OutEdges(old_node)) {
+      expected.push_back(original.OutEdgeDst(e));
+    }
+    std::vector<katana::GraphTopology::Node> found;
+    for (auto e : view.OutEdges(node)) {
+      found.push_back(view.GetLocalNodeID(view.OutEdgeDst(e)));
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    KATANA_LOG_ASSERT(expected == found);
+  }
+  KATANA_LOG_ASSERT(
+      std::all_of(seen.begin(), seen.end(), [](int s) { return s == 1; }));
+}
+
+using Node = katana::GraphTopology::Node;
+
+/// Make a topology of \p edges whose node ids are shuffled, so that the
+/// structure of the graph does not show in its ids. \p relabel gets the new id
+/// of each node.
+katana::GraphTopology
+MakeRelabeledTopology(
+    size_t num_nodes, const std::vector<std::pair<Node, Node>>& edges,
+    std::vector<Node>* relabel) noexcept {
+  relabel->resize(num_nodes);
+  std::iota(relabel->begin(), relabel->end(), Node{0});
+  std::mt19937 gen(0);
+  std::shuffle(relabel->begin(), relabel->end(), gen);
+
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(num_nodes);
+  for (const auto& [src, dst] : edges) {
+    builder.AddEdge((*relabel)[src], (*relabel)[dst]);
+  }
+  return builder.ConvertToCSR();
+}
+
+/// Largest difference between the ids of the ends of an edge of \p graph
+template <typename Graph>
+uint64_t
+Bandwidth(const Graph& graph) noexcept {
+  uint64_t bandwidth = 0;
+  for (auto node : graph.Nodes()) {
+    for (auto e : graph.OutEdges(node)) {
+      auto dst = graph.OutEdgeDst(e);
+      bandwidth = std::max<uint64_t>(
+          bandwidth, node > dst ? node - dst : dst - node);
+    }
+  }
+  return bandwidth;
+}
+
+/// Check that RCM order narrows the band of a grid whose edges only point
+/// right and down, which it only does if it follows in-edges too, and that it
+/// puts isolated nodes last
+void
+TestRCMBandwidth() noexcept {
+  constexpr Node kWidth = 20;
+  constexpr Node kHeight = 20;
+  constexpr Node kNumIsolated = 7;
+  constexpr Node kNumGridNodes = kWidth * kHeight;
+
+  std::vector<std::pair<Node, Node>> edges;
+  for (Node y = 0; y < kHeight; ++y) {
+    for (Node x = 0; x < kWidth; ++x) {
+      Node n = y * kWidth + x;
+      if (x + 1 < kWidth) {
+        edges.emplace_back(n, n + 1);
+      }
+      if (y + 1 < kHeight) {
+        edges.emplace_back(n, n + kWidth);
+      }
+    }
+  }
+  std::vector<Node> relabel;
+  katana::GraphTopology original =
+      MakeRelabeledTopology(kNumGridNodes + kNumIsolated, edges, &relabel);
+
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::GraphTopology::Copy(original));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  auto view = pg->BuildView<
+      katana::PropertyGraphViews::NodesSortedByRCMEdgesSortedByDestID>();
+
+  uint64_t original_bandwidth = Bandwidth(original);
+  uint64_t rcm_bandwidth = Bandwidth(view);
+  KATANA_LOG_VASSERT(
+      rcm_bandwidth <= 2 * kWidth && rcm_bandwidth < original_bandwidth,
+      "RCM bandwidth {} original bandwidth {}", rcm_bandwidth,
+      original_bandwidth);
+
+  std::vector<Node> isolated(relabel.begin() + kNumGridNodes, relabel.end());
+  std::sort(isolated.begin(), isolated.end());
+  for (Node node = kNumGridNodes; node < view.NumNodes(); ++node) {
+    KATANA_LOG_ASSERT(std::binary_search(
+        isolated.begin(), isolated.end(), view.GetLocalNodeID(node)));
+  }
+}
+
+/// Check that community order gives the nodes of each of a few disjoint
+/// cliques consecutive ids
+void
+TestCommunityContiguous() noexcept {
+  constexpr Node kNumCliques = 8;
+  constexpr Node kCliqueSize = 10;
+
+  std::vector<std::pair<Node, Node>> edges;
+  for (Node c = 0; c < kNumCliques; ++c) {
+    for (Node i = 0; i < kCliqueSize; ++i) {
+      for (Node j = 0; j < kCliqueSize; ++j) {
+        if (i != j) {
+          edges.emplace_back(c * kCliqueSize + i, c * kCliqueSize + j);
+        }
+      }
+    }
+  }
+  std::vector<Node> relabel;
+  katana::GraphTopology original =
+      MakeRelabeledTopology(kNumCliques * kCliqueSize, edges, &relabel);
+  std::vector<Node> clique_of(original.NumNodes());
+  for (Node n = 0; n < relabel.size(); ++n) {
+    clique_of[relabel[n]] = n / kCliqueSize;
+  }
+
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::GraphTopology::Copy(original));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  auto view = pg->BuildView<
+      katana::PropertyGraphViews::NodesSortedByCommunityEdgesSortedByDestID>();
+
+  std::vector<int> placed(kNumCliques);
+  Node prev_clique = clique_of[view.GetLocalNodeID(0)];
+  placed[prev_clique] = 1;
+  for (auto node : view.Nodes()) {
+    Node clique = clique_of[view.GetLocalNodeID(node)];
+    if (clique != prev_clique) {
+      KATANA_LOG_VASSERT(!placed[clique], "clique {} is split", clique);
+      placed[clique] = 1;
+      prev_clique = clique;
+    }
+  }
+}
+
+/// Check that View puts the hubs of a graph with a few high degree nodes
+/// first, by descending degree if \p by_degree and by id otherwise, followed
+/// by the other nodes by id
+template <typename View>
+void
+TestHubsFirst(bool by_degree) noexcept {
+  constexpr Node kNumNodes = 100;
+  constexpr Node kNumHubs = 5;
+
+  // Hub h has 20 + 10 * h out-edges, the other nodes form a cycle
+  std::vector<std::pair<Node, Node>> edges;
+  for (Node h = 0; h < kNumHubs; ++h) {
+    for (Node k = 0; k < 20 + 10 * h; ++k) {
+      edges.emplace_back(h, kNumHubs + k);
+    }
+  }
+  for (Node n = kNumHubs; n < kNumNodes; ++n) {
+    edges.emplace_back(n, n + 1 < kNumNodes ? n + 1 : kNumHubs);
+  }
+  std::vector<Node> relabel;
+  katana::GraphTopology original =
+      MakeRelabeledTopology(kNumNodes, edges, &relabel);
+
+  auto pg_res =
+      katana::PropertyGraph::Make(katana::GraphTopology::Copy(original));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  auto view = pg->BuildView<View>();
+
+  std::vector<Node> old_ids;
+  for (auto node : view.Nodes()) {
+    old_ids.push_back(view.GetLocalNodeID(node));
+  }
+  auto degree = [&](Node n) { return original.OutDegree(n); };
+  for (Node i = 0; i < kNumHubs; ++i) {
+    KATANA_LOG_ASSERT(degree(old_ids[i]) >= 20);
+  }
+  if (by_degree) {
+    KATANA_LOG_ASSERT(std::is_sorted(
+        old_ids.begin(), old_ids.begin() + kNumHubs,
+        [&](Node a, Node b) { return degree(a) > degree(b); }));
+  } else {
+    KATANA_LOG_ASSERT(
+        std::is_sorted(old_ids.begin(), old_ids.begin() + kNumHubs));
+  }
+  KATANA_LOG_ASSERT(std::is_sorted(old_ids.begin() + kNumHubs, old_ids.end()));
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -23,6 +354,29 @@ main() {
       katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode);
 
   TestEdgeSource(topo);
+  TestCSRTopology<uint32_t>(topo);
+  TestCSRTopology<uint64_t>(topo);
+
+  TestNodeReordering<
+      katana::PropertyGraphViews::NodesSortedByRCMEdgesSortedByDestID>(topo);
+  TestNodeReordering<
+      katana::PropertyGraphViews::NodesSortedByCommunityEdgesSortedByDestID>(
+      topo);
+  TestNodeReordering<
+      katana::PropertyGraphViews::NodesHubSortedEdgesSortedByDestID>(topo);
+  TestNodeReordering<
+      katana::PropertyGraphViews::NodesHubClusteredEdgesSortedByDestID>(topo);
+  TestRCMBandwidth();
+  TestCommunityContiguous();
+  TestHubsFirst<katana::PropertyGraphViews::NodesHubSortedEdgesSortedByDestID>(
+      true);
+  TestHubsFirst<
+      katana::PropertyGraphViews::NodesHubClusteredEdgesSortedByDestID>(false);
+
+  for (unsigned threads : {1U, 4U}) {
+    katana::setActiveThreads(threads);
+    TestNUMAPartition(topo);
+  }
 
   return 0;
 }
@@ -1,11 +1,15 @@
 #include <arrow/api.h>
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
+#include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
 #include "katana/Logging.h"
 #include "katana/Properties.h"
 #include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
 
 using DataType = int64_t;
 
@@ -135,6 +139,42 @@ TestError1(size_t num_nodes, size_t line_width) {
       "Should return PropertyNotFound when node property doesn't exist.");
 }
 
+/// Test loading a stored graph with its local files mapped in place
+void
+TestMappedLoad(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, &policy, &txn_ctx);
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertygraphmapped");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_result = g->Write(rdg_dir, "", &txn_ctx);
+  KATANA_LOG_VASSERT(
+      write_result, "Could not write graph: {}", write_result.error());
+
+  for (auto map_policy : {katana::FileView::MapPolicy::kLazy,
+                          katana::FileView::MapPolicy::kWillNeed,
+                          katana::FileView::MapPolicy::kPopulate}) {
+    katana::RDGLoadOptions opts;
+    opts.map_local_files = map_policy;
+    auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+    KATANA_LOG_VASSERT(
+        make_result, "Could not load graph: {}", make_result.error());
+    std::unique_ptr<katana::PropertyGraph> loaded =
+        std::move(make_result.value());
+
+    KATANA_LOG_ASSERT(loaded->topology().Equals(g->topology()));
+    KATANA_LOG_ASSERT(loaded->GetNumNodeProperties() == 1);
+    KATANA_LOG_ASSERT(loaded->GetNumEdgeProperties() == 1);
+  }
+
+  fs::remove_all(rdg_dir);
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -143,6 +183,7 @@ main() {
   TestIterate3(10, 3);
   TestIterate4(10, 3);
   TestError1(10, 3);
+  TestMappedLoad(10, 3);
 
   return 0;
 }
@@ -1,6 +1,7 @@
 #include <arrow/api.h>
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
+#include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
 #include "katana/EntityIndex.h"
@@ -8,13 +9,19 @@
 #include "katana/Properties.h"
 #include "katana/SharedMemSys.h"
 
+namespace fs = boost::filesystem;
+
 template <typename node_or_edge>
 struct NodeOrEdge {
   static katana::Result<katana::EntityIndex<node_or_edge>*> MakeIndex(
-      katana::PropertyGraph* pg, const std::string& property_name);
+      katana::PropertyGraph* pg, const std::string& property_name,
+      katana::EntityIndexKind kind = katana::kOrderedIndex);
   static katana::Result<void> AddProperties(
       katana::PropertyGraph* pg, std::shared_ptr<arrow::Table> properties,
       katana::TxnContext* txn_ctx);
+  static katana::Result<void> UpsertProperties(
+      katana::PropertyGraph* pg, std::shared_ptr<arrow::Table> properties,
+      katana::TxnContext* txn_ctx);
   static size_t num_entities(katana::PropertyGraph* pg);
 };
 
@@ -23,8 +30,10 @@ using Edge = NodeOrEdge<katana::GraphTopology::Edge>;
 
 template <>
 katana::Result<katana::EntityIndex<katana::GraphTopology::Node>*>
-Node::MakeIndex(katana::PropertyGraph* pg, const std::string& property_name) {
-  auto result = pg->MakeNodeIndex(property_name);
+Node::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    katana::EntityIndexKind kind) {
+  auto result = pg->MakeNodeIndex(property_name, kind);
   if (!result) {
     return result.error();
   }
@@ -40,8 +49,10 @@ Node::MakeIndex(katana::PropertyGraph* pg, const std::string& property_name) {
 
 template <>
 katana::Result<katana::EntityIndex<katana::GraphTopology::Edge>*>
-Edge::MakeIndex(katana::PropertyGraph* pg, const std::string& property_name) {
-  auto result = pg->MakeEdgeIndex(property_name);
+Edge::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    katana::EntityIndexKind kind) {
+  auto result = pg->MakeEdgeIndex(property_name, kind);
   if (!result) {
     return result.error();
   }
@@ -83,6 +94,22 @@ Edge::AddProperties(
   return pg->AddEdgeProperties(properties, txn_ctx);
 }
 
+template <>
+katana::Result<void>
+Node::UpsertProperties(
+    katana::PropertyGraph* pg, std::shared_ptr<arrow::Table> properties,
+    katana::TxnContext* txn_ctx) {
+  return pg->UpsertNodeProperties(properties, txn_ctx);
+}
+
+template <>
+katana::Result<void>
+Edge::UpsertProperties(
+    katana::PropertyGraph* pg, std::shared_ptr<arrow::Table> properties,
+    katana::TxnContext* txn_ctx) {
+  return pg->UpsertEdgeProperties(properties, txn_ctx);
+}
+
 template <typename c_type>
 std::shared_ptr<arrow::Table>
 CreatePrimitiveProperty(
@@ -203,6 +230,17 @@ TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
   it = nonuniform_index->UpperBound(44);
   KATANA_LOG_ASSERT(it != nonuniform_index->end());
   KATANA_LOG_ASSERT(typed_prop->Value(*it) == 46);
+
+  // Entity i has the value 42 + 2 * i.
+  katana::DynamicBitset batch = nonuniform_index->FindBatch({48, 43, 44, 48});
+  KATANA_LOG_ASSERT(batch.size() == num_entities);
+  KATANA_LOG_ASSERT(batch.count() == 2);
+  KATANA_LOG_ASSERT(batch.test(1) && batch.test(3));
+
+  katana::DynamicBitset range = nonuniform_index->RangeScan(43, 48);
+  KATANA_LOG_ASSERT(range.count() == 3);
+  KATANA_LOG_ASSERT(range.test(1) && range.test(2) && range.test(3));
+  KATANA_LOG_ASSERT(nonuniform_index->RangeScan(48, 44).count() == 0);
 }
 
 template <typename node_or_edge>
@@ -271,6 +309,206 @@ TestStringIndex(size_t num_nodes, size_t line_width) {
   it = nonuniform_index->UpperBound("aaak");
   KATANA_LOG_ASSERT(it != nonuniform_index->end());
   KATANA_LOG_ASSERT(typed_prop->GetView(*it) == "aaam");
+
+  katana::DynamicBitset batch =
+      nonuniform_index->FindBatch({"aaae", "aaaj", "aaac"});
+  KATANA_LOG_ASSERT(batch.count() == 2);
+  KATANA_LOG_ASSERT(batch.test(1) && batch.test(2));
+
+  katana::DynamicBitset range = nonuniform_index->RangeScan("aaab", "aaae");
+  KATANA_LOG_ASSERT(range.count() == 2);
+  KATANA_LOG_ASSERT(range.test(1) && range.test(2));
+
+  // Every value starts with "aaa"; only "aaac" starts with "aaac".
+  auto [prefix_begin, prefix_end] = nonuniform_index->PrefixRange("aaa");
+  KATANA_LOG_ASSERT(
+      static_cast<size_t>(std::distance(prefix_begin, prefix_end)) ==
+      std::min<size_t>(num_entities, 13));
+  std::tie(prefix_begin, prefix_end) = nonuniform_index->PrefixRange("aaac");
+  KATANA_LOG_ASSERT(std::distance(prefix_begin, prefix_end) == 1);
+  KATANA_LOG_ASSERT(*prefix_begin == 1);
+  KATANA_LOG_ASSERT(nonuniform_index->PrefixScan("aab").count() == 0);
+}
+
+template <typename node_or_edge>
+void
+TestHashStringIndex(size_t num_nodes, size_t line_width) {
+  using IndexType = katana::HashStringEntityIndex<node_or_edge>;
+
+  LinePolicy policy{line_width};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int>(num_nodes, 0, &policy, &txn_ctx);
+  size_t num_entities = NodeOrEdge<node_or_edge>::num_entities(g.get());
+
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(), CreateStringProperty("uniform", true, num_entities), &txn_ctx));
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(), CreateStringProperty("nonuniform", false, num_entities),
+      &txn_ctx));
+
+  auto uniform_index_result = NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "uniform", katana::kHashIndex);
+  KATANA_LOG_VASSERT(
+      uniform_index_result, "Could not create index: {}",
+      uniform_index_result.error());
+  auto nonuniform_index_result = NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "nonuniform", katana::kHashIndex);
+  KATANA_LOG_VASSERT(
+      nonuniform_index_result, "Could not create index: {}",
+      nonuniform_index_result.error());
+
+  auto* uniform_index =
+      dynamic_cast<IndexType*>(uniform_index_result.value());
+  auto* nonuniform_index =
+      dynamic_cast<IndexType*>(nonuniform_index_result.value());
+  KATANA_LOG_ASSERT(uniform_index != nullptr && nonuniform_index != nullptr);
+
+  // Every entity has the value "aaaa".
+  KATANA_LOG_ASSERT(uniform_index->num_codes() == 1);
+  KATANA_LOG_ASSERT(uniform_index->Find("aaaq") == uniform_index->end());
+  auto [begin, end] = uniform_index->EqualRange("aaaa");
+  KATANA_LOG_ASSERT(
+      static_cast<size_t>(std::distance(begin, end)) == num_entities);
+
+  // Entity i has the i-th value of "aaaa", "aaac", "aaae", ...
+  KATANA_LOG_ASSERT(nonuniform_index->Find("aaaj") == nonuniform_index->end());
+  auto it = nonuniform_index->Find("aaae");
+  KATANA_LOG_ASSERT(it != nonuniform_index->end());
+  KATANA_LOG_ASSERT(*it == 2);
+  std::tie(begin, end) = nonuniform_index->EqualRange("aaae");
+  KATANA_LOG_ASSERT(std::distance(begin, end) == 1);
+
+  katana::DynamicBitset batch =
+      nonuniform_index->FindBatch({"aaae", "aaaj", "aaac"});
+  KATANA_LOG_ASSERT(batch.count() == 2);
+  KATANA_LOG_ASSERT(batch.test(1) && batch.test(2));
+
+  // Hash indexes are only available for strings.
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(), CreatePrimitiveProperty<int64_t>("number", false, num_entities),
+      &txn_ctx));
+  KATANA_LOG_ASSERT(!NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "number", katana::kHashIndex));
+}
+
+// The result of an index query can be used to project the graph.
+void
+TestProjectFromIndex(size_t num_nodes, size_t line_width) {
+  using IndexType =
+      katana::PrimitiveEntityIndex<katana::GraphTopology::Node, int64_t>;
+
+  LinePolicy policy{line_width};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+
+  KATANA_LOG_ASSERT(Node::AddProperties(
+      g.get(), CreatePrimitiveProperty<int64_t>("prop", false, num_nodes),
+      &txn_ctx));
+  auto index_result = Node::MakeIndex(g.get(), "prop");
+  KATANA_LOG_VASSERT(
+      index_result, "Could not create index: {}", index_result.error());
+  auto* index = static_cast<IndexType*>(index_result.value());
+
+  auto projected_result =
+      katana::PropertyGraph::MakeProjectedGraph(*g, index->RangeScan(44, 48));
+  KATANA_LOG_VASSERT(
+      projected_result, "Could not project graph: {}",
+      projected_result.error());
+  std::unique_ptr<katana::PropertyGraph> projected =
+      std::move(projected_result.value());
+  KATANA_LOG_ASSERT(projected->NumNodes() == 3);
+  for (auto n : projected->topology().Nodes()) {
+    auto original = projected->topology().GetLocalNodeID(n);
+    KATANA_LOG_ASSERT(original >= 1 && original <= 3);
+  }
+}
+
+// Indexes written with a graph are loaded instead of rebuilt, and are dropped
+// when the indexed property changes.
+template <typename node_or_edge>
+void
+TestStoredIndex(size_t num_nodes, size_t line_width) {
+  using IndexType = katana::PrimitiveEntityIndex<node_or_edge, int64_t>;
+
+  LinePolicy policy{line_width};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+  size_t num_entities = NodeOrEdge<node_or_edge>::num_entities(g.get());
+
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(), CreatePrimitiveProperty<int64_t>("prop", false, num_entities),
+      &txn_ctx));
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "prop"));
+
+  auto uri_res = katana::URI::MakeRand("/tmp/propertyindex");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_result = g->Write(rdg_dir, "", &txn_ctx);
+  KATANA_LOG_VASSERT(
+      write_result, "Could not write graph: {}", write_result.error());
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(
+      make_result, "Could not load graph: {}", make_result.error());
+  std::unique_ptr<katana::PropertyGraph> loaded = std::move(make_result.value());
+
+  auto index_result = NodeOrEdge<node_or_edge>::MakeIndex(loaded.get(), "prop");
+  KATANA_LOG_VASSERT(
+      index_result, "Could not load index: {}", index_result.error());
+  auto* index = static_cast<IndexType*>(index_result.value());
+  KATANA_LOG_ASSERT(index->loaded_from_storage());
+
+  KATANA_LOG_ASSERT(
+      static_cast<size_t>(std::distance(index->begin(), index->end())) ==
+      num_entities);
+  auto it = index->LowerBound(43);
+  KATANA_LOG_ASSERT(it != index->end());
+  KATANA_LOG_ASSERT(*it == 1);
+  KATANA_LOG_ASSERT(index->Find(43) == index->end());
+
+  // Upserting the property drops the index, so it can be made again and
+  // reflects the new values.
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::UpsertProperties(
+      loaded.get(),
+      CreatePrimitiveProperty<int64_t>("prop", true, num_entities), &txn_ctx));
+  index_result = NodeOrEdge<node_or_edge>::MakeIndex(loaded.get(), "prop");
+  KATANA_LOG_VASSERT(
+      index_result, "Could not rebuild index: {}", index_result.error());
+  index = static_cast<IndexType*>(index_result.value());
+  KATANA_LOG_ASSERT(!index->loaded_from_storage());
+  KATANA_LOG_ASSERT(index->LowerBound(43) == index->end());
+
+  // The rebuilt index is written in place of the stored one
+  uri_res = katana::URI::MakeRand("/tmp/propertyindex");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rewritten_dir(uri_res.value().path());
+  write_result = loaded->Write(rewritten_dir, "", &txn_ctx);
+  KATANA_LOG_VASSERT(
+      write_result, "Could not write graph: {}", write_result.error());
+  make_result = katana::PropertyGraph::Make(
+      rewritten_dir, &txn_ctx, katana::RDGLoadOptions());
+  KATANA_LOG_VASSERT(
+      make_result, "Could not load graph: {}", make_result.error());
+  loaded = std::move(make_result.value());
+  index_result = NodeOrEdge<node_or_edge>::MakeIndex(loaded.get(), "prop");
+  KATANA_LOG_VASSERT(
+      index_result, "Could not load index: {}", index_result.error());
+  index = static_cast<IndexType*>(index_result.value());
+  KATANA_LOG_ASSERT(index->loaded_from_storage());
+  KATANA_LOG_ASSERT(index->LowerBound(43) == index->end());
+
+  fs::remove_all(rdg_dir);
+  fs::remove_all(rewritten_dir);
 }
 
 int
@@ -285,5 +523,13 @@ main() {
   TestStringIndex<katana::GraphTopology::Node>(10, 3);
   TestStringIndex<katana::GraphTopology::Edge>(10, 3);
 
+  TestHashStringIndex<katana::GraphTopology::Node>(10, 3);
+  TestHashStringIndex<katana::GraphTopology::Edge>(10, 3);
+
+  TestStoredIndex<katana::GraphTopology::Node>(10, 3);
+  TestStoredIndex<katana::GraphTopology::Edge>(10, 3);
+
+  TestProjectFromIndex(10, 3);
+
   return 0;
 }
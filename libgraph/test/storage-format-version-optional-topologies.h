@@ -102,4 +102,28 @@ TestOptionalTopologyStorageEdgeTypeAwareTopology(std::string inputFile) {
   verify_view(generated_sorted_view, loaded_sorted_view);
 }
 
+/// Check that a ShuffleTopology with node order View, e.g., RCM or community
+/// order, is stored and loaded with its node relabeling
+template <typename View>
+void
+TestOptionalTopologyStorageNodeOrder(std::string inputFile) {
+  katana::PropertyGraph pg = LoadGraph(inputFile);
+  View generated_view = pg.BuildView<View>();
+
+  std::string g2_rdg_file = StoreGraph(&pg);
+  katana::PropertyGraph pg2 = LoadGraph(g2_rdg_file);
+  View loaded_view = pg2.BuildView<View>();
+
+  verify_view(generated_view, loaded_view);
+  for (auto node : generated_view.Nodes()) {
+    KATANA_LOG_ASSERT(
+        generated_view.GetLocalNodeID(node) ==
+        loaded_view.GetLocalNodeID(node));
+    for (auto e : generated_view.OutEdges(node)) {
+      KATANA_LOG_ASSERT(
+          generated_view.OutEdgeDst(e) == loaded_view.OutEdgeDst(e));
+    }
+  }
+}
+
 #endif
@@ -1006,25 +1006,37 @@ DefPropertyGraph(py::module& m) {
   cls.def("has_node_index", &PropertyGraph::HasNodeIndex, py::arg("name"));
   cls.def(
       "get_node_index",
-      [](PropertyGraph& self, const std::string& name)
+      [](PropertyGraph& self, const std::string& name,
+         katana::EntityIndexKind kind)
           -> std::shared_ptr<katana::EntityIndex<katana::GraphTopology::Node>> {
         if (!self.HasNodeIndex(name)) {
-          PythonChecked(self.MakeNodeIndex(name));
+          PythonChecked(self.MakeNodeIndex(name, kind));
         }
         return PythonChecked(self.GetNodeIndex(name));
       },
-      py::arg("name"), py::return_value_policy::reference_internal);
+      py::arg("name"), py::arg("kind") = katana::kOrderedIndex,
+      py::return_value_policy::reference_internal,
+      R"""(
+      Return the index over the node property `name`, making it with the given
+      kind if there is none. An existing index is returned whatever its kind.
+      )""");
   cls.def("has_edge_index", &PropertyGraph::HasEdgeIndex, py::arg("name"));
   cls.def(
       "get_edge_index",
-      [](PropertyGraph& self, const std::string& name)
+      [](PropertyGraph& self, const std::string& name,
+         katana::EntityIndexKind kind)
           -> std::shared_ptr<katana::EntityIndex<katana::GraphTopology::Edge>> {
         if (!self.HasEdgeIndex(name)) {
-          PythonChecked(self.MakeEdgeIndex(name));
+          PythonChecked(self.MakeEdgeIndex(name, kind));
         }
         return PythonChecked(self.GetEdgeIndex(name));
       },
-      py::arg("name"), py::return_value_policy::reference_internal);
+      py::arg("name"), py::arg("kind") = katana::kOrderedIndex,
+      py::return_value_policy::reference_internal,
+      R"""(
+      Return the index over the edge property `name`, making it with the given
+      kind if there is none. An existing index is returned whatever its kind.
+      )""");
 
   cls.def("unload_topologies", &PropertyGraph::DropAllTopologies);
 
@@ -1054,6 +1066,17 @@ DefPropertyGraph(py::module& m) {
   cls.def_property_readonly("path", &PropertyGraph::rdg_dir);
 }
 
+/// The entity with key v in index; raises KeyError if there is none
+template <typename Index, typename T>
+auto
+FindOrRaise(Index& index, const T& v) {
+  auto it = index.Find(v);
+  if (it == index.end()) {
+    throw py::key_error(fmt::format("{}", v));
+  }
+  return *it;
+}
+
 template <typename node_or_edge>
 struct WrapPrimitiveEntityIndex {
   py::class_<
@@ -1066,8 +1089,9 @@ struct WrapPrimitiveEntityIndex {
     using Cls = katana::PrimitiveEntityIndex<node_or_edge, T>;
     py::class_<Cls, std::shared_ptr<Cls>> cls(m, name, base_cls);
 
-    cls.template def(
-        "__getitem__", [](Cls& self, const T& v) { return *self.Find(v); });
+    cls.template def("__getitem__", [](Cls& self, const T& v) {
+      return FindOrRaise(self, v);
+    });
     cls.template def("find_all", [](Cls& self, const T& v) {
       return py::make_iterator(self.LowerBound(v), self.UpperBound(v));
     });
@@ -1090,7 +1114,7 @@ struct WrapStringEntityIndex {
     py::class_<Cls, std::shared_ptr<Cls>> cls(m, name, base_cls);
 
     cls.template def("__getitem__", [](Cls& self, const std::string& v) {
-      return *self.Find(v);
+      return FindOrRaise(self, v);
     });
     cls.template def("find_all", [](Cls& self, const std::string& v) {
       return py::make_iterator(self.LowerBound(v), self.UpperBound(v));
@@ -1102,6 +1126,36 @@ struct WrapStringEntityIndex {
   }
 };
 
+template <typename node_or_edge>
+struct WrapHashStringEntityIndex {
+  py::class_<
+      katana::EntityIndex<node_or_edge>,
+      std::shared_ptr<katana::EntityIndex<node_or_edge>>>
+      base_cls;
+
+  py::object instantiate(py::module& m, const char* name) {
+    using Cls = katana::HashStringEntityIndex<node_or_edge>;
+    py::class_<Cls, std::shared_ptr<Cls>> cls(m, name, base_cls);
+
+    cls.template def("__getitem__", [](Cls& self, const std::string& v) {
+      return FindOrRaise(self, v);
+    });
+    cls.template def("find_all", [](Cls& self, const std::string& v) {
+      auto [begin, end] = self.EqualRange(v);
+      return py::make_iterator(begin, end);
+    });
+
+    return std::move(cls);
+  }
+};
+
+void
+DefEntityIndexKind(py::module& m) {
+  py::enum_<katana::EntityIndexKind>(m, "EntityIndexKind")
+      .value("Ordered", katana::kOrderedIndex)
+      .value("Hash", katana::kHashIndex);
+}
+
 template <typename node_or_edge>
 void
 DefEntityIndex(py::module& m) {
@@ -1120,6 +1174,8 @@ DefEntityIndex(py::module& m) {
       WrapPrimitiveEntityIndex<node_or_edge>{cls});
   WrapStringEntityIndex<node_or_edge>{cls}.instantiate(
       m, ("String" + cls_name).c_str());
+  WrapHashStringEntityIndex<node_or_edge>{cls}.instantiate(
+      m, ("HashString" + cls_name).c_str());
 }
 
 void
@@ -1157,6 +1213,7 @@ DefAccessors(py::module& m) {
 void
 katana::python::InitPropertyGraph(py::module& m) {
   DefAccessors(m);
+  DefEntityIndexKind(m);
   DefEntityIndex<katana::GraphTopologyTypes::Node>(m);
   DefEntityIndex<katana::GraphTopologyTypes::Edge>(m);
   DefTxnContext(m);
@@ -1,23 +1,27 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_CACHE_H_
 #define KATANA_LIBSUPPORT_KATANA_CACHE_H_
 
-// This is single threaded only, it is not intended to store large objects,
-// but rather metadata (e.g., a shared_ptr to a property column).
-
-// The problem witchel had implementing a multi-threaded version using
-// parallel-hashmap is a lock ordering problem.  parallel-hashmap 1.33 allows
-// execution of code with the write lock held, only when modifying, not when adding an
-// element.  We have to modify the LRU list when eviciting an element, so the natural
-// lock ordering is parallel-hashmap write lock, then list lock.  But without a way to
-// execute insert code with the parallel-hashmap write lock held, it seemed like there
-// would be some form of race condition.
+// The cache is not intended to store large objects, but rather metadata (e.g.,
+// a shared_ptr to a property column).
+//
+// It is thread safe. Entries are spread over shards by key hash, each with its
+// own lock, LRU list and statistics, so lookups of different keys rarely
+// contend. Only one shard lock is ever held at a time, which avoids the lock
+// ordering problems of sharing one LRU list between the shards of a
+// concurrent hash map.
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <arrow/table.h>
 
@@ -49,6 +53,15 @@ struct CacheStats {
             static_cast<float>(insert_hit_count)) /
            total_count();
   }
+  /// Percentage of the bytes clients asked for that came from the cache
+  /// rather than being loaded after a miss (see Cache::AddMissBytes)
+  float get_hit_byte_percentage() const {
+    if (get_hit_bytes + get_miss_bytes == 0LL) {
+      return 0.0;
+    }
+    return 100.0 * static_cast<float>(get_hit_bytes) /
+           (get_hit_bytes + get_miss_bytes);
+  }
   uint64_t total_count() const { return insert_count + get_count; }
   void Log() const {
     katana::GetTracer().GetActiveSpan().Log(
@@ -57,16 +70,124 @@ struct CacheStats {
             {"get_per", fmt::format("{:.2f}%", get_hit_percentage())},
             {"insert_per", fmt::format("{:.2f}%", insert_hit_percentage())},
             {"total_per", fmt::format("{:.2f}%", total_hit_percentage())},
+            {"get_byte_per", fmt::format("{:.2f}%", get_hit_byte_percentage())},
             {"total_count", total_count()},
             {"get_count", get_count},
             {"insert_count", insert_count},
+            {"get_hit_bytes", get_hit_bytes},
+            {"get_miss_bytes", get_miss_bytes},
+            {"insert_bytes", insert_bytes},
+            {"capacity_evictions", capacity_evictions},
+            {"reclaim_evictions", reclaim_evictions},
+            {"evicted_bytes", evicted_bytes},
+            {"rejected_inserts", rejected_inserts},
+            {"oversized_inserts", oversized_inserts},
         });
   }
 
+  CacheStats& operator+=(const CacheStats& other) {
+    get_count += other.get_count;
+    get_hit_count += other.get_hit_count;
+    insert_count += other.insert_count;
+    insert_hit_count += other.insert_hit_count;
+    get_hit_bytes += other.get_hit_bytes;
+    get_miss_bytes += other.get_miss_bytes;
+    insert_bytes += other.insert_bytes;
+    capacity_evictions += other.capacity_evictions;
+    reclaim_evictions += other.reclaim_evictions;
+    evicted_bytes += other.evicted_bytes;
+    rejected_inserts += other.rejected_inserts;
+    oversized_inserts += other.oversized_inserts;
+    return *this;
+  }
+
   int64_t get_count{0LL};
   int64_t get_hit_count{0LL};
   int64_t insert_count{0LL};
   int64_t insert_hit_count{0LL};
+
+  // Byte counts are only kept by caches that know the size of their values
+  int64_t get_hit_bytes{0LL};
+  int64_t get_miss_bytes{0LL};
+  int64_t insert_bytes{0LL};
+
+  // Why entries left the cache, or never entered it
+  int64_t capacity_evictions{0LL};  // evicted to stay within capacity
+  int64_t reclaim_evictions{0LL};   // evicted by Reclaim
+  int64_t evicted_bytes{0LL};
+  int64_t rejected_inserts{0LL};   // refused by the admission policy
+  int64_t oversized_inserts{0LL};  // larger than the capacity of a shard
+};
+
+/// Approximate access counts of keys: a count-min sketch of small saturating
+/// counters that are halved periodically so that old popularity fades, as in
+/// TinyLFU. Not thread safe.
+class FrequencySketch {
+public:
+  static constexpr size_t kDefaultWidth = 1024;
+
+  explicit FrequencySketch(size_t width = kDefaultWidth)
+      : counters_(kDepth * width, 0),
+        width_(width),
+        sample_limit_(10 * width) {}
+
+  void Increment(size_t hash) {
+    for (size_t row = 0; row < kDepth; ++row) {
+      uint8_t& counter = counters_[Index(hash, row)];
+      if (counter < kMaxCount) {
+        ++counter;
+      }
+    }
+    if (++samples_ >= sample_limit_) {
+      Age();
+    }
+  }
+
+  uint8_t Estimate(size_t hash) const {
+    uint8_t estimate = kMaxCount;
+    for (size_t row = 0; row < kDepth; ++row) {
+      estimate = std::min(estimate, counters_[Index(hash, row)]);
+    }
+    return estimate;
+  }
+
+private:
+  static constexpr size_t kDepth = 4;
+  static constexpr uint8_t kMaxCount = 15;
+
+  size_t Index(size_t hash, size_t row) const {
+    uint64_t h = (hash + row) * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 29;
+    return row * width_ + h % width_;
+  }
+
+  void Age() {
+    for (auto& counter : counters_) {
+      counter >>= 1;
+    }
+    samples_ /= 2;
+  }
+
+  std::vector<uint8_t> counters_;
+  size_t width_;
+  size_t sample_limit_;
+  size_t samples_{0};
+};
+
+/// kAlways - every insert is admitted and replacement is purely LRU
+/// kFrequency - an insert that would evict other entries is only admitted if
+///   its key has been used more often than the keys it would evict (or as
+///   often, if it is no bigger than them). Reclaim evicts the entry with the
+///   fewest uses per unit of size among the least recently used entries
+///   first. This keeps a large table that is used once from pushing out small
+///   hot ones.
+enum class CacheAdmission { kAlways, kFrequency };
+
+struct CacheOptions {
+  /// Entries are spread over this many independently locked shards. The
+  /// capacity of the cache is divided evenly between them.
+  size_t num_shards{1};
+  CacheAdmission admission{CacheAdmission::kAlways};
 };
 
 template <typename Value>
@@ -77,6 +198,11 @@ class KATANA_EXPORT Cache {
     Value value;
     // This allows us to delete the old position in the LRU list without a scan
     typename ListType::iterator lru_it;
+    size_t hash;
+    int64_t bytes;
+    // tick of the last use, to find the least recently used entry across
+    // shards
+    uint64_t last_use;
   };
   using MapType = std::unordered_map<Key, MapValue, Key::Hash>;
   // kLRUSize - LRU replacement when the number of elements is above threshold
@@ -84,18 +210,37 @@ class KATANA_EXPORT Cache {
   // kNone - LRU replacement only on demand
   enum class ReplacementPolicy { kLRUSize, kLRUBytes, kLRUExplicit };
 
+  struct Shard {
+    std::mutex mutex;
+    // Map from key to value
+    MapType key_to_value;
+    // LRU list
+    ListType lru_list;
+    // in entries or bytes, depending on the replacement policy
+    int64_t size{0};
+    // Hit statistics for gets and inserts
+    CacheStats stats;
+    std::unique_ptr<FrequencySketch> sketch;
+  };
+
+  // How many entries at the end of the LRU list are compared when choosing
+  // what to evict under CacheAdmission::kFrequency
+  static constexpr int kVictimWindow = 4;
+
 public:
   /// Construct an LRU cache that has a fixed number of entries.
-  Cache(int64_t capacity)  // number of entries
+  Cache(int64_t capacity, CacheOptions options = CacheOptions())  // entries
       : policy_(ReplacementPolicy::kLRUSize),
         capacity_(capacity),
         value_to_bytes_(nullptr) {
     KATANA_LOG_VASSERT(capacity_ > 0, "cache requires positive capacity");
+    MakeShards(options);
   }
   /// Construct an LRU cache that holds fixed number of bytes.
   Cache(
       int64_t capacity,  // bytes of entries
-      std::function<int64_t(const Value& value)> value_to_bytes)
+      std::function<int64_t(const Value& value)> value_to_bytes,
+      CacheOptions options = CacheOptions())
       : policy_(ReplacementPolicy::kLRUBytes),
         capacity_(capacity),
         value_to_bytes_(std::move(value_to_bytes)) {
@@ -103,167 +248,368 @@ public:
     KATANA_LOG_VASSERT(
         value_to_bytes_ != nullptr,
         "kLRUBytes policy requires value to bytes function");
+    MakeShards(options);
   }
   /// Construct an LRU cache that holds whatever we put in it and only evicts when we
-  /// explicitly tell it to do so.
+  /// explicitly tell it to do so. Its capacity (see set_capacity) is only a
+  /// budget for admission: under CacheAdmission::kFrequency, inserts that
+  /// would take the cache over it must be used more often than the entries
+  /// Reclaim would evict to get back under it.
   /// NB: The way we use this, the insert hit rate is always 0 because we GetAndEvict and
   /// then possibly insert back.
-  Cache(std::function<int64_t(const Value& value)> value_to_bytes)
+  Cache(
+      std::function<int64_t(const Value& value)> value_to_bytes,
+      CacheOptions options = CacheOptions())
       : policy_(ReplacementPolicy::kLRUExplicit),
         capacity_(std::numeric_limits<int64_t>::max()),
         value_to_bytes_(std::move(value_to_bytes)) {
     KATANA_LOG_VASSERT(
         value_to_bytes_ != nullptr,
         "kLRUExplicit policy requires value to bytes function");
+    MakeShards(options);
   }
 
   /// Returns the size of the cache (in number of elements or size of elements,
   /// depending on the replacement policy).
-  int64_t size() const {
-    if (policy_ == ReplacementPolicy::kLRUSize) {
-      return key_to_value_.size();
-    }
-    return total_bytes_;
-  }
+  int64_t size() const { return size_; }
 
   /// Returns the capacity (in number of elements or size of elements, depending on
   /// the replacement policy).
-  int64_t capacity() const {
-    if (policy_ == ReplacementPolicy::kLRUExplicit) {
-      return std::numeric_limits<int64_t>::max();
-    }
-    return capacity_;
+  int64_t capacity() const { return capacity_; }
+
+  /// Set the admission budget, in bytes, of a cache that only evicts
+  /// explicitly. It changes as memory is used elsewhere, so it is not fixed at
+  /// construction.
+  void set_capacity(int64_t capacity) {
+    KATANA_LOG_DEBUG_ASSERT(policy_ == ReplacementPolicy::kLRUExplicit);
+    capacity_ = std::max<int64_t>(capacity, 0);
   }
 
+  size_t num_shards() const { return shards_.size(); }
+
   /// Clear cache
   void clear() {
-    key_to_value_.clear();
-    lru_list_.clear();
-    total_bytes_ = 0;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      num_entries_ -= shard->key_to_value.size();
+      size_ -= shard->size;
+      shard->key_to_value.clear();
+      shard->lru_list.clear();
+      shard->size = 0;
+    }
   }
 
   /// Returns true if the cache is empty
-  bool empty() const { return key_to_value_.empty(); }
+  bool empty() const { return num_entries_ == 0; }
 
   /// Try to reclaim \p goal bytes (#entries), evicting least recently used entries to
-  /// do it.  Returns the number of bytes actually evicted.
-  int64_t Reclaim(int64_t goal) {
+  /// do it.  Returns the number of bytes actually evicted. If given, \p on_evict
+  /// is called with each evicted entry, without any cache lock held.
+  int64_t Reclaim(
+      int64_t goal,
+      const std::function<void(const Key& key, Value&& value)>& on_evict =
+          nullptr) {
     int64_t reclaimed{};
-    while (!empty() && reclaimed < goal) {
-      reclaimed += EvictLastOne();
+    while (reclaimed < goal) {
+      // Find the shard whose next victim should go first. Shards are locked
+      // one at a time, so the choice is only approximate under concurrent use.
+      Shard* victim_shard = nullptr;
+      std::pair<double, uint64_t> victim_rank;
+      for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        auto it = FindVictim(*shard);
+        if (it == shard->key_to_value.end()) {
+          continue;
+        }
+        auto rank = VictimRank(*shard, it->second);
+        if (victim_shard == nullptr || rank < victim_rank) {
+          victim_shard = shard.get();
+          victim_rank = rank;
+        }
+      }
+      if (victim_shard == nullptr) {
+        break;
+      }
+
+      std::unique_lock<std::mutex> lock(victim_shard->mutex);
+      auto it = FindVictim(*victim_shard);
+      if (it == victim_shard->key_to_value.end()) {
+        continue;
+      }
+      reclaimed += Units(it->second.bytes);
+      victim_shard->stats.reclaim_evictions++;
+      Key key = it->first;
+      Value value = Evict(*victim_shard, it);
+      lock.unlock();
+      if (on_evict) {
+        on_evict(key, std::move(value));
+      }
     }
     return reclaimed;
   }
 
   bool Contains(const Key& key) const {
-    return key_to_value_.find(key) != key_to_value_.end();
-  }
-
-  void Insert(const Key& key, const Value& value) {
-    cache_stats_.insert_count++;
-    auto mapit = key_to_value_.find(key);
-    if (mapit == key_to_value_.end()) {
-      int64_t approx_bytes{};
-      if (value_to_bytes_ != nullptr) {
-        approx_bytes = value_to_bytes_(value);
-        if (approx_bytes > capacity_) {
-          // Object too big, don't insert
-          return;
-        }
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.key_to_value.find(key) != shard.key_to_value.end();
+  }
+
+  /// Returns false if the value was not cached, because it is too big or the
+  /// admission policy refused it
+  bool Insert(const Key& key, const Value& value) {
+    int64_t approx_bytes{};
+    if (value_to_bytes_ != nullptr) {
+      approx_bytes = value_to_bytes_(value);
+    }
+    size_t hash = Key::Hash{}(key);
+    Shard& shard = *shards_[hash % shards_.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    shard.stats.insert_count++;
+    shard.stats.insert_bytes += approx_bytes;
+    if (shard.sketch) {
+      shard.sketch->Increment(hash);
+    }
+    auto mapit = shard.key_to_value.find(key);
+    if (mapit == shard.key_to_value.end()) {
+      int64_t units = Units(approx_bytes);
+      if (units > shard_capacity_) {
+        // Object too big, don't insert
+        shard.stats.oversized_inserts++;
+        return false;
       }
-      lru_list_.push_front(key);
-      key_to_value_[key] = {value, lru_list_.begin()};
-      if (value_to_bytes_ != nullptr) {
-        if (approx_bytes == 0) {
-          KATANA_LOG_WARN(
-              "caching zero sized object with LRUBytes policy is illogical");
-        }
-        total_bytes_ += approx_bytes;
+      if (!Admit(shard, hash, units)) {
+        shard.stats.rejected_inserts++;
+        return false;
+      }
+      shard.lru_list.push_front(key);
+      shard.key_to_value[key] = {
+          value, shard.lru_list.begin(), hash, approx_bytes, Tick()};
+      if (value_to_bytes_ != nullptr && approx_bytes == 0) {
+        KATANA_LOG_WARN(
+            "caching zero sized object with LRUBytes policy is illogical");
       }
+      num_entries_++;
+      AddSize(shard, units);
     } else {
-      cache_stats_.insert_hit_count++;
+      shard.stats.insert_hit_count++;
+      AddSize(shard, Units(approx_bytes) - Units(mapit->second.bytes));
       mapit->second.value = value;
-      UpdateLRU(mapit);
+      mapit->second.bytes = approx_bytes;
+      UpdateLRU(shard, mapit);
     }
-    EvictIfNecessary();
+    EvictIfNecessary(shard);
+    return true;
   }
 
   std::optional<Value> Get(const Key& key) {
+    size_t hash = Key::Hash{}(key);
+    Shard& shard = *shards_[hash % shards_.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
     // lookup value in the cache
-    cache_stats_.get_count++;
+    shard.stats.get_count++;
+    if (shard.sketch) {
+      shard.sketch->Increment(hash);
+    }
     std::optional<Value> ret;
-    auto it = key_to_value_.find(key);
-    if (it != key_to_value_.end()) {
-      ret = UpdateLRU(it);
-      cache_stats_.get_hit_count++;
+    auto it = shard.key_to_value.find(key);
+    if (it != shard.key_to_value.end()) {
+      ret = UpdateLRU(shard, it);
+      shard.stats.get_hit_count++;
+      shard.stats.get_hit_bytes += it->second.bytes;
     }
     return ret;
   }
 
   std::optional<Value> GetAndEvict(const Key& key) {
+    size_t hash = Key::Hash{}(key);
+    Shard& shard = *shards_[hash % shards_.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
     // lookup value in the cache
-    cache_stats_.get_count++;
+    shard.stats.get_count++;
+    if (shard.sketch) {
+      shard.sketch->Increment(hash);
+    }
     std::optional<Value> ret;
-    auto it = key_to_value_.find(key);
-    if (it != key_to_value_.end()) {
-      ret = EvictMe(it->second.lru_it);
-      cache_stats_.get_hit_count++;
+    auto it = shard.key_to_value.find(key);
+    if (it != shard.key_to_value.end()) {
+      shard.stats.get_hit_count++;
+      shard.stats.get_hit_bytes += it->second.bytes;
+      ret = Remove(shard, it);
     }
     return ret;
   }
 
-  CacheStats GetStats() const { return cache_stats_; }
+  /// Note that a value of \p bytes had to be loaded after a miss on \p key,
+  /// for the byte hit ratio
+  void AddMissBytes(const Key& key, int64_t bytes) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.stats.get_miss_bytes += bytes;
+  }
 
-  // This is mostly a debugging function.  It also explains the cache data structures
+  CacheStats GetStats() const {
+    CacheStats stats;
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      stats += shard->stats;
+    }
+    return stats;
+  }
+
+  // This is mostly a debugging function.  It also explains the cache data
+  // structures. Positions are within the shard of the key.
   int64_t LRUPosition(const Key& key) {
-    auto it = key_to_value_.find(key);
-    if (it != key_to_value_.end()) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.key_to_value.find(key);
+    if (it != shard.key_to_value.end()) {
       auto& lru_it = it->second.lru_it;
-      return std::distance(lru_list_.begin(), lru_it);
+      return std::distance(shard.lru_list.begin(), lru_it);
     }
     return -1L;
   }
 
 private:
-  Value UpdateLRU(typename MapType::iterator mapit) {
+  void MakeShards(const CacheOptions& options) {
+    size_t num_shards = std::max<size_t>(options.num_shards, 1);
+    for (size_t i = 0; i < num_shards; ++i) {
+      auto shard = std::make_unique<Shard>();
+      if (options.admission == CacheAdmission::kFrequency) {
+        shard->sketch = std::make_unique<FrequencySketch>();
+      }
+      shards_.emplace_back(std::move(shard));
+    }
+    shard_capacity_ = capacity_;
+    if (policy_ != ReplacementPolicy::kLRUExplicit) {
+      shard_capacity_ =
+          std::max<int64_t>(capacity_ / static_cast<int64_t>(num_shards), 1);
+    }
+  }
+
+  Shard& ShardFor(const Key& key) const {
+    return *shards_[Key::Hash{}(key) % shards_.size()];
+  }
+
+  /// The size of an entry in the units of the replacement policy
+  int64_t Units(int64_t bytes) const {
+    return policy_ == ReplacementPolicy::kLRUSize ? 1 : bytes;
+  }
+
+  uint64_t Tick() { return clock_++; }
+
+  void AddSize(Shard& shard, int64_t units) {
+    shard.size += units;
+    size_ += units;
+  }
+
+  Value UpdateLRU(Shard& shard, typename MapType::iterator mapit) {
     auto lru_it = mapit->second.lru_it;
-    if (lru_it != lru_list_.begin()) {
+    if (lru_it != shard.lru_list.begin()) {
       // move item to the front of the most recently used list
-      lru_list_.erase(lru_it);
-      lru_list_.push_front(mapit->first);
-      mapit->second.lru_it = lru_list_.begin();
+      shard.lru_list.erase(lru_it);
+      shard.lru_list.push_front(mapit->first);
+      mapit->second.lru_it = shard.lru_list.begin();
     }
+    mapit->second.last_use = Tick();
     return mapit->second.value;
   }
 
-  Value EvictMe(ListType::iterator evictit) {
-    KATANA_LOG_DEBUG_ASSERT(evictit != lru_list_.end());
-    Key evicted_key = std::move(*evictit);
-    lru_list_.erase(evictit);
-    auto evicted_value = std::move(key_to_value_.at(evicted_key).value);
-    key_to_value_.erase(evicted_key);
-    if (value_to_bytes_ != nullptr) {
-      total_bytes_ -= value_to_bytes_(evicted_value);
+  Value Remove(Shard& shard, typename MapType::iterator mapit) {
+    shard.lru_list.erase(mapit->second.lru_it);
+    AddSize(shard, -Units(mapit->second.bytes));
+    num_entries_--;
+    auto removed_value = std::move(mapit->second.value);
+    shard.key_to_value.erase(mapit);
+    return removed_value;
+  }
+
+  Value Evict(Shard& shard, typename MapType::iterator mapit) {
+    shard.stats.evicted_bytes += mapit->second.bytes;
+    return Remove(shard, mapit);
+  }
+
+  /// Lower ranks are evicted first. When tracking frequency, the rank is the
+  /// uses of an entry per unit of size it would free, so a large table goes
+  /// before a small one used as often; ties, and all entries otherwise, go in
+  /// LRU order.
+  std::pair<double, uint64_t> VictimRank(
+      const Shard& shard, const MapValue& entry) const {
+    if (!shard.sketch) {
+      return {0.0, entry.last_use};
     }
-    return evicted_value;
+    double uses = shard.sketch->Estimate(entry.hash) + 1.0;
+    return {
+        uses / std::max<int64_t>(Units(entry.bytes), 1), entry.last_use};
   }
 
-  uint64_t EvictLastOne() {
-    // evict item from the end of most recently used list
-    auto tail = --lru_list_.end();
-    auto evicted_value = EvictMe(tail);
-    if (value_to_bytes_ != nullptr) {
-      return value_to_bytes_(evicted_value);
+  /// The entry to evict next from shard: the least recently used entry or,
+  /// when tracking frequency, the lowest ranked of the last few entries. If
+  /// \p keep_newest, the most recently used entry is not a candidate.
+  typename MapType::iterator FindVictim(
+      Shard& shard, bool keep_newest = false) {
+    auto victim = shard.key_to_value.end();
+    int candidates = 0;
+    for (auto it = shard.lru_list.rbegin(); it != shard.lru_list.rend(); ++it) {
+      if (keep_newest && std::next(it) == shard.lru_list.rend()) {
+        break;
+      }
+      auto mapit = shard.key_to_value.find(*it);
+      if (victim == shard.key_to_value.end() ||
+          VictimRank(shard, mapit->second) <
+              VictimRank(shard, victim->second)) {
+        victim = mapit;
+      }
+      if (!shard.sketch || ++candidates == kVictimWindow) {
+        break;
+      }
     }
-    return 1;
+    return victim;
   }
 
-  void EvictIfNecessary() {
+  /// Whether an entry of \p units with key hash \p hash should be let into a
+  /// shard, considering what would have to be evicted to make room for it.
+  /// Caches that only evict explicitly compare against their whole budget,
+  /// since Reclaim may take the room from any shard, but only weigh the
+  /// entries of this shard, since only its lock is held.
+  bool Admit(Shard& shard, size_t hash, int64_t units) {
+    bool is_explicit = policy_ == ReplacementPolicy::kLRUExplicit;
+    int64_t needed = is_explicit ? size_ + units - capacity_
+                                 : shard.size + units - shard_capacity_;
+    if (!shard.sketch || needed <= 0) {
+      return true;
+    }
+    uint8_t max_victim_frequency = 0;
+    int64_t freed = 0;
+    for (auto it = shard.lru_list.rbegin();
+         it != shard.lru_list.rend() && freed < needed; ++it) {
+      const MapValue& entry = shard.key_to_value.find(*it)->second;
+      freed += Units(entry.bytes);
+      max_victim_frequency = std::max(
+          max_victim_frequency, shard.sketch->Estimate(entry.hash));
+    }
+    if (freed < needed && !is_explicit) {
+      return false;
+    }
+    uint8_t frequency = shard.sketch->Estimate(hash);
+    return frequency > max_victim_frequency ||
+           (frequency == max_victim_frequency && units <= freed);
+  }
+
+  void EvictIfNecessary(Shard& shard) {
     switch (policy_) {
     case ReplacementPolicy::kLRUSize:
     case ReplacementPolicy::kLRUBytes: {
-      while (size() > capacity_) {
-        EvictLastOne();
+      while (shard.size > shard_capacity_) {
+        // The entry just inserted or updated was admitted over the others
+        auto victim = FindVictim(shard, true);
+        if (victim == shard.key_to_value.end()) {
+          break;
+        }
+        shard.stats.capacity_evictions++;
+        Evict(shard, victim);
       }
     } break;
     case ReplacementPolicy::kLRUExplicit: {
@@ -274,17 +620,16 @@ private:
     }
   }
 
-  // Map from key to value
-  MapType key_to_value_;
-  // LRU list
-  ListType lru_list_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 
   ReplacementPolicy policy_;
-  // for kLRUSize number of entries kLRUBytes it is byte total
-  int64_t capacity_{0};
-  int64_t total_bytes_{0};
-  // Hit statistics for gets and inserts
-  CacheStats cache_stats_;
+  // for kLRUSize number of entries kLRUBytes it is byte total, for
+  // kLRUExplicit it is the admission budget in bytes
+  std::atomic<int64_t> capacity_{0};
+  int64_t shard_capacity_{0};
+  std::atomic<int64_t> size_{0};
+  std::atomic<int64_t> num_entries_{0};
+  std::atomic<uint64_t> clock_{0};
 
   std::function<int64_t(const Value& value)> value_to_bytes_;
 };
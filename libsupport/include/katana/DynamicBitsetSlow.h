@@ -41,42 +41,35 @@ public:
         bit_offset_(bit_offset) {}
 
   DynamicBitsetIterator& operator++() {
-    // Step forward one to the bit we want to examine first.
-    bit_offset_++;
-    if (bit_offset_ > DynamicBitsetType::kNumBitsInUint64) {
-      bit_offset_ = 0;
-      array_index_++;
-    }
-
+    constexpr uint64_t kBits = DynamicBitsetType::kNumBitsInUint64;
     const auto& bitvec = underlying_->get_vec();
     const size_t size = underlying_->size();
 
-    // Used only to make sure we stop on the last real used bit in cases where
-    // the number of bits is not a multiple of kNumBitsInUint64.
-    uint64_t current_bit_index = **this;
-
-    // The following code is optimized to make the search process fast for
-    // sparse bitsets. It's performance for densely filled bitsets should be
-    // good too.
-
-    // Iterate forward word by word
-    for (; array_index_ < bitvec.size(); array_index_++) {
-      uint64_t word = bitvec[array_index_].load(std::memory_order_relaxed);
-      // For each word we check if it is non-zero (that is it contains a 1 bit)
-      if (word != 0) {
-        // Iterate over the bits in the work
-        uint64_t bit_mask = uint64_t{1} << bit_offset_;
-        for (; bit_offset_ < DynamicBitsetType::kNumBitsInUint64 &&
-               current_bit_index < size;
-             bit_offset_++, current_bit_index++, bit_mask <<= 1) {
-          // Check if the bit is set. If it is we have reached where we need to be
-          if ((word & bit_mask) != 0) {
+    // Step forward one to the bit we want to examine first.
+    uint64_t next = **this + 1;
+    array_index_ = next / kBits;
+
+    // Skip zero words and then jump straight to the lowest set bit of the
+    // first non-zero word, so sparse bitsets take one step per word and dense
+    // ones one step per set bit.
+    if (next < size) {
+      uint64_t word = bitvec[array_index_].load(std::memory_order_relaxed) &
+                      (~uint64_t{0} << (next % kBits));
+      for (;;) {
+        if (word != 0) {
+          uint8_t bit = __builtin_ctzll(word);
+          // Make sure we stop on the last real used bit in cases where the
+          // number of bits is not a multiple of kNumBitsInUint64.
+          if (array_index_ * kBits + bit < size) {
+            bit_offset_ = bit;
             return *this;
           }
+          break;
+        }
+        if (++array_index_ == bitvec.size()) {
+          break;
         }
-        // Reset bit_offset_ here so that we start from our last bit_offset_ and
-        // only reset when we roll over to the next word.
-        bit_offset_ = 0;
+        word = bitvec[array_index_].load(std::memory_order_relaxed);
       }
     }
     bit_offset_ = 0;
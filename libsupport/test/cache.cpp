@@ -2,6 +2,7 @@
 
 #include <map>
 #include <random>
+#include <thread>
 
 #include "katana/Cache.h"
 #include "katana/Logging.h"
@@ -212,6 +213,151 @@ TestLRUSize(int64_t lru_size, const std::vector<katana::URI>& keys) {
   KATANA_LOG_ASSERT(cache.size() == 0);
 }
 
+void
+TestExplicitAdmission(const std::vector<katana::URI>& keys) {
+  constexpr int64_t kNumHot = 3;
+  katana::Cache<CacheValue> cache(
+      [](const CacheValue& value) { return BytesInValue(value); },
+      katana::CacheOptions{.admission = katana::CacheAdmission::kFrequency});
+  cache.set_capacity(kNumHot);
+  KATANA_LOG_ASSERT(cache.capacity() == kNumHot);
+
+  for (int64_t i = 0; i < kNumHot; ++i) {
+    KATANA_LOG_ASSERT(cache.Insert(keys[i], SizeOneValue()));
+    for (int j = 0; j < 3; ++j) {
+      KATANA_LOG_ASSERT(cache.Get(keys[i]).has_value());
+    }
+  }
+
+  // Over budget, a big value used once is refused
+  const katana::URI& big = keys[kNumHot];
+  KATANA_LOG_ASSERT(!cache.Insert(big, SizeFiveValue()));
+  KATANA_LOG_ASSERT(!cache.Contains(big));
+  KATANA_LOG_ASSERT(cache.GetStats().rejected_inserts == 1);
+  cache.AddMissBytes(big, 5);
+  KATANA_LOG_ASSERT(cache.GetStats().get_miss_bytes == 5);
+
+  // but admitted once it is hot. Nothing is evicted until Reclaim.
+  for (int j = 0; j < 12; ++j) {
+    KATANA_LOG_ASSERT(!cache.Get(big).has_value());
+  }
+  KATANA_LOG_ASSERT(cache.Insert(big, SizeFiveValue()));
+  KATANA_LOG_ASSERT(cache.size() == kNumHot + 5);
+
+  // Within budget, everything is admitted
+  cache.set_capacity(100);
+  KATANA_LOG_ASSERT(cache.Insert(keys[kNumHot + 1], SizeFiveValue()));
+  KATANA_LOG_ASSERT(cache.GetStats().rejected_inserts == 1);
+}
+
+void
+TestVictimBytes(const std::vector<katana::URI>& keys) {
+  katana::Cache<CacheValue> cache(
+      [](const CacheValue& value) { return BytesInValue(value); },
+      katana::CacheOptions{.admission = katana::CacheAdmission::kFrequency});
+
+  // Used as often as the small value and more recently, but it frees five
+  // times the bytes
+  cache.Insert(keys[0], SizeOneValue());
+  KATANA_LOG_ASSERT(cache.Get(keys[0]).has_value());
+  cache.Insert(keys[1], SizeFiveValue());
+  KATANA_LOG_ASSERT(cache.Get(keys[1]).has_value());
+
+  KATANA_LOG_ASSERT(cache.Reclaim(1) == 5);
+  KATANA_LOG_ASSERT(cache.Contains(keys[0]));
+  KATANA_LOG_ASSERT(!cache.Contains(keys[1]));
+}
+
+void
+TestFrequencyAdmission(const std::vector<katana::URI>& keys) {
+  constexpr int64_t kNumHot = 5;
+  katana::Cache<CacheValue> cache(
+      kNumHot, [](const CacheValue& value) { return BytesInValue(value); },
+      katana::CacheOptions{.admission = katana::CacheAdmission::kFrequency});
+
+  for (int64_t i = 0; i < kNumHot; ++i) {
+    cache.Insert(keys[i], SizeOneValue());
+    for (int j = 0; j < 3; ++j) {
+      KATANA_LOG_ASSERT(cache.Get(keys[i]).has_value());
+    }
+  }
+
+  // A big value used once does not push out small values used often
+  const katana::URI& big = keys[kNumHot];
+  cache.Insert(big, SizeFiveValue());
+  KATANA_LOG_ASSERT(!cache.Contains(big));
+  KATANA_LOG_ASSERT(cache.size() == kNumHot);
+  KATANA_LOG_ASSERT(cache.GetStats().rejected_inserts == 1);
+
+  // but it gets in once it is used more than they are
+  for (int j = 0; j < 12; ++j) {
+    KATANA_LOG_ASSERT(!cache.Get(big).has_value());
+  }
+  cache.Insert(big, SizeFiveValue());
+  KATANA_LOG_ASSERT(cache.Contains(big));
+  KATANA_LOG_ASSERT(cache.size() == 5);
+
+  auto stats = cache.GetStats();
+  KATANA_LOG_ASSERT(stats.capacity_evictions == kNumHot);
+  KATANA_LOG_ASSERT(stats.evicted_bytes == kNumHot);
+  KATANA_LOG_ASSERT(stats.get_hit_bytes == 3 * kNumHot);
+  KATANA_LOG_ASSERT(stats.insert_bytes == kNumHot + 10);
+}
+
+void
+TestSharded(const std::vector<katana::URI>& keys) {
+  constexpr int kNumThreads = 8;
+  constexpr size_t kNumKeys = 64;
+  KATANA_LOG_ASSERT(keys.size() >= kNumKeys);
+
+  katana::Cache<CacheValue> cache(
+      [](const CacheValue& value) { return BytesInValue(value); },
+      katana::CacheOptions{.num_shards = 4});
+  KATANA_LOG_ASSERT(cache.num_shards() == 4);
+
+  // Reclaim evicts the least recently used entry of any shard
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    cache.Insert(keys[i], SizeOneValue());
+  }
+  KATANA_LOG_ASSERT(cache.Get(keys[0]).has_value());
+  KATANA_LOG_ASSERT(cache.Reclaim(2) == 2);
+  KATANA_LOG_ASSERT(cache.Contains(keys[0]));
+  KATANA_LOG_ASSERT(!cache.Contains(keys[1]));
+  KATANA_LOG_ASSERT(!cache.Contains(keys[2]));
+
+  katana::Cache<CacheValue> shared(
+      [](const CacheValue& value) { return BytesInValue(value); },
+      katana::CacheOptions{
+          .num_shards = 4, .admission = katana::CacheAdmission::kFrequency});
+  // the random generator is not thread safe
+  const CacheValue five = SizeFiveValue();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&shared, &keys, &five, t]() {
+      for (size_t i = t; i < kNumKeys; i += kNumThreads) {
+        shared.Insert(keys[i], five);
+        KATANA_LOG_ASSERT(shared.Get(keys[i]).has_value());
+        auto value = shared.GetAndEvict(keys[i]);
+        KATANA_LOG_ASSERT(value.has_value());
+        shared.Insert(keys[i], value.value());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto stats = shared.GetStats();
+  KATANA_LOG_ASSERT(stats.insert_count == kNumKeys * 2);
+  KATANA_LOG_ASSERT(stats.get_count == kNumKeys * 2);
+  KATANA_LOG_ASSERT(stats.get_hit_count == kNumKeys * 2);
+  KATANA_LOG_ASSERT(stats.get_hit_bytes == kNumKeys * 10);
+  KATANA_LOG_ASSERT(shared.size() == static_cast<int64_t>(kNumKeys * 5));
+  KATANA_LOG_ASSERT(
+      shared.Reclaim(shared.size()) == static_cast<int64_t>(kNumKeys * 5));
+  KATANA_LOG_ASSERT(shared.empty());
+}
+
 int
 main(int argc, char** argv) {
   constexpr int64_t lru_size = 10;
@@ -236,5 +382,13 @@ main(int argc, char** argv) {
 
   TestLRUExplicit(keys);
 
+  TestExplicitAdmission(keys);
+
+  TestVictimBytes(keys);
+
+  TestFrequencyAdmission(keys);
+
+  TestSharded(keys);
+
   return 0;
 }
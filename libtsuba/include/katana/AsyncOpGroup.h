@@ -3,7 +3,9 @@
 
 #include <future>
 #include <list>
+#include <memory>
 
+#include "katana/IOExecutor.h"
 #include "katana/Result.h"
 
 namespace katana {
@@ -27,11 +29,16 @@ public:
   /// wait for the op at the head of the list, return true if there was one
   bool FinishOne();
 
+  /// Counters shared with the operations of this group that were submitted to
+  /// the IOExecutor
+  const std::shared_ptr<IOStats>& stats() const { return stats_; }
+
 private:
   std::list<AsyncOp> pending_ops_;
   uint64_t errors_{0};
   uint64_t total_{0};
   katana::CopyableErrorInfo last_error_;
+  std::shared_ptr<IOStats> stats_{std::make_shared<IOStats>()};
 };
 
 }  // namespace katana
@@ -0,0 +1,204 @@
+#ifndef KATANA_LIBTSUBA_KATANA_ENTITYINDEXPRIMITIVE_H_
+#define KATANA_LIBTSUBA_KATANA_ENTITYINDEXPRIMITIVE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "katana/ErrorCode.h"
+#include "katana/FileFrame.h"
+#include "katana/FileView.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+#include "katana/RDGOptionalDatastructure.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+#include "katana/file.h"
+
+namespace katana {
+
+const std::string kOptionalDatastructureEntityIndexPrimitive =
+    "kg.v1.entity_index";
+const std::string kOptionalDatastructureEntityIndexPrimitiveFilename =
+    "entity_index_manifest";
+const std::string kEntityIndexPrimitiveIDsFilename = "entity_index_ids";
+const std::string kEntityIndexPrimitiveKeysFilename = "entity_index_keys";
+
+/// EntityIndexPrimitive is the storage representation of a katana::EntityIndex:
+/// the ids of the indexed entities in index order and, for fixed width
+/// property types, the property value of each of those ids.
+///
+/// Load() only reads the json manifest; the id and key arrays are mapped into
+/// memory by Bind() so that indexes which are never queried cost nothing.
+class KATANA_EXPORT EntityIndexPrimitive
+    : private katana::RDGOptionalDatastructure {
+public:
+  /// The name an index over the given property is registered under in the
+  /// RDG's optional datastructures
+  static std::string ManifestName(
+      bool is_node_index, const std::string& property_name) {
+    return kOptionalDatastructureEntityIndexPrimitive +
+           (is_node_index ? ".node." : ".edge.") + property_name;
+  }
+
+  static katana::Result<EntityIndexPrimitive> Load(
+      const katana::URI& rdg_dir_path, const std::string& path) {
+    EntityIndexPrimitive index =
+        KATANA_CHECKED(LoadJson(rdg_dir_path.Join(path).string()));
+    index.rdg_dir_ = rdg_dir_path;
+    return index;
+  }
+
+  katana::Result<std::string> Write(katana::URI rdg_dir_path) {
+    // Write out the arrays, then our json manifest
+    if (num_keys_ > 0) {
+      katana::URI ids_path =
+          rdg_dir_path.RandFile(kEntityIndexPrimitiveIDsFilename);
+      KATANA_CHECKED(
+          katana::FileStore(ids_path.string(), ids_, num_keys_ * id_width_));
+      paths_[kEntityIndexPrimitiveIDsFilename] = ids_path.BaseName();
+
+      if (key_width_ > 0) {
+        katana::URI keys_path =
+            rdg_dir_path.RandFile(kEntityIndexPrimitiveKeysFilename);
+        KATANA_CHECKED(katana::FileStore(
+            keys_path.string(), keys_, num_keys_ * key_width_));
+        paths_[kEntityIndexPrimitiveKeysFilename] = keys_path.BaseName();
+      }
+    }
+
+    katana::URI manifest_path = rdg_dir_path.RandFile(
+        kOptionalDatastructureEntityIndexPrimitiveFilename);
+    KATANA_CHECKED(WriteManifest(manifest_path.string()));
+    return manifest_path.BaseName();
+  }
+
+  /// Map the id and key arrays of a loaded index into memory
+  katana::Result<void> Bind() {
+    if (num_keys_ == 0 || ids_file_) {
+      return katana::ResultSuccess();
+    }
+    ids_file_ = KATANA_CHECKED(
+        BindArray(kEntityIndexPrimitiveIDsFilename, num_keys_ * id_width_));
+    ids_ = ids_file_->ptr<void>();
+    if (key_width_ > 0) {
+      keys_file_ = KATANA_CHECKED(BindArray(
+          kEntityIndexPrimitiveKeysFilename, num_keys_ * key_width_));
+      keys_ = keys_file_->ptr<void>();
+    }
+    return katana::ResultSuccess();
+  }
+
+  const std::string& property_name() const { return property_name_; }
+  void set_property_name(const std::string& name) { property_name_ = name; }
+
+  bool is_node_index() const { return is_node_index_; }
+  void set_is_node_index(bool is_node_index) { is_node_index_ = is_node_index; }
+
+  /// Whether the ids are grouped by value hash rather than sorted by value
+  bool is_hash_index() const { return is_hash_index_; }
+  void set_is_hash_index(bool is_hash_index) { is_hash_index_ = is_hash_index; }
+
+  /// The number of nodes or edges in the graph when the index was built
+  uint64_t num_entities() const { return num_entities_; }
+  void set_num_entities(uint64_t num) { num_entities_ = num; }
+
+  /// The number of entries in the index, i.e., entities with a valid value
+  uint64_t num_keys() const { return num_keys_; }
+
+  uint64_t id_width() const { return id_width_; }
+
+  /// Zero for indexes that only store ids (e.g., over strings)
+  uint64_t key_width() const { return key_width_; }
+
+  const void* ids() const { return ids_; }
+  const void* keys() const { return keys_; }
+
+  /// Set the arrays to store. The caller must keep them alive until Write()
+  /// returns.
+  void set_ids(const void* ids, uint64_t num_keys, uint64_t id_width) {
+    ids_ = ids;
+    num_keys_ = num_keys;
+    id_width_ = id_width;
+  }
+  void set_keys(const void* keys, uint64_t key_width) {
+    keys_ = keys;
+    key_width_ = key_width;
+  }
+
+  friend void to_json(nlohmann::json& j, const EntityIndexPrimitive& index);
+  friend void from_json(const nlohmann::json& j, EntityIndexPrimitive& index);
+
+private:
+  std::string property_name_;
+  bool is_node_index_{true};
+  bool is_hash_index_{false};
+  uint64_t num_entities_{0};
+  uint64_t num_keys_{0};
+  uint64_t id_width_{0};
+  uint64_t key_width_{0};
+
+  /// not serialized
+  katana::URI rdg_dir_;
+  const void* ids_{nullptr};
+  const void* keys_{nullptr};
+  std::unique_ptr<katana::FileView> ids_file_;
+  std::unique_ptr<katana::FileView> keys_file_;
+
+  katana::Result<std::unique_ptr<katana::FileView>> BindArray(
+      const std::string& name, uint64_t expected_size) const {
+    auto it = paths_.find(name);
+    if (it == paths_.end()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "entity index over {} has no {} file", property_name_, name);
+    }
+    auto fv = std::make_unique<katana::FileView>();
+    KATANA_CHECKED(fv->Bind(rdg_dir_.Join(it->second).string(), true));
+    if (fv->size() != expected_size) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "entity index file {} has size {}, expected {}", it->second,
+          fv->size(), expected_size);
+    }
+    return fv;
+  }
+
+  static katana::Result<EntityIndexPrimitive> LoadJson(
+      const std::string& path) {
+    katana::FileView fv;
+    KATANA_CHECKED(fv.Bind(path, true));
+
+    if (fv.size() == 0) {
+      return EntityIndexPrimitive();
+    }
+
+    EntityIndexPrimitive index;
+    KATANA_CHECKED(katana::JsonParse<EntityIndexPrimitive>(fv, &index));
+
+    return index;
+  }
+
+  katana::Result<void> WriteManifest(const std::string& path) const {
+    std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
+    // POSIX files end with newlines
+    serialized = serialized + "\n";
+
+    auto ff = std::make_unique<katana::FileFrame>();
+    KATANA_CHECKED(ff->Init(serialized.size()));
+    if (auto res = ff->Write(serialized.data(), serialized.size()); !res.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(res.code()), "arrow error: {}", res);
+    }
+    ff->Bind(path);
+    // persist now
+    KATANA_CHECKED(ff->Persist());
+
+    return katana::ResultSuccess();
+  }
+};
+
+}  // namespace katana
+
+#endif
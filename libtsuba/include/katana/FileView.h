@@ -16,6 +16,16 @@ namespace katana {
 
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
 public:
+  /// How BindMapped brings the pages of a file into memory
+  enum class MapPolicy {
+    /// fault pages in on first access
+    kLazy,
+    /// start reading the whole file ahead asynchronously (MADV_WILLNEED)
+    kWillNeed,
+    /// read the whole file before BindMapped returns (MAP_POPULATE)
+    kPopulate,
+  };
+
   FileView() = default;
   FileView(const FileView&) = delete;
   FileView& operator=(const FileView&) = delete;
@@ -28,6 +38,7 @@ public:
         mem_start_(other.mem_start_),
         filename_(std::move(other.filename_)),
         bound_(other.bound_),
+        mapped_(other.mapped_),
         filling_(std::move(other.filling_)),
         fetches_(std::move(other.fetches_)) {
     other.bound_ = false;
@@ -45,6 +56,7 @@ public:
       mem_start_ = other.mem_start_;
       filename_ = std::move(other.filename_);
       bound_ = other.bound_;
+      mapped_ = other.mapped_;
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
@@ -75,10 +87,19 @@ public:
     return Bind(filename, 0, std::numeric_limits<uint64_t>::max(), resolve);
   }
 
+  /// Map a file on the local file system directly rather than reading it into
+  /// memory. The view then shares pages with the page cache and nothing is
+  /// copied; writes through the mapping are private to this process. Returns
+  /// NotImplemented for files that are not local.
+  katana::Result<void> BindMapped(std::string_view filename, MapPolicy policy);
+
   katana::Result<void> Fill(uint64_t begin, uint64_t end, bool resolve);
 
   bool Valid() const { return bound_; }
 
+  /// Whether the view maps the file itself (see BindMapped)
+  bool mapped() const { return mapped_; }
+
   katana::Result<void> Unbind();
 
   /// Be very careful with this function. It is the caller's responsibility to
@@ -169,6 +190,7 @@ private:
   int64_t mem_start_{0};
   std::string filename_;
   bool bound_{false};
+  bool mapped_{false};
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
 };
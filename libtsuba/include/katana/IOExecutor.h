@@ -0,0 +1,141 @@
+#ifndef KATANA_LIBTSUBA_KATANA_IOEXECUTOR_H_
+#define KATANA_LIBTSUBA_KATANA_IOEXECUTOR_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Queued operations with a lower priority value are started first
+enum class IOPriority : uint8_t {
+  kTopology = 0,
+  /// Storing data that has already been encoded in memory goes ahead of
+  /// starting new property work, which bounds how much is held in memory
+  kEncoded = 1,
+  kProperty = 2,
+};
+
+/// Counters for the operations of one ReadGroup or WriteGroup. Latencies are
+/// measured from submission to completion, so they include time spent queued,
+/// and are binned by powers of two milliseconds: bin 0 counts operations that
+/// took less than 1ms and bin i > 0 those that took [2^(i-1), 2^i) ms.
+class KATANA_EXPORT IOStats {
+public:
+  static constexpr size_t kNumLatencyBins = 16;
+
+  void RecordOp(std::chrono::steady_clock::duration latency);
+  void AddBytes(uint64_t bytes) { bytes_ += bytes; }
+  void AddCoalesced(uint64_t num_merged) { num_coalesced_ += num_merged; }
+
+  uint64_t num_ops() const { return num_ops_; }
+  uint64_t bytes() const { return bytes_; }
+  /// The number of requests that were merged into an adjacent request
+  uint64_t num_coalesced() const { return num_coalesced_; }
+  std::array<uint64_t, kNumLatencyBins> latency_histogram() const;
+
+  /// Log the counters to the active ProgressTracer span
+  void Report(const std::string& event) const;
+
+private:
+  std::atomic<uint64_t> num_ops_{0};
+  std::atomic<uint64_t> bytes_{0};
+  std::atomic<uint64_t> num_coalesced_{0};
+  std::array<std::atomic<uint64_t>, kNumLatencyBins> latency_bins_{};
+};
+
+/// IOExecutor runs the storage operations of ReadGroups and WriteGroups on a
+/// shared set of threads so that the number of operations in flight is
+/// bounded no matter how many files a graph has. The limit defaults to the
+/// number of cores (at least kMinInFlight, at most kMaxInFlight) and can be
+/// set with KATANA_IO_MAX_IN_FLIGHT or SetMaxInFlight.
+///
+/// Operations must not wait on other operations submitted to the executor.
+class KATANA_EXPORT IOExecutor {
+public:
+  static constexpr size_t kMinInFlight = 4;
+  static constexpr size_t kMaxInFlight = 64;
+
+  IOExecutor(const IOExecutor& no_copy) = delete;
+  IOExecutor(IOExecutor&& no_move) = delete;
+  IOExecutor& operator=(const IOExecutor& no_copy) = delete;
+  IOExecutor& operator=(IOExecutor&& no_move) = delete;
+  ~IOExecutor();
+
+  static IOExecutor& Get() {
+    static IOExecutor executor;
+    return executor;
+  }
+
+  size_t max_in_flight() const;
+  void SetMaxInFlight(size_t max_in_flight);
+
+  /// Queue op, which returns a CopyableResult, and return a future for its
+  /// result. If stats is given, the op is counted there when it finishes.
+  template <typename OpFn>
+  auto Submit(
+      IOPriority priority, OpFn op, std::shared_ptr<IOStats> stats = nullptr)
+      -> std::future<std::invoke_result_t<OpFn>> {
+    using RetType = std::invoke_result_t<OpFn>;
+    auto start = std::chrono::steady_clock::now();
+    auto task = std::make_shared<std::packaged_task<RetType()>>(
+        [op = std::move(op), stats = std::move(stats), start]() mutable {
+          RetType res = op();
+          if (stats) {
+            stats->RecordOp(std::chrono::steady_clock::now() - start);
+          }
+          return res;
+        });
+    auto future = task->get_future();
+    Enqueue(priority, [task]() { (*task)(); });
+    return future;
+  }
+
+private:
+  struct Work {
+    IOPriority priority;
+    uint64_t seq;
+    std::function<void()> fn;
+  };
+  /// Order by priority, then FIFO
+  struct WorkAfter {
+    bool operator()(const Work& a, const Work& b) const {
+      if (a.priority != b.priority) {
+        return a.priority > b.priority;
+      }
+      return a.seq > b.seq;
+    }
+  };
+
+  IOExecutor();
+
+  void Enqueue(IOPriority priority, std::function<void()> fn);
+  void WorkLoop();
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::priority_queue<Work, std::vector<Work>, WorkAfter> queue_;
+  std::vector<std::thread> threads_;
+  size_t max_in_flight_;
+  size_t active_{0};
+  uint64_t next_seq_{0};
+  bool stopping_{false};
+};
+
+}  // namespace katana
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef KATANA_LIBTSUBA_KATANA_PARQUETREADER_H_
 #define KATANA_LIBTSUBA_KATANA_PARQUETREADER_H_
 
+#include <functional>
 #include <optional>
+#include <vector>
 
 #include <arrow/api.h>
 
@@ -27,10 +29,27 @@ public:
     /// if true (default) make sure canonical types are used and table columns
     /// are not chunked
     bool make_canonical{true};
+    /// if true (default) decode the columns of a row group in parallel
+    bool use_threads{true};
+    /// if true, and make_canonical is true, read whole tables by decoding
+    /// record batches straight into one array per column that is allocated
+    /// up front, rather than reading chunked columns and combining them
+    /// afterwards. This roughly halves peak memory use for large columns.
+    bool preallocate_columns{false};
 
     static ReadOpts Defaults() { return ReadOpts{}; }
   };
 
+  /// Restrict a read to the row groups that may hold a value of a numeric
+  /// column in [min, max] according to the row group statistics. Row groups
+  /// without statistics for the column are always read, and the rows of the
+  /// row groups that are read are not filtered.
+  struct RowGroupFilter {
+    int32_t column;
+    double min;
+    double max;
+  };
+
   /// build a reader that will read a table from storage location optionally
   /// reading only part of the table.
   /// \param opts an opt structure detailing how reads should behave (see
@@ -57,12 +76,33 @@ public:
       const katana::URI& uri);
 
   /// read a column part of a table from storage
-  /// n.b. support for the `slice` read option is missing here
   ///   \param uri an identifier for a parquet file
   ///   \param column_idx must be a valid column index for the table in that
   ///      file
   katana::Result<std::shared_ptr<arrow::Table>> ReadColumn(
-      const katana::URI& uri, int32_t column_idx);
+      const katana::URI& uri, int32_t column_idx,
+      std::optional<Slice> slice = std::nullopt);
+
+  /// read some columns of the row groups of a table that pass every filter
+  ///   \param uri an identifier for a parquet file
+  ///   \param column_indexes the columns of the returned table
+  ///   \param filters see RowGroupFilter
+  katana::Result<std::shared_ptr<arrow::Table>> ReadFilteredTable(
+      const katana::URI& uri, const std::vector<int32_t>& column_indexes,
+      const std::vector<RowGroupFilter>& filters);
+
+  /// read a table from storage one record batch at a time rather than
+  /// materializing all of it; batches are passed to consume in order
+  ///   \param uri an identifier for a parquet file
+  ///   \param column_indexes if given, the columns of each batch
+  katana::Result<void> ReadBatches(
+      const katana::URI& uri,
+      const std::function<katana::Result<void>(
+          const std::shared_ptr<arrow::RecordBatch>&)>& consume);
+  katana::Result<void> ReadBatches(
+      const katana::URI& uri, const std::vector<int32_t>& column_indexes,
+      const std::function<katana::Result<void>(
+          const std::shared_ptr<arrow::RecordBatch>&)>& consume);
 
   /// Get the number of columns for the table stored in a parquet file
   ///   \param uri an identifier for a parquet file
@@ -77,7 +117,10 @@ public:
   katana::Result<std::vector<std::string>> GetFiles(const katana::URI& uri);
 
 private:
-  ParquetReader(bool make_canonical) : make_canonical_{make_canonical} {}
+  ParquetReader(bool make_canonical, bool use_threads, bool preallocate_columns)
+      : make_canonical_{make_canonical},
+        use_threads_{use_threads},
+        preallocate_columns_{preallocate_columns} {}
 
   katana::Result<std::shared_ptr<arrow::Table>> ReadFromUriSliced(
       const katana::URI& uri);
@@ -88,7 +131,14 @@ private:
   katana::Result<std::shared_ptr<arrow::Schema>> FixSchema(
       const std::shared_ptr<arrow::Schema>& schema);
 
+  katana::Result<std::shared_ptr<arrow::RecordBatch>> FixBatch(
+      const std::shared_ptr<arrow::RecordBatch>& batch);
+
+  static katana::Result<void> CheckSlice(const Slice& slice);
+
   bool make_canonical_;
+  bool use_threads_;
+  bool preallocate_columns_;
 };
 
 }  // namespace katana
@@ -2,9 +2,11 @@
 #define KATANA_LIBTSUBA_KATANA_PARQUETWRITER_H_
 
 #include <limits>
+#include <unordered_map>
 #include <vector>
 
 #include <arrow/api.h>
+#include <arrow/util/compression.h>
 #include <parquet/properties.h>
 
 #include "katana/Result.h"
@@ -31,6 +33,30 @@ public:
 
     /// control the approximate size of blocked files when writing blocked
     uint64_t mbs_per_block{256};
+
+    /// if true (default) encode and compress the columns of a file in
+    /// parallel. Files are always encoded in parallel with each other, and
+    /// each is stored as soon as it has been encoded.
+    bool use_threads{true};
+
+    /// codec for columns whose type is not in compression_by_type, e.g.,
+    /// arrow::Compression::ZSTD. Codecs must be available in this build of
+    /// arrow (see arrow::util::Codec::IsAvailable).
+    arrow::Compression::type default_compression{
+        arrow::Compression::UNCOMPRESSED};
+    /// codec per (top-level) column type, e.g., LZ4 for integers and ZSTD for
+    /// strings
+    std::unordered_map<arrow::Type::type, arrow::Compression::type>
+        compression_by_type;
+
+    /// if true (default) only dictionary encode columns that look like they
+    /// have few distinct values. A sample of each column is checked, and
+    /// columns with more than max_dictionary_ratio distinct values per value
+    /// are written plainly rather than building a dictionary that parquet
+    /// would give up on anyway.
+    bool auto_dictionary{true};
+    double max_dictionary_ratio{0.25};
+
     static WriteOpts Defaults() { return WriteOpts{}; }
   };
 
@@ -59,10 +85,16 @@ public:
 
 private:
   ParquetWriter(
-      std::vector<std::shared_ptr<arrow::Table>> tables, WriteOpts opts)
-      : tables_(std::move(tables)), opts_(opts) {}
+      std::vector<std::shared_ptr<arrow::Table>> tables, WriteOpts opts,
+      std::shared_ptr<parquet::WriterProperties> writer_props)
+      : tables_(std::move(tables)),
+        opts_(std::move(opts)),
+        writer_props_(std::move(writer_props)) {}
 
-  std::shared_ptr<parquet::WriterProperties> StandardWriterProperties();
+  /// Writer properties for table, with per column compression and dictionary
+  /// encoding chosen according to opts
+  static katana::Result<std::shared_ptr<parquet::WriterProperties>>
+  StandardWriterProperties(const arrow::Table& table, const WriteOpts& opts);
 
   std::shared_ptr<parquet::ArrowWriterProperties> StandardArrowProperties();
 
@@ -75,6 +107,7 @@ private:
 
   std::vector<std::shared_ptr<arrow::Table>> tables_;
   WriteOpts opts_;
+  std::shared_ptr<parquet::WriterProperties> writer_props_;
 };
 
 }  // namespace katana
@@ -6,12 +6,14 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/chunked_array.h>
 #include <nlohmann/json.hpp>
 
 #include "katana/Cache.h"
+#include "katana/EntityIndexPrimitive.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileFrame.h"
@@ -48,12 +50,24 @@ struct KATANA_EXPORT RDGLoadOptions {
   /// List of edge properties that should be loaded
   /// nullptr means all edge properties will be loaded
   std::optional<std::vector<std::string>> edge_properties{std::nullopt};
+  /// How to map the topology and entity type id files when they are on the
+  /// local file system; nullopt means they are read into memory. Mapped files
+  /// are used by the loaded graph without copying, so they must not be
+  /// modified while it is in use. Files that are not local are always read.
+  std::optional<FileView::MapPolicy> map_local_files{std::nullopt};
+  /// Whether PropertyGraph::Make places the topology blocked by node range
+  /// across NUMA nodes, see PropertyGraph::PartitionTopologyAcrossNUMANodes.
+  /// This copies the topology, so combine it with map_local_files to avoid
+  /// reading the topology into memory first.
+  bool partition_topology_across_numa_nodes{false};
 
   /// Build a default options struct the default behavior is:
   ///  * load the partition associated with this host
   ///  * load all node properties
   ///  * load all edge properties
   ///  * do not use a property cache
+  ///  * read topology and entity type id files into memory
+  ///  * do not partition the topology across NUMA nodes
   static RDGLoadOptions Defaults() { return RDGLoadOptions{}; }
 };
 
@@ -319,6 +333,26 @@ public:
 
   void set_view_name(const std::string& v) { view_type_ = v; }
 
+  /// Returns true if an index over the named property has been stored
+  bool HasEntityIndexPrimitive(
+      bool is_node_index, const std::string& property_name) const;
+
+  /// Returns the manifest of the stored index over the named property, or
+  /// std::nullopt if there is none. The index arrays are not read until
+  /// EntityIndexPrimitive::Bind() is called.
+  katana::Result<std::optional<katana::EntityIndexPrimitive>>
+  LoadEntityIndexPrimitive(
+      bool is_node_index, const std::string& property_name);
+
+  /// Queue an index to be written by the next Store(), into the location the
+  /// RDG is stored to. The arrays the index refers to must stay alive until
+  /// then.
+  void StageEntityIndexPrimitive(katana::EntityIndexPrimitive&& index);
+
+  /// Drop the stored index over the named property, if any
+  void RemoveEntityIndexPrimitive(
+      bool is_node_index, const std::string& property_name);
+
   // Returns katana::ResultErrno if the RDKLSHIndexPrimitive is not found on disk
   katana::Result<std::optional<katana::RDKLSHIndexPrimitive>>
   LoadRDKLSHIndexPrimitive();
@@ -335,6 +369,8 @@ public:
 
 private:
   std::string view_type_;
+  std::vector<katana::EntityIndexPrimitive> staged_entity_indexes_;
+  std::optional<FileView::MapPolicy> map_policy_;
   RDG(std::unique_ptr<RDGCore>&& core);
 
   void InitEmptyTables();
@@ -44,7 +44,12 @@ public:
     kInvalid = -1,
     kAny = 0,
     kSortedByDegree,
-    kSortedByNodeType
+    kSortedByNodeType,
+    // locality improving orders, see ShuffleTopology
+    kReverseCuthillMcKee,
+    kCommunity,
+    kHubSorted,
+    kHubClustered
   };
 
   enum class TopologyKind : int {
@@ -200,6 +205,11 @@ public:
   katana::Result<void> Bind(
       const katana::URI& metadata_dir, bool resolve = true);
 
+  /// Bind a topology file to the file_storage object by mapping the entire
+  /// local file rather than reading it (see FileView::BindMapped)
+  katana::Result<void> BindMapped(
+      const katana::URI& metadata_dir, FileView::MapPolicy policy);
+
   /// Bind a topology file to the file_storage object, bind specific offset
   katana::Result<void> Bind(
       const katana::URI& metadata_dir, uint64_t begin, uint64_t end,
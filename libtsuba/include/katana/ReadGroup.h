@@ -4,13 +4,15 @@
 #include <future>
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "katana/AsyncOpGroup.h"
+#include "katana/IOExecutor.h"
 #include "katana/Result.h"
 
 namespace katana {
 
-/// Track multiple, outstanding async writes and provide a mechanism to ensure
+/// Track multiple, outstanding async reads and provide a mechanism to ensure
 /// that they have all completed
 class KATANA_EXPORT ReadGroup {
 public:
@@ -55,8 +57,32 @@ public:
     AddOp(std::move(new_future), file, generic_complete_fn);
   }
 
+  /// Queue a read of \p size bytes at \p offset in \p file into \p buf.
+  /// Queued reads are started by StartRangeReads or Finish; reads of adjacent
+  /// ranges of the same file into adjacent memory are merged into a single
+  /// request.
+  void AddRangeRead(
+      const std::string& file, uint64_t offset, uint64_t size, uint8_t* buf,
+      IOPriority priority = IOPriority::kProperty);
+
+  /// Start all queued range reads
+  void StartRangeReads();
+
+  const std::shared_ptr<IOStats>& stats() const {
+    return async_op_group_.stats();
+  }
+
 private:
+  struct RangeRead {
+    std::string file;
+    uint64_t offset;
+    uint64_t size;
+    uint8_t* buf;
+    IOPriority priority;
+  };
+
   AsyncOpGroup async_op_group_;
+  std::vector<RangeRead> range_reads_;
 };
 
 }  // namespace katana
@@ -7,6 +7,7 @@
 
 #include "katana/AsyncOpGroup.h"
 #include "katana/FileFrame.h"
+#include "katana/IOExecutor.h"
 #include "katana/Result.h"
 #include "katana/file.h"
 
@@ -41,13 +42,20 @@ public:
   katana::Result<void> Finish();
 
   /// Start async store op, we hold onto the data until op finishes
-  void StartStore(std::shared_ptr<FileFrame> ff);
+  void StartStore(
+      std::shared_ptr<FileFrame> ff,
+      IOPriority priority = IOPriority::kProperty);
 
   /// Start async store op, caller responsible for keeping buffer live
   void StartStore(const std::string& file, const uint8_t* buf, uint64_t size) {
+    stats()->AddBytes(size);
     AddOp(FileStoreAsync(file, buf, size), file);
   }
 
+  const std::shared_ptr<IOStats>& stats() const {
+    return async_op_group_.stats();
+  }
+
   void AddToOutstanding(uint64_t size) { outstanding_size_ += size; }
 
   /// Add future to the list of futures this descriptor will wait for, note
@@ -9,6 +9,7 @@
 #include "katana/ArrowInterchange.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileView.h"
+#include "katana/IOExecutor.h"
 #include "katana/Logging.h"
 #include "katana/MemorySupervisor.h"
 #include "katana/ParquetReader.h"
@@ -118,16 +119,24 @@ katana::AddProperties(
                                              });
     const katana::URI& path = uri.Join(prop->path());
 
+    std::shared_ptr<IOStats> stats = grp ? grp->stats() : nullptr;
     std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
-        std::async(
-            std::launch::async,
-            [prop,
-             path]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
-              return KATANA_CHECKED_CONTEXT(
-                  LoadProperties(prop->name(), path), "error loading {}", path);
-            });
-    auto on_complete = [add_fn, is_property,
-                        prop](const std::shared_ptr<arrow::Table>& props)
+        IOExecutor::Get().Submit(
+            IOPriority::kProperty,
+            [prop, path,
+             stats]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+              std::shared_ptr<arrow::Table> load_result =
+                  KATANA_CHECKED_CONTEXT(
+                      LoadProperties(prop->name(), path), "error loading {}",
+                      path);
+              if (stats) {
+                stats->AddBytes(katana::ApproxTableMemUse(load_result));
+              }
+              return load_result;
+            },
+            stats);
+    auto on_complete = [add_fn, is_property, prop,
+                        path](const std::shared_ptr<arrow::Table>& props)
         -> katana::CopyableResult<void> {
       KATANA_CHECKED_CONTEXT(
           add_fn(props), "adding {}", std::quoted(prop->name()));
@@ -135,7 +144,7 @@ katana::AddProperties(
       PropertyManager* pm =
           katana::MemorySupervisor::Get().GetPropertyManager();
       if (is_property) {
-        pm->PropertyLoadedActive(props);
+        pm->PropertyLoadedActive(path, props);
       } else {
         katana::GetTracer().GetActiveSpan().Log(
             "addproperties property cache callback non-property",
@@ -176,17 +185,22 @@ katana::AddPropertySlice(
     }
     const katana::URI& path = dir.Join(prop->path());
 
+    std::shared_ptr<IOStats> stats = grp ? grp->stats() : nullptr;
     std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
-        std::async(
-            std::launch::async,
-            [path, prop, begin,
-             size]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
+        IOExecutor::Get().Submit(
+            IOPriority::kProperty,
+            [path, prop, begin, size,
+             stats]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
               std::shared_ptr<arrow::Table> load_result =
                   KATANA_CHECKED_CONTEXT(
                       LoadPropertySlice(prop->name(), path, begin, size),
                       "error loading {}", path);
+              if (stats) {
+                stats->AddBytes(katana::ApproxTableMemUse(load_result));
+              }
               return load_result;
-            });
+            },
+            stats);
     auto on_complete = [add_fn,
                         prop](const std::shared_ptr<arrow::Table>& props)
         -> katana::CopyableResult<void> {
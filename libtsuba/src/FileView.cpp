@@ -1,6 +1,8 @@
 #include "katana/FileView.h"
 
+#include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <cassert>
@@ -10,6 +12,7 @@
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
+#include "katana/URI.h"
 #include "katana/file.h"
 
 /*
@@ -58,6 +61,7 @@ katana::FileView::Unbind() {
     KATANA_LOG_DEBUG_ASSERT(fetches_->empty());
 
     bound_ = false;
+    mapped_ = false;
   }
   return katana::ResultSuccess();
 }
@@ -113,6 +117,66 @@ katana::FileView::Bind(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::FileView::BindMapped(std::string_view filename, MapPolicy policy) {
+  katana::URI uri = KATANA_CHECKED(katana::URI::Make(std::string(filename)));
+  if (uri.scheme() != "file") {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented, "only local files can be mapped: {}",
+        filename);
+  }
+
+  int fd = open(uri.path().c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", uri.path());
+  }
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) != 0) {
+    auto err = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(err, "stat {}", uri.path());
+  }
+  uint64_t size = stat_buf.st_size;
+
+  void* tmp = nullptr;
+  if (size > 0) {
+    // PROT_WRITE with MAP_PRIVATE gives callers that modify the data their own
+    // copy of the affected pages and leaves the file untouched
+    int flags = MAP_PRIVATE;
+    if (policy == MapPolicy::kPopulate) {
+      flags |= MAP_POPULATE;
+    }
+    tmp = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (tmp == MAP_FAILED) {
+      auto err = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(err, "mapping {} ({} bytes)", uri.path(), size);
+    }
+    if (policy == MapPolicy::kWillNeed) {
+      if (madvise(tmp, size, MADV_WILLNEED) != 0) {
+        KATANA_LOG_DEBUG(
+            "madvise {}: {}", uri.path(), katana::ResultErrno().message());
+      }
+    }
+  }
+  close(fd);
+
+  KATANA_CHECKED(Unbind());
+
+  page_shift_ = 20; /* 1M */
+  map_start_ = static_cast<uint8_t*>(tmp);
+  mem_start_ = 0;
+  filename_ = filename;
+  file_size_ = size;
+  // Every page is backed by the file, so there is never anything to fetch
+  filling_.assign(page_number(size) / 64 + 1, ~UINT64_C(0));
+  fetches_ = std::make_unique<std::vector<FillingRange>>();
+  cursor_ = 0;
+  bound_ = true;
+  mapped_ = true;
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   uint64_t in_end = std::min<uint64_t>(end, file_size_);
@@ -0,0 +1,120 @@
+#include "katana/IOExecutor.h"
+
+#include <algorithm>
+
+#include "katana/Env.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Strings.h"
+
+void
+katana::IOStats::RecordOp(std::chrono::steady_clock::duration latency) {
+  uint64_t ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(latency).count();
+  size_t bin = 0;
+  if (ms > 0) {
+    bin = std::min<size_t>(64 - __builtin_clzll(ms), kNumLatencyBins - 1);
+  }
+  latency_bins_[bin] += 1;
+  num_ops_ += 1;
+}
+
+std::array<uint64_t, katana::IOStats::kNumLatencyBins>
+katana::IOStats::latency_histogram() const {
+  std::array<uint64_t, kNumLatencyBins> hist{};
+  for (size_t i = 0; i < kNumLatencyBins; ++i) {
+    hist[i] = latency_bins_[i];
+  }
+  return hist;
+}
+
+void
+katana::IOStats::Report(const std::string& event) const {
+  auto hist = latency_histogram();
+  katana::GetTracer().GetActiveSpan().Log(
+      event, {
+                 {"ops", num_ops()},
+                 {"bytes", bytes()},
+                 {"coalesced", num_coalesced()},
+                 {"latency_ms_log2_histogram",
+                  katana::Join(hist.begin(), hist.end(), " ")},
+             });
+}
+
+katana::IOExecutor::IOExecutor() {
+  int max_in_flight = 0;
+  if (katana::GetEnv("KATANA_IO_MAX_IN_FLIGHT", &max_in_flight) &&
+      max_in_flight > 0) {
+    max_in_flight_ = max_in_flight;
+  } else {
+    max_in_flight_ = std::clamp<size_t>(
+        std::thread::hardware_concurrency(), kMinInFlight, kMaxInFlight);
+  }
+}
+
+katana::IOExecutor::~IOExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+size_t
+katana::IOExecutor::max_in_flight() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_in_flight_;
+}
+
+void
+katana::IOExecutor::SetMaxInFlight(size_t max_in_flight) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_in_flight_ = std::max<size_t>(max_in_flight, 1);
+  }
+  cv_.notify_all();
+}
+
+void
+katana::IOExecutor::Enqueue(IOPriority priority, std::function<void()> fn) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push(Work{
+        .priority = priority,
+        .seq = next_seq_++,
+        .fn = std::move(fn),
+    });
+    // Threads are started on demand; all of them may be needed at once if the
+    // limit is raised later
+    if (threads_.size() < std::min(active_ + queue_.size(), max_in_flight_)) {
+      threads_.emplace_back([this]() { WorkLoop(); });
+    }
+  }
+  cv_.notify_one();
+}
+
+void
+katana::IOExecutor::WorkLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    cv_.wait(lock, [this]() {
+      return stopping_ || (!queue_.empty() && active_ < max_in_flight_);
+    });
+    if (queue_.empty()) {
+      return;
+    }
+    Work work = queue_.top();
+    queue_.pop();
+    ++active_;
+
+    lock.unlock();
+    work.fn();
+    lock.lock();
+
+    --active_;
+    // a queued op may have been held back by the limit
+    cv_.notify_one();
+  }
+}
@@ -7,7 +7,9 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <iterator>
 #include <system_error>
 
@@ -15,6 +17,7 @@
 #include <boost/system/error_code.hpp>
 
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -47,6 +50,49 @@ GetPath(const std::string& uri) {
   return u.path();
 }
 
+int
+NumIOThreads() {
+  int num_threads = 0;
+  if (katana::GetEnv("KATANA_LOCAL_IO_THREADS", &num_threads) &&
+      num_threads > 0) {
+    return num_threads;
+  }
+  return std::clamp<int>(
+      std::thread::hardware_concurrency(), 1,
+      katana::LocalStorage::kMaxIOThreads);
+}
+
+/// O_DIRECT requires the buffer, offset and length to be block aligned; only
+/// bother for reads large enough to benefit from skipping the page cache
+bool
+UseDirectIO(uint64_t start, uint64_t size, const uint8_t* data) {
+  return size >= katana::LocalStorage::kDirectIOMinSize &&
+         (start & katana::kBlockOffsetMask) == 0 &&
+         (size & katana::kBlockOffsetMask) == 0 &&
+         (reinterpret_cast<uintptr_t>(data) & katana::kBlockOffsetMask) == 0;
+}
+
+/// Read until size bytes have been read or the end of the file. The number of
+/// bytes read so far is kept in done so that a failed read can be resumed.
+katana::Result<void>
+PreadFully(
+    int fd, uint64_t start, uint64_t size, uint8_t* data, uint64_t* done) {
+  while (*done < size) {
+    ssize_t ret = pread(fd, data + *done, size - *done, start + *done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return katana::ResultErrno();
+    }
+    if (ret == 0) {
+      break;
+    }
+    *done += ret;
+  }
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -55,14 +101,28 @@ katana::LocalStorage::WriteFile(
   std::string path = KATANA_CHECKED(GetPath(uri));
   KATANA_CHECKED(EnsureDirectories(path));
 
-  std::ofstream ofile(path);
-  if (!ofile.good()) {
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
     return KATANA_ERROR(
         ErrorCode::LocalStorageError, "opening file: {}", strerror(errno));
   }
-  ofile.write(reinterpret_cast<const char*>(data), size); /* NOLINT */
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "writing file");
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t ret = pwrite(fd, data + done, size - done, done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::error_code ec = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "writing file: {}", ec.message());
+    }
+    done += ret;
+  }
+  if (close(fd) != 0) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "closing file: {}", strerror(errno));
   }
   return katana::ResultSuccess();
 }
@@ -99,32 +159,110 @@ katana::Result<void>
 katana::LocalStorage::ReadFile(
     const std::string& uri, uint64_t start, uint64_t size, uint8_t* data) {
   std::string path = KATANA_CHECKED(GetPath(uri));
-  std::ifstream ifile(path, std::ios_base::binary);
-  if (!ifile) {
-    return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to open source file {}",
-        std::quoted(path));
+  bool direct = UseDirectIO(start, size, data);
+  int fd = -1;
+  if (direct) {
+    // not every file system supports O_DIRECT (e.g., tmpfs)
+    fd = open(path.c_str(), O_RDONLY | O_DIRECT);
+    direct = fd >= 0;
   }
-
-  ifile.seekg(start);
-  if (!ifile) {
+  if (fd < 0) {
+    fd = open(path.c_str(), O_RDONLY);
+  }
+  if (fd < 0) {
     return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to seek to offset {}", start);
+        ErrorCode::LocalStorageError, "failed to open source file {}: {}",
+        std::quoted(path), strerror(errno));
   }
 
-  ifile.read(reinterpret_cast<char*>(data), size); /* NOLINT */
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to read");
+  uint64_t done = 0;
+  auto read_res = PreadFully(fd, start, size, data, &done);
+  if (!read_res && direct &&
+      read_res.error().error_code() == std::errc::invalid_argument) {
+    // a short direct read left us unaligned; finish through the page cache
+    close(fd);
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "failed to reopen source file {}: {}",
+          std::quoted(path), strerror(errno));
+    }
+    read_res = PreadFully(fd, start, size, data, &done);
+  }
+  close(fd);
+  if (!read_res) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "failed to read at offset {}: {}",
+        start + done, read_res.error());
   }
 
   // if the difference in what was read from what we wanted is less  than a
   // block it's because the file size isn't well aligned so don't complain.
-  if (size - ifile.gcount() > kBlockSize) {
+  if (size - done > kBlockSize) {
     return ErrorCode::LocalStorageError;
   }
   return katana::ResultSuccess();
 }
 
+std::future<katana::CopyableResult<void>>
+katana::LocalStorage::SubmitIO(std::function<katana::Result<void>()> op) {
+  IOTask task([op = std::move(op)]() -> katana::CopyableResult<void> {
+    if (auto res = op(); !res) {
+      katana::CopyableErrorInfo cei{res.error()};
+      return cei;
+    }
+    return katana::CopyableResultSuccess();
+  });
+  auto future = task.get_future();
+  {
+    std::lock_guard<std::mutex> lock(io_mutex_);
+    // while stopping, the exiting threads still drain the queue
+    if (io_threads_.empty() && !io_stopping_) {
+      int num_threads = NumIOThreads();
+      for (int i = 0; i < num_threads; ++i) {
+        io_threads_.emplace_back([this]() { IOLoop(); });
+      }
+    }
+    io_queue_.emplace_back(std::move(task));
+  }
+  io_cv_.notify_one();
+  return future;
+}
+
+void
+katana::LocalStorage::IOLoop() {
+  for (;;) {
+    IOTask task;
+    {
+      std::unique_lock<std::mutex> lock(io_mutex_);
+      io_cv_.wait(
+          lock, [this]() { return io_stopping_ || !io_queue_.empty(); });
+      if (io_queue_.empty()) {
+        return;
+      }
+      task = std::move(io_queue_.front());
+      io_queue_.pop_front();
+    }
+    task();
+  }
+}
+
+void
+katana::LocalStorage::StopIOThreads() {
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lock(io_mutex_);
+    io_stopping_ = true;
+    threads.swap(io_threads_);
+  }
+  io_cv_.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::lock_guard<std::mutex> lock(io_mutex_);
+  io_stopping_ = false;
+}
+
 katana::Result<void>
 katana::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
   std::string path = KATANA_CHECKED(GetPath(uri));
@@ -3,19 +3,39 @@
 
 #include <sys/mman.h>
 
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <future>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "katana/FileStorage.h"
 #include "katana/Result.h"
 
 namespace katana {
 
-/// Store byte arrays to the local file system; Provided as a convenience for
-/// testing only (un-optimized)
+/// Store byte arrays to the local file system
+///
+/// Files are read and written with pread/pwrite. Asynchronous gets and puts
+/// are queued to a bounded pool of I/O threads (KATANA_LOCAL_IO_THREADS,
+/// default: the number of cores up to kMaxIOThreads) that is started on first
+/// use, so many outstanding property file reads keep a fast device busy
+/// without creating a thread per request. Large block aligned reads, e.g., of
+/// topology files, bypass the page cache with O_DIRECT where the file system
+/// supports it.
 class LocalStorage : public FileStorage {
+  using IOTask = std::packaged_task<katana::CopyableResult<void>()>;
+
+  std::mutex io_mutex_;
+  std::condition_variable io_cv_;
+  std::deque<IOTask> io_queue_;
+  std::vector<std::thread> io_threads_;
+  bool io_stopping_{false};
+
   katana::Result<void> WriteFile(
       const std::string&, const uint8_t* data, uint64_t size);
   katana::Result<void> ReadFile(
@@ -24,11 +44,26 @@ class LocalStorage : public FileStorage {
       const std::string& source_uri, const std::string& dest_uri,
       uint64_t begin, uint64_t size);
 
+  /// Queue an operation to the I/O threads, starting them if needed
+  std::future<katana::CopyableResult<void>> SubmitIO(
+      std::function<katana::Result<void>()> op);
+  void IOLoop();
+  void StopIOThreads();
+
 public:
+  /// Upper bound on the default number of I/O threads
+  static constexpr int kMaxIOThreads = 16;
+  /// Reads at least this large are candidates for O_DIRECT
+  static constexpr uint64_t kDirectIOMinSize = UINT64_C(8) << 20; /* 8M */
+
   LocalStorage() : FileStorage("file://") {}
+  ~LocalStorage() override { StopIOThreads(); }
 
   katana::Result<void> Init() override { return katana::ResultSuccess(); }
-  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+  katana::Result<void> Fini() override {
+    StopIOThreads();
+    return katana::ResultSuccess();
+  }
   katana::Result<void> Stat(const std::string& uri, StatBuf* s_buf) override;
 
   uint32_t Priority() const override { return 1; }
@@ -53,32 +88,16 @@ public:
   // get on future can potentially block (bulk synchronous parallel)
   std::future<katana::CopyableResult<void>> PutAsync(
       const std::string& uri, const uint8_t* data, uint64_t size) override {
-    // No need for AsyncPut to local storage right now
-    if (auto write_res = WriteFile(uri, data, size); !write_res) {
-      katana::CopyableErrorInfo cei{write_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
+    return SubmitIO([this, uri, data, size]() {
+      return WriteFile(uri, data, size);
+    });
   }
   std::future<katana::CopyableResult<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
       uint8_t* result_buf) override {
-    // I suppose there is no need for AsyncGet to local storage either
-    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
-      katana::CopyableErrorInfo cei{read_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
+    return SubmitIO([this, uri, start, size, result_buf]() {
+      return ReadFile(uri, start, size, result_buf);
+    });
   }
   std::future<katana::CopyableResult<void>> ListAsync(
       const std::string& uri, std::vector<std::string>* list,
@@ -1,15 +1,23 @@
 #include "katana/ParquetReader.h"
 
+#include <algorithm>
+#include <functional>
 #include <limits>
 #include <memory>
-#include <unordered_map>
+#include <numeric>
+#include <optional>
 
 #include <arrow/array/util.h>
+#include <arrow/builder.h>
 #include <arrow/chunked_array.h>
 #include <arrow/compute/cast.h>
 #include <arrow/type.h>
 #include <arrow/type_fwd.h>
+#include <arrow/type_traits.h>
+#include <parquet/arrow/reader.h>
 #include <parquet/arrow/schema.h>
+#include <parquet/metadata.h>
+#include <parquet/statistics.h>
 
 #include "katana/ErrorCode.h"
 #include "katana/FileView.h"
@@ -22,6 +30,9 @@ using ErrorCode = katana::ErrorCode;
 
 namespace {
 
+using BatchFn = std::function<katana::Result<void>(
+    const std::shared_ptr<arrow::RecordBatch>&)>;
+
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 HandleBadParquetTypes(std::shared_ptr<arrow::ChunkedArray> old_array) {
   switch (old_array->type()->id()) {
@@ -51,6 +62,10 @@ HandleBadParquetTypes(std::shared_ptr<arrow::Field> old_field) {
     return std::make_shared<arrow::Field>(
         old_field->name(), arrow::large_utf8());
   }
+  case arrow::Type::type::BINARY: {
+    return std::make_shared<arrow::Field>(
+        old_field->name(), arrow::large_binary());
+  }
   default:
     return old_field;
   }
@@ -58,7 +73,7 @@ HandleBadParquetTypes(std::shared_ptr<arrow::Field> old_field) {
 
 Result<std::unique_ptr<parquet::arrow::FileReader>>
 BuildReader(
-    const std::string& uri, bool preload,
+    const std::string& uri, bool preload, bool use_threads,
     std::shared_ptr<katana::FileView>* fv) {
   auto fv_tmp = std::make_shared<katana::FileView>();
   uint64_t end = preload ? std::numeric_limits<uint64_t>::max() : 0;
@@ -70,14 +85,52 @@ BuildReader(
   std::unique_ptr<parquet::arrow::FileReader> reader;
   KATANA_CHECKED(
       parquet::arrow::OpenFile(fv_tmp, arrow::default_memory_pool(), &reader));
+  // Decode columns in parallel. This uses arrow's CPU pool rather than the
+  // Katana thread pool because reads are issued from IOExecutor threads, and
+  // the Katana thread pool only supports one caller at a time.
+  reader->set_use_threads(use_threads);
 
   return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
 }
 
+/// Fetch only the column chunks of the given columns in the given row groups
+Result<void>
+FillColumnChunks(
+    parquet::arrow::FileReader* reader, katana::FileView* fv,
+    const std::vector<int>& row_groups, const std::vector<int>& columns) {
+  auto md = reader->parquet_reader()->metadata();
+  for (int rg : row_groups) {
+    auto rg_md = md->RowGroup(rg);
+    for (int col : columns) {
+      auto col_md = rg_md->ColumnChunk(col);
+      int64_t begin = col_md->has_dictionary_page()
+                          ? col_md->dictionary_page_offset()
+                          : col_md->data_page_offset();
+      KATANA_CHECKED(
+          fv->Fill(begin, begin + col_md->total_compressed_size(), false));
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+/// Read the given row groups, and only the given columns if there are any
+Result<std::shared_ptr<arrow::Table>>
+ReadRowGroups(
+    parquet::arrow::FileReader* reader, const std::vector<int>& row_groups,
+    const std::optional<std::vector<int>>& columns) {
+  std::shared_ptr<arrow::Table> out;
+  if (columns) {
+    KATANA_CHECKED(reader->ReadRowGroups(row_groups, *columns, &out));
+  } else {
+    KATANA_CHECKED(reader->ReadRowGroups(row_groups, &out));
+  }
+  return out;
+}
+
 Result<std::shared_ptr<arrow::Table>>
 ReadTableSlice(
     parquet::arrow::FileReader* reader, katana::FileView* fv, int64_t first_row,
-    int64_t last_row) {
+    int64_t last_row, const std::optional<std::vector<int>>& columns) {
   std::vector<int> row_groups;
   int rg_count = reader->num_row_groups();
   int64_t row_offset = 0;
@@ -100,15 +153,123 @@ ReadTableSlice(
     cumulative_bytes += new_bytes;
   }
 
-  if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
+  if (columns) {
+    KATANA_CHECKED(FillColumnChunks(reader, fv, row_groups, *columns));
+  } else if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
     return res.error();
   }
 
-  std::shared_ptr<arrow::Table> out;
-  KATANA_CHECKED(reader->ReadRowGroups(row_groups, &out));
+  std::shared_ptr<arrow::Table> out =
+      KATANA_CHECKED(ReadRowGroups(reader, row_groups, columns));
   return out->Slice(row_offset, last_row - first_row);
 }
 
+/// Return false if the statistics of the row group show that none of its
+/// values of filter.column are in [filter.min, filter.max]
+bool
+MayMatch(
+    const parquet::RowGroupMetaData& rg_md,
+    const katana::ParquetReader::RowGroupFilter& filter) {
+  auto col_md = rg_md.ColumnChunk(filter.column);
+  if (!col_md->is_stats_set()) {
+    return true;
+  }
+  std::shared_ptr<parquet::Statistics> stats = col_md->statistics();
+  if (!stats || !stats->HasMinMax()) {
+    return true;
+  }
+  // unsigned integers are stored in signed physical types
+  bool is_unsigned =
+      stats->descr()->sort_order() == parquet::SortOrder::UNSIGNED;
+  double min = 0;
+  double max = 0;
+  switch (stats->physical_type()) {
+  case parquet::Type::INT32: {
+    auto typed = std::static_pointer_cast<parquet::Int32Statistics>(stats);
+    if (is_unsigned) {
+      min = static_cast<uint32_t>(typed->min());
+      max = static_cast<uint32_t>(typed->max());
+    } else {
+      min = typed->min();
+      max = typed->max();
+    }
+    break;
+  }
+  case parquet::Type::INT64: {
+    auto typed = std::static_pointer_cast<parquet::Int64Statistics>(stats);
+    if (is_unsigned) {
+      min = static_cast<uint64_t>(typed->min());
+      max = static_cast<uint64_t>(typed->max());
+    } else {
+      min = typed->min();
+      max = typed->max();
+    }
+    break;
+  }
+  case parquet::Type::FLOAT: {
+    auto typed = std::static_pointer_cast<parquet::FloatStatistics>(stats);
+    min = typed->min();
+    max = typed->max();
+    break;
+  }
+  case parquet::Type::DOUBLE: {
+    auto typed = std::static_pointer_cast<parquet::DoubleStatistics>(stats);
+    min = typed->min();
+    max = typed->max();
+    break;
+  }
+  default:
+    return true;
+  }
+  return !(max < filter.min || min > filter.max);
+}
+
+/// Parquet reads each column once and in file order; the columns asked
+/// for may repeat or come in any order. Returns the distinct sorted columns
+/// to read and, for each requested column, its position among them.
+std::pair<std::vector<int>, std::vector<int>>
+PlanColumns(const std::vector<int32_t>& requested) {
+  std::vector<int> distinct(requested.begin(), requested.end());
+  std::sort(distinct.begin(), distinct.end());
+  distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+  std::vector<int> positions;
+  positions.reserve(requested.size());
+  for (int32_t col : requested) {
+    positions.emplace_back(
+        std::lower_bound(distinct.begin(), distinct.end(), col) -
+        distinct.begin());
+  }
+  return std::make_pair(std::move(distinct), std::move(positions));
+}
+
+std::shared_ptr<arrow::Table>
+ArrangeColumns(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<int>& positions) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int pos : positions) {
+    fields.emplace_back(table->field(pos));
+    columns.emplace_back(table->column(pos));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns, table->num_rows());
+}
+
+std::shared_ptr<arrow::RecordBatch>
+ArrangeColumns(
+    const std::shared_ptr<arrow::RecordBatch>& batch,
+    const std::vector<int>& positions) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (int pos : positions) {
+    fields.emplace_back(batch->schema()->field(pos));
+    columns.emplace_back(batch->column(pos));
+  }
+  return arrow::RecordBatch::Make(
+      arrow::schema(fields), batch->num_rows(), columns);
+}
+
 class BlockedParquetReader {
 public:
   /// Read a potentially blocked Parquet file at the provide uri
@@ -130,9 +291,9 @@ public:
   /// "s3://example_file/table.parquet.part_000000000" and rows 10-end are
   /// in "s3://example_file/table.parquet.part_000000001"
   static Result<std::unique_ptr<BlockedParquetReader>> Make(
-      const katana::URI& uri, bool preload) {
+      const katana::URI& uri, bool preload, bool use_threads) {
     std::shared_ptr<katana::FileView> fv;
-    auto builder_res = BuildReader(uri.string(), preload, &fv);
+    auto builder_res = BuildReader(uri.string(), preload, use_threads, &fv);
 
     if (builder_res) {
       std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers;
@@ -141,7 +302,7 @@ public:
       fvs.emplace_back(std::move(fv));
 
       return std::unique_ptr<BlockedParquetReader>(new BlockedParquetReader(
-          uri.string(), std::move(fvs), std::move(readers), {0}));
+          uri.string(), std::move(fvs), std::move(readers), {0}, use_threads));
     }
 
     if (builder_res.error() != katana::ErrorCode::InvalidArgument) {
@@ -169,7 +330,7 @@ public:
 
     std::unique_ptr<BlockedParquetReader> bpr(new BlockedParquetReader(
         uri.string(), std::move(fvs), std::move(readers),
-        std::move(row_offsets)));
+        std::move(row_offsets), use_threads));
 
     if (preload) {
       for (size_t i = 0, num_files = bpr->row_offsets_.size(); i < num_files;
@@ -200,14 +361,60 @@ public:
     return schema;
   }
 
+  /// The arrow schema of the table, restricted to columns if given
+  Result<std::shared_ptr<arrow::Schema>> ArrowSchema(
+      const std::optional<std::vector<int>>& columns) {
+    KATANA_CHECKED(EnsureReader(0));
+    std::shared_ptr<arrow::Schema> schema;
+    KATANA_CHECKED(readers_[0]->GetSchema(&schema));
+    if (!columns) {
+      return schema;
+    }
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    for (int col : *columns) {
+      fields.emplace_back(schema->field(col));
+    }
+    return arrow::schema(fields);
+  }
+
+  /// Check that every index in col_indexes names a column
+  Result<void> ValidateColumns(const std::vector<int32_t>& col_indexes) {
+    int32_t num_columns = KATANA_CHECKED(NumColumns());
+    for (int32_t idx : col_indexes) {
+      if (idx < 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "column indexes must be positive");
+      }
+      if (idx >= num_columns) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "column index {} should be less than the number of columns {}",
+            idx, num_columns);
+      }
+    }
+    return katana::ResultSuccess();
+  }
+
+  /// Read the rows in slice (all rows if not given) of the columns in
+  /// columns (all columns if not given). columns must be distinct and
+  /// sorted.
   Result<std::shared_ptr<arrow::Table>> ReadTable(
-      std::optional<katana::ParquetReader::Slice> slice = std::nullopt) {
+      const std::optional<std::vector<int>>& columns,
+      std::optional<katana::ParquetReader::Slice> slice) {
     if (!slice) {
       std::vector<std::shared_ptr<arrow::Table>> tables;
       for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
-        KATANA_CHECKED(EnsureReader(i, true));
+        KATANA_CHECKED(EnsureReader(i, !columns));
         std::shared_ptr<arrow::Table> table;
-        KATANA_CHECKED(readers_[i]->ReadTable(&table));
+        if (columns) {
+          std::vector<int> row_groups(readers_[i]->num_row_groups());
+          std::iota(row_groups.begin(), row_groups.end(), 0);
+          KATANA_CHECKED(FillColumnChunks(
+              readers_[i].get(), fvs_[i].get(), row_groups, *columns));
+          KATANA_CHECKED(readers_[i]->ReadTable(*columns, &table));
+        } else {
+          KATANA_CHECKED(readers_[i]->ReadTable(&table));
+        }
         tables.emplace_back(std::move(table));
       }
       return KATANA_CHECKED(arrow::ConcatenateTables(tables));
@@ -239,7 +446,7 @@ public:
                                           : row_offsets_[idx + 1]);
       std::shared_ptr<arrow::Table> table;
       if (curr_global_row == table_offset &&
-          last_global_row >= next_table_offset) {
+          last_global_row >= next_table_offset && !columns) {
         KATANA_CHECKED(EnsureReader(idx, true));
         KATANA_CHECKED(readers_[idx]->ReadTable(&table));
       } else {
@@ -249,72 +456,95 @@ public:
             curr_global_row - table_offset,
             std::min(
                 next_table_offset - table_offset,
-                last_global_row - table_offset)));
+                last_global_row - table_offset),
+            columns));
       }
       tables.emplace_back(std::move(table));
       curr_global_row = next_table_offset;
     }
 
     if (tables.empty()) {
-      KATANA_CHECKED(EnsureReader(0, false));
-      std::shared_ptr<arrow::Schema> schema;
-      KATANA_CHECKED(readers_[idx]->GetSchema(&schema));
-
-      std::vector<std::shared_ptr<arrow::ChunkedArray>> cols;
-      for (const auto& field : schema->fields()) {
-        cols.emplace_back(std::make_shared<arrow::ChunkedArray>(
-            KATANA_CHECKED(arrow::MakeArrayOfNull(field->type(), 0))));
-      }
-      return arrow::Table::Make(schema, cols);
+      return EmptyTable(columns);
     }
 
     return KATANA_CHECKED(arrow::ConcatenateTables(tables));
   }
 
-  Result<std::shared_ptr<arrow::Table>> ReadTable(
-      std::vector<int32_t> col_indexes,
-      std::optional<katana::ParquetReader::Slice> slice = std::nullopt) {
+  /// Read the columns in columns (all columns if not given) of the row groups
+  /// whose statistics do not rule out every filter. columns must be distinct
+  /// and sorted.
+  Result<std::shared_ptr<arrow::Table>> ReadFilteredTable(
+      const std::optional<std::vector<int>>& columns,
+      const std::vector<katana::ParquetReader::RowGroupFilter>& filters) {
     std::vector<std::shared_ptr<arrow::Table>> tables;
-
-    for (auto& reader : readers_) {
-      std::vector<std::shared_ptr<arrow::Field>> fields;
-      std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
-      std::unordered_map<int32_t, std::shared_ptr<arrow::ChunkedArray>>
-          read_arrays;
-
-      std::shared_ptr<arrow::Schema> schema;
-      KATANA_CHECKED(reader->GetSchema(&schema));
-      for (int32_t idx : col_indexes) {
-        if (idx < 0) {
-          return KATANA_ERROR(
-              ErrorCode::InvalidArgument, "column indexes must be positive");
-        }
-        if (idx >= schema->num_fields()) {
-          return KATANA_ERROR(
-              ErrorCode::InvalidArgument,
-              "column index {} should be less than the number of columns {}",
-              idx, schema->num_fields());
-        }
-        std::shared_ptr<arrow::ChunkedArray> column;
-        if (auto arr_it = read_arrays.find(idx); arr_it != read_arrays.end()) {
-          column = arr_it->second;
-        } else {
-          KATANA_CHECKED(reader->ReadColumn(idx, &column));
-          read_arrays.emplace(idx, column);
+    for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
+      KATANA_CHECKED(EnsureReader(i, false));
+      parquet::arrow::FileReader* reader = readers_[i].get();
+      auto md = reader->parquet_reader()->metadata();
+
+      std::vector<int> row_groups;
+      for (int rg = 0, num_rgs = md->num_row_groups(); rg < num_rgs; ++rg) {
+        auto rg_md = md->RowGroup(rg);
+        if (std::all_of(
+                filters.begin(), filters.end(),
+                [&rg_md](const auto& filter) {
+                  return MayMatch(*rg_md, filter);
+                })) {
+          row_groups.emplace_back(rg);
         }
-        fields.emplace_back(schema->field(idx));
-        columns.emplace_back(std::move(column));
       }
-      tables.emplace_back(arrow::Table::Make(arrow::schema(fields), columns));
+      if (row_groups.empty()) {
+        continue;
+      }
+
+      std::vector<int> fill_columns;
+      if (columns) {
+        fill_columns = *columns;
+      } else {
+        fill_columns.resize(md->num_columns());
+        std::iota(fill_columns.begin(), fill_columns.end(), 0);
+      }
+      KATANA_CHECKED(
+          FillColumnChunks(reader, fvs_[i].get(), row_groups, fill_columns));
+      tables.emplace_back(
+          KATANA_CHECKED(ReadRowGroups(reader, row_groups, columns)));
     }
 
-    std::shared_ptr<arrow::Table> concatenated_table =
-        KATANA_CHECKED(arrow::ConcatenateTables(tables));
-    if (slice) {
-      concatenated_table =
-          concatenated_table->Slice(slice->offset, slice->length);
+    if (tables.empty()) {
+      return EmptyTable(columns);
     }
-    return concatenated_table;
+    return KATANA_CHECKED(arrow::ConcatenateTables(tables));
+  }
+
+  /// Pass the rows of the columns in columns (all columns if not given) to
+  /// consume a record batch at a time. columns must be distinct and sorted.
+  Result<void> ReadBatches(
+      const std::optional<std::vector<int>>& columns, const BatchFn& consume) {
+    for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
+      KATANA_CHECKED(EnsureReader(i, false));
+      parquet::arrow::FileReader* reader = readers_[i].get();
+
+      std::vector<int> row_groups(reader->num_row_groups());
+      std::iota(row_groups.begin(), row_groups.end(), 0);
+
+      std::unique_ptr<arrow::RecordBatchReader> batches;
+      if (columns) {
+        KATANA_CHECKED(
+            reader->GetRecordBatchReader(row_groups, *columns, &batches));
+      } else {
+        KATANA_CHECKED(reader->GetRecordBatchReader(row_groups, &batches));
+      }
+
+      for (;;) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        KATANA_CHECKED(batches->ReadNext(&batch));
+        if (!batch) {
+          break;
+        }
+        KATANA_CHECKED(consume(batch));
+      }
+    }
+    return katana::ResultSuccess();
   }
 
   Result<std::vector<std::string>> GetFiles() {
@@ -334,11 +564,35 @@ private:
   BlockedParquetReader(
       std::string prefix, std::vector<std::shared_ptr<katana::FileView>>&& fvs,
       std::vector<std::unique_ptr<parquet::arrow::FileReader>>&& readers,
-      std::vector<int64_t>&& row_offsets)
+      std::vector<int64_t>&& row_offsets, bool use_threads)
       : prefix_(std::move(prefix)),
         fvs_(std::move(fvs)),
         readers_(std::move(readers)),
-        row_offsets_(std::move(row_offsets)) {}
+        row_offsets_(std::move(row_offsets)),
+        use_threads_(use_threads) {}
+
+  Result<std::shared_ptr<arrow::Table>> EmptyTable(
+      const std::optional<std::vector<int>>& columns) {
+    KATANA_CHECKED(EnsureReader(0, false));
+    std::shared_ptr<arrow::Schema> schema;
+    KATANA_CHECKED(readers_[0]->GetSchema(&schema));
+
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    if (columns) {
+      for (int col : *columns) {
+        fields.emplace_back(schema->field(col));
+      }
+    } else {
+      fields = schema->fields();
+    }
+
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> cols;
+    for (const auto& field : fields) {
+      cols.emplace_back(std::make_shared<arrow::ChunkedArray>(
+          KATANA_CHECKED(arrow::MakeArrayOfNull(field->type(), 0))));
+    }
+    return arrow::Table::Make(arrow::schema(fields), cols);
+  }
 
   Result<void> EnsureReader(size_t idx, bool preload = false) {
     if (readers_[idx]) {
@@ -346,7 +600,8 @@ private:
       return katana::ResultSuccess();
     }
     readers_[idx] = KATANA_CHECKED(BuildReader(
-        fmt::format("{}.part_{:09}", prefix_, idx), preload, &fvs_[idx]));
+        fmt::format("{}.part_{:09}", prefix_, idx), preload, use_threads_,
+        &fvs_[idx]));
 
     return katana::ResultSuccess();
   }
@@ -355,13 +610,104 @@ private:
   std::vector<std::shared_ptr<katana::FileView>> fvs_;
   std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers_;
   std::vector<int64_t> row_offsets_;
+  bool use_threads_;
 };
 
+using ColumnBuilders = std::vector<std::unique_ptr<arrow::ArrayBuilder>>;
+using FixBatchFn =
+    std::function<katana::Result<std::shared_ptr<arrow::RecordBatch>>(
+        const std::shared_ptr<arrow::RecordBatch>&)>;
+
+/// Whether the builders of arrays of type can append slices of existing
+/// arrays; other builders return NotImplemented
+bool
+CanAppendArraySlices(const arrow::DataType& type) {
+  switch (type.id()) {
+  case arrow::Type::LIST:
+  case arrow::Type::LARGE_LIST:
+    return CanAppendArraySlices(*type.field(0)->type());
+  default:
+    return arrow::is_primitive(type.id()) ||
+           arrow::is_base_binary_like(type.id());
+  }
+}
+
+/// Builders for the fields of schema with room for num_rows rows, or nullopt
+/// if a field's builder cannot append slices of existing arrays
+Result<std::optional<ColumnBuilders>>
+MakeColumnBuilders(
+    const std::shared_ptr<arrow::Schema>& schema, int64_t num_rows) {
+  for (const auto& field : schema->fields()) {
+    if (!CanAppendArraySlices(*field->type())) {
+      return std::optional<ColumnBuilders>();
+    }
+  }
+
+  ColumnBuilders builders;
+  for (const auto& field : schema->fields()) {
+    std::unique_ptr<arrow::ArrayBuilder> builder;
+    KATANA_CHECKED(arrow::MakeBuilder(
+        arrow::default_memory_pool(), field->type(), &builder));
+    KATANA_CHECKED(builder->Reserve(num_rows));
+    builders.emplace_back(std::move(builder));
+  }
+  return std::make_optional(std::move(builders));
+}
+
+/// Read columns (all columns if not given) into a single array per column
+/// that is sized up front from the row counts in the parquet metadata. Record
+/// batches are copied into place as they are decoded, so besides the result
+/// at most one batch is held at a time, and nothing needs to be combined
+/// afterwards. Returns nullptr if some column cannot be read this way.
+///
+/// \param schema the canonical schema of the columns
+/// \param fix_batch makes the types of a batch canonical
+Result<std::shared_ptr<arrow::Table>>
+ReadPreallocated(
+    BlockedParquetReader* bpr, const std::optional<std::vector<int>>& columns,
+    const std::shared_ptr<arrow::Schema>& schema, const FixBatchFn& fix_batch) {
+  int64_t num_rows = KATANA_CHECKED(bpr->NumRows());
+  std::optional<ColumnBuilders> builders =
+      KATANA_CHECKED(MakeColumnBuilders(schema, num_rows));
+  if (!builders) {
+    return std::shared_ptr<arrow::Table>();
+  }
+
+  KATANA_CHECKED(bpr->ReadBatches(
+      columns,
+      [&builders, &fix_batch](const std::shared_ptr<arrow::RecordBatch>& raw)
+          -> katana::Result<void> {
+        std::shared_ptr<arrow::RecordBatch> batch =
+            KATANA_CHECKED(fix_batch(raw));
+        for (int i = 0, size = batch->num_columns(); i < size; ++i) {
+          auto& builder = (*builders)[i];
+          const std::shared_ptr<arrow::Array>& column = batch->column(i);
+          if (!column->type()->Equals(builder->type())) {
+            return KATANA_ERROR(
+                ErrorCode::ArrowError, "column {} has type {}, expected {}", i,
+                column->type()->ToString(), builder->type()->ToString());
+          }
+          KATANA_CHECKED(
+              builder->AppendArraySlice(*column->data(), 0, column->length()));
+        }
+        return katana::ResultSuccess();
+      }));
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> out_columns;
+  for (auto& builder : *builders) {
+    std::shared_ptr<arrow::Array> array;
+    KATANA_CHECKED(builder->Finish(&array));
+    out_columns.emplace_back(std::make_shared<arrow::ChunkedArray>(array));
+  }
+  return arrow::Table::Make(schema, out_columns, num_rows);
+}
+
 }  // namespace
 
 Result<std::unique_ptr<katana::ParquetReader>>
 katana::ParquetReader::Make(ReadOpts opts) {
-  return std::unique_ptr<ParquetReader>(new ParquetReader(opts.make_canonical));
+  return std::unique_ptr<ParquetReader>(new ParquetReader(
+      opts.make_canonical, opts.use_threads, opts.preallocate_columns));
 }
 
 Result<std::shared_ptr<arrow::Table>>
@@ -369,51 +715,138 @@ katana::ParquetReader::ReadTable(
     const katana::URI& uri, std::optional<katana::ParquetReader::Slice> slice) {
   bool preload = true;
   if (slice) {
-    if (slice->offset < 0 || slice->length < 0) {
-      return KATANA_ERROR(
-          ErrorCode::InvalidArgument,
-          "slice offset and length must be non-negative");
-    }
+    KATANA_CHECKED(CheckSlice(*slice));
     preload = false;
   }
 
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, preload));
-  return FixTable(KATANA_CHECKED(bpr->ReadTable(slice)));
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, preload, use_threads_));
+  if (!slice && make_canonical_ && preallocate_columns_) {
+    auto raw_schema = KATANA_CHECKED(bpr->ArrowSchema(std::nullopt));
+    auto schema = KATANA_CHECKED(FixSchema(raw_schema));
+    auto table = KATANA_CHECKED(ReadPreallocated(
+        bpr.get(), std::nullopt, schema,
+        [this](const std::shared_ptr<arrow::RecordBatch>& batch) {
+          return FixBatch(batch);
+        }));
+    if (table) {
+      return table;
+    }
+  }
+  return FixTable(KATANA_CHECKED(bpr->ReadTable(std::nullopt, slice)));
 }
 
 katana::Result<std::shared_ptr<arrow::Schema>>
 katana::ParquetReader::GetSchema(const katana::URI& uri) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
   return FixSchema(KATANA_CHECKED(bpr->ReadSchema()));
 }
 
 Result<std::shared_ptr<arrow::Table>>
-katana::ParquetReader::ReadColumn(const katana::URI& uri, int32_t column_idx) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
-  return FixTable(KATANA_CHECKED(bpr->ReadTable({column_idx})));
+katana::ParquetReader::ReadColumn(
+    const katana::URI& uri, int32_t column_idx,
+    std::optional<katana::ParquetReader::Slice> slice) {
+  return ReadTable(uri, std::vector<int32_t>{column_idx}, slice);
 }
 
 Result<std::shared_ptr<arrow::Table>>
 katana::ParquetReader::ReadTable(
     const katana::URI& uri, const std::vector<int32_t>& column_indexes,
     std::optional<katana::ParquetReader::Slice> slice) {
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
-  return FixTable(KATANA_CHECKED(bpr->ReadTable(column_indexes, slice)));
+  if (slice) {
+    KATANA_CHECKED(CheckSlice(*slice));
+  }
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
+  KATANA_CHECKED(bpr->ValidateColumns(column_indexes));
+
+  auto [columns, positions] = PlanColumns(column_indexes);
+  if (!slice && make_canonical_ && preallocate_columns_) {
+    auto raw_schema = KATANA_CHECKED(bpr->ArrowSchema(columns));
+    auto schema = KATANA_CHECKED(FixSchema(raw_schema));
+    auto table = KATANA_CHECKED(ReadPreallocated(
+        bpr.get(), columns, schema,
+        [this](const std::shared_ptr<arrow::RecordBatch>& batch) {
+          return FixBatch(batch);
+        }));
+    if (table) {
+      return ArrangeColumns(table, positions);
+    }
+  }
+  auto table = KATANA_CHECKED(bpr->ReadTable(columns, slice));
+  return FixTable(ArrangeColumns(table, positions));
+}
+
+Result<std::shared_ptr<arrow::Table>>
+katana::ParquetReader::ReadFilteredTable(
+    const katana::URI& uri, const std::vector<int32_t>& column_indexes,
+    const std::vector<RowGroupFilter>& filters) {
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
+  KATANA_CHECKED(bpr->ValidateColumns(column_indexes));
+  std::vector<int32_t> filter_columns;
+  for (const auto& filter : filters) {
+    filter_columns.emplace_back(filter.column);
+  }
+  KATANA_CHECKED(bpr->ValidateColumns(filter_columns));
+
+  auto [columns, positions] = PlanColumns(column_indexes);
+  auto table = KATANA_CHECKED(bpr->ReadFilteredTable(columns, filters));
+  return FixTable(ArrangeColumns(table, positions));
+}
+
+Result<void>
+katana::ParquetReader::ReadBatches(
+    const katana::URI& uri, const std::vector<int32_t>& column_indexes,
+    const std::function<katana::Result<void>(
+        const std::shared_ptr<arrow::RecordBatch>&)>& consume) {
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
+  KATANA_CHECKED(bpr->ValidateColumns(column_indexes));
+
+  auto [columns, positions] = PlanColumns(column_indexes);
+  return bpr->ReadBatches(
+      columns,
+      [this, &positions = positions,
+       &consume](const std::shared_ptr<arrow::RecordBatch>& batch)
+          -> katana::Result<void> {
+        return consume(
+            KATANA_CHECKED(FixBatch(ArrangeColumns(batch, positions))));
+      });
+}
+
+Result<void>
+katana::ParquetReader::ReadBatches(
+    const katana::URI& uri,
+    const std::function<katana::Result<void>(
+        const std::shared_ptr<arrow::RecordBatch>&)>& consume) {
+  auto bpr =
+      KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_));
+  return bpr->ReadBatches(
+      std::nullopt,
+      [this, &consume](const std::shared_ptr<arrow::RecordBatch>& batch)
+          -> katana::Result<void> {
+        return consume(KATANA_CHECKED(FixBatch(batch)));
+      });
 }
 
 Result<int32_t>
 katana::ParquetReader::NumColumns(const katana::URI& uri) {
-  return KATANA_CHECKED(BlockedParquetReader::Make(uri, false))->NumColumns();
+  return KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_))
+      ->NumColumns();
 }
 
 Result<int64_t>
 katana::ParquetReader::NumRows(const katana::URI& uri) {
-  return KATANA_CHECKED(BlockedParquetReader::Make(uri, false))->NumRows();
+  return KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_))
+      ->NumRows();
 }
 
 Result<std::vector<std::string>>
 katana::ParquetReader::GetFiles(const katana::URI& uri) {
-  return KATANA_CHECKED(BlockedParquetReader::Make(uri, false))->GetFiles();
+  return KATANA_CHECKED(BlockedParquetReader::Make(uri, false, use_threads_))
+      ->GetFiles();
 }
 
 Result<std::shared_ptr<arrow::Schema>>
@@ -429,6 +862,40 @@ katana::ParquetReader::FixSchema(const std::shared_ptr<arrow::Schema>& schema) {
   return arrow::schema(fields);
 }
 
+Result<void>
+katana::ParquetReader::CheckSlice(const Slice& slice) {
+  if (slice.offset < 0 || slice.length < 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "slice offset and length must be non-negative");
+  }
+  return katana::ResultSuccess();
+}
+
+Result<std::shared_ptr<arrow::RecordBatch>>
+katana::ParquetReader::FixBatch(
+    const std::shared_ptr<arrow::RecordBatch>& batch) {
+  KATANA_CHECKED(batch->Validate());
+
+  if (!make_canonical_) {
+    return batch;
+  }
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (int i = 0, size = batch->num_columns(); i < size; ++i) {
+    std::shared_ptr<arrow::Field> field =
+        KATANA_CHECKED(HandleBadParquetTypes(batch->schema()->field(i)));
+    std::shared_ptr<arrow::Array> column = batch->column(i);
+    if (!field->type()->Equals(column->type())) {
+      column = KATANA_CHECKED(arrow::compute::Cast(*column, field->type()));
+    }
+    fields.emplace_back(std::move(field));
+    columns.emplace_back(std::move(column));
+  }
+  return arrow::RecordBatch::Make(
+      arrow::schema(fields), batch->num_rows(), columns);
+}
+
 Result<std::shared_ptr<arrow::Table>>
 katana::ParquetReader::FixTable(std::shared_ptr<arrow::Table>&& _table) {
   std::shared_ptr<arrow::Table> table(std::move(_table));
@@ -1,8 +1,17 @@
 #include "katana/ParquetWriter.h"
 
+#include <algorithm>
+#include <future>
+#include <optional>
+
+#include <arrow/compute/api_vector.h>
+#include <parquet/arrow/schema.h>
+#include <parquet/schema.h>
+
 #include "katana/ArrowInterchange.h"
 #include "katana/ErrorCode.h"
 #include "katana/FaultTest.h"
+#include "katana/IOExecutor.h"
 #include "katana/JSON.h"
 #include "katana/Result.h"
 
@@ -58,6 +67,45 @@ BlockTable(std::shared_ptr<arrow::Table> table, uint64_t mbs_per_block) {
   return blocks;
 }
 
+/// Rows checked per sample and number of samples when estimating how many
+/// distinct values a column has
+constexpr int64_t kDictionarySampleRows = 1024;
+constexpr int64_t kDictionaryNumSamples = 4;
+
+/// Estimate the number of distinct values per value in column from a few
+/// evenly spaced slices of it. Returns nullopt if the type is not supported.
+std::optional<double>
+EstimateDistinctRatio(const std::shared_ptr<arrow::ChunkedArray>& column) {
+  int64_t length = column->length();
+  if (length == 0) {
+    return std::nullopt;
+  }
+
+  arrow::ArrayVector sample;
+  int64_t stride = std::max<int64_t>(length / kDictionaryNumSamples, 1);
+  for (int64_t offset = 0; offset < length; offset += stride) {
+    auto slice = column->Slice(offset, kDictionarySampleRows);
+    sample.insert(sample.end(), slice->chunks().begin(), slice->chunks().end());
+  }
+  auto sampled = std::make_shared<arrow::ChunkedArray>(sample, column->type());
+  if (sampled->length() == 0) {
+    return std::nullopt;
+  }
+
+  auto unique_res = arrow::compute::Unique(sampled);
+  if (!unique_res.ok()) {
+    return std::nullopt;
+  }
+  return static_cast<double>(unique_res.ValueOrDie()->length()) /
+         static_cast<double>(sampled->length());
+}
+
+/// Store a file in two steps: encode the table into memory, then persist it.
+/// With a write group, both run on the IOExecutor, but persisting is queued
+/// ahead of new encoding so that files are stored while later ones are still
+/// being encoded. Without one, the caller waits for the file, and waiting for
+/// a task of the IOExecutor could deadlock if the caller is one of its
+/// workers, so both steps run on the calling thread.
 Result<void>
 DoStoreParquet(
     const std::string& path, std::shared_ptr<arrow::Table> table,
@@ -68,34 +116,65 @@ DoStoreParquet(
   KATANA_CHECKED(ff->Init());
   ff->Bind(path);
 
-  auto future = std::async(
-      std::launch::async,
-      [table = std::move(table), ff = std::move(ff), desc, writer_props,
-       arrow_props]() mutable -> katana::CopyableResult<void> {
-        auto write_result = parquet::arrow::WriteTable(
-            *table, arrow::default_memory_pool(), ff,
-            std::numeric_limits<int64_t>::max(), writer_props, arrow_props);
-        table.reset();
-
-        if (!write_result.ok()) {
-          return KATANA_ERROR(
-              katana::ErrorCode::ArrowError, "arrow error: {}", write_result);
-        }
-        if (desc) {
-          desc->AddToOutstanding(ff->map_size());
-        }
-
-        TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
-        KATANA_CHECKED(ff->Persist());
-
-        return katana::CopyableResultSuccess();
-      });
+  auto write_table = [ff, writer_props, arrow_props](
+                         const arrow::Table& table) -> Result<void> {
+    auto write_result = parquet::arrow::WriteTable(
+        table, arrow::default_memory_pool(), ff,
+        std::numeric_limits<int64_t>::max(), writer_props, arrow_props);
+    if (!write_result.ok()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::ArrowError, "arrow error: {}", write_result);
+    }
+    return katana::ResultSuccess();
+  };
 
   if (!desc) {
-    KATANA_CHECKED(future.get());
+    KATANA_CHECKED(write_table(*table));
+    table.reset();
+    TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
+    KATANA_CHECKED(ff->Persist());
     return katana::ResultSuccess();
   }
 
+  std::shared_ptr<katana::IOStats> stats = desc->stats();
+  auto stored = std::make_shared<std::promise<katana::CopyableResult<void>>>();
+  auto future = stored->get_future();
+
+  auto persist = [ff, desc]() -> katana::CopyableResult<void> {
+    TSUBA_PTP(katana::internal::FaultSensitivity::Normal);
+    KATANA_CHECKED(ff->Persist());
+    desc->stats()->AddBytes(ff->map_size());
+    return katana::CopyableResultSuccess();
+  };
+
+  auto encode = [table = std::move(table), ff = std::move(ff), desc, stats,
+                 stored, write_table = std::move(write_table),
+                 persist = std::move(persist)]() mutable
+      -> katana::CopyableResult<void> {
+    auto write_result = write_table(*table);
+    table.reset();
+
+    if (!write_result) {
+      katana::CopyableResult<void> res =
+          katana::CopyableErrorInfo{write_result.error()};
+      stored->set_value(res);
+      return res;
+    }
+    desc->AddToOutstanding(ff->map_size());
+
+    katana::IOExecutor::Get().Submit(
+        katana::IOPriority::kEncoded,
+        [stored, persist = std::move(persist)]() {
+          katana::CopyableResult<void> res = persist();
+          stored->set_value(res);
+          return res;
+        },
+        stats);
+    return katana::CopyableResultSuccess();
+  };
+  katana::IOExecutor::Get().Submit(
+      katana::IOPriority::kProperty, std::move(encode));
+
   desc->AddOp(std::move(future), path);
   return katana::ResultSuccess();
 }
@@ -115,12 +194,15 @@ katana::ParquetWriter::Make(
 Result<std::unique_ptr<katana::ParquetWriter>>
 katana::ParquetWriter::Make(
     std::shared_ptr<arrow::Table> table, WriteOpts opts) {
+  // choose encodings once for the whole table so that all blocks agree
+  auto writer_props = KATANA_CHECKED(StandardWriterProperties(*table, opts));
   if (!opts.write_blocked) {
-    return std::unique_ptr<ParquetWriter>(
-        new ParquetWriter({std::move(table)}, opts));
+    return std::unique_ptr<ParquetWriter>(new ParquetWriter(
+        {std::move(table)}, std::move(opts), std::move(writer_props)));
   }
+  auto blocks = BlockTable(std::move(table), opts.mbs_per_block);
   return std::unique_ptr<ParquetWriter>(new ParquetWriter(
-      BlockTable(std::move(table), opts.mbs_per_block), opts));
+      std::move(blocks), std::move(opts), std::move(writer_props)));
 }
 
 katana::Result<void>
@@ -133,17 +215,70 @@ katana::ParquetWriter::WriteToUri(const katana::URI& uri, WriteGroup* group) {
   }
 }
 
-std::shared_ptr<parquet::WriterProperties>
-katana::ParquetWriter::StandardWriterProperties() {
-  return parquet::WriterProperties::Builder()
-      .version(opts_.parquet_version)
-      ->data_page_version(opts_.data_page_version)
-      ->build();
+Result<std::shared_ptr<parquet::WriterProperties>>
+katana::ParquetWriter::StandardWriterProperties(
+    const arrow::Table& table, const WriteOpts& opts) {
+  parquet::WriterProperties::Builder builder;
+  builder.version(opts.parquet_version)
+      ->data_page_version(opts.data_page_version);
+
+  auto codec_for = [&opts](arrow::Type::type type_id) {
+    auto it = opts.compression_by_type.find(type_id);
+    return it == opts.compression_by_type.end() ? opts.default_compression
+                                                : it->second;
+  };
+  std::vector<arrow::Compression::type> codecs;
+  std::vector<bool> dictionary;
+  bool any_compressed = false;
+  bool any_plain = false;
+  for (int i = 0, size = table.num_columns(); i < size; ++i) {
+    arrow::Compression::type codec = codec_for(table.field(i)->type()->id());
+    if (!arrow::util::Codec::IsAvailable(codec)) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "compression {} for column {} is not available",
+          arrow::util::Codec::GetCodecAsString(codec), table.field(i)->name());
+    }
+    codecs.emplace_back(codec);
+    any_compressed |= codec != arrow::Compression::UNCOMPRESSED;
+
+    bool use_dictionary = true;
+    if (opts.auto_dictionary) {
+      std::optional<double> ratio = EstimateDistinctRatio(table.column(i));
+      use_dictionary = !ratio || *ratio <= opts.max_dictionary_ratio;
+    }
+    dictionary.emplace_back(use_dictionary);
+    any_plain |= !use_dictionary;
+  }
+  if (!any_compressed && !any_plain) {
+    return builder.build();
+  }
+
+  // Properties are set per leaf column of the parquet schema, so map each
+  // leaf back to the top-level field it came from
+  std::shared_ptr<parquet::SchemaDescriptor> descr;
+  auto default_props = builder.build();
+  KATANA_CHECKED(parquet::arrow::ToParquetSchema(
+      table.schema().get(), *default_props, &descr));
+  for (int i = 0, size = descr->num_columns(); i < size; ++i) {
+    int field = table.schema()->GetFieldIndex(descr->GetColumnRoot(i)->name());
+    if (field < 0) {
+      continue;
+    }
+    std::string path = descr->Column(i)->path()->ToDotString();
+    builder.compression(path, codecs[field]);
+    if (!dictionary[field]) {
+      builder.disable_dictionary(path);
+    }
+  }
+  return builder.build();
 }
 
 std::shared_ptr<parquet::ArrowWriterProperties>
 katana::ParquetWriter::StandardArrowProperties() {
-  return parquet::ArrowWriterProperties::Builder().build();
+  return parquet::ArrowWriterProperties::Builder()
+      .set_use_threads(opts_.use_threads)
+      ->build();
 }
 
 /// Store the arrow table in a file
@@ -151,7 +286,7 @@ katana::Result<void>
 katana::ParquetWriter::StoreParquet(
     std::shared_ptr<arrow::Table> table, const katana::URI& uri,
     katana::WriteGroup* desc) {
-  auto writer_props = StandardWriterProperties();
+  const auto& writer_props = writer_props_;
   auto arrow_props = StandardArrowProperties();
   std::string prefix = uri.string();
 
@@ -45,6 +45,17 @@ using json = nlohmann::json;
 
 namespace {
 
+// Map local files when a map policy is given, otherwise read them into memory.
+katana::Result<void>
+BindStorage(
+    katana::FileView* file_view, const katana::URI& path,
+    std::optional<katana::FileView::MapPolicy> map_policy) {
+  if (map_policy && path.scheme() == "file") {
+    return file_view->BindMapped(path.string(), map_policy.value());
+  }
+  return file_view->Bind(path.string(), true);
+}
+
 katana::Result<std::string>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const katana::URI& dir,
@@ -216,7 +227,8 @@ katana::RDG::DoStoreNodeEntityTypeIDArray(
     katana::URI path_uri = MakeNodeEntityTypeIDArrayFileName(handle);
     node_entity_type_id_array_ff->Bind(path_uri.string());
     TSUBA_PTP(internal::FaultSensitivity::Normal);
-    write_group->StartStore(std::move(node_entity_type_id_array_ff));
+    write_group->StartStore(
+        std::move(node_entity_type_id_array_ff), IOPriority::kTopology);
     TSUBA_PTP(internal::FaultSensitivity::Normal);
     core_->part_header().set_node_entity_type_id_array_path(
         path_uri.BaseName());
@@ -264,7 +276,8 @@ katana::RDG::DoStoreEdgeEntityTypeIDArray(
     katana::URI path_uri = MakeEdgeEntityTypeIDArrayFileName(handle);
     edge_entity_type_id_array_ff->Bind(path_uri.string());
     TSUBA_PTP(internal::FaultSensitivity::Normal);
-    write_group->StartStore(std::move(edge_entity_type_id_array_ff));
+    write_group->StartStore(
+        std::move(edge_entity_type_id_array_ff), IOPriority::kTopology);
     TSUBA_PTP(internal::FaultSensitivity::Normal);
     core_->part_header().set_edge_entity_type_id_array_path(
         path_uri.BaseName());
@@ -420,13 +433,15 @@ katana::RDG::DoMake(
   if (core_->part_header().IsEntityTypeIDsOutsideProperties()) {
     katana::URI node_entity_type_id_array_path = metadata_dir.Join(
         core_->part_header().node_entity_type_id_array_path());
-    KATANA_CHECKED(core_->node_entity_type_id_array_file_storage().Bind(
-        node_entity_type_id_array_path.string(), true));
+    KATANA_CHECKED(BindStorage(
+        &core_->node_entity_type_id_array_file_storage(),
+        node_entity_type_id_array_path, map_policy_));
 
     katana::URI edge_entity_type_id_array_path = metadata_dir.Join(
         core_->part_header().edge_entity_type_id_array_path());
-    KATANA_CHECKED(core_->edge_entity_type_id_array_file_storage().Bind(
-        edge_entity_type_id_array_path.string(), true));
+    KATANA_CHECKED(BindStorage(
+        &core_->edge_entity_type_id_array_file_storage(),
+        edge_entity_type_id_array_path, map_policy_));
   }
   core_->set_rdg_dir(metadata_dir);
 
@@ -504,6 +519,7 @@ katana::RDG::Make(const RDGManifest& manifest, const RDGLoadOptions& opts) {
       partition_path);
 
   RDG rdg(std::make_unique<RDGCore>(std::move(part_header)));
+  rdg.map_policy_ = opts.map_local_files;
   // rdg.DoMake will try to lookup in the property cache, and it
   // needs a valid rdg_dir
   rdg.set_rdg_dir(manifest.dir());
@@ -593,6 +609,20 @@ katana::RDG::Store(
         rdg_dir(), handle.impl_->rdg_manifest().dir()));
   }
 
+  // Staged indexes go straight to the new location, so they are registered
+  // only after the existing optional datastructures have been moved.
+  std::vector<EntityIndexPrimitive> staged_entity_indexes =
+      std::move(staged_entity_indexes_);
+  staged_entity_indexes_.clear();
+  for (EntityIndexPrimitive& index : staged_entity_indexes) {
+    std::string name = EntityIndexPrimitive::ManifestName(
+        index.is_node_index(), index.property_name());
+    std::string path =
+        KATANA_CHECKED(index.Write(handle.impl_->rdg_manifest().dir()));
+    core_->part_header().RemoveOptionalDatastructureManifest(name);
+    core_->part_header().AppendOptionalDatastructureManifest(name, path);
+  }
+
   // All write buffers must outlive desc
   std::unique_ptr<WriteGroup> desc = KATANA_CHECKED(WriteGroup::Make());
 
@@ -1008,7 +1038,11 @@ katana::Result<katana::RDGTopology*>
 katana::RDG::GetTopology(const katana::RDGTopology& shadow) {
   RDGTopology* topology =
       KATANA_CHECKED(core_->topology_manager().GetTopology(shadow));
-  KATANA_CHECKED(topology->Bind(rdg_dir()));
+  if (map_policy_ && rdg_dir().scheme() == "file") {
+    KATANA_CHECKED(topology->BindMapped(rdg_dir(), map_policy_.value()));
+  } else {
+    KATANA_CHECKED(topology->Bind(rdg_dir()));
+  }
   KATANA_CHECKED(topology->Map());
   return topology;
 }
@@ -1079,6 +1113,41 @@ katana::RDG::edge_entity_type_id_array() const {
   return KATANA_CHECKED(core_->edge_entity_type_id_array());
 }
 
+bool
+katana::RDG::HasEntityIndexPrimitive(
+    bool is_node_index, const std::string& property_name) const {
+  return core_->part_header().HasOptionalDatastructureManifest(
+      EntityIndexPrimitive::ManifestName(is_node_index, property_name));
+}
+
+katana::Result<std::optional<katana::EntityIndexPrimitive>>
+katana::RDG::LoadEntityIndexPrimitive(
+    bool is_node_index, const std::string& property_name) {
+  if (!HasEntityIndexPrimitive(is_node_index, property_name)) {
+    return std::nullopt;
+  }
+  std::optional<std::string> res =
+      KATANA_CHECKED(core_->part_header().OptionalDatastructureManifest(
+          EntityIndexPrimitive::ManifestName(is_node_index, property_name)));
+
+  katana::EntityIndexPrimitive index = KATANA_CHECKED_CONTEXT(
+      katana::EntityIndexPrimitive::Load(rdg_dir(), res.value()),
+      "Failed to load EntityIndexPrimitive located at {}", res.value());
+  return std::optional<katana::EntityIndexPrimitive>(std::move(index));
+}
+
+void
+katana::RDG::StageEntityIndexPrimitive(katana::EntityIndexPrimitive&& index) {
+  staged_entity_indexes_.emplace_back(std::move(index));
+}
+
+void
+katana::RDG::RemoveEntityIndexPrimitive(
+    bool is_node_index, const std::string& property_name) {
+  core_->part_header().RemoveOptionalDatastructureManifest(
+      EntityIndexPrimitive::ManifestName(is_node_index, property_name));
+}
+
 katana::Result<std::optional<katana::RDKLSHIndexPrimitive>>
 katana::RDG::LoadRDKLSHIndexPrimitive() {
   std::optional<std::string> res =
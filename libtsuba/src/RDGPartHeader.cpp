@@ -731,6 +731,34 @@ katana::to_json(
       {"paths", index.paths_}};
 }
 
+void
+katana::from_json(
+    const nlohmann::json& j, katana::EntityIndexPrimitive& index) {
+  j.at("property_name").get_to(index.property_name_);
+  j.at("is_node_index").get_to(index.is_node_index_);
+  if (auto it = j.find("is_hash_index"); it != j.end()) {
+    it->get_to(index.is_hash_index_);
+  }
+  j.at("num_entities").get_to(index.num_entities_);
+  j.at("num_keys").get_to(index.num_keys_);
+  j.at("id_width").get_to(index.id_width_);
+  j.at("key_width").get_to(index.key_width_);
+  j.at("paths").get_to(index.paths_);
+}
+
+void
+katana::to_json(nlohmann::json& j, const katana::EntityIndexPrimitive& index) {
+  j = nlohmann::json{
+      {"property_name", index.property_name_},
+      {"is_node_index", index.is_node_index_},
+      {"is_hash_index", index.is_hash_index_},
+      {"num_entities", index.num_entities_},
+      {"num_keys", index.num_keys_},
+      {"id_width", index.id_width_},
+      {"key_width", index.key_width_},
+      {"paths", index.paths_}};
+}
+
 void
 katana::from_json(
     const nlohmann::json& j, katana::RDGOptionalDatastructure& data) {
@@ -13,6 +13,7 @@
 #include <arrow/api.h>
 
 #include "PartitionTopologyMetadata.h"
+#include "katana/EntityIndexPrimitive.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/ErrorCode.h"
 #include "katana/JSON.h"
@@ -446,6 +447,25 @@ public:
         optional_datastructure_manifests_.size());
   }
 
+  bool HasOptionalDatastructureManifest(
+      const std::string& optional_datastructure_name) const {
+    return optional_datastructure_manifests_.find(
+               optional_datastructure_name) !=
+           optional_datastructure_manifests_.end();
+  }
+
+  /// Forget an optional datastructure, e.g., because the data it was derived
+  /// from changed. Its files are left for garbage collection.
+  void RemoveOptionalDatastructureManifest(
+      const std::string& optional_datastructure_name) {
+    if (optional_datastructure_manifests_.erase(optional_datastructure_name)) {
+      KATANA_LOG_DEBUG(
+          "Removed optional datastructure manifest {}, total count = {}",
+          optional_datastructure_name,
+          optional_datastructure_manifests_.size());
+    }
+  }
+
   const std::unordered_map<std::string, std::string>&
   optional_datastructure_manifests() const {
     return optional_datastructure_manifests_;
@@ -605,6 +625,9 @@ void from_json(const nlohmann::json& j, RDKLSHIndexPrimitive& index);
 void to_json(nlohmann::json& j, const RDKSubstructureIndexPrimitive& index);
 void from_json(const nlohmann::json& j, RDKSubstructureIndexPrimitive& index);
 
+void to_json(nlohmann::json& j, const EntityIndexPrimitive& index);
+void from_json(const nlohmann::json& j, EntityIndexPrimitive& index);
+
 void to_json(nlohmann::json& j, const RDGOptionalDatastructure& data);
 void from_json(const nlohmann::json& j, RDGOptionalDatastructure& data);
 
@@ -631,7 +654,11 @@ NLOHMANN_JSON_SERIALIZE_ENUM(
     {{RDGTopology::NodeSortKind::kInvalid, "kInvalid"},
      {RDGTopology::NodeSortKind::kAny, "kAny"},
      {RDGTopology::NodeSortKind::kSortedByDegree, "kSortedByDegree"},
-     {RDGTopology::NodeSortKind::kSortedByNodeType, "kSortedByNodeType"}})
+     {RDGTopology::NodeSortKind::kSortedByNodeType, "kSortedByNodeType"},
+     {RDGTopology::NodeSortKind::kReverseCuthillMcKee, "kReverseCuthillMcKee"},
+     {RDGTopology::NodeSortKind::kCommunity, "kCommunity"},
+     {RDGTopology::NodeSortKind::kHubSorted, "kHubSorted"},
+     {RDGTopology::NodeSortKind::kHubClustered, "kHubClustered"}})
 
 NLOHMANN_JSON_SERIALIZE_ENUM(
     RDGTopology::TopologyKind,
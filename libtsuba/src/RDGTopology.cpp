@@ -85,6 +85,28 @@ katana::RDGTopology::Bind(const katana::URI& metadata_dir, bool resolve) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::RDGTopology::BindMapped(
+    const katana::URI& metadata_dir, FileView::MapPolicy policy) {
+  if (file_store_bound_) {
+    KATANA_LOG_WARN("topology already bound, nothing to do");
+    return katana::ResultSuccess();
+  }
+  if (path().empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Cannot bind topology with empty path");
+  }
+
+  katana::URI t_path = metadata_dir.Join(path());
+  KATANA_LOG_DEBUG("mapping entire topology file at path {}", t_path.string());
+  KATANA_CHECKED(file_storage_.BindMapped(t_path.string(), policy));
+
+  file_store_bound_ = true;
+  storage_valid_ = true;
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::RDGTopology::Bind(
     const katana::URI& metadata_dir, uint64_t begin, uint64_t end,
@@ -457,7 +479,7 @@ katana::RDGTopology::DoStore(
     katana::URI path_uri = MakeTopologyFileName(handle);
     ff->Bind(path_uri.string());
     TSUBA_PTP(internal::FaultSensitivity::Normal);
-    write_group->StartStore(std::move(ff));
+    write_group->StartStore(std::move(ff), IOPriority::kTopology);
     TSUBA_PTP(internal::FaultSensitivity::Normal);
 
     // update the metadata entry
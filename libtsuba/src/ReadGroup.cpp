@@ -1,5 +1,10 @@
 #include "katana/ReadGroup.h"
 
+#include <algorithm>
+#include <tuple>
+
+#include "katana/file.h"
+
 void
 katana::ReadGroup::AddOp(
     std::future<katana::CopyableResult<void>> future, std::string file,
@@ -7,7 +12,64 @@ katana::ReadGroup::AddOp(
   async_op_group_.AddOp(std::move(future), std::move(file), on_complete);
 }
 
+void
+katana::ReadGroup::AddRangeRead(
+    const std::string& file, uint64_t offset, uint64_t size, uint8_t* buf,
+    IOPriority priority) {
+  range_reads_.emplace_back(RangeRead{
+      .file = file,
+      .offset = offset,
+      .size = size,
+      .buf = buf,
+      .priority = priority,
+  });
+}
+
+void
+katana::ReadGroup::StartRangeReads() {
+  std::stable_sort(
+      range_reads_.begin(), range_reads_.end(),
+      [](const RangeRead& a, const RangeRead& b) {
+        return std::tie(a.file, a.offset) < std::tie(b.file, b.offset);
+      });
+
+  const std::shared_ptr<IOStats>& group_stats = stats();
+  for (size_t i = 0; i < range_reads_.size();) {
+    RangeRead merged = range_reads_[i];
+    size_t next = i + 1;
+    for (; next < range_reads_.size(); ++next) {
+      const RangeRead& read = range_reads_[next];
+      if (read.file != merged.file ||
+          read.offset != merged.offset + merged.size ||
+          read.buf != merged.buf + merged.size) {
+        break;
+      }
+      merged.size += read.size;
+      merged.priority = std::min(merged.priority, read.priority);
+    }
+    group_stats->AddCoalesced(next - i - 1);
+    i = next;
+
+    auto future = IOExecutor::Get().Submit(
+        merged.priority,
+        [merged, group_stats]() -> katana::CopyableResult<void> {
+          KATANA_CHECKED(katana::FileGet(
+              merged.file, merged.buf, merged.offset, merged.size));
+          group_stats->AddBytes(merged.size);
+          return katana::CopyableResultSuccess();
+        },
+        group_stats);
+    AddOp(std::move(future), merged.file, []() {
+      return katana::CopyableResultSuccess();
+    });
+  }
+  range_reads_.clear();
+}
+
 katana::Result<void>
 katana::ReadGroup::Finish() {
-  return async_op_group_.Finish();
+  StartRangeReads();
+  auto res = async_op_group_.Finish();
+  stats()->Report("read group finished");
+  return res;
 }
@@ -26,7 +26,9 @@ katana::WriteGroup::Make() {
 
 Result<void>
 katana::WriteGroup::Finish() {
-  return async_op_group_.Finish();
+  auto res = async_op_group_.Finish();
+  stats()->Report("write group finished");
+  return res;
 }
 
 void
@@ -56,13 +58,16 @@ katana::WriteGroup::AddOp(
 // shared pointer because FileFrames are often held that way due do the way
 // they're used with arrow
 void
-katana::WriteGroup::StartStore(std::shared_ptr<katana::FileFrame> ff) {
+katana::WriteGroup::StartStore(
+    std::shared_ptr<katana::FileFrame> ff, IOPriority priority) {
   std::string file = ff->path();
   uint64_t size = ff->map_size();
+  stats()->AddBytes(size);
 
   // wrap future to hold onto FileFrame, but free it as soon as possible
-  auto future = std::async(std::launch::async, [ff = std::move(ff)]() mutable {
-    return ff->PersistAsync().get();
-  });
+  auto future = IOExecutor::Get().Submit(
+      priority,
+      [ff = std::move(ff)]() mutable { return ff->PersistAsync().get(); },
+      stats());
   AddOp(std::move(future), file, size);
 }
@@ -1,6 +1,12 @@
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 
 #include "katana/FileView.h"
+#include "katana/ReadGroup.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "katana/file.h"
@@ -31,9 +37,97 @@ TestEmpty(const std::string& path) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestAsync(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+  auto data_uri = uri.Join("async_file");
+
+  // large enough that a whole file read may go through O_DIRECT
+  constexpr uint64_t kNumWords = (UINT64_C(16) << 20) / sizeof(uint64_t);
+  std::vector<uint64_t> data(kNumWords);
+  for (uint64_t i = 0; i < kNumWords; ++i) {
+    data[i] = i;
+  }
+  uint64_t num_bytes = kNumWords * sizeof(uint64_t);
+  KATANA_CHECKED(
+      katana::FileStoreAsync(data_uri.string(), data.data(), num_bytes).get());
+
+  // many outstanding small reads
+  constexpr uint64_t kNumChunks = 256;
+  constexpr uint64_t kChunkWords = kNumWords / kNumChunks;
+  std::vector<uint64_t> chunked(kNumWords);
+  std::vector<std::future<katana::CopyableResult<void>>> futures;
+  for (uint64_t i = 0; i < kNumChunks; ++i) {
+    futures.emplace_back(katana::FileGetAsync(
+        data_uri.string(), &chunked[i * kChunkWords],
+        i * kChunkWords * sizeof(uint64_t), kChunkWords * sizeof(uint64_t)));
+  }
+  for (auto& future : futures) {
+    KATANA_CHECKED(future.get());
+  }
+  KATANA_LOG_ASSERT(chunked == data);
+
+  // one large block aligned read
+  void* aligned = nullptr;
+  KATANA_LOG_ASSERT(
+      posix_memalign(&aligned, katana::kBlockSize, num_bytes) == 0);
+  KATANA_CHECKED(
+      katana::FileGetAsync(data_uri.string(), aligned, 0, num_bytes).get());
+  KATANA_LOG_ASSERT(
+      std::equal(data.begin(), data.end(), static_cast<uint64_t*>(aligned)));
+  free(aligned);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestReadGroup(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::URI::MakeFromFile(path));
+  auto data_uri = uri.Join("read_group_file");
+
+  constexpr uint64_t kNumWords = 1024;
+  constexpr uint64_t kChunkWords = 64;
+  std::vector<uint64_t> data(kNumWords);
+  for (uint64_t i = 0; i < kNumWords; ++i) {
+    data[i] = i;
+  }
+  KATANA_CHECKED(katana::FileStore(
+      data_uri.string(), data.data(), kNumWords * sizeof(uint64_t)));
+
+  // adjacent ranges into adjacent memory are merged into one read, out of
+  // order ranges are fine
+  std::vector<uint64_t> read(kNumWords);
+  katana::ReadGroup grp;
+  for (uint64_t i = kNumWords; i > 0; i -= kChunkWords) {
+    uint64_t begin = i - kChunkWords;
+    grp.AddRangeRead(
+        data_uri.string(), begin * sizeof(uint64_t),
+        kChunkWords * sizeof(uint64_t),
+        reinterpret_cast<uint8_t*>(&read[begin]));
+  }
+  // overlaps the others, so it is not merged
+  uint64_t word = 0;
+  grp.AddRangeRead(
+      data_uri.string(), (kNumWords - 1) * sizeof(uint64_t), sizeof(uint64_t),
+      reinterpret_cast<uint8_t*>(&word));
+  KATANA_CHECKED(grp.Finish());
+
+  KATANA_LOG_ASSERT(read == data);
+  KATANA_LOG_ASSERT(word == kNumWords - 1);
+  KATANA_LOG_ASSERT(grp.stats()->num_ops() == 2);
+  KATANA_LOG_ASSERT(
+      grp.stats()->num_coalesced() == kNumWords / kChunkWords - 1);
+  KATANA_LOG_ASSERT(
+      grp.stats()->bytes() == (kNumWords + 1) * sizeof(uint64_t));
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path) {
   KATANA_CHECKED_CONTEXT(TestEmpty(path), "TestEmpty");
+  KATANA_CHECKED_CONTEXT(TestAsync(path), "TestAsync");
+  KATANA_CHECKED_CONTEXT(TestReadGroup(path), "TestReadGroup");
 
   return katana::ResultSuccess();
 }
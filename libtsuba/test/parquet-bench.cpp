@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <arrow/builder.h>
+#include <arrow/io/file.h>
+#include <arrow/table.h>
+#include <benchmark/benchmark.h>
+#include <parquet/arrow/writer.h>
+
+#include "katana/Logging.h"
+#include "katana/ParquetReader.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/tsuba.h"
+
+namespace {
+
+constexpr int64_t kRowGroupSize = 1 << 16;
+
+/// Directory for the files read by the benchmarks
+std::string bench_dir;
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long rows : {1 << 20, 1 << 23}) {
+    for (long preallocate : {0, 1}) {
+      b->Args({rows, preallocate});
+    }
+  }
+}
+
+/// Reset the peak resident set size of this process; false if unsupported
+bool
+ResetPeakRss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  return clear_refs.good();
+}
+
+/// Peak resident set size of this process in bytes (VmHWM), or 0 if unknown
+uint64_t
+PeakRssBytes() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      std::istringstream fields(line.substr(6));
+      uint64_t kb = 0;
+      fields >> kb;
+      return kb * 1024;
+    }
+  }
+  return 0;
+}
+
+/// Write a file with an int64 column of num_rows rows unless it exists
+katana::Result<katana::URI>
+MakeInput(int64_t num_rows) {
+  auto uri = KATANA_CHECKED(katana::URI::Make(bench_dir))
+                 .Join(fmt::format("int64-{}.parquet", num_rows));
+  if (std::filesystem::exists(uri.path())) {
+    return uri;
+  }
+
+  arrow::Int64Builder builder;
+  KATANA_CHECKED(builder.Reserve(num_rows));
+  for (int64_t i = 0; i < num_rows; ++i) {
+    builder.UnsafeAppend(i * 7919);
+  }
+  std::shared_ptr<arrow::Array> values;
+  KATANA_CHECKED(builder.Finish(&values));
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field("value", arrow::int64())}), {values});
+  auto out = KATANA_CHECKED(arrow::io::FileOutputStream::Open(uri.path()));
+  KATANA_CHECKED(parquet::arrow::WriteTable(
+      *table, arrow::default_memory_pool(), out, kRowGroupSize));
+  KATANA_CHECKED(out->Close());
+  return uri;
+}
+
+/// Read a whole file with and without preallocated columns. The
+/// peak_rss_growth counter is how much the peak RSS grew above the RSS before
+/// the read, if the peak can be reset.
+void
+ReadTable(benchmark::State& state) {
+  int64_t num_rows = state.range(0);
+  bool preallocate = state.range(1);
+
+  auto uri_res = MakeInput(num_rows);
+  KATANA_LOG_VASSERT(uri_res, "making input: {}", uri_res.error());
+  auto reader_res = katana::ParquetReader::Make(
+      katana::ParquetReader::ReadOpts{.preallocate_columns = preallocate});
+  KATANA_LOG_VASSERT(reader_res, "making reader: {}", reader_res.error());
+  auto reader = std::move(reader_res.value());
+
+  bool can_reset = true;
+  uint64_t peak_growth = 0;
+  for (auto _ : state) {
+    can_reset = can_reset && ResetPeakRss();
+    uint64_t before = katana::ProgressTracer::ParseProcSelfRssBytes();
+    auto table_res = reader->ReadTable(uri_res.value());
+    KATANA_LOG_VASSERT(table_res, "reading: {}", table_res.error());
+    KATANA_LOG_ASSERT(table_res.value()->num_rows() == num_rows);
+    uint64_t peak = PeakRssBytes();
+    peak_growth = std::max(peak_growth, peak > before ? peak - before : 0);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_rows);
+  if (can_reset) {
+    state.counters["peak_rss_growth"] = benchmark::Counter(
+        peak_growth, benchmark::Counter::kDefaults,
+        benchmark::Counter::kIs1024);
+  }
+}
+
+BENCHMARK(ReadTable)->Apply(MakeArguments)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (auto init_good = katana::InitTsuba(); !init_good) {
+    KATANA_LOG_FATAL("katana::InitTsuba: {}", init_good.error());
+  }
+
+  char dir_template[] = "/tmp/parquet-bench-XXXXXX";
+  KATANA_LOG_ASSERT(mkdtemp(dir_template) != nullptr);
+  bench_dir = dir_template;
+
+  ::benchmark::RunSpecifiedBenchmarks();
+
+  std::filesystem::remove_all(bench_dir);
+  if (auto fini_good = katana::FiniTsuba(); !fini_good) {
+    KATANA_LOG_FATAL("katana::FiniTsuba: {}", fini_good.error());
+  }
+  return 0;
+}
@@ -1,9 +1,16 @@
+#include <string>
+
 #include <arrow/chunked_array.h>
+#include <arrow/io/file.h>
 #include <arrow/type_fwd.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
 
 #include "katana/ParquetReader.h"
 #include "katana/ParquetWriter.h"
 #include "katana/Result.h"
+#include "katana/WriteGroup.h"
 #include "katana/tsuba.h"
 
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
@@ -38,10 +45,202 @@ TestLargeStringRoundTrip(const std::string& dir) {
   return katana::ResultSuccess();
 }
 
+/// Write a table of kNumRows rows with an int64 column equal to the row number
+/// and a string column, in row groups of kRowGroupSize rows
+constexpr int64_t kNumRows = 1000;
+constexpr int64_t kRowGroupSize = 100;
+
+katana::Result<katana::URI>
+WriteRowGroups(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::URI::Make(dir)).Join("row_groups.parquet");
+
+  arrow::Int64Builder int_builder;
+  arrow::StringBuilder string_builder;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    KATANA_CHECKED(int_builder.Append(i));
+    KATANA_CHECKED(string_builder.Append(fmt::format("row-{}", i)));
+  }
+  std::shared_ptr<arrow::Array> ints;
+  KATANA_CHECKED(int_builder.Finish(&ints));
+  std::shared_ptr<arrow::Array> strings;
+  KATANA_CHECKED(string_builder.Finish(&strings));
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("number", arrow::int64()),
+           arrow::field("name", arrow::utf8())}),
+      {ints, strings});
+
+  auto out = KATANA_CHECKED(arrow::io::FileOutputStream::Open(uri.path()));
+  KATANA_CHECKED(parquet::arrow::WriteTable(
+      *table, arrow::default_memory_pool(), out, kRowGroupSize));
+  KATANA_CHECKED(out->Close());
+  return uri;
+}
+
+int64_t
+FirstNumber(const std::shared_ptr<arrow::Table>& table, int column) {
+  auto numbers = std::static_pointer_cast<arrow::Int64Array>(
+      table->column(column)->chunk(0));
+  return numbers->Value(0);
+}
+
+katana::Result<void>
+TestPartialReads(const std::string& dir) {
+  katana::URI uri = KATANA_CHECKED(WriteRowGroups(dir));
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+
+  auto column = KATANA_CHECKED(reader->ReadColumn(
+      uri, 0, katana::ParquetReader::Slice{.offset = 250, .length = 100}));
+  KATANA_LOG_ASSERT(column->num_columns() == 1);
+  KATANA_LOG_ASSERT(column->num_rows() == 100);
+  KATANA_LOG_ASSERT(FirstNumber(column, 0) == 250);
+
+  // columns may repeat and come in any order
+  auto projected = KATANA_CHECKED(reader->ReadTable(
+      uri, {1, 0, 1},
+      katana::ParquetReader::Slice{.offset = 990, .length = 100}));
+  KATANA_LOG_ASSERT(projected->num_columns() == 3);
+  KATANA_LOG_ASSERT(projected->num_rows() == 10);
+  KATANA_LOG_ASSERT(projected->field(0)->name() == "name");
+  KATANA_LOG_ASSERT(projected->field(1)->name() == "number");
+  KATANA_LOG_ASSERT(projected->field(2)->type()->Equals(arrow::large_utf8()));
+  KATANA_LOG_ASSERT(FirstNumber(projected, 1) == 990);
+
+  // only the row group holding 400-499 can match
+  auto filtered = KATANA_CHECKED(reader->ReadFilteredTable(
+      uri, {0, 1},
+      {katana::ParquetReader::RowGroupFilter{
+          .column = 0, .min = 420, .max = 450}}));
+  KATANA_LOG_ASSERT(filtered->num_rows() == kRowGroupSize);
+  KATANA_LOG_ASSERT(FirstNumber(filtered, 0) == 400);
+
+  auto none = KATANA_CHECKED(reader->ReadFilteredTable(
+      uri, {0},
+      {katana::ParquetReader::RowGroupFilter{
+          .column = 0, .min = kNumRows, .max = 2 * kNumRows}}));
+  KATANA_LOG_ASSERT(none->num_columns() == 1);
+  KATANA_LOG_ASSERT(none->num_rows() == 0);
+
+  int64_t num_rows = 0;
+  KATANA_CHECKED(reader->ReadBatches(
+      uri, {1},
+      [&num_rows](const std::shared_ptr<arrow::RecordBatch>& batch)
+          -> katana::Result<void> {
+        KATANA_LOG_ASSERT(batch->num_columns() == 1);
+        KATANA_LOG_ASSERT(
+            batch->column(0)->type()->Equals(arrow::large_utf8()));
+        num_rows += batch->num_rows();
+        return katana::ResultSuccess();
+      }));
+  KATANA_LOG_ASSERT(num_rows == kNumRows);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestPreallocatedReads(const std::string& dir) {
+  katana::URI uri = KATANA_CHECKED(WriteRowGroups(dir));
+  auto chunked_reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make(
+      katana::ParquetReader::ReadOpts{.preallocate_columns = true}));
+
+  auto expected = KATANA_CHECKED(chunked_reader->ReadTable(uri));
+  auto table = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(table->Equals(*expected));
+  KATANA_LOG_ASSERT(table->field(1)->type()->Equals(arrow::large_utf8()));
+  for (const auto& column : table->columns()) {
+    KATANA_LOG_ASSERT(column->num_chunks() == 1);
+  }
+
+  auto projected = KATANA_CHECKED(reader->ReadTable(uri, {1, 0, 1}));
+  KATANA_LOG_ASSERT(projected->num_columns() == 3);
+  KATANA_LOG_ASSERT(projected->num_rows() == kNumRows);
+  KATANA_LOG_ASSERT(projected->field(0)->name() == "name");
+  KATANA_LOG_ASSERT(FirstNumber(projected, 1) == 0);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestWriteEncodings(const std::string& dir) {
+  constexpr int64_t kWriteRows = 1 << 18;
+
+  arrow::LargeStringBuilder label_builder;
+  arrow::Int64Builder id_builder;
+  for (int64_t i = 0; i < kWriteRows; ++i) {
+    KATANA_CHECKED(label_builder.Append(fmt::format("label-{}", i % 4)));
+    KATANA_CHECKED(id_builder.Append(i * 31));
+  }
+  std::shared_ptr<arrow::Array> labels;
+  KATANA_CHECKED(label_builder.Finish(&labels));
+  std::shared_ptr<arrow::Array> ids;
+  KATANA_CHECKED(id_builder.Finish(&ids));
+  auto table = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("label", arrow::large_utf8()),
+           arrow::field("id", arrow::int64())}),
+      {labels, ids});
+
+  arrow::Compression::type codec = arrow::Compression::UNCOMPRESSED;
+  for (auto candidate :
+       {arrow::Compression::ZSTD, arrow::Compression::SNAPPY}) {
+    if (arrow::util::Codec::IsAvailable(candidate)) {
+      codec = candidate;
+      break;
+    }
+  }
+  katana::ParquetWriter::WriteOpts opts;
+  opts.compression_by_type[arrow::Type::LARGE_STRING] = codec;
+
+  // strings are compressed and dictionary encoded, unique ids are neither
+  auto uri = KATANA_CHECKED(katana::URI::Make(dir)).Join("encodings.parquet");
+  auto writer = KATANA_CHECKED(katana::ParquetWriter::Make(table, opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto file_reader = parquet::ParquetFileReader::OpenFile(uri.path());
+  auto row_group = file_reader->metadata()->RowGroup(0);
+  KATANA_LOG_ASSERT(row_group->ColumnChunk(0)->compression() == codec);
+  KATANA_LOG_ASSERT(row_group->ColumnChunk(0)->has_dictionary_page());
+  KATANA_LOG_ASSERT(
+      row_group->ColumnChunk(1)->compression() ==
+      arrow::Compression::UNCOMPRESSED);
+  KATANA_LOG_ASSERT(!row_group->ColumnChunk(1)->has_dictionary_page());
+
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  KATANA_LOG_ASSERT(KATANA_CHECKED(reader->ReadTable(uri))->Equals(*table));
+
+  // blocks are encoded and stored concurrently
+  opts.write_blocked = true;
+  opts.mbs_per_block = 1;
+  auto blocked_uri =
+      KATANA_CHECKED(katana::URI::Make(dir)).Join("blocked.parquet");
+  auto blocked_writer =
+      KATANA_CHECKED(katana::ParquetWriter::Make(table, opts));
+  auto group = KATANA_CHECKED(katana::WriteGroup::Make());
+  KATANA_CHECKED(blocked_writer->WriteToUri(blocked_uri, group.get()));
+  KATANA_CHECKED(group->Finish());
+  KATANA_LOG_ASSERT(group->stats()->num_ops() > 1);
+
+  int64_t num_rows = 0;
+  for (uint64_t i = 0; i < group->stats()->num_ops(); ++i) {
+    auto block = KATANA_CHECKED(
+        reader->ReadTable(blocked_uri + fmt::format(".{:06}", i)));
+    KATANA_LOG_ASSERT(FirstNumber(block, 1) == num_rows * 31);
+    num_rows += block->num_rows();
+  }
+  KATANA_LOG_ASSERT(num_rows == kWriteRows);
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& dir) {
   KATANA_CHECKED_CONTEXT(
       TestLargeStringRoundTrip(dir), "TestLargeStringRoundTrip");
+  KATANA_CHECKED_CONTEXT(TestPartialReads(dir), "TestPartialReads");
+  KATANA_CHECKED_CONTEXT(
+      TestPreallocatedReads(dir), "TestPreallocatedReads");
+  KATANA_CHECKED_CONTEXT(TestWriteEncodings(dir), "TestWriteEncodings");
 
   return katana::ResultSuccess();
 }
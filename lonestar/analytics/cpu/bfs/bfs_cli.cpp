@@ -82,7 +82,10 @@ static cll::opt<BfsPlan::Algorithm> algo(
         clEnumValN(BfsPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BfsPlan::kSynchronousDirectOpt, "SyncDO",
-            "Synchronous direction optimization")),
+            "Synchronous direction optimization"),
+        clEnumValN(
+            BfsPlan::kSynchronousDirectOptCompressed, "SyncDOCompressed",
+            "Synchronous direction optimization on a compressed topology")),
     cll::init(BfsPlan::kSynchronousDirectOpt));
 
 std::string
@@ -98,6 +101,8 @@ AlgorithmName(BfsPlan::Algorithm algorithm) {
     return "Sync";
   case BfsPlan::kSynchronousDirectOpt:
     return "SyncDO";
+  case BfsPlan::kSynchronousDirectOptCompressed:
+    return "SyncDOCompressed";
   default:
     return "Unknown";
   }
@@ -125,6 +130,10 @@ main(int argc, char** argv) {
     plan = BfsPlan::SynchronousDirectOpt(alpha, beta);
     break;
   }
+  case BfsPlan::kSynchronousDirectOptCompressed: {
+    plan = BfsPlan::SynchronousDirectOptCompressed(alpha, beta);
+    break;
+  }
   default:
     KATANA_LOG_FATAL("Unsupported algorithm: {}", algo.getValue());
   }
@@ -45,6 +45,10 @@ static cll::opt<ConnectedComponentsPlan::Algorithm> algo(
         clEnumValN(
             ConnectedComponentsPlan::kLabelProp, "LabelProp",
             "Label propagation algorithms"),
+        clEnumValN(
+            ConnectedComponentsPlan::kLabelPropCompressed,
+            "LabelPropCompressed",
+            "Label propagation on a compressed topology"),
         clEnumValN(
             ConnectedComponentsPlan::kSynchronous, "Synchronous",
             "Synchronous algorithm"),
@@ -99,6 +103,8 @@ AlgorithmName(ConnectedComponentsPlan::Algorithm algorithm) {
     return "Serial";
   case ConnectedComponentsPlan::kLabelProp:
     return "LabelProp";
+  case ConnectedComponentsPlan::kLabelPropCompressed:
+    return "LabelPropCompressed";
   case ConnectedComponentsPlan::kSynchronous:
     return "Synchronous";
   case ConnectedComponentsPlan::kAsynchronous:
@@ -165,6 +171,9 @@ main(int argc, char** argv) {
   case ConnectedComponentsPlan::kLabelProp:
     plan = ConnectedComponentsPlan::LabelProp();
     break;
+  case ConnectedComponentsPlan::kLabelPropCompressed:
+    plan = ConnectedComponentsPlan::LabelPropCompressed();
+    break;
   case ConnectedComponentsPlan::kSynchronous:
     plan = ConnectedComponentsPlan::Synchronous();
     break;
@@ -45,11 +45,21 @@ static cll::opt<PagerankPlan::Algorithm> algo(
         clEnumValN(
             PagerankPlan::kPullTopological, "PullTopological",
             "PullTopological"),
+        clEnumValN(
+            PagerankPlan::kPullTopologicalCompressed,
+            "PullTopologicalCompressed", "PullTopologicalCompressed"),
         clEnumValN(PagerankPlan::kPullResidual, "PullResidual", "PullResidual"),
         clEnumValN(PagerankPlan::kPushSynchronous, "PushSync", "PushSync"),
         clEnumValN(PagerankPlan::kPushAsynchronous, "PushAsync", "PushAsync")),
     cll::init(PagerankPlan::kPushAsynchronous));
 
+static cll::opt<bool> numaPartition(
+    "numaPartition",
+    cll::desc(
+        "Place the graph blocked by node range across NUMA nodes and run "
+        "pull loops on the nodes each thread owns (default false)"),
+    cll::init(false));
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -65,7 +75,7 @@ main(int argc, char** argv) {
 
   std::cout << "Reading from file: " << inputFile << "\n";
   std::unique_ptr<katana::PropertyGraph> pg =
-      MakeFileGraph(inputFile, edge_property_name);
+      MakeFileGraph(inputFile, edge_property_name, numaPartition);
 
   std::cout << "Read " << pg->topology().NumNodes() << " nodes, "
             << pg->topology().NumEdges() << " edges\n";
@@ -30,7 +30,8 @@
 
 inline std::unique_ptr<katana::PropertyGraph>
 MakeFileGraph(
-    const std::string& rdg_name, const std::string& edge_property_name) {
+    const std::string& rdg_name, const std::string& edge_property_name,
+    bool partition_topology_across_numa_nodes = false) {
   std::vector<std::string> edge_properties;
   std::vector<std::string> node_properties;
   if (!edge_property_name.empty()) {
@@ -41,6 +42,8 @@ MakeFileGraph(
   katana::RDGLoadOptions opts;
   opts.node_properties = node_properties;
   opts.edge_properties = edge_properties;
+  opts.partition_topology_across_numa_nodes =
+      partition_topology_across_numa_nodes;
   auto pfg_result = katana::PropertyGraph::Make(rdg_name, &txn_ctx, opts);
   if (!pfg_result) {
     KATANA_LOG_FATAL("cannot make graph: {}", pfg_result.error());
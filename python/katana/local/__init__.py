@@ -14,6 +14,7 @@ from katana.local.dynamic_bitset import DynamicBitset
 from katana.local.entity_type_array import EntityTypeArray
 from katana.local_native import (
     AtomicEntityType,
+    EntityIndexKind,
     EntityType,
     EntityTypeManager,
     Graph,
@@ -50,6 +51,7 @@ __all__ = [
     "AtomicEntityType",
     "EntityTypeManager",
     "EntityTypeArray",
+    "EntityIndexKind",
 ]
 
 Graph.out_edges = graph_adds.out_edges
@@ -41,6 +41,7 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
             kSynchronousTile "katana::analytics::BfsPlan::kSynchronousTile"
             kSynchronous "katana::analytics::BfsPlan::kSynchronous"
             kSynchronousDirectOpt "katana::analytics::BfsPlan::kSynchronousDirectOpt"
+            kSynchronousDirectOptCompressed "katana::analytics::BfsPlan::kSynchronousDirectOptCompressed"
 
         _BfsPlan.Algorithm algorithm() const
         ptrdiff_t edge_tile_size() const
@@ -62,6 +63,9 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
         @staticmethod
         _BfsPlan SynchronousDirectOpt(uint32_t, uint32_t)
 
+        @staticmethod
+        _BfsPlan SynchronousDirectOptCompressed(uint32_t, uint32_t)
+
     ptrdiff_t kDefaultEdgeTileSize "katana::analytics::BfsPlan::kDefaultEdgeTileSize"
     uint32_t kDefaultAlpha "katana::analytics::BfsPlan::kDefaultAlpha"
     uint32_t kDefaultBeta "katana::analytics::BfsPlan::kDefaultBeta"
@@ -92,6 +96,7 @@ class _BfsAlgorithm(Enum):
     AsynchronousTile = _BfsPlan.Algorithm.kAsynchronousTile
     Synchronous = _BfsPlan.Algorithm.kSynchronous
     SynchronousDirectOpt = _BfsPlan.Algorithm.kSynchronousDirectOpt
+    SynchronousDirectOptCompressed = _BfsPlan.Algorithm.kSynchronousDirectOptCompressed
     SynchronousTile = _BfsPlan.Algorithm.kSynchronousTile
 
 
@@ -159,6 +164,15 @@ cdef class BfsPlan(Plan):
         """
         return BfsPlan.make(_BfsPlan.SynchronousDirectOpt(alpha, beta))
 
+    @staticmethod
+    def synchronous_direction_opt_compressed(int alpha=kDefaultAlpha, int beta=kDefaultBeta):
+        """
+        Bulk-synchronous using edge direction optimizations over compressed out- and in-neighbors. Unlike
+        synchronous_direction_opt, this does not build a transposed topology, but the compressed neighbors are
+        held in addition to the topology of the graph.
+        """
+        return BfsPlan.make(_BfsPlan.SynchronousDirectOptCompressed(alpha, beta))
+
 
 def bfs(pg, uint32_t start_node, str output_property_name, BfsPlan plan = BfsPlan(), *, txn_ctx = None):
     """
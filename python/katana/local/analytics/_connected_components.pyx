@@ -50,6 +50,7 @@ cdef extern from "katana/analytics/connected_components/connected_components.h"
             kAfforest "katana::analytics::ConnectedComponentsPlan::kAfforest"
             kEdgeAfforest "katana::analytics::ConnectedComponentsPlan::kEdgeAfforest"
             kEdgeTiledAfforest "katana::analytics::ConnectedComponentsPlan::kEdgeTiledAfforest"
+            kLabelPropCompressed "katana::analytics::ConnectedComponentsPlan::kLabelPropCompressed"
 
         _ConnectedComponentsPlan.Algorithm algorithm() const
         ptrdiff_t edge_tile_size() const
@@ -64,6 +65,9 @@ cdef extern from "katana/analytics/connected_components/connected_components.h"
         @staticmethod
         _ConnectedComponentsPlan LabelProp()
 
+        @staticmethod
+        _ConnectedComponentsPlan LabelPropCompressed()
+
         @staticmethod
         _ConnectedComponentsPlan Synchronous()
 
@@ -124,6 +128,7 @@ class _ConnectedComponentsPlanAlgorithm(Enum):
     Afforest = _ConnectedComponentsPlan.Algorithm.kAfforest
     EdgeAfforest = _ConnectedComponentsPlan.Algorithm.kEdgeAfforest
     EdgeTiledAfforest = _ConnectedComponentsPlan.Algorithm.kEdgeTiledAfforest
+    LabelPropCompressed = _ConnectedComponentsPlan.Algorithm.kLabelPropCompressed
 
 
 cdef class ConnectedComponentsPlan(Plan):
@@ -181,6 +186,16 @@ cdef class ConnectedComponentsPlan(Plan):
         """
         return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.LabelProp())
     @staticmethod
+    def label_prop_compressed() -> ConnectedComponentsPlan:
+        """
+        Label propagation over compressed undirected neighbors that decodes
+        the neighbors of each node while visiting them. Unlike label_prop, this
+        does not build a transposed topology for directed graphs, but the
+        compressed neighbors are held in addition to the topology of the
+        graph. Symmetric graphs are run with label_prop.
+        """
+        return ConnectedComponentsPlan.make(_ConnectedComponentsPlan.LabelPropCompressed())
+    @staticmethod
     def synchronous() -> ConnectedComponentsPlan:
         """
         Synchronous connected components algorithm.  Initially all nodes are in
@@ -41,6 +41,7 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
             kPullResidual "katana::analytics::PagerankPlan::kPullResidual"
             kPushSynchronous "katana::analytics::PagerankPlan::kPushSynchronous"
             kPushAsynchronous "katana::analytics::PagerankPlan::kPushAsynchronous"
+            kPullTopologicalCompressed "katana::analytics::PagerankPlan::kPullTopologicalCompressed"
 
         # unsigned int kChunkSize
 
@@ -60,6 +61,8 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         _PagerankPlan PushAsynchronous(float tolerance, float alpha)
         @staticmethod
         _PagerankPlan PushSynchronous(float tolerance, unsigned int max_iterations, float alpha)
+        @staticmethod
+        _PagerankPlan PullTopologicalCompressed(float tolerance, unsigned int max_iterations, float alpha)
 
     double kDefaultTolerance "katana::analytics::PagerankPlan::kDefaultTolerance"
     int kDefaultMaxIterations "katana::analytics::PagerankPlan::kDefaultMaxIterations"
@@ -85,6 +88,7 @@ class _PagerankPlanAlgorithm(Enum):
     PullResidual = _PagerankPlan.Algorithm.kPullResidual
     PushSynchronous = _PagerankPlan.Algorithm.kPushSynchronous
     PushAsynchronous = _PagerankPlan.Algorithm.kPushAsynchronous
+    PullTopologicalCompressed = _PagerankPlan.Algorithm.kPullTopologicalCompressed
 
 
 cdef class PagerankPlan(Plan):
@@ -136,6 +140,16 @@ cdef class PagerankPlan(Plan):
         """
         return PagerankPlan.make(_PagerankPlan.PullTopological(tolerance, max_iterations, alpha))
 
+    @staticmethod
+    def pull_topological_compressed(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
+        """
+        Topological pull algorithm over compressed in-neighbors. Unlike pull_topological, this does not build a
+        transposed topology, but the compressed neighbors are held in addition to the topology of the graph.
+
+        The graph must be transposed to use this algorithm.
+        """
+        return PagerankPlan.make(_PagerankPlan.PullTopologicalCompressed(tolerance, max_iterations, alpha))
+
     @staticmethod
     def pull_residual(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
         """
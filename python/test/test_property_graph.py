@@ -6,7 +6,7 @@ import pyarrow
 import pytest
 
 from katana import do_all, do_all_operator
-from katana.local import Graph
+from katana.local import EntityIndexKind, Graph
 
 
 def test_load(graph):
@@ -154,6 +154,22 @@ def test_add_node_property(graph):
     assert graph.get_node_property("new_prop").combine_chunks() == pyarrow.array(range(graph.num_nodes()))
 
 
+def test_node_index(graph):
+    names = pyarrow.array([f"node-{i}" for i in range(graph.num_nodes())], type=pyarrow.large_string())
+    graph.add_node_property(pyarrow.table(dict(new_name=names, new_id=range(graph.num_nodes()))))
+
+    id_index = graph.get_node_index("new_id")
+    assert id_index[10] == 10
+    with pytest.raises(KeyError):
+        id_index[graph.num_nodes()]  # pylint: disable=pointless-statement
+
+    name_index = graph.get_node_index("new_name", kind=EntityIndexKind.Hash)
+    assert name_index["node-10"] == 10
+    assert list(name_index.find_all("node-10")) == [10]
+    with pytest.raises(KeyError):
+        name_index["no-such-node"]  # pylint: disable=pointless-statement
+
+
 def test_add_node_property_kwarg(graph):
     graph.add_node_property(new_prop=range(graph.num_nodes()))
     assert graph.get_node_property("new_prop").combine_chunks() == pyarrow.array(range(graph.num_nodes()))